@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+#include "storage/order_journal.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <filesystem>
+#include <mutex>
+
+using namespace order_engine;
+
+namespace {
+
+std::string benchDir(const char* name) {
+    return (std::filesystem::temp_directory_path() /
+            (std::string("bench_journal_") + name + "_" + std::to_string(::getpid()))).string();
+}
+
+services::OrderInfo makeOrder(uint64_t order_id) {
+    services::OrderInfo order{};
+    order.order_id = order_id;
+    order.user_id = 10086;
+    order.product_ids = {1001, 1002, 1003};
+    order.quantities = {1, 2, 1};
+    order.total_amount = 299.0;
+    order.created_at = 1700000000;
+    order.updated_at = 1700000000;
+    order.shipping_address = "No. 1 Software Avenue, Nanshan District, Shenzhen";
+    order.payment_method = "alipay";
+    return order;
+}
+
+// 基线：每条记录各自write + fdatasync，写入方串行
+struct SyncPerRecordLog {
+    std::mutex mutex;
+    int fd = -1;
+    off_t offset = 0;
+};
+
+SyncPerRecordLog* g_sync_log = nullptr;
+storage::OrderJournal* g_journal = nullptr;
+
+} // namespace
+
+static void BM_SyncPerRecord(benchmark::State& state) {
+    std::string dir = benchDir("sync");
+    if (state.thread_index() == 0) {
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        g_sync_log = new SyncPerRecordLog();
+        g_sync_log->fd = ::open((dir + "/baseline.log").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+
+    services::OrderInfo order = makeOrder(static_cast<uint64_t>(state.thread_index()) + 1);
+    std::string payload;
+    storage::OrderJournal::encodeOrderCreated(payload, order, "RSV-BENCH");
+    for (auto _ : state) {
+        std::lock_guard<std::mutex> lock(g_sync_log->mutex);
+        if (::pwrite(g_sync_log->fd, payload.data(), payload.size(), g_sync_log->offset) < 0 ||
+            ::fdatasync(g_sync_log->fd) != 0) {
+            state.SkipWithError("write failed");
+            break;
+        }
+        g_sync_log->offset += static_cast<off_t>(payload.size());
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        state.counters["records_per_commit"] = 1;
+        ::close(g_sync_log->fd);
+        delete g_sync_log;
+        g_sync_log = nullptr;
+        std::filesystem::remove_all(dir);
+    }
+}
+BENCHMARK(BM_SyncPerRecord)->ThreadRange(1, 32)->UseRealTime();
+
+// 组提交：每个写入方追加后等待落盘才算完成，参数为提交等待窗口（微秒）
+static void BM_GroupCommit(benchmark::State& state) {
+    std::string dir = benchDir("group");
+    if (state.thread_index() == 0) {
+        std::filesystem::remove_all(dir);
+        storage::JournalOptions options;
+        options.dir = dir;
+        options.commit_interval_us = static_cast<int>(state.range(0));
+        g_journal = new storage::OrderJournal(options);
+        if (!g_journal->open()) {
+            state.SkipWithError("open failed");
+        }
+    }
+
+    services::OrderInfo order = makeOrder(static_cast<uint64_t>(state.thread_index()) + 1);
+    for (auto _ : state) {
+        uint64_t lsn = g_journal->appendOrderCreated(order, "RSV-BENCH");
+        if (lsn == 0 || !g_journal->waitForCommit(lsn)) {
+            state.SkipWithError("append failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        g_journal->close();
+        uint64_t commits = g_journal->getCommitCount();
+        state.counters["records_per_commit"] = commits == 0 ? 0.0 :
+            static_cast<double>(g_journal->getCommittedRecords()) / static_cast<double>(commits);
+        delete g_journal;
+        g_journal = nullptr;
+        std::filesystem::remove_all(dir);
+    }
+}
+BENCHMARK(BM_GroupCommit)
+    ->ArgNames({"interval_us"})
+    ->ArgsProduct({{0, 200, 1000}})
+    ->ThreadRange(1, 32)
+    ->UseRealTime();
@@ -0,0 +1,297 @@
+#include <benchmark/benchmark.h>
+#include "utils/json_utils.h"
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+
+using namespace order_engine;
+
+namespace {
+
+// 基线：逐字节递归下降构建DOM，即多数手写解析器的做法
+struct DomValue {
+    enum Kind { kNull, kBool, kNumber, kString, kArray, kObject } kind = kNull;
+    bool boolean = false;
+    double number = 0;
+    std::string string;
+    std::vector<DomValue> array;
+    std::map<std::string, DomValue> object;
+};
+
+class DomParser {
+public:
+    explicit DomParser(std::string_view json) : json_(json), pos_(0) {}
+
+    bool parse(DomValue& value) {
+        return parseValue(value) && (skipWs(), pos_ == json_.size());
+    }
+
+private:
+    void skipWs() {
+        while (pos_ < json_.size() && std::isspace(static_cast<unsigned char>(json_[pos_]))) {
+            ++pos_;
+        }
+    }
+
+    bool parseValue(DomValue& value) {
+        skipWs();
+        if (pos_ >= json_.size()) {
+            return false;
+        }
+        char c = json_[pos_];
+        if (c == '{') {
+            value.kind = DomValue::kObject;
+            ++pos_;
+            skipWs();
+            if (pos_ < json_.size() && json_[pos_] == '}') {
+                ++pos_;
+                return true;
+            }
+            while (true) {
+                std::string key;
+                skipWs();
+                if (!parseString(key)) {
+                    return false;
+                }
+                skipWs();
+                if (pos_ >= json_.size() || json_[pos_++] != ':') {
+                    return false;
+                }
+                if (!parseValue(value.object[key])) {
+                    return false;
+                }
+                skipWs();
+                if (pos_ >= json_.size()) {
+                    return false;
+                }
+                if (json_[pos_] == ',') {
+                    ++pos_;
+                    continue;
+                }
+                return json_[pos_++] == '}';
+            }
+        }
+        if (c == '[') {
+            value.kind = DomValue::kArray;
+            ++pos_;
+            skipWs();
+            if (pos_ < json_.size() && json_[pos_] == ']') {
+                ++pos_;
+                return true;
+            }
+            while (true) {
+                value.array.emplace_back();
+                if (!parseValue(value.array.back())) {
+                    return false;
+                }
+                skipWs();
+                if (pos_ >= json_.size()) {
+                    return false;
+                }
+                if (json_[pos_] == ',') {
+                    ++pos_;
+                    continue;
+                }
+                return json_[pos_++] == ']';
+            }
+        }
+        if (c == '"') {
+            value.kind = DomValue::kString;
+            return parseString(value.string);
+        }
+        if (json_.substr(pos_, 4) == "true" || json_.substr(pos_, 5) == "false") {
+            value.kind = DomValue::kBool;
+            value.boolean = c == 't';
+            pos_ += value.boolean ? 4 : 5;
+            return true;
+        }
+        if (json_.substr(pos_, 4) == "null") {
+            pos_ += 4;
+            return true;
+        }
+        std::string token;
+        while (pos_ < json_.size() && std::strchr("+-.eE0123456789", json_[pos_]) != nullptr) {
+            token += json_[pos_++];
+        }
+        value.kind = DomValue::kNumber;
+        value.number = std::strtod(token.c_str(), nullptr);
+        return !token.empty();
+    }
+
+    bool parseString(std::string& out) {
+        if (pos_ >= json_.size() || json_[pos_] != '"') {
+            return false;
+        }
+        ++pos_;
+        while (pos_ < json_.size()) {
+            char c = json_[pos_++];
+            if (c == '"') {
+                return true;
+            }
+            if (c == '\\' && pos_ < json_.size()) {
+                char e = json_[pos_++];
+                out += e == 'n' ? '\n' : e == 't' ? '\t' : e;
+                continue;
+            }
+            out += c;
+        }
+        return false;
+    }
+
+    std::string_view json_;
+    size_t pos_;
+};
+
+services::OrderInfo makeOrder(size_t items) {
+    services::OrderInfo order{};
+    order.order_id = 1729000000123456ULL;
+    order.user_id = 10086;
+    for (size_t i = 0; i < items; ++i) {
+        order.product_ids.push_back(100000 + i);
+        order.quantities.push_back(static_cast<uint32_t>(i % 5 + 1));
+    }
+    order.total_amount = 1299.50;
+    order.status = services::OrderStatus::PENDING;
+    order.created_at = 1792300000;
+    order.updated_at = 1792300000;
+    order.shipping_address = "No. 1 Software Avenue, Nanshan District, Shenzhen \"Tower B\"";
+    order.payment_method = "alipay";
+    return order;
+}
+
+std::string makeRequestBody(size_t items) {
+    std::string body;
+    utils::JsonWriter writer(body);
+    services::OrderInfo order = makeOrder(items);
+    writer.startObject();
+    writer.key("user_id");
+    writer.writeUint(order.user_id);
+    writer.key("items");
+    writer.startArray();
+    for (size_t i = 0; i < items; ++i) {
+        writer.startObject();
+        writer.key("product_id");
+        writer.writeUint(order.product_ids[i]);
+        writer.key("quantity");
+        writer.writeUint(order.quantities[i]);
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.key("total_amount");
+    writer.writeDouble(order.total_amount);
+    writer.key("shipping_address");
+    writer.writeString(order.shipping_address);
+    writer.key("payment_method");
+    writer.writeString(order.payment_method);
+    writer.endObject();
+    return body;
+}
+
+void streamEscaped(std::ostringstream& os, const std::string& value) {
+    os << '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            os << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        } else {
+            os << c;
+        }
+    }
+    os << '"';
+}
+
+} // namespace
+
+static void BM_DomParse(benchmark::State& state) {
+    std::string body = makeRequestBody(state.range(0));
+    for (auto _ : state) {
+        DomValue root;
+        DomParser parser(body);
+        bool ok = parser.parse(root);
+        benchmark::DoNotOptimize(ok);
+        services::OrderInfo order{};
+        order.user_id = static_cast<uint64_t>(root.object["user_id"].number);
+        for (const DomValue& item : root.object["items"].array) {
+            order.product_ids.push_back(static_cast<uint64_t>(item.object.at("product_id").number));
+            order.quantities.push_back(static_cast<uint32_t>(item.object.at("quantity").number));
+        }
+        order.shipping_address = root.object["shipping_address"].string;
+        benchmark::DoNotOptimize(order);
+    }
+    state.SetBytesProcessed(state.iterations() * body.size());
+}
+BENCHMARK(BM_DomParse)->Arg(1)->Arg(8)->Arg(64);
+
+static void BM_IndexParseScalar(benchmark::State& state) {
+    std::string body = makeRequestBody(state.range(0));
+    utils::JsonParser parser(false);
+    std::string error;
+    for (auto _ : state) {
+        services::OrderInfo order{};
+        bool ok = utils::parseOrderInfo(parser, body, order, error);
+        benchmark::DoNotOptimize(ok);
+        benchmark::DoNotOptimize(order);
+    }
+    state.SetBytesProcessed(state.iterations() * body.size());
+}
+BENCHMARK(BM_IndexParseScalar)->Arg(1)->Arg(8)->Arg(64);
+
+static void BM_IndexParseSimd(benchmark::State& state) {
+    if (!utils::JsonParser::simdSupported()) {
+        state.SkipWithError("AVX2 not supported");
+        return;
+    }
+    std::string body = makeRequestBody(state.range(0));
+    utils::JsonParser parser(true);
+    std::string error;
+    for (auto _ : state) {
+        services::OrderInfo order{};
+        bool ok = utils::parseOrderInfo(parser, body, order, error);
+        benchmark::DoNotOptimize(ok);
+        benchmark::DoNotOptimize(order);
+    }
+    state.SetBytesProcessed(state.iterations() * body.size());
+}
+BENCHMARK(BM_IndexParseSimd)->Arg(1)->Arg(8)->Arg(64);
+
+static void BM_StreamSerialize(benchmark::State& state) {
+    services::OrderInfo order = makeOrder(state.range(0));
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::ostringstream os;
+        os << "{\"order_id\":" << order.order_id << ",\"user_id\":" << order.user_id
+           << ",\"status\":\"PENDING\",\"total_amount\":" << std::setprecision(17) << order.total_amount
+           << ",\"items\":[";
+        for (size_t i = 0; i < order.product_ids.size(); ++i) {
+            os << (i ? "," : "") << "{\"product_id\":" << order.product_ids[i]
+               << ",\"quantity\":" << order.quantities[i] << "}";
+        }
+        os << "],\"shipping_address\":";
+        streamEscaped(os, order.shipping_address);
+        os << ",\"payment_method\":";
+        streamEscaped(os, order.payment_method);
+        os << ",\"created_at\":" << order.created_at << ",\"updated_at\":" << order.updated_at << "}";
+        std::string out = os.str();
+        bytes = out.size();
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_StreamSerialize)->Arg(1)->Arg(8)->Arg(64);
+
+static void BM_WriterSerialize(benchmark::State& state) {
+    services::OrderInfo order = makeOrder(state.range(0));
+    // 模拟连接输出缓冲：容量跨请求保留
+    std::string out;
+    for (auto _ : state) {
+        out.clear();
+        utils::JsonWriter writer(out);
+        utils::writeOrderInfo(writer, order);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * out.size());
+}
+BENCHMARK(BM_WriterSerialize)->Arg(1)->Arg(8)->Arg(64);
@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+#include "protocol/order_protocol.h"
+#include "order.pb.h"
+
+using namespace order_engine;
+
+namespace {
+
+services::OrderInfo makeOrder(size_t items) {
+    services::OrderInfo order{};
+    order.user_id = 10086;
+    for (size_t i = 0; i < items; ++i) {
+        order.product_ids.push_back(100000 + i);
+        order.quantities.push_back(static_cast<uint32_t>(i % 5 + 1));
+    }
+    order.total_amount = 1299.50;
+    order.shipping_address = "No. 1 Software Avenue, Nanshan District, Shenzhen";
+    order.payment_method = "alipay";
+    return order;
+}
+
+void fillProto(const services::OrderInfo& order, proto::CreateOrderRequest& request) {
+    request.set_user_id(order.user_id);
+    request.set_total_amount_cents(static_cast<int64_t>(order.total_amount * 100));
+    for (size_t i = 0; i < order.product_ids.size(); ++i) {
+        proto::LineItem* item = request.add_items();
+        item->set_product_id(order.product_ids[i]);
+        item->set_quantity(order.quantities[i]);
+    }
+    request.set_shipping_address(order.shipping_address);
+    request.set_payment_method(order.payment_method);
+}
+
+} // namespace
+
+static void BM_BinaryEncode(benchmark::State& state) {
+    services::OrderInfo order = makeOrder(state.range(0));
+    std::string buffer;
+    for (auto _ : state) {
+        buffer.clear();
+        protocol::encodeCreateOrderRequest(buffer, 1, order);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK(BM_BinaryEncode)->Arg(1)->Arg(8)->Arg(64);
+
+static void BM_ProtobufEncode(benchmark::State& state) {
+    services::OrderInfo order = makeOrder(state.range(0));
+    std::string buffer;
+    for (auto _ : state) {
+        proto::CreateOrderRequest request;
+        fillProto(order, request);
+        buffer.clear();
+        request.SerializeToString(&buffer);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK(BM_ProtobufEncode)->Arg(1)->Arg(8)->Arg(64);
+
+// 解码并读取全部字段，两者工作量对齐
+static void BM_BinaryDecode(benchmark::State& state) {
+    std::string buffer;
+    protocol::encodeCreateOrderRequest(buffer, 1, makeOrder(state.range(0)));
+    for (auto _ : state) {
+        protocol::FrameView frame;
+        protocol::CreateOrderView view;
+        if (protocol::decodeFrame(buffer.data(), buffer.size(), frame) != protocol::DecodeStatus::kOk ||
+            protocol::CreateOrderView::parse(frame, view) != protocol::DecodeStatus::kOk) {
+            state.SkipWithError("decode failed");
+            break;
+        }
+        uint64_t sum = view.userId();
+        for (size_t i = 0; i < view.itemCount(); ++i) {
+            sum += view.item(i).productId() + view.item(i).quantity();
+        }
+        sum += view.shippingAddress().size() + view.paymentMethod().size();
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK(BM_BinaryDecode)->Arg(1)->Arg(8)->Arg(64);
+
+static void BM_ProtobufDecode(benchmark::State& state) {
+    proto::CreateOrderRequest source;
+    fillProto(makeOrder(state.range(0)), source);
+    std::string buffer = source.SerializeAsString();
+    for (auto _ : state) {
+        proto::CreateOrderRequest request;
+        if (!request.ParseFromString(buffer)) {
+            state.SkipWithError("decode failed");
+            break;
+        }
+        uint64_t sum = request.user_id();
+        for (const auto& item : request.items()) {
+            sum += item.product_id() + item.quantity();
+        }
+        sum += request.shipping_address().size() + request.payment_method().size();
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size());
+}
+BENCHMARK(BM_ProtobufDecode)->Arg(1)->Arg(8)->Arg(64);
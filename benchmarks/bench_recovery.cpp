@@ -0,0 +1,126 @@
+#include <benchmark/benchmark.h>
+#include "storage/order_journal.h"
+#include "storage/order_recovery.h"
+#include "storage/order_snapshot.h"
+#include <unistd.h>
+#include <filesystem>
+
+using namespace order_engine;
+
+namespace {
+
+std::string benchDir(const char* name) {
+    return (std::filesystem::temp_directory_path() /
+            (std::string("bench_recovery_") + name + "_" + std::to_string(::getpid()))).string();
+}
+
+services::OrderInfo makeOrder(uint64_t order_id) {
+    services::OrderInfo order{};
+    order.order_id = order_id;
+    order.user_id = order_id % 100000;
+    order.product_ids = {1001, 1002};
+    order.quantities = {1, 2};
+    order.total_amount = 199.0;
+    order.created_at = 1700000000;
+    order.updated_at = 1700000000;
+    order.shipping_address = "No. 1 Software Avenue, Nanshan District, Shenzhen";
+    order.payment_method = "alipay";
+    return order;
+}
+
+void fillStore(services::OrderStore& store, size_t count) {
+    store.executeAll([count, &store](size_t index, services::OrderShard& shard) {
+        for (uint64_t id = 1; id <= count; ++id) {
+            if (store.shardOf(id) == index) {
+                shard.insert(makeOrder(id), "RSV-0000000001");
+            }
+        }
+    });
+}
+
+} // namespace
+
+// 快照写入：各分片并行序列化 + 顺序写文件
+static void BM_SnapshotWrite(benchmark::State& state) {
+    std::string dir = benchDir("write");
+    services::OrderStore store;
+    store.start();
+    fillStore(store, static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        storage::SnapshotInfo info;
+        if (!storage::OrderSnapshot::write(dir, store, nullptr, &info)) {
+            state.SkipWithError("write failed");
+            break;
+        }
+        state.counters["bytes_per_order"] = static_cast<double>(info.bytes) / static_cast<double>(info.orders);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    store.stop();
+    std::filesystem::remove_all(dir);
+}
+BENCHMARK(BM_SnapshotWrite)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 快照加载：mmap + 各分片并行解码
+static void BM_SnapshotLoad(benchmark::State& state) {
+    std::string dir = benchDir("load");
+    std::string path;
+    {
+        services::OrderStore store;
+        fillStore(store, static_cast<size_t>(state.range(0)));
+        storage::SnapshotInfo info;
+        storage::OrderSnapshot::write(dir, store, nullptr, &info);
+        path = info.path;
+    }
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto store = std::make_unique<services::OrderStore>();
+        store->start();
+        state.ResumeTiming();
+        if (!storage::OrderSnapshot::load(path, *store)) {
+            state.SkipWithError("load failed");
+            break;
+        }
+        state.PauseTiming();
+        store->stop();
+        store.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    std::filesystem::remove_all(dir);
+}
+BENCHMARK(BM_SnapshotLoad)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 日志回放：顺序读取校验 + 各分片并行应用
+static void BM_JournalReplay(benchmark::State& state) {
+    storage::JournalOptions options;
+    options.dir = benchDir("journal");
+    options.sync = false;
+    {
+        storage::OrderJournal journal(options);
+        journal.open();
+        uint64_t lsn = 0;
+        for (uint64_t id = 1; id <= static_cast<uint64_t>(state.range(0)); ++id) {
+            lsn = journal.appendOrderCreated(makeOrder(id), "RSV-0000000001");
+        }
+        journal.waitForCommit(lsn);
+        journal.close();
+    }
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto store = std::make_unique<services::OrderStore>();
+        store->start();
+        state.ResumeTiming();
+        uint64_t applied = 0;
+        if (!storage::OrderRecovery::replayJournal(options.dir, {}, *store, applied)) {
+            state.SkipWithError("replay failed");
+            break;
+        }
+        state.PauseTiming();
+        store->stop();
+        store.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    std::filesystem::remove_all(options.dir);
+}
+BENCHMARK(BM_JournalReplay)->Arg(1 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -2,6 +2,8 @@
 
 #include <memory>
 #include <string>
+#include <utility>
+#include <fmt/format.h>
 
 // 前向声明避免包含冲突
 namespace spdlog {
@@ -68,13 +70,33 @@ private:
     std::shared_ptr<spdlog::logger> business_logger_;
 };
 
-// 便捷宏定义
-#define LOG_TRACE(msg) order_engine::common::Logger::getInstance().trace(msg)
-#define LOG_DEBUG(msg) order_engine::common::Logger::getInstance().debug(msg)
-#define LOG_INFO(msg) order_engine::common::Logger::getInstance().info(msg)
-#define LOG_WARN(msg) order_engine::common::Logger::getInstance().warn(msg)
-#define LOG_ERROR(msg) order_engine::common::Logger::getInstance().error(msg)
-#define LOG_CRITICAL(msg) order_engine::common::Logger::getInstance().critical(msg)
+/**
+ * @brief 日志消息格式化
+ *
+ * 只有一个参数时原样作为消息；带参数时第一个参数是格式串，C++20下
+ * 由fmt::format_string在编译期检查占位符与参数
+ */
+inline std::string formatLog(const char* message) {
+    return message;
+}
+
+inline const std::string& formatLog(const std::string& message) {
+    return message;
+}
+
+template <typename T, typename... Args>
+std::string formatLog(fmt::format_string<T, Args...> format, T&& arg, Args&&... args) {
+    return fmt::format(format, std::forward<T>(arg), std::forward<Args>(args)...);
+}
+
+// 便捷宏定义：LOG_INFO("msg")或LOG_INFO("fd: {}, peer: {}", fd, peer)
+#define LOG_TRACE(...) order_engine::common::Logger::getInstance().trace(order_engine::common::formatLog(__VA_ARGS__))
+#define LOG_DEBUG(...) order_engine::common::Logger::getInstance().debug(order_engine::common::formatLog(__VA_ARGS__))
+#define LOG_INFO(...) order_engine::common::Logger::getInstance().info(order_engine::common::formatLog(__VA_ARGS__))
+#define LOG_WARN(...) order_engine::common::Logger::getInstance().warn(order_engine::common::formatLog(__VA_ARGS__))
+#define LOG_ERROR(...) order_engine::common::Logger::getInstance().error(order_engine::common::formatLog(__VA_ARGS__))
+#define LOG_CRITICAL(...) \
+    order_engine::common::Logger::getInstance().critical(order_engine::common::formatLog(__VA_ARGS__))
 
 // 格式化日志宏
 #define LOG_DEBUG_FMT(fmt, arg) order_engine::common::Logger::getInstance().debug_fmt(fmt, arg)
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace order_engine {
+namespace http {
+
+enum class Method : uint8_t {
+    kGet,
+    kHead,
+    kPost,
+    kPut,
+    kDelete,
+    kPatch,
+    kOptions,
+    kUnknown
+};
+
+const size_t kMethodCount = static_cast<size_t>(Method::kUnknown);
+
+const char* methodToString(Method method);
+
+struct HttpHeader {
+    std::string_view name;
+    std::string_view value;
+};
+
+/**
+ * @brief HTTP请求视图
+ *
+ * 所有字段都是指向连接输入缓冲区的string_view，
+ * 只在本次分发期间有效，需要保留时由调用方拷贝
+ */
+struct HttpRequest {
+    static const size_t kMaxHeaders = 32;
+
+    Method method = Method::kUnknown;
+    std::string_view target;     // 原始请求目标（路径+查询串）
+    std::string_view path;
+    std::string_view query;
+    int version_minor = 1;       // HTTP/1.x
+    bool keep_alive = true;
+
+    HttpHeader headers[kMaxHeaders];
+    size_t header_count = 0;
+    std::string_view body;
+
+    // 头部名大小写不敏感，不存在时返回空
+    std::string_view header(std::string_view name) const;
+    // 查询参数（不做百分号解码）
+    std::string_view queryParam(std::string_view name) const;
+};
+
+enum class ParseStatus {
+    kComplete,
+    kNeedMore,
+    kBadRequest,
+    kHeadersTooLarge,
+    kBodyTooLarge,
+    kNotImplemented     // 例如chunked请求体
+};
+
+/**
+ * @brief 增量式HTTP/1.1请求解析器
+ *
+ * 每个连接一个实例。数据不足时记录已扫描的位置和已解析出的
+ * 头部/消息体长度，下次只扫描新到的数据；请求完整时一次性
+ * 填充HttpRequest视图。解析过程不分配内存。
+ *
+ * 支持keep-alive和流水线：一次调用只解析缓冲区头部的一个请求，
+ * 调用方消费consumed字节后继续解析下一个
+ */
+class HttpParser {
+public:
+    static constexpr size_t kMaxHeaderSize = 16 * 1024;
+    static constexpr size_t kMaxBodySize = 1 << 20;
+
+    HttpParser() { reset(); }
+
+    ParseStatus parse(const char* data, size_t len, HttpRequest& request, size_t& consumed);
+    void reset();
+
+private:
+    ParseStatus parseHead(const char* data, size_t header_len, HttpRequest& request);
+
+    size_t scanned_;        // 已确认不含头部结束符的字节数
+    size_t header_len_;     // 头部长度（含空行），0表示头部未完整
+    size_t body_len_;
+};
+
+} // namespace http
+} // namespace order_engine
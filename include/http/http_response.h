@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace order_engine {
+namespace network {
+class TcpConnection;
+}
+
+namespace http {
+
+/**
+ * @brief HTTP响应写入器
+ *
+ * 直接把状态行、头部和消息体追加到输出缓冲区，不构造中间对象：
+ * - send()：一次性发送，带Content-Length
+ * - beginChunked()/writeChunk()/endChunked()：分块发送，长度未知的
+ *   响应（如/metrics）边生成边写；缓冲超过阈值时先推给连接
+ * - beginBody()/endBody()：调用方（如JsonWriter）直接序列化到输出缓冲区，
+ *   Content-Length先写定宽占位，结束时回填
+ *
+ * HEAD请求只写头部。setStatus()须在addHeader()之前调用；
+ * 每个响应必须且只能以send()、endChunked()或endBody()结束
+ */
+class HttpResponse {
+public:
+    static const size_t kFlushThreshold = 64 * 1024;
+
+    HttpResponse(std::string& out, network::TcpConnection* conn, bool keep_alive, bool head_only);
+
+    void setStatus(int code);
+    void addHeader(std::string_view name, std::string_view value);
+
+    void send(std::string_view body, std::string_view content_type = "text/plain");
+
+    void beginChunked(std::string_view content_type = "text/plain");
+    void writeChunk(std::string_view data);
+    void endChunked();
+
+    std::string& beginBody(std::string_view content_type = "application/json");
+    void endBody();
+
+    bool isFinished() const { return finished_; }
+    bool keepAlive() const { return keep_alive_; }
+    int status() const { return status_; }
+
+    static const char* reasonPhrase(int code);
+
+private:
+    void writeStatusLine();
+    void writeCommonHeaders(std::string_view content_type);
+
+    std::string& out_;
+    network::TcpConnection* conn_;
+    bool keep_alive_;
+    bool head_only_;
+    int status_;
+    bool head_written_;
+    bool chunked_;
+    bool finished_;
+    size_t length_offset_;  // beginBody()写入的Content-Length占位位置，0表示未开始
+    size_t body_offset_;
+};
+
+} // namespace http
+} // namespace order_engine
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "http/http_parser.h"
+#include "http/http_response.h"
+
+namespace order_engine {
+namespace http {
+
+/**
+ * @brief 路由参数（:name和*name捕获的路径段，指向请求缓冲区）
+ */
+class RouteParams {
+public:
+    static const size_t kMaxParams = 8;
+
+    std::string_view get(std::string_view name) const;
+    size_t size() const { return count_; }
+
+private:
+    friend class HttpRouter;
+
+    bool push(std::string_view name, std::string_view value);
+
+    struct Param {
+        std::string_view name;
+        std::string_view value;
+    };
+    Param params_[kMaxParams];
+    size_t count_ = 0;
+};
+
+/**
+ * @brief 前缀树路由
+ *
+ * 按'/'分段建树，每个节点可有静态子节点、一个参数子节点(:id)
+ * 和一个通配子节点(*rest，匹配剩余路径)。匹配优先级：
+ * 静态 > 参数 > 通配，必要时回溯。匹配过程不分配内存。
+ *
+ * 路由在服务启动前注册，运行期只读，可被多个Reactor线程并发匹配
+ */
+class HttpRouter {
+public:
+    using Handler = std::function<void(const HttpRequest&, const RouteParams&, HttpResponse&)>;
+
+    enum class MatchResult {
+        kMatched,
+        kNotFound,
+        kMethodNotAllowed
+    };
+
+    HttpRouter();
+    ~HttpRouter();
+
+    // 注册路由，模式非法或与已有路由冲突时返回false
+    bool addRoute(Method method, std::string_view pattern, Handler handler);
+
+    // HEAD未单独注册时回退到GET
+    MatchResult match(Method method, std::string_view path, const Handler*& handler,
+                      RouteParams& params) const;
+
+private:
+    struct Node;
+
+    const Node* matchNode(const Node* node, std::string_view rest, RouteParams& params) const;
+
+    std::unique_ptr<Node> root_;
+};
+
+} // namespace http
+} // namespace order_engine
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include "http/http_router.h"
+#include "network/tcp_server.h"
+
+namespace order_engine {
+namespace http {
+
+/**
+ * @brief HTTP/1.1服务器
+ *
+ * 复用TcpServer的主从Reactor线程模型，通过分帧回调在连接缓冲区上
+ * 就地解析请求：
+ * - keep-alive：HTTP/1.1默认保持连接，Connection: close时发送完关闭写端
+ * - 流水线：一次读事件内的多个请求按顺序处理，响应合并发送
+ * - 解析错误时回复4xx/5xx并关闭连接
+ *
+ * 路由须在start()之前注册
+ */
+class HttpServer {
+public:
+    HttpServer(const std::string& ip, uint16_t port, int thread_num = 1);
+    ~HttpServer();
+
+    HttpRouter& router() { return router_; }
+
+    bool start();
+    void stop();
+
+    bool isRunning() const { return server_->isRunning(); }
+    int getConnectionCount() const { return server_->getConnectionCount(); }
+    uint64_t getRequestCount() const { return request_count_.load(); }
+
+private:
+    size_t handleData(const network::TcpConnectionPtr& conn, const char* data, size_t len);
+    void dispatch(const HttpRequest& request, HttpResponse& response);
+    static int statusForParseError(ParseStatus status);
+
+    std::unique_ptr<network::TcpServer> server_;
+    HttpRouter router_;
+    std::atomic<uint64_t> request_count_;
+};
+
+} // namespace http
+} // namespace order_engine
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include "message/order_event_pipeline.h"
+
+struct rd_kafka_s;
+
+namespace order_engine {
+namespace message {
+
+/**
+ * @brief Kafka生产者配置（对应配置文件[kafka]节）
+ */
+struct KafkaConfig {
+    std::string brokers = "localhost:9092";
+    std::string client_id = "order_engine_producer";
+    std::string compression_type = "snappy";
+    int batch_size = 16384;
+    int linger_ms = 5;
+    int retries = 3;
+    int request_timeout_ms = 30000;
+    int max_in_flight_requests = 5;
+    int queue_buffering_max_messages = 100000;   // librdkafka本地队列上限
+};
+
+/**
+ * @brief Kafka事件输出端（librdkafka）
+ *
+ * 批次中的每条记录按流水线算好的分区、以订单ID为键发送；librdkafka再按
+ * batch.size/linger.ms在本地攒批并负责重试。write()从不阻塞：本地队列满时
+ * 该批次剩余记录计为失败。投递结果通过回调统计，在每次write()时轮询
+ */
+class KafkaProducer : public EventSink {
+public:
+    explicit KafkaProducer(KafkaConfig config);
+    ~KafkaProducer() override;
+
+    KafkaProducer(const KafkaProducer&) = delete;
+    KafkaProducer& operator=(const KafkaProducer&) = delete;
+
+    bool connect();
+    bool write(const EventBatch& batch) override;
+    // 最多等待request_timeout_ms，把本地队列中的消息发完
+    void flush() override;
+
+    uint64_t getDeliveredCount() const { return delivered_.load(std::memory_order_relaxed); }
+    uint64_t getFailedCount() const { return failed_.load(std::memory_order_relaxed); }
+
+    // 投递回调（librdkafka线程外、poll时调用）
+    void recordDelivery(bool success);
+
+private:
+    KafkaConfig config_;
+    rd_kafka_s* producer_;
+
+    std::atomic<uint64_t> delivered_;
+    std::atomic<uint64_t> failed_;
+};
+
+} // namespace message
+} // namespace order_engine
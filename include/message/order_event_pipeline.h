@@ -0,0 +1,185 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "services/order_service.h"
+#include "utils/mpsc_ring.h"
+
+namespace order_engine {
+namespace message {
+
+/**
+ * @brief 订单事件类型
+ */
+enum class OrderEventType : uint8_t {
+    kCreated = 1,
+    kStatusChanged = 2,
+    kCancelled = 3
+};
+
+/**
+ * @brief 订单事件（定长，发布时不分配内存）
+ */
+struct OrderEvent {
+    uint64_t order_id;
+    uint64_t user_id;
+    double total_amount;
+    int64_t timestamp;
+    OrderEventType type;
+    services::OrderStatus status;
+};
+
+/**
+ * @brief 交给事件输出端的一个批次：同一主题、同一分区的若干条记录
+ *
+ * 每条记录是一行JSON（以'\n'结尾），连续存放在payload中，
+ * 第i条从offsets[i]开始，到offsets[i+1]（或payload末尾）结束
+ */
+struct EventBatch {
+    std::string topic;
+    uint32_t partition = 0;
+    std::string payload;
+    std::vector<uint32_t> offsets;
+    std::vector<uint64_t> keys;   // 每条记录的分区键（订单ID）
+    std::chrono::steady_clock::time_point first_at;
+
+    size_t count() const { return offsets.size(); }
+    std::string_view record(size_t i) const {
+        size_t end = i + 1 < offsets.size() ? offsets[i + 1] : payload.size();
+        return std::string_view(payload).substr(offsets[i], end - offsets[i]);
+    }
+    void clear() {
+        payload.clear();
+        offsets.clear();
+        keys.clear();
+    }
+};
+
+/**
+ * @brief 事件输出端（Kafka、本地文件等）
+ *
+ * 只在流水线的序列化线程中调用
+ */
+class EventSink {
+public:
+    virtual ~EventSink() = default;
+
+    // 返回false时该批次计为失败，不重试（重试由输出端自己负责）
+    virtual bool write(const EventBatch& batch) = 0;
+    // 流水线停止时调用，等待已交出的批次写完
+    virtual void flush() {}
+};
+
+/**
+ * @brief 本地分段文件输出端（测试和无Kafka环境使用）
+ *
+ * 按Kafka的目录布局写入：<dir>/<topic>-<partition>/<首条记录偏移，20位>.log，
+ * 每条记录一行JSON。段达到segment_size后滚动到新文件。不fsync
+ */
+class FileEventSink : public EventSink {
+public:
+    explicit FileEventSink(std::string dir, size_t segment_size = 64 * 1024 * 1024);
+    ~FileEventSink() override;
+
+    bool write(const EventBatch& batch) override;
+
+    // 分区下一条记录的偏移（已写入的记录数）
+    uint64_t nextOffset(std::string_view topic, uint32_t partition) const;
+    static std::string segmentName(uint64_t base_offset);
+
+private:
+    struct Segment {
+        int fd = -1;
+        size_t bytes = 0;
+        uint64_t next_offset = 0;
+    };
+
+    bool roll(const std::string& partition_dir, Segment& segment);
+
+    std::string dir_;
+    size_t segment_size_;
+    std::unordered_map<std::string, Segment> segments_;   // 键为"<topic>-<partition>"
+};
+
+/**
+ * @brief 事件流水线配置
+ */
+struct EventPipelineOptions {
+    std::string topic = "order_events";
+    size_t ring_capacity = 65536;
+    uint32_t partitions = 16;
+    size_t batch_bytes = 16384;   // 分区批次达到后立即交给输出端（kafka.batch_size）
+    int linger_ms = 5;            // 分区批次第一条记录最多等待这么久（kafka.linger_ms）
+};
+
+/**
+ * @brief 订单事件发布流水线
+ *
+ * 订单线程把定长事件写入无锁MPSC环形队列后立即返回，从不阻塞；队列满时
+ * 丢弃事件并计数（getDroppedCount()），序列化线程每秒最多打印一次丢弃告警。
+ * 序列化线程取出事件编码成JSON，按订单ID分区攒批（同一订单的事件进入同一
+ * 分区，保持顺序），批次达到batch_bytes或等待满linger_ms后交给输出端。
+ * 队列空闲时序列化线程每次休眠1毫秒
+ */
+class OrderEventPipeline {
+public:
+    explicit OrderEventPipeline(std::shared_ptr<EventSink> sink,
+                                EventPipelineOptions options = EventPipelineOptions());
+    ~OrderEventPipeline();
+
+    OrderEventPipeline(const OrderEventPipeline&) = delete;
+    OrderEventPipeline& operator=(const OrderEventPipeline&) = delete;
+
+    void start();
+    // 交出队列中剩余的事件后停止
+    void stop();
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+    // 任意线程调用，无锁；队列满时丢弃并返回false
+    bool publish(const OrderEvent& event);
+
+    // 统计
+    uint64_t getPublishedCount() const { return published_.load(std::memory_order_relaxed); }
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t getSentCount() const { return sent_.load(std::memory_order_relaxed); }
+    uint64_t getBatchCount() const { return batch_count_.load(std::memory_order_relaxed); }
+    uint64_t getFailedBatchCount() const { return failed_batch_count_.load(std::memory_order_relaxed); }
+    size_t queueDepth() const { return ring_.size(); }
+    size_t queueCapacity() const { return ring_.capacity(); }
+
+    static void serialize(const OrderEvent& event, std::string& out);
+    static uint32_t partitionFor(uint64_t order_id, uint32_t partitions);
+    static const char* eventTypeName(OrderEventType type);
+
+private:
+    void serializeLoop();
+    // 交出批次满或等待超时的分区，force时交出全部
+    void flushReady(std::chrono::steady_clock::time_point now, bool force);
+    void send(EventBatch& batch);
+
+    std::shared_ptr<EventSink> sink_;
+    EventPipelineOptions options_;
+    utils::MpscRing<OrderEvent> ring_;
+    std::vector<EventBatch> batches_;   // 每个分区一个，只由序列化线程访问
+
+    std::thread serializer_thread_;
+    std::atomic<bool> running_;
+
+    std::atomic<uint64_t> published_;
+    std::atomic<uint64_t> dropped_;
+    std::atomic<uint64_t> sent_;
+    std::atomic<uint64_t> batch_count_;
+    std::atomic<uint64_t> failed_batch_count_;
+};
+
+} // namespace message
+} // namespace order_engine
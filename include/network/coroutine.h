@@ -0,0 +1,225 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace order_engine {
+namespace network {
+
+/**
+ * @brief 协程帧内存池
+ *
+ * 每个Reactor持有一个，按64字节粒度分级缓存协程帧：
+ * - 帧释放后回到所属线程的空闲链表，稳态下挂起/恢复不触发堆分配
+ * - 跨线程释放或超出分级上限时直接交还全局堆
+ * - 仅由所属Reactor线程访问，无需加锁
+ */
+class FramePool {
+public:
+    FramePool() = default;
+    ~FramePool();
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    void* allocate(size_t size);
+    void deallocate(void* ptr, size_t size);
+
+    // 当前线程绑定的内存池（由Reactor::loop设置）
+    static FramePool* current();
+    static void setCurrent(FramePool* pool);
+
+    // 统计信息
+    uint64_t getAllocCount() const { return alloc_count_; }
+    uint64_t getReuseCount() const { return reuse_count_; }
+    size_t getCachedBlocks() const;
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    static size_t sizeClass(size_t size) { return (size + kGranularity - 1) / kGranularity; }
+
+    static const size_t kGranularity = 64;
+    static const size_t kNumClasses = 64;          // 最大缓存4KB的帧
+    static const size_t kMaxCachedPerClass = 1024;
+
+    FreeBlock* free_lists_[kNumClasses] = {};
+    size_t free_counts_[kNumClasses] = {};
+    uint64_t alloc_count_ = 0;
+    uint64_t reuse_count_ = 0;
+};
+
+template <typename T = void>
+class Task;
+
+namespace detail {
+
+/**
+ * @brief 协程帧分配入口
+ *
+ * 帧头部记录分配时的FramePool，释放时若仍在同一线程则归还池中
+ */
+void* allocateFrame(size_t size);
+void deallocateFrame(void* ptr, size_t size);
+
+struct PromiseBase {
+    static void* operator new(size_t size) { return allocateFrame(size); }
+    static void operator delete(void* ptr, size_t size) { deallocateFrame(ptr, size); }
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            // 对称转移到等待者，避免递归恢复导致栈增长
+            auto continuation = handle.promise().continuation_;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() { exception_ = std::current_exception(); }
+
+    void rethrowIfFailed() {
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+    }
+
+    std::coroutine_handle<> continuation_;
+    std::exception_ptr exception_;
+};
+
+template <typename T>
+struct TaskPromise : PromiseBase {
+    Task<T> get_return_object() noexcept;
+
+    template <typename U>
+    void return_value(U&& value) { value_.emplace(std::forward<U>(value)); }
+
+    T takeResult() {
+        rethrowIfFailed();
+        return std::move(*value_);
+    }
+
+    std::optional<T> value_;
+};
+
+template <>
+struct TaskPromise<void> : PromiseBase {
+    Task<void> get_return_object() noexcept;
+
+    void return_void() const noexcept {}
+
+    void takeResult() { rethrowIfFailed(); }
+};
+
+} // namespace detail
+
+/**
+ * @brief 惰性启动的协程任务
+ *
+ * 被co_await时才开始执行，结束时对称转移回等待者。
+ * 与回调接口相比，多步业务流程可以写成顺序代码：
+ *
+ *     Task<void> handle(TcpConnectionPtr conn) {
+ *         char buf[4096];
+ *         ssize_t n = co_await conn->read(buf, sizeof(buf));
+ *         co_await conn->write(buf, n);
+ *     }
+ */
+template <typename T>
+class Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() noexcept = default;
+    explicit Task(Handle handle) noexcept : handle_(handle) {}
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() { destroy(); }
+
+    bool valid() const noexcept { return static_cast<bool>(handle_); }
+    bool done() const noexcept { return !handle_ || handle_.done(); }
+
+    // 等待者接口
+    bool await_ready() const noexcept { return done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept {
+        handle_.promise().continuation_ = awaiter;
+        return handle_;
+    }
+
+    T await_resume() { return handle_.promise().takeResult(); }
+
+private:
+    void destroy() {
+        if (handle_) {
+            handle_.destroy();
+            handle_ = nullptr;
+        }
+    }
+
+    Handle handle_;
+};
+
+namespace detail {
+
+template <typename T>
+inline Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+/**
+ * @brief 分离执行的协程外壳，执行结束后自行销毁
+ */
+struct DetachedTask {
+    struct promise_type {
+        static void* operator new(size_t size) { return allocateFrame(size); }
+        static void operator delete(void* ptr, size_t size) { deallocateFrame(ptr, size); }
+
+        DetachedTask get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept;
+    };
+};
+
+DetachedTask runDetached(Task<void> task);
+
+} // namespace detail
+
+/**
+ * @brief 启动一个顶层协程任务，不等待其结果
+ *
+ * 应在Reactor线程中调用，使协程帧从该线程的FramePool分配
+ */
+inline void spawn(Task<void> task) {
+    detail::runDetached(std::move(task));
+}
+
+} // namespace network
+} // namespace order_engine
@@ -34,7 +34,7 @@ public:
     virtual void removeChannel(Channel* channel) = 0;
 
 protected:
-    void fillActiveChannels(int num_events, ChannelList* active_channels) const;
+    virtual void fillActiveChannels(int num_events, ChannelList* active_channels) const;
     
     Reactor* reactor_;
     std::unordered_map<int, Channel*> channels_;
@@ -73,6 +73,7 @@ public:
     void removeChannel(Channel* channel) override;
 
 private:
+    void fillActiveChannels(int num_events, ChannelList* active_channels) const override;
     void update(int operation, Channel* channel);
     
     static const int kInitEventListSize = 16;
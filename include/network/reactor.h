@@ -7,8 +7,12 @@
 #include <mutex>
 #include <thread>
 #include <unordered_map>
+#include <chrono>
+#include <coroutine>
+#include <optional>
 #include "poller.h"
 #include "channel.h"
+#include "coroutine.h"
 
 namespace order_engine {
 namespace network {
@@ -20,11 +24,32 @@ namespace network {
  * - 事件注册和分发
  * - 定时器管理
  * - 任务队列
+ * - 协程挂起与恢复
  * - 优雅退出
  */
 class Reactor {
 public:
     using Task = std::function<void()>;
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Reactor::sleep返回的等待体
+     *
+     * 挂起点只记录协程句柄和到期时间，不分配std::function
+     */
+    class SleepAwaiter {
+    public:
+        SleepAwaiter(Reactor* reactor, Clock::time_point deadline)
+            : reactor_(reactor), deadline_(deadline) {}
+
+        bool await_ready() const noexcept { return deadline_ <= Clock::now(); }
+        void await_suspend(std::coroutine_handle<> handle) { reactor_->addSleeper(deadline_, handle); }
+        void await_resume() const noexcept {}
+
+    private:
+        Reactor* reactor_;
+        Clock::time_point deadline_;
+    };
 
     Reactor();
     ~Reactor();
@@ -46,8 +71,22 @@ public:
     void runAt(const Task& task, time_t when);
     void runAfter(const Task& task, double delay_seconds);
     void runEvery(const Task& task, double interval_seconds);
+    
+    // 协程支持（须在Reactor线程中co_await）
+    SleepAwaiter sleep(double delay_seconds);
+    FramePool& framePool() { return frame_pool_; }
 
 private:
+    struct Sleeper {
+        Clock::time_point deadline;
+        std::coroutine_handle<> handle;
+        bool operator>(const Sleeper& other) const { return deadline > other.deadline; }
+    };
+    
+    void addSleeper(Clock::time_point deadline, std::coroutine_handle<> handle);
+    void resumeExpiredSleepers();
+    int nextPollTimeout() const;
+
     void wakeup();
     void handleWakeup();
     void doPendingTasks();
@@ -67,11 +106,60 @@ private:
     int wakeup_fd_;
     std::unique_ptr<Channel> wakeup_channel_;
     
-    // 线程标识
-    std::thread::id thread_id_;
+    // 线程标识（loop()开始时绑定到事件循环线程）
+    std::atomic<std::thread::id> thread_id_;
+    
+    // 协程帧内存池与睡眠队列（最小堆，仅Reactor线程访问）
+    FramePool frame_pool_;
+    std::vector<Sleeper> sleepers_;
+    
+    static const int kMaxPollTimeoutMs = 1000;
 };
 
+/**
+ * @brief 回调式接口的等待体基类
+ *
+ * 派生类在start()中发起操作，完成时（任意线程，恰好一次）调用resolve()。
+ * 同步完成时不挂起；在其他线程完成时把恢复投递回发起时的Reactor，
+ * 协程总在自己的Reactor线程中继续执行。挂起点不分配std::function
+ */
+template <typename Result>
+class CallbackAwaiter {
+public:
+    explicit CallbackAwaiter(Reactor* reactor) : reactor_(reactor), completed_(false) {}
+    virtual ~CallbackAwaiter() = default;
+
+    CallbackAwaiter(const CallbackAwaiter&) = delete;
+    CallbackAwaiter& operator=(const CallbackAwaiter&) = delete;
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+        handle_ = handle;
+        start();
+        // 先到者只做标记，后到者负责继续：resolve已先到则不挂起
+        return !completed_.exchange(true, std::memory_order_acq_rel);
+    }
+
+    Result await_resume() { return std::move(*result_); }
 
+protected:
+    virtual void start() = 0;
+
+    void resolve(Result result) {
+        result_.emplace(std::move(result));
+        if (completed_.exchange(true, std::memory_order_acq_rel)) {
+            std::coroutine_handle<> handle = handle_;
+            reactor_->queueInLoop([handle]() { handle.resume(); });
+        }
+    }
+
+private:
+    Reactor* reactor_;
+    std::coroutine_handle<> handle_;
+    std::optional<Result> result_;
+    std::atomic<bool> completed_;
+};
 
 } // namespace network
 } // namespace order_engine
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace order_engine {
+namespace network {
+
+/**
+ * @brief 热重启时交接的文件描述符
+ */
+struct HandoffFds {
+    std::vector<int> listen_fds;      // 监听socket
+    std::vector<int> connection_fds;  // 空闲连接（可选）
+};
+
+/**
+ * @brief 监听socket热交接
+ *
+ * 通过本地Unix socket以SCM_RIGHTS在新旧进程间传递fd，流程：
+ * 1. 旧进程启动时调用startListening()在交接路径上等待
+ * 2. 新进程调用requestFrom()连接旧进程，收到监听fd和空闲连接fd
+ * 3. 新进程完成初始化后调用confirm()回复确认
+ * 4. 旧进程收到确认后停止accept和写入，关闭预写日志，releaseJournal()把
+ *    最后的LSN发给新进程，之后才排空存量连接（只应答查询）
+ * 5. 新进程waitJournalRelease()收到后才打开日志、恢复订单簿并开始服务
+ *
+ * 确认之前旧进程保持正常服务，新进程启动失败不会导致监听中断。
+ * 日志任何时刻只有一个进程写入，新进程的等待时间不受存量连接排空时长影响
+ */
+class SocketHandoff {
+public:
+    explicit SocketHandoff(const std::string& socket_path);
+    ~SocketHandoff();
+
+    SocketHandoff(const SocketHandoff&) = delete;
+    SocketHandoff& operator=(const SocketHandoff&) = delete;
+
+    // 旧进程：监听交接请求
+    bool startListening();
+    bool hasPendingRequest(int timeout_ms);
+    // 成功时保留与新进程的连接，用于之后交出日志
+    bool serve(const HandoffFds& fds, int ack_timeout_ms);
+    void stopListening();
+    // 日志关闭之后调用；没有已确认的新进程时返回false
+    bool releaseJournal(uint64_t last_lsn);
+
+    // 新进程：从旧进程接收fd并确认
+    bool requestFrom(HandoffFds& fds, int timeout_ms);
+    bool confirm();
+    // 等待旧进程交出日志；旧进程未交出就断开或超时返回false
+    bool waitJournalRelease(uint64_t& last_lsn, int timeout_ms);
+
+    void close();
+    const std::string& getSocketPath() const { return socket_path_; }
+
+private:
+    static bool sendFds(int sock, const HandoffFds& fds);
+    static bool recvFds(int sock, HandoffFds& fds);
+    static bool waitReadable(int fd, int timeout_ms);
+
+    // 协议头，紧跟在fd之前发送
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t listen_count;
+        uint32_t connection_count;
+    };
+
+    static const uint32_t kMagic = 0x4F454846;  // "OEHF"
+    static const uint32_t kVersion = 2;   // 2：确认后交出日志
+    static const char kJournalReleased = 'J';
+    static const size_t kMaxFdsPerMessage = 64;
+
+    std::string socket_path_;
+    int listen_fd_;   // 旧进程的Unix监听socket
+    int client_fd_;   // 旧进程：已确认的新进程连接
+    int peer_fd_;     // 新进程到旧进程的连接
+};
+
+} // namespace network
+} // namespace order_engine
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <any>
 #include <memory>
 #include <string>
 #include <functional>
 #include <atomic>
 #include <ctime>
+#include <coroutine>
 
 #ifdef _WIN32
 #include <winsock2.h>
@@ -17,6 +19,7 @@
 namespace order_engine {
 namespace network {
 
+class Reactor;
 class TcpConnection;
 using TcpConnectionPtr = std::shared_ptr<TcpConnection>;
 
@@ -28,6 +31,7 @@ using TcpConnectionPtr = std::shared_ptr<TcpConnection>;
  * - 缓冲区管理
  * - 连接状态跟踪
  * - 心跳检测
+ * - 协程式读写（read/write等待体）
  */
 class TcpConnection : public std::enable_shared_from_this<TcpConnection> {
 public:
@@ -40,6 +44,57 @@ public:
 
     using MessageCallback = std::function<void(const TcpConnectionPtr&, const std::string&)>;
     using CloseCallback = std::function<void(const TcpConnectionPtr&)>;
+    // 分帧回调：返回已消费的字节数，剩余的半帧保留在输入缓冲区
+    using BufferCallback = std::function<size_t(const TcpConnectionPtr&, const char*, size_t)>;
+
+    /**
+     * @brief 读等待体
+     *
+     * 输入缓冲区有数据时立即完成，否则挂起到下一次可读事件；
+     * 结果为拷贝到调用方缓冲区的字节数，连接关闭时为0
+     */
+    class ReadAwaiter {
+    public:
+        ReadAwaiter(TcpConnection* conn, char* buf, size_t len) : conn_(conn), buf_(buf), len_(len) {}
+
+        bool await_ready() const noexcept {
+            return !conn_->input_buffer_.empty() || conn_->state_ != kConnected;
+        }
+        void await_suspend(std::coroutine_handle<> handle) noexcept { conn_->read_waiter_ = handle; }
+        ssize_t await_resume() { return conn_->consumeInput(buf_, len_); }
+
+    private:
+        TcpConnection* conn_;
+        char* buf_;
+        size_t len_;
+    };
+
+    /**
+     * @brief 写等待体
+     *
+     * 数据可直接写入内核时立即完成，否则挂起直到输出缓冲区排空；
+     * 结果为写入字节数，出错或连接关闭时为-1
+     */
+    class WriteAwaiter {
+    public:
+        WriteAwaiter(TcpConnection* conn, const char* data, size_t len)
+            : conn_(conn), data_(data), len_(len), result_(0) {}
+
+        bool await_ready() {
+            result_ = conn_->send(data_, len_);
+            return result_ < 0 || conn_->output_buffer_.empty();
+        }
+        void await_suspend(std::coroutine_handle<> handle) noexcept { conn_->write_waiter_ = handle; }
+        ssize_t await_resume() const noexcept {
+            return (result_ >= 0 && conn_->state_ == kConnected) ? result_ : -1;
+        }
+
+    private:
+        TcpConnection* conn_;
+        const char* data_;
+        size_t len_;
+        ssize_t result_;
+    };
 
     TcpConnection(int sockfd, const struct sockaddr_in& peer_addr);
     ~TcpConnection();
@@ -47,6 +102,8 @@ public:
     // 连接管理
     void establishConnection();
     void closeConnection();
+    // 输出缓冲区发送完后关闭写端（对端读到EOF后关闭连接）
+    void shutdown();
     
     // 数据收发
     ssize_t send(const std::string& data);
@@ -54,6 +111,10 @@ public:
     void handleRead();
     void handleWrite();
     
+    // 协程读写（须在连接所属Reactor线程中co_await，调用方负责持有连接）
+    ReadAwaiter read(char* buf, size_t len) { return ReadAwaiter(this, buf, len); }
+    WriteAwaiter write(const char* data, size_t len) { return WriteAwaiter(this, data, len); }
+    
     // 状态查询
     bool isConnected() const { return state_ == kConnected; }
     State getState() const { return state_; }
@@ -62,22 +123,34 @@ public:
     
     // 回调设置
     void setMessageCallback(const MessageCallback& cb) { message_callback_ = cb; }
+    void setBufferCallback(const BufferCallback& cb) { buffer_callback_ = cb; }
     void setCloseCallback(const CloseCallback& cb) { close_callback_ = cb; }
     
+    // 上层协议的连接级状态（如HTTP解析进度），只在所属Reactor线程访问
+    void setContext(std::any context) { context_ = std::move(context); }
+    std::any& getContext() { return context_; }
+    
     // 心跳检测
     void updateLastActiveTime();
     bool isTimeout(int timeout_seconds) const;
     
     // Channel管理（简化处理）
     void setChannel(std::unique_ptr<class Channel> channel) { channel_ = std::move(channel); }
+    Reactor* ownerReactor() const;
+    
+    // 热重启交接：空闲时从Reactor摘下并返回dup后的fd，否则返回-1（须在所属Reactor线程调用）
+    int detachForHandoff();
 
 private:
     void setState(State state) { state_ = state; }
     void handleError();
+    size_t consumeInput(char* buf, size_t len);
+    void resumeWaiter(std::coroutine_handle<>& waiter);
     
     int sockfd_;
     struct sockaddr_in peer_addr_;
     State state_;
+    bool shutdown_pending_;
     
     // 缓冲区
     std::string input_buffer_;
@@ -85,11 +158,18 @@ private:
     
     // 回调函数
     MessageCallback message_callback_;
+    BufferCallback buffer_callback_;
     CloseCallback close_callback_;
     
+    std::any context_;
+    
     // 时间戳
     std::atomic<time_t> last_active_time_;
     
+    // 挂起中的协程
+    std::coroutine_handle<> read_waiter_;
+    std::coroutine_handle<> write_waiter_;
+    
     // Channel管理（简化处理）
     std::unique_ptr<class Channel> channel_;
     
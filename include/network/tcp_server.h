@@ -20,11 +20,13 @@ namespace network {
  * - 非阻塞I/O
  * - 连接池管理
  * - 负载均衡
+ * - 热重启（接管已打开的监听fd，排空后退出）
  */
 class TcpServer {
 public:
     using MessageCallback = std::function<void(const TcpConnectionPtr&, const std::string&)>;
     using ConnectionCallback = std::function<void(const TcpConnectionPtr&)>;
+    using BufferCallback = TcpConnection::BufferCallback;
 
     TcpServer(const std::string& ip, uint16_t port, int thread_num = 0);
     ~TcpServer();
@@ -32,10 +34,22 @@ public:
     // 启动和停止服务器
     bool start();
     void stop();
+    
+    // 热重启：start()之前接管旧进程交来的监听fd，跳过bind/listen
+    void adoptListenFd(int listen_fd);
+    // 热重启：start()之后接管旧进程交来的已建立连接
+    bool adoptConnection(int connfd);
+    int getListenFd() const { return listen_fd_; }
+    
+    // 热重启：摘下空闲连接（返回dup后的fd，原连接在本进程中关闭）
+    std::vector<int> detachIdleConnections(int idle_seconds);
+    // 停止accept并等待存量连接关闭，超时后强制停止
+    void drain(int timeout_seconds);
 
     // 设置回调函数
     void setMessageCallback(const MessageCallback& cb) { message_callback_ = cb; }
     void setConnectionCallback(const ConnectionCallback& cb) { connection_callback_ = cb; }
+    void setBufferCallback(const BufferCallback& cb) { buffer_callback_ = cb; }
 
     // 服务器状态
     bool isRunning() const { return running_.load(); }
@@ -45,6 +59,8 @@ public:
     void broadcast(const std::string& message);
 
 private:
+    bool createListenSocket();
+    void stopAccepting();
     void acceptConnection();
     void handleNewConnection(int connfd, const struct sockaddr_in& peer_addr);
     
@@ -63,6 +79,7 @@ private:
     
     // 回调函数
     MessageCallback message_callback_;
+    BufferCallback buffer_callback_;
     ConnectionCallback connection_callback_;
     
     // 连接管理
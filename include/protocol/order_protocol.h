@@ -0,0 +1,363 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "services/order_service.h"
+
+namespace order_engine {
+namespace protocol {
+
+static_assert(std::endian::native == std::endian::little,
+              "order protocol reads little-endian fields in place");
+
+/**
+ * @brief 订单二进制协议
+ *
+ * 定长帧头 + 定长消息体 + 变长尾部，全部字段小端、按自然边界对齐：
+ *
+ *     | magic u16 | version u8 | type u8 | length u32 | request_id u64 |
+ *     | crc32c u32 | flags u16 | reserved u16 | payload[length] ...   |
+ *
+ * 解码不拷贝：各View直接从连接缓冲区按偏移读取字段，
+ * 变长字符串以string_view返回，生命周期与缓冲区一致。
+ *
+ * 同一连接上的响应不保证按请求顺序返回：下单在落盘完成后才应答，
+ * 其后的查询等请求可能先得到响应，客户端按request_id匹配
+ */
+enum class MessageType : uint8_t {
+    kCreateOrderRequest = 1,
+    kCreateOrderResponse = 2,
+    kQueryOrderRequest = 3,
+    kQueryOrderResponse = 4,
+    kCancelOrderRequest = 5,
+    kCancelOrderResponse = 6,
+    kReserveStockRequest = 7,
+    kReserveStockResponse = 8,
+    kBatchCreateOrderRequest = 9,
+    kBatchCreateOrderResponse = 10,
+    kErrorResponse = 127
+};
+
+enum class DecodeStatus {
+    kOk,
+    kNeedMore,      // 数据不足一帧，等待更多数据
+    kBadMagic,
+    kBadVersion,
+    kTooLarge,
+    kBadChecksum,
+    kMalformed      // 消息体与声明的长度或条目数不符
+};
+
+enum class ResultCode : uint16_t {
+    kOk = 0,
+    kInvalidRequest = 1,
+    kNotFound = 2,
+    kInsufficientStock = 3,
+    kServiceUnavailable = 4,
+    kInternalError = 5
+};
+
+const uint16_t kProtocolMagic = 0x454F;  // "OE"
+const uint8_t kProtocolVersion = 1;
+const size_t kFrameHeaderSize = 24;
+const size_t kMaxPayloadSize = 1 << 20;
+const size_t kMaxItemsPerOrder = 1024;
+const size_t kMaxOrdersPerBatch = 1024;
+
+// 帧头flags
+const uint16_t kFlagProtobuf = 0x0001;  // 消息体为protobuf编码（见protocol/protobuf_codec.h）
+
+const char* decodeStatusToString(DecodeStatus status);
+
+namespace detail {
+
+template <typename T>
+inline T load(const char* p) {
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+} // namespace detail
+
+/**
+ * @brief 帧视图
+ */
+class FrameView {
+public:
+    FrameView() : data_(nullptr) {}
+    explicit FrameView(const char* data) : data_(data) {}
+
+    MessageType type() const { return static_cast<MessageType>(detail::load<uint8_t>(data_ + 3)); }
+    uint8_t version() const { return detail::load<uint8_t>(data_ + 2); }
+    uint32_t payloadSize() const { return detail::load<uint32_t>(data_ + 4); }
+    uint64_t requestId() const { return detail::load<uint64_t>(data_ + 8); }
+    uint32_t checksum() const { return detail::load<uint32_t>(data_ + 16); }
+    uint16_t flags() const { return detail::load<uint16_t>(data_ + 20); }
+
+    const char* payload() const { return data_ + kFrameHeaderSize; }
+    size_t frameSize() const { return kFrameHeaderSize + payloadSize(); }
+
+private:
+    const char* data_;
+};
+
+/**
+ * @brief 从缓冲区头部解出一帧
+ *
+ * 只做边界、版本和CRC校验，不解析消息体；
+ * 返回kOk时frame指向data内部，调用方消费frame.frameSize()字节
+ */
+DecodeStatus decodeFrame(const char* data, size_t len, FrameView& frame);
+
+/**
+ * @brief 订单明细视图（16字节：product_id u64, quantity u32, unit_price_cents u32）
+ */
+class LineItemView {
+public:
+    static const size_t kSize = 16;
+
+    explicit LineItemView(const char* data) : data_(data) {}
+
+    uint64_t productId() const { return detail::load<uint64_t>(data_); }
+    uint32_t quantity() const { return detail::load<uint32_t>(data_ + 8); }
+    uint32_t unitPriceCents() const { return detail::load<uint32_t>(data_ + 12); }
+
+private:
+    const char* data_;
+};
+
+/**
+ * @brief 创建订单请求
+ *
+ *     | user_id u64 | total_cents i64 | item_count u16 | address_len u16 |
+ *     | payment_len u8 | reserved[3] | items[item_count] | address | payment |
+ */
+class CreateOrderView {
+public:
+    static const size_t kFixedSize = 24;
+
+    static DecodeStatus parse(const FrameView& frame, CreateOrderView& view);
+
+    uint64_t userId() const { return detail::load<uint64_t>(data_); }
+    int64_t totalAmountCents() const { return detail::load<int64_t>(data_ + 8); }
+    uint16_t itemCount() const { return detail::load<uint16_t>(data_ + 16); }
+    LineItemView item(size_t i) const { return LineItemView(data_ + kFixedSize + i * LineItemView::kSize); }
+    std::string_view shippingAddress() const;
+    std::string_view paymentMethod() const;
+
+    // 兼容现有业务结构（此处才发生拷贝）
+    void toOrderInfo(services::OrderInfo& order) const;
+
+private:
+    friend class BatchCreateOrderView;
+
+    // 校验data处的一个订单体，成功时body_size为其实际长度
+    static DecodeStatus parseBody(const char* data, size_t available, CreateOrderView& view, size_t& body_size);
+
+    uint16_t addressLength() const { return detail::load<uint16_t>(data_ + 18); }
+    uint8_t paymentLength() const { return detail::load<uint8_t>(data_ + 20); }
+
+    const char* data_ = nullptr;
+};
+
+/**
+ * @brief 批量创建订单请求
+ *
+ *     | order_count u16 | reserved[6] | order[0] | order[1] | ... |
+ *
+ * 每个order与CreateOrderView的消息体格式相同、首尾相接。
+ * 订单体变长，按顺序遍历：
+ *
+ *     size_t offset = 0;
+ *     CreateOrderView order;
+ *     while (batch.next(offset, order)) { ... }
+ */
+class BatchCreateOrderView {
+public:
+    static const size_t kFixedSize = 8;
+
+    static DecodeStatus parse(const FrameView& frame, BatchCreateOrderView& view);
+
+    uint16_t orderCount() const { return detail::load<uint16_t>(data_); }
+    bool next(size_t& offset, CreateOrderView& order) const;
+
+    void toOrderInfos(std::vector<services::OrderInfo>& orders) const;
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief 查询订单请求：| order_id u64 |
+ */
+class QueryOrderView {
+public:
+    static const size_t kFixedSize = 8;
+
+    static DecodeStatus parse(const FrameView& frame, QueryOrderView& view);
+
+    uint64_t orderId() const { return detail::load<uint64_t>(data_); }
+
+private:
+    const char* data_ = nullptr;
+};
+
+/**
+ * @brief 取消订单请求：| order_id u64 | reason_len u16 | reserved[6] | reason |
+ */
+class CancelOrderView {
+public:
+    static const size_t kFixedSize = 16;
+
+    static DecodeStatus parse(const FrameView& frame, CancelOrderView& view);
+
+    uint64_t orderId() const { return detail::load<uint64_t>(data_); }
+    std::string_view reason() const {
+        return std::string_view(data_ + kFixedSize, detail::load<uint16_t>(data_ + 8));
+    }
+
+private:
+    const char* data_ = nullptr;
+};
+
+/**
+ * @brief 库存预留请求
+ *
+ *     | order_id u64 | timeout_seconds u32 | item_count u16 | reserved u16 | items[item_count] |
+ */
+class ReserveStockView {
+public:
+    static const size_t kFixedSize = 16;
+
+    static DecodeStatus parse(const FrameView& frame, ReserveStockView& view);
+
+    uint64_t orderId() const { return detail::load<uint64_t>(data_); }
+    uint32_t timeoutSeconds() const { return detail::load<uint32_t>(data_ + 8); }
+    uint16_t itemCount() const { return detail::load<uint16_t>(data_ + 12); }
+    LineItemView item(size_t i) const { return LineItemView(data_ + kFixedSize + i * LineItemView::kSize); }
+
+private:
+    const char* data_ = nullptr;
+};
+
+/**
+ * @brief 订单快照（查询响应的消息体）
+ *
+ *     | order_id u64 | user_id u64 | total_cents i64 | created_at i64 | updated_at i64 |
+ *     | result u16 | status u8 | payment_len u8 | item_count u16 | address_len u16 |
+ *     | items[item_count] | address | payment |
+ */
+class OrderRecordView {
+public:
+    static const size_t kFixedSize = 48;
+
+    static DecodeStatus parse(const FrameView& frame, OrderRecordView& view);
+
+    uint64_t orderId() const { return detail::load<uint64_t>(data_); }
+    uint64_t userId() const { return detail::load<uint64_t>(data_ + 8); }
+    int64_t totalAmountCents() const { return detail::load<int64_t>(data_ + 16); }
+    int64_t createdAt() const { return detail::load<int64_t>(data_ + 24); }
+    int64_t updatedAt() const { return detail::load<int64_t>(data_ + 32); }
+    ResultCode result() const { return static_cast<ResultCode>(detail::load<uint16_t>(data_ + 40)); }
+    services::OrderStatus status() const {
+        return static_cast<services::OrderStatus>(detail::load<uint8_t>(data_ + 42));
+    }
+    uint16_t itemCount() const { return detail::load<uint16_t>(data_ + 44); }
+    LineItemView item(size_t i) const { return LineItemView(data_ + kFixedSize + i * LineItemView::kSize); }
+    std::string_view shippingAddress() const;
+    std::string_view paymentMethod() const;
+
+    void toOrderInfo(services::OrderInfo& order) const;
+
+private:
+    uint8_t paymentLength() const { return detail::load<uint8_t>(data_ + 43); }
+    uint16_t addressLength() const { return detail::load<uint16_t>(data_ + 46); }
+
+    const char* data_ = nullptr;
+};
+
+/**
+ * @brief 通用结果响应（创建/取消/预留/错误）
+ *
+ *     | order_id u64 | result u16 | message_len u16 | reserved u32 | message |
+ */
+class ResultView {
+public:
+    static const size_t kFixedSize = 16;
+
+    static DecodeStatus parse(const FrameView& frame, ResultView& view);
+
+    uint64_t orderId() const { return detail::load<uint64_t>(data_); }
+    ResultCode result() const { return static_cast<ResultCode>(detail::load<uint16_t>(data_ + 8)); }
+    std::string_view message() const {
+        return std::string_view(data_ + kFixedSize, detail::load<uint16_t>(data_ + 10));
+    }
+
+private:
+    const char* data_ = nullptr;
+};
+
+/**
+ * @brief 批量创建订单响应，结果与请求中的订单一一对应
+ *
+ *     | order_count u16 | reserved[6] | { order_id u64, result u16, reserved[6] }[order_count] |
+ */
+class BatchResultView {
+public:
+    static const size_t kFixedSize = 8;
+    static const size_t kEntrySize = 16;
+
+    static DecodeStatus parse(const FrameView& frame, BatchResultView& view);
+
+    uint16_t orderCount() const { return detail::load<uint16_t>(data_); }
+    uint64_t orderId(size_t i) const { return detail::load<uint64_t>(data_ + kFixedSize + i * kEntrySize); }
+    ResultCode result(size_t i) const {
+        return static_cast<ResultCode>(detail::load<uint16_t>(data_ + kFixedSize + i * kEntrySize + 8));
+    }
+
+private:
+    const char* data_ = nullptr;
+};
+
+/**
+ * @brief 帧编码原语
+ *
+ * beginFrame写入帧头占位并返回帧起始偏移；调用方追加消息体后
+ * 由endFrame回填长度和CRC
+ */
+size_t beginFrame(std::string& out, MessageType type, uint64_t request_id, uint16_t flags = 0);
+void endFrame(std::string& out, size_t start);
+
+/**
+ * 编码：直接追加到输出缓冲区，帧头的长度和CRC在消息体写完后回填
+ *
+ * 携带订单/商品的编码函数不截断：商品为空或超过kMaxItemsPerOrder、商品与数量
+ * 条数不一致、地址/支付方式超长、批量订单数为0或超过kMaxOrdersPerBatch、
+ * 消息体超过kMaxPayloadSize时返回false，out保持不变
+ */
+bool encodeCreateOrderRequest(std::string& out, uint64_t request_id, const services::OrderInfo& order);
+bool encodeBatchCreateOrderRequest(std::string& out, uint64_t request_id,
+                                   const std::vector<services::OrderInfo>& orders);
+void encodeBatchCreateOrderResponse(std::string& out, uint64_t request_id,
+                                    const std::vector<services::OrderResult>& results);
+void encodeQueryOrderRequest(std::string& out, uint64_t request_id, uint64_t order_id);
+void encodeCancelOrderRequest(std::string& out, uint64_t request_id, uint64_t order_id,
+                              std::string_view reason);
+bool encodeReserveStockRequest(std::string& out, uint64_t request_id, uint64_t order_id,
+                               const std::vector<uint64_t>& product_ids,
+                               const std::vector<uint32_t>& quantities,
+                               uint32_t timeout_seconds);
+bool encodeOrderRecord(std::string& out, uint64_t request_id, ResultCode result,
+                       const services::OrderInfo& order);
+void encodeResult(std::string& out, MessageType type, uint64_t request_id, uint64_t order_id,
+                  ResultCode result, std::string_view message);
+
+} // namespace protocol
+} // namespace order_engine
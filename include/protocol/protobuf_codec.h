@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/message_lite.h>
+#include "protocol/order_protocol.h"
+
+namespace order_engine {
+namespace proto {
+class CreateOrderRequest;
+class OrderRecord;
+} // namespace proto
+
+namespace protocol {
+
+/**
+ * @brief 基于Arena的Protobuf编解码适配器
+ *
+ * 复用二进制协议的帧头（flags带kFlagProtobuf），消息体为protobuf编码：
+ * - 解码：直接从连接缓冲区解析到arena上的消息对象
+ * - 编码：按ByteSize预留空间，直接序列化到输出缓冲区
+ *
+ * arena以自有内存块作为初始块，reset()后整块复用；某个请求超出
+ * 初始块时，下次reset会按峰值扩大初始块，稳态下每个请求零分配。
+ * 注意：当前protobuf版本中string字段的std::string对象在arena上，
+ * 但超过SSO长度的内容仍走堆分配。
+ * 非线程安全，每个Reactor线程持有一个实例
+ */
+class ProtobufCodec {
+public:
+    static const size_t kDefaultBlockSize = 16 * 1024;
+    static const size_t kMaxBlockSize = 4 * 1024 * 1024;
+
+    explicit ProtobufCodec(size_t initial_block_size = kDefaultBlockSize);
+    ~ProtobufCodec();
+
+    ProtobufCodec(const ProtobufCodec&) = delete;
+    ProtobufCodec& operator=(const ProtobufCodec&) = delete;
+
+    // 在arena上创建消息（用于构造响应）
+    template <typename Message>
+    Message* create() {
+        return google::protobuf::Arena::CreateMessage<Message>(&*arena_);
+    }
+
+    /**
+     * @brief 把帧的消息体解析到arena消息，失败返回nullptr
+     *
+     * 消息对象生命周期到下一次reset()为止
+     */
+    template <typename Message>
+    Message* parse(const FrameView& frame) {
+        if (!(frame.flags() & kFlagProtobuf)) {
+            return nullptr;
+        }
+        Message* message = create<Message>();
+        if (!message->ParseFromArray(frame.payload(), static_cast<int>(frame.payloadSize()))) {
+            return nullptr;
+        }
+        return message;
+    }
+
+    // 把消息编码为一帧追加到out
+    void serialize(std::string& out, MessageType type, uint64_t request_id,
+                   const google::protobuf::MessageLite& message);
+
+    // 一次请求/响应结束后调用，释放本次请求的所有消息
+    void reset();
+
+    // 统计信息
+    size_t getBlockSize() const { return block_size_; }
+    uint64_t getGrowCount() const { return grow_count_; }
+    uint64_t getResetCount() const { return reset_count_; }
+
+private:
+    void rebuildArena(size_t block_size);
+
+    std::unique_ptr<char[]> block_;
+    size_t block_size_;
+    std::optional<google::protobuf::Arena> arena_;
+    uint64_t grow_count_;
+    uint64_t reset_count_;
+};
+
+// protobuf消息与业务订单结构互转，TCP protobuf帧与gRPC接口共用
+void toOrderInfo(const proto::CreateOrderRequest& request, services::OrderInfo& order);
+void fromOrderInfo(const services::OrderInfo& order, proto::OrderRecord& record);
+
+} // namespace protocol
+} // namespace order_engine
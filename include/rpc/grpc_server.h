@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <grpcpp/generic/async_generic_service.h>
+#include <grpcpp/server.h>
+#include "services/order_service.h"
+#include "services/inventory_service.h"
+
+namespace order_engine {
+namespace rpc {
+
+/**
+ * @brief 异步gRPC服务器
+ *
+ * 面向内部调用方的订单/库存接口（proto/order.proto中的OrderService）：
+ * - 每个CPU核心一个完成队列和一个轮询线程，不使用同步的每RPC一线程模型
+ * - 通过AsyncGenericService按方法名分发，请求/响应消息分配在每个调用的arena上
+ * - 业务处理进入与TCP协议相同的OrderService/InventoryService接口，
+ *   业务回调完成时直接发出响应
+ *
+ * 业务服务为空时对应RPC返回UNAVAILABLE
+ */
+class GrpcServer {
+public:
+    GrpcServer(const std::string& ip, int port, int queue_num,
+               std::shared_ptr<services::OrderService> order_service,
+               std::shared_ptr<services::InventoryService> inventory_service);
+    ~GrpcServer();
+
+    GrpcServer(const GrpcServer&) = delete;
+    GrpcServer& operator=(const GrpcServer&) = delete;
+
+    // 启动和停止
+    bool start();
+    void stop();
+
+    // 实际监听端口（配置端口为0时由系统分配）
+    int getPort() const { return selected_port_; }
+    size_t getQueueCount() const { return queues_.size(); }
+    uint64_t getHandledCount() const { return handled_count_.load(); }
+
+private:
+    class Call;
+
+    // 投递一个待接收的调用；服务器关闭后不再投递
+    void postCall(grpc::ServerCompletionQueue* cq);
+    void pollQueue(grpc::ServerCompletionQueue* cq);
+
+    std::string ip_;
+    int port_;
+    int queue_num_;
+    int selected_port_;
+
+    std::shared_ptr<services::OrderService> order_service_;
+    std::shared_ptr<services::InventoryService> inventory_service_;
+
+    grpc::AsyncGenericService generic_service_;
+    std::unique_ptr<grpc::Server> server_;
+    std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::mutex shutdown_mutex_;
+    bool shutdown_;
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> handled_count_;
+
+    // 每个队列预先投递的待接收调用数
+    static const int kPendingCallsPerQueue = 8;
+};
+
+} // namespace rpc
+} // namespace order_engine
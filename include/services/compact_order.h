@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include "services/order_service.h"
+#include "utils/inline_vector.h"
+#include "utils/string_arena.h"
+
+namespace order_engine {
+namespace services {
+
+/**
+ * @brief 订单行（16字节）
+ */
+struct LineItem {
+    uint64_t product_id;
+    uint32_t quantity;
+    uint32_t price_cents;   // 单价（分），旧格式OrderInfo中没有时为0
+};
+
+/**
+ * @brief 支付方式
+ *
+ * 常用取值固定编码；其余字符串在首次出现时登记到进程级表中，
+ * 编码从kFirstInterned开始，最多255种
+ */
+enum class PaymentMethod : uint8_t {
+    UNKNOWN = 0,
+    ALIPAY = 1,
+    WECHAT = 2,
+    CREDIT_CARD = 3,
+    BANK_TRANSFER = 4,
+    CASH_ON_DELIVERY = 5,
+    kFirstInterned = 16
+};
+
+// 字符串 -> 编码，表满时返回UNKNOWN
+uint8_t internPaymentMethod(std::string_view name);
+std::string_view paymentMethodName(uint8_t code);
+
+/**
+ * @brief 紧凑订单表示
+ *
+ * 前kInlineItems个订单行内联存放，支付方式为1字节编码，收货地址和
+ * 预留ID放在所属分片的StringArena中。常见订单（不超过4个商品）
+ * 不产生任何单独的堆分配
+ */
+struct CompactOrder {
+    static constexpr size_t kInlineItems = 4;
+
+    uint64_t order_id;
+    uint64_t user_id;
+    double total_amount;
+    uint32_t created_at;
+    uint32_t updated_at;
+    OrderStatus status;
+    uint8_t payment_method;
+    std::string_view shipping_address;   // 指向StringArena
+    utils::InlineVector<LineItem, kInlineItems> items;
+
+    // 字符串字段拷贝到arena中
+    static CompactOrder fromOrderInfo(const OrderInfo& order, utils::StringArena& arena);
+    void toOrderInfo(OrderInfo& order) const;
+};
+
+} // namespace services
+} // namespace order_engine
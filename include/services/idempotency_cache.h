@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace order_engine {
+namespace services {
+
+/**
+ * @brief 幂等键去重配置
+ */
+struct IdempotencyOptions {
+    size_t capacity = 1000000;   // 最多保留的键数（所有分片合计）
+    int ttl_seconds = 86400;     // 键的有效期
+    size_t shards = 16;
+};
+
+/**
+ * @brief 幂等键去重表统计（任意线程可读）
+ */
+struct IdempotencyStats {
+    size_t keys;
+    size_t memory_bytes;   // 估算值：哈希表节点、桶数组及过期队列
+    uint64_t hits;         // 返回了已完成请求的结果
+    uint64_t in_progress;  // 首个请求仍在执行时到达、挂到首个请求上的重试
+    uint64_t evicted;      // 因容量上限被淘汰的键
+};
+
+/**
+ * @brief 创建订单的幂等键去重表
+ *
+ * 键为(user_id, 幂等键)的64位哈希，只保存订单ID、过期时间和状态
+ * （每个键约60字节），不保存请求和应答本身。按键哈希分片，每个分片一把锁。
+ *
+ * 同一个键的请求：
+ * - 首个请求得到kNew，执行后调用complete()；
+ * - 执行期间到达的重试得到kInProgress，传入的waiter挂在该键上，
+ *   首个请求complete()时在其线程上依次调用，不占用等待线程；
+ * - 完成之后到达的重试得到kDone和原订单ID。
+ *
+ * 只记住成功的结果：失败的请求已整体回滚，complete(false)删除键并以
+ * 失败调用挂起的waiter，之后的重试重新执行。所有分片的TTL相同，插入顺序即过期顺序，
+ * 过期从每个分片的FIFO队头进行；超出容量时跳过进行中的键，
+ * 淘汰最早的已完成键
+ */
+class IdempotencyCache {
+public:
+    enum class BeginResult { kNew, kInProgress, kDone };
+    // 首个请求完成时回调挂起的重试：成功时order_id为原订单ID
+    using Waiter = std::function<void(bool success, uint64_t order_id)>;
+
+    explicit IdempotencyCache(IdempotencyOptions options = IdempotencyOptions());
+
+    IdempotencyCache(const IdempotencyCache&) = delete;
+    IdempotencyCache& operator=(const IdempotencyCache&) = delete;
+
+    static uint64_t makeKey(uint64_t user_id, std::string_view idempotency_key);
+
+    // 登记一次请求，kDone时order_id为原订单ID；kInProgress时waiter挂到首个请求上
+    BeginResult begin(uint64_t key, time_t now, uint64_t& order_id, Waiter waiter = Waiter());
+
+    // 首个请求完成：成功时记住订单ID，失败时删除键；在锁外调用挂起的waiter
+    void complete(uint64_t key, bool success, uint64_t order_id, time_t now);
+
+    IdempotencyStats stats() const;
+    const IdempotencyOptions& options() const { return options_; }
+
+private:
+    enum class State : uint8_t { kInFlight = 0, kDone = 1 };
+
+    struct Entry {
+        uint64_t order_id;
+        uint32_t expires_at;
+        State state;
+    };
+
+    struct Expiry {
+        uint64_t key;
+        uint32_t expires_at;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<uint64_t, Entry> entries;
+        std::deque<Expiry> fifo;
+        // 进行中的键上挂起的重试，只有并发重试时才有
+        std::unordered_map<uint64_t, std::vector<Waiter>> waiters;
+    };
+
+    Shard& shardFor(uint64_t key) { return *shards_[key % shards_.size()]; }
+    // 删除已过期或超出容量的键（持有分片锁），过期的进行中键上的waiter移入orphaned
+    void trim(Shard& shard, uint32_t now, std::vector<Waiter>& orphaned);
+
+    IdempotencyOptions options_;
+    size_t shard_capacity_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> in_progress_;
+    std::atomic<uint64_t> evicted_;
+};
+
+} // namespace services
+} // namespace order_engine
@@ -6,25 +6,20 @@
 #include <unordered_map>
 #include <mutex>
 #include <atomic>
+#include <thread>
+#include <functional>
+#include "services/inventory_table.h"
+#include "network/reactor.h"
 // TODO: 待实现的头文件
 // #include "../database/connection_pool.h"
 // #include "../cache/cache_manager.h"
 
 namespace order_engine {
-namespace services {
+namespace utils {
+class TimingWheel;
+}
 
-/**
- * @brief 库存信息结构
- */
-struct InventoryInfo {
-    uint64_t product_id;
-    uint32_t total_stock;      // 总库存
-    uint32_t available_stock;  // 可用库存
-    uint32_t reserved_stock;   // 预留库存
-    uint32_t sold_stock;       // 已售库存
-    time_t updated_at;
-    uint32_t version;          // 乐观锁版本号
-};
+namespace services {
 
 /**
  * @brief 库存预留信息
@@ -34,10 +29,29 @@ struct ReservationInfo {
     uint64_t product_id;
     uint32_t quantity;
     time_t reserved_at;
-    time_t expires_at;
+    time_t expires_at;      // 0表示不过期
     std::string order_id;
 };
 
+/**
+ * @brief 批量预留中的单个请求（通常对应一个订单）
+ *
+ * 只引用调用方的商品数组，不拷贝
+ */
+struct StockRequest {
+    const std::vector<uint64_t>* product_ids;
+    const std::vector<uint32_t>* quantities;
+    std::string order_id;
+};
+
+/**
+ * @brief 协程接口的预留结果：成功时message为预留ID
+ */
+struct StockOutcome {
+    bool success;
+    std::string message;
+};
+
 /**
  * @brief 库存服务
  * 
@@ -53,9 +67,12 @@ public:
     using InventoryCallback = std::function<void(bool success, const std::string& message)>;
     using QueryCallback = std::function<void(bool success, const InventoryInfo& info)>;
 
-    // 临时构造函数，后续会替换为完整版本
+    static constexpr size_t kDefaultTableCapacity = 131072;
+
+    // 临时构造函数，后续会替换为完整版本；table_capacity为内存库存表最多容纳的商品数
     InventoryService(std::shared_ptr<void> db_pool = nullptr,
-                     std::shared_ptr<void> cache_manager = nullptr);
+                     std::shared_ptr<void> cache_manager = nullptr,
+                     size_t table_capacity = kDefaultTableCapacity);
     
     ~InventoryService();
 
@@ -73,13 +90,37 @@ public:
     bool batchCheckStock(const std::vector<uint64_t>& product_ids, 
                         const std::vector<uint32_t>& quantities);
     
-    // 库存预留
+    // 预留不过期，直到调用方确认或释放（由订单超时取消兜底）
+    static constexpr int kNoExpiry = -1;
+
+    // 库存预留：timeout_seconds为0时用默认期限，kNoExpiry表示不过期
     void reserveStock(const std::vector<uint64_t>& product_ids,
                      const std::vector<uint32_t>& quantities,
                      const std::string& order_id,
                      int timeout_seconds,
                      const InventoryCallback& callback);
     
+    class ReserveStockAwaiter;
+    /**
+     * @brief 协程入口：在reactor线程中co_await，预留完成后在该线程继续
+     *
+     *     StockOutcome outcome = co_await inventory.awaitReserveStock(reactor, ids, quantities, order_id, 60);
+     */
+    ReserveStockAwaiter awaitReserveStock(network::Reactor& reactor, std::vector<uint64_t> product_ids,
+                                          std::vector<uint32_t> quantities, std::string order_id,
+                                          int timeout_seconds);
+
+    /**
+     * @brief 批量预留
+     *
+     * 按顺序逐个处理，每个请求的商品整体成功或失败，
+     * 前面请求的预留会计入后面请求可用的库存。
+     * reservation_ids与requests一一对应，预留失败的位置为空串
+     */
+    void batchReserveStock(const std::vector<StockRequest>& requests,
+                           int timeout_seconds,
+                           std::vector<std::string>& reservation_ids);
+    
     // 库存确认扣减
     void confirmReservation(const std::string& reservation_id,
                            const InventoryCallback& callback);
@@ -96,6 +137,30 @@ public:
     void syncInventoryFromDB(uint64_t product_id);
     void syncAllInventoryFromDB();
 
+    /**
+     * @brief 热点商品（秒杀）模式：可用库存拆到每核一个的子桶，各核本地扣减
+     *
+     * 手动启用（管理接口）或同一商品每秒CAS失败达到阈值时自动启用，0表示
+     * 不自动启用。商品不存在时返回false
+     */
+    bool enableHotStock(uint64_t product_id);
+    bool isHotStock(uint64_t product_id) const { return inventory_.isHot(product_id); }
+    void setHotStockThreshold(uint32_t failures_per_second) { inventory_.setHotThreshold(failures_per_second); }
+    size_t getHotStockCount() const { return inventory_.hotCount(); }
+    uint64_t getHotStockRebalances() const { return inventory_.hotRebalances(); }
+
+    /**
+     * @brief 释放到now为止超时未确认的预留，返回释放的预留数；清理线程每秒调用一次
+     *
+     * 超时期限保存在每个预留分片的时间轮中，只处理到期的预留，不扫描预留表
+     */
+    size_t expireReservations(time_t now);
+
+    // 统计信息
+    uint64_t getTotalReservations() const { return total_reservations_.load(); }
+    uint64_t getSuccessfulReservations() const { return successful_reservations_.load(); }
+    uint64_t getFailedReservations() const { return failed_reservations_.load(); }
+
 private:
     // 内部方法
     bool getInventoryFromCache(uint64_t product_id, InventoryInfo& info);
@@ -109,12 +174,20 @@ private:
     bool acquireDistributedLock(uint64_t product_id, int timeout_ms);
     void releaseDistributedLock(uint64_t product_id);
     
-    // 预留管理
-    std::string generateReservationId();
-    void saveReservation(const ReservationInfo& reservation);
-    bool getReservation(const std::string& reservation_id, ReservationInfo& reservation);
-    void removeReservation(const std::string& reservation_id);
-    void cleanupExpiredReservations();
+    // 预留管理：一个预留ID对应一个订单的全部商品；seq为ID中的序号，用于分片
+    std::string generateReservationId(time_t now, uint64_t& seq);
+    /**
+     * @brief 逐个商品CAS预留，某个商品不足时退回已预留的商品
+     *
+     * 不加锁：退回前已预留的数量对并发请求短暂不可用，可能使其失败，但不会超卖
+     */
+    bool tryReserve(const std::vector<uint64_t>& product_ids,
+                    const std::vector<uint32_t>& quantities,
+                    const std::string& order_id,
+                    int timeout_seconds,
+                    std::string& reservation_id);
+    void saveReservation(uint64_t seq, std::vector<ReservationInfo> items);
+    bool takeReservation(const std::string& reservation_id, std::vector<ReservationInfo>& items);
     
     // CAS操作
     bool compareAndSwapStock(uint64_t product_id, uint32_t expected_available, 
@@ -124,9 +197,28 @@ private:
     std::shared_ptr<void> db_pool_;
     std::shared_ptr<void> cache_manager_;
     
+    // 内存库存表（Phase 1: 数据库接入前作为权威数据）
+    InventoryTable inventory_;
+    
+    /**
+     * @brief 预留表的一个分片
+     *
+     * 库存扣减本身是库存表上的CAS，预留记录仍需加锁：按预留序号分片，
+     * 每个分片一把锁，并发预留/确认/释放只在同一分片上竞争。
+     * 超时期限放在分片的时间轮中（惰性删除：已确认或释放的预留到期时查不到）
+     */
+    struct ReservationShard {
+        std::mutex mutex;
+        std::unordered_map<uint64_t, std::vector<ReservationInfo>> reservations;  // 键为预留序号
+        std::unique_ptr<utils::TimingWheel> wheel;
+    };
+    static constexpr size_t kReservationShards = 16;
+
+    ReservationShard& reservationShard(uint64_t seq) { return *reservation_shards_[seq % kReservationShards]; }
+
     // 预留信息缓存
-    std::unordered_map<std::string, ReservationInfo> reservations_;
-    std::mutex reservations_mutex_;
+    std::vector<std::unique_ptr<ReservationShard>> reservation_shards_;
+    std::atomic<uint64_t> reservation_seq_;
     
     // 定时清理线程
     std::thread cleanup_thread_;
@@ -144,5 +236,39 @@ private:
     static const int kReservationExpireTime;
 };
 
+class InventoryService::ReserveStockAwaiter : public network::CallbackAwaiter<StockOutcome> {
+public:
+    ReserveStockAwaiter(InventoryService* service, network::Reactor& reactor, std::vector<uint64_t> product_ids,
+                        std::vector<uint32_t> quantities, std::string order_id, int timeout_seconds)
+        : CallbackAwaiter(&reactor)
+        , service_(service)
+        , product_ids_(std::move(product_ids))
+        , quantities_(std::move(quantities))
+        , order_id_(std::move(order_id))
+        , timeout_seconds_(timeout_seconds) {}
+
+protected:
+    void start() override {
+        service_->reserveStock(product_ids_, quantities_, order_id_, timeout_seconds_,
+                               [this](bool success, const std::string& message) {
+                                   resolve(StockOutcome{success, message});
+                               });
+    }
+
+private:
+    InventoryService* service_;
+    std::vector<uint64_t> product_ids_;
+    std::vector<uint32_t> quantities_;
+    std::string order_id_;
+    int timeout_seconds_;
+};
+
+inline InventoryService::ReserveStockAwaiter InventoryService::awaitReserveStock(
+        network::Reactor& reactor, std::vector<uint64_t> product_ids, std::vector<uint32_t> quantities,
+        std::string order_id, int timeout_seconds) {
+    return ReserveStockAwaiter(this, reactor, std::move(product_ids), std::move(quantities), std::move(order_id),
+                               timeout_seconds);
+}
+
 } // namespace services
 } // namespace order_engine
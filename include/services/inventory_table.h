@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace order_engine {
+namespace services {
+
+/**
+ * @brief 库存信息结构
+ */
+struct InventoryInfo {
+    uint64_t product_id;
+    uint32_t total_stock;      // 总库存
+    uint32_t available_stock;  // 可用库存
+    uint32_t reserved_stock;   // 预留库存
+    uint32_t sold_stock;       // 已售库存
+    time_t updated_at;
+    uint32_t version;          // 乐观锁版本号
+};
+
+/**
+ * @brief 内存库存表（开放寻址，线性探测）
+ *
+ * 每个商品独占一个缓存行大小的槽，可用/预留/版本号打包在同一个64位字中
+ * （各24/24/16位），检查和预留只读或CAS这一个字，不加锁，不同商品之间
+ * 也没有伪共享。总库存和已售数是统计值，在CAS成功后单独累加。
+ *
+ * 槽数在构造时确定：容纳capacity个商品时装载率不超过3/4，向上取2的幂。
+ * 商品只增不删，装满capacity后不再插入新商品。product_id为0保留为空槽标记
+ *
+ * 热点商品（秒杀）的所有预留都落在同一个字上，CAS失败重试成为瓶颈。
+ * 热点模式把可用库存拆到每线程一个的子桶中，各线程只扣本地桶；本地桶
+ * 不足时加该商品的锁，收回所有桶的库存后重新平均分配，收回后合计仍不足
+ * 才判定库存不足，不会因库存分散在其他桶而误判售罄。退回和确认同样
+ * 加该商品的锁，按所有桶的预留合计截断（成功的预留数不超过库存，这把锁
+ * 不在抢购失败的热路径上）。每秒CAS失败次数
+ * 达到阈值时自动启用，也可手动启用；启用后不再退出
+ */
+class InventoryTable {
+public:
+    // 单个商品可用与预留之和的上限
+    static constexpr uint32_t kMaxStock = (1u << 24) - 1;
+
+    // hot_buckets为热点商品的子桶数，0表示每个CPU核心一个
+    explicit InventoryTable(size_t capacity, size_t hot_buckets = 0);
+
+    bool get(uint64_t product_id, InventoryInfo& info) const;
+    // 商品存在且可用库存不少于quantity
+    bool hasAvailable(uint64_t product_id, uint64_t quantity) const;
+
+    // 可用库存不足或商品不存在时返回false，不做任何修改
+    bool reserve(uint64_t product_id, uint32_t quantity);
+    // 预留退回可用，最多退回当前预留数
+    void release(uint64_t product_id, uint32_t quantity);
+    // 预留转为已售，最多转移当前预留数
+    void commit(uint64_t product_id, uint32_t quantity);
+
+    /**
+     * @brief 补充库存，商品不存在时插入
+     *
+     * 超过kMaxStock或表已满时返回false。info非空时返回补充后的状态
+     */
+    bool add(uint64_t product_id, uint32_t quantity, InventoryInfo* info = nullptr);
+
+    // 乐观锁：可用库存和版本号（低16位）都与期望值相同时才更新；热点商品不支持，返回false
+    bool compareAndSwap(uint64_t product_id, uint32_t expected_available,
+                        uint32_t new_available, uint32_t expected_version);
+
+    // 商品不存在时返回false，已是热点时返回true
+    bool enableHot(uint64_t product_id);
+    bool isHot(uint64_t product_id) const;
+    // 同一商品每秒CAS失败达到该次数时自动启用热点模式，0表示不自动启用
+    void setHotThreshold(uint32_t failures_per_second) {
+        hot_threshold_.store(failures_per_second, std::memory_order_relaxed);
+    }
+    // 记入商品在now所在秒内的CAS失败次数，达到阈值时启用热点模式（reserve内部调用）
+    void noteContention(uint64_t product_id, uint32_t failures, time_t now);
+    size_t hotCount() const;
+    // 所有热点商品本地桶不足、收回重分配的累计次数
+    uint64_t hotRebalances() const { return hot_rebalances_.load(std::memory_order_relaxed); }
+
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+    size_t capacity() const { return capacity_; }
+
+private:
+    // 预留和已售是相对值：退回、确认可能落在与预留时不同的桶，只有合计有意义
+    struct alignas(64) HotBucket {
+        std::atomic<uint64_t> available{0};
+        std::atomic<int64_t> reserved{0};
+        std::atomic<int64_t> sold{0};
+    };
+
+    struct HotStock {
+        explicit HotStock(size_t count) : bucket_count(count), buckets(new HotBucket[count]) {}
+
+        size_t bucket_count;
+        std::unique_ptr<HotBucket[]> buckets;
+        std::mutex rebalance_mutex;   // 跨桶搬移库存只在持有该锁时进行
+        std::atomic<uint64_t> moves{0};   // 搬移开始和结束各加一，奇数表示正在搬移
+    };
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> product_id{0};
+        std::atomic<uint64_t> state{0};   // available | reserved << 24 | version << 48
+        std::atomic<uint32_t> total{0};
+        std::atomic<uint32_t> sold{0};
+        std::atomic<int64_t> updated_at{0};
+        std::atomic<HotStock*> hot{nullptr};
+        std::atomic<uint32_t> contention{0};          // 本秒内的CAS失败次数
+        std::atomic<uint32_t> contention_second{0};
+    };
+
+    static constexpr uint64_t kFieldMask = kMaxStock;
+    static constexpr uint64_t kVersionMask = 0xffff;
+
+    static uint32_t availableOf(uint64_t state) { return static_cast<uint32_t>(state & kFieldMask); }
+    static uint32_t reservedOf(uint64_t state) { return static_cast<uint32_t>((state >> 24) & kFieldMask); }
+    static uint32_t versionOf(uint64_t state) { return static_cast<uint32_t>(state >> 48); }
+    // 版本号加一（回绕）
+    static uint64_t pack(uint32_t available, uint32_t reserved, uint64_t state) {
+        return available | static_cast<uint64_t>(reserved) << 24 | ((versionOf(state) + 1) & kVersionMask) << 48;
+    }
+
+    Slot* find(uint64_t product_id) const;
+    Slot* findOrInsert(uint64_t product_id);
+    static void touch(Slot& slot);
+    // 取走表槽中的全部可用库存（启用热点前已在途的退回可能落在表槽）
+    static uint32_t takeSlotAvailable(Slot& slot);
+    HotBucket& localBucket(HotStock& hot) const;
+
+    bool reserveHot(Slot& slot, HotStock& hot, uint32_t quantity);
+    // 不加锁判断售罄：读取期间没有跨桶搬移且表槽和各桶的可用合计不足quantity
+    static bool hotSoldOut(const Slot& slot, const HotStock& hot, uint32_t quantity);
+    // 跨桶搬移的开始和结束（持有rebalance_mutex）
+    static void beginMove(HotStock& hot);
+    static void endMove(HotStock& hot);
+    // 收回所有桶的可用库存，扣除quantity（不足时不扣）后平均分回各桶
+    bool rebalance(Slot& slot, HotStock& hot, HotBucket& local, uint32_t quantity);
+    // 从本地桶扣除预留，不超过所有桶（含表槽）的预留合计，返回实际扣除数
+    uint32_t takeHotReserved(Slot& slot, HotStock& hot, HotBucket& local, uint32_t quantity);
+    void noteContention(Slot& slot, uint32_t failures, time_t now);
+
+    size_t capacity_;
+    size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<size_t> size_;
+
+    size_t hot_buckets_;
+    std::atomic<uint32_t> hot_threshold_;
+    std::atomic<uint64_t> hot_rebalances_;
+    mutable std::mutex hot_mutex_;
+    std::vector<std::unique_ptr<HotStock>> hot_stocks_;   // 随表释放
+};
+
+} // namespace services
+} // namespace order_engine
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include "services/order_state_machine.h"
+
+namespace order_engine {
+namespace services {
+
+/**
+ * @brief 一个时间窗口内的业务统计
+ */
+struct OrderWindowStats {
+    uint64_t orders = 0;                                   // 新建订单数
+    double revenue = 0.0;                                  // 新建订单金额
+    std::array<uint64_t, kOrderStatusCount> transitions{}; // 进入各状态的订单数（新建计入PENDING）
+};
+
+/**
+ * @brief 订单业务计数器
+ *
+ * 每个线程写自己独占缓存行的计数槽（线程数超过槽数时共享），
+ * 读取时汇总所有槽，写路径只有不带CAS循环的fetch_add。金额按分累计为整数。
+ *
+ * 每个槽维护三组按时间分桶的计数：
+ * - 最近60秒：60个1秒桶
+ * - 最近60分钟：60个1分钟桶
+ * - 当天：1个按本地日期的桶，跨天后自动归零
+ *
+ * 桶带有所属时间段编号，写入时发现编号过期则先清零再累加；
+ * 读取只汇总编号仍在窗口内的桶，无需后台线程清理
+ */
+class OrderMetrics {
+public:
+    // slot_count为0时每个CPU核心一个槽
+    explicit OrderMetrics(size_t slot_count = 0);
+    ~OrderMetrics();
+
+    OrderMetrics(const OrderMetrics&) = delete;
+    OrderMetrics& operator=(const OrderMetrics&) = delete;
+
+    // 新建count个订单，金额合计revenue
+    void recordCreated(uint64_t count, double revenue, time_t now);
+    // count个订单进入status
+    void recordTransition(OrderStatus status, uint64_t count, time_t now);
+    // 恢复订单簿后设置累计订单数的基数
+    void setTotalOrders(uint64_t total);
+
+    uint64_t totalOrders() const;
+    OrderWindowStats lastMinute(time_t now) const;
+    OrderWindowStats lastHour(time_t now) const;
+    OrderWindowStats today(time_t now) const;
+
+private:
+    static constexpr size_t kBuckets = 60;
+
+    struct Bucket {
+        std::atomic<int64_t> epoch{-1};   // 秒、分钟或本地日期编号
+        std::atomic<uint64_t> orders{0};
+        std::atomic<int64_t> revenue_cents{0};
+        std::array<std::atomic<uint64_t>, kOrderStatusCount> transitions{};
+    };
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> total_orders{0};
+        std::array<Bucket, kBuckets> seconds;
+        std::array<Bucket, kBuckets> minutes;
+        Bucket day;
+    };
+
+    Slot& localSlot();
+    // 返回epoch对应的桶，过期时清零
+    static Bucket& advance(Bucket& bucket, int64_t epoch);
+    static void accumulate(const Bucket& bucket, OrderWindowStats& stats);
+    int64_t dayOf(time_t now) const { return (static_cast<int64_t>(now) + utc_offset_) / 86400; }
+
+    size_t slot_count_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<uint64_t> base_total_;
+    int64_t utc_offset_;   // 本地时区偏移（秒），构造时确定
+};
+
+} // namespace services
+} // namespace order_engine
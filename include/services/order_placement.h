@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "services/order_service.h"
+
+namespace order_engine {
+namespace services {
+
+/**
+ * @brief 分级下单的一个批次：若干请求的订单拼接在一起，各级整批处理
+ *
+ * results与orders一一对应；某一级失败的订单把结果码改为非SUCCESS，
+ * 之后的各级跳过它。最后一级处理完后complete()按请求回调
+ */
+struct PlacementBatch {
+    using Completion = std::function<void(PlacementBatch& batch, size_t begin, size_t end)>;
+
+    struct Request {
+        size_t begin;
+        size_t end;
+        Completion done;
+    };
+
+    std::vector<OrderInfo> orders;
+    std::vector<OrderResult> results;
+    std::vector<std::string> reservation_ids;
+    std::vector<Request> requests;
+
+    size_t size() const { return orders.size(); }
+    bool empty() const { return orders.empty(); }
+
+    // 追加一个请求的订单
+    void add(std::vector<OrderInfo> request_orders, Completion done);
+    // 合并另一个批次（同一级中排队的多个批次合成一批）
+    void append(PlacementBatch&& other);
+    void complete();
+};
+
+/**
+ * @brief 分级下单配置
+ */
+struct PlacementOptions {
+    size_t queue_capacity = 4096;   // 每级队列最多排队的订单数
+    size_t max_batch = 512;         // 每级一次最多合并处理的订单数
+    size_t persist_workers = 2;     // 落盘级并行的批次数（等待日志提交时下一批可以先写入）
+};
+
+/**
+ * @brief 一级处理：有界队列 + 工作线程
+ *
+ * 工作线程一次取走队列中排队的全部批次（不超过max_batch个订单）合成一批
+ * 处理，然后交给下一级；下一级队列满时阻塞，背压逐级向上传到入口。
+ * 空闲时来一个处理一个，没有攒批等待；负载越高批次越大
+ */
+class PlacementStage {
+public:
+    using Handler = std::function<void(PlacementBatch& batch)>;
+
+    struct Stats {
+        size_t queued_orders;
+        uint64_t batches;
+        uint64_t orders;
+        uint64_t rejected;
+    };
+
+    PlacementStage(std::string name, size_t workers, const PlacementOptions& options, Handler handler,
+                   PlacementStage* next);
+    ~PlacementStage();
+
+    PlacementStage(const PlacementStage&) = delete;
+    PlacementStage& operator=(const PlacementStage&) = delete;
+
+    void start();
+    // 处理完已排队的批次后停止（上一级须先停止）
+    void stop();
+
+    // 入口：队列已满时立即返回false
+    bool tryPush(PlacementBatch&& batch);
+    // 上一级：队列已满时等待
+    void push(PlacementBatch&& batch);
+
+    const std::string& name() const { return name_; }
+    Stats stats() const;
+
+private:
+    void workerLoop();
+    // 空队列总能放入一个批次，超过容量的大批次不会被永久拒绝
+    bool hasRoom(size_t count) const { return queue_.empty() || queued_orders_ + count <= capacity_; }
+
+    std::string name_;
+    size_t worker_count_;
+    size_t capacity_;
+    size_t max_batch_;
+    Handler handler_;
+    PlacementStage* next_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<PlacementBatch> queue_;
+    size_t queued_orders_;
+    bool stopping_;
+    std::vector<std::thread> workers_;
+
+    std::atomic<uint64_t> batches_;
+    std::atomic<uint64_t> orders_;
+    std::atomic<uint64_t> rejected_;
+};
+
+/**
+ * @brief 分级（SEDA）下单流水线：预留库存 -> 落盘 -> 完成
+ *
+ * - reserve：校验、整段分配订单ID、一次分组预留全部库存
+ * - persist：订单簿按分片分组插入、日志一次提交、数据库一次多行写入
+ * - complete：写缓存、发布事件、一次更新统计，然后逐个请求回调
+ *
+ * 各级的处理函数由OrderService提供
+ */
+class OrderPlacementPipeline {
+public:
+    OrderPlacementPipeline(const PlacementOptions& options, PlacementStage::Handler reserve,
+                           PlacementStage::Handler persist, PlacementStage::Handler complete);
+    ~OrderPlacementPipeline();
+
+    void start();
+    // 逐级停止，已接受的请求全部完成回调
+    void stop();
+
+    // 入口队列已满或已停止时返回false，不回调
+    bool submit(PlacementBatch&& batch);
+
+    // 按处理顺序排列的各级
+    std::vector<const PlacementStage*> stages() const;
+
+private:
+    std::unique_ptr<PlacementStage> complete_;
+    std::unique_ptr<PlacementStage> persist_;
+    std::unique_ptr<PlacementStage> reserve_;
+};
+
+} // namespace services
+} // namespace order_engine
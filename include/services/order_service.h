@@ -2,18 +2,46 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <functional>
 #include <atomic>
 #include <mutex>
+#include <thread>
+#include "services/inventory_service.h"
+#include "utils/id_generator.h"
 // TODO: 待实现的头文件
 // #include "../database/connection_pool.h"
 // #include "../cache/cache_manager.h"
 // #include "../message/kafka_producer.h"
 
 namespace order_engine {
+namespace storage {
+class OrderJournal;
+class OrderArchive;
+class PersistenceBatcher;
+}
+
+namespace utils {
+class TimingWheel;
+}
+
+namespace message {
+class OrderEventPipeline;
+enum class OrderEventType : uint8_t;
+}
+
 namespace services {
 
+class OrderStore;
+class OrderMetrics;
+class IdempotencyCache;
+class OrderPlacementPipeline;
+struct PlacementBatch;
+struct PlacementOptions;
+struct StoredOrder;
+struct UserOrderKey;
+
 /**
  * @brief 订单状态枚举
  */
@@ -42,6 +70,36 @@ struct OrderInfo {
     std::string payment_method;
 };
 
+/**
+ * @brief 单个订单的处理结果码（数值与protocol::ResultCode一致）
+ */
+enum class OrderResultCode : uint16_t {
+    SUCCESS = 0,
+    INVALID_ORDER = 1,
+    NOT_FOUND = 2,
+    INSUFFICIENT_STOCK = 3,
+    SERVICE_UNAVAILABLE = 4,   // 下单队列已满，稍后重试
+    INTERNAL_ERROR = 5
+};
+
+/**
+ * @brief 批量创建中单个订单的结果
+ */
+struct OrderResult {
+    uint64_t order_id;
+    OrderResultCode code;
+    std::string message;
+};
+
+/**
+ * @brief 协程接口的下单结果
+ */
+struct OrderOutcome {
+    bool success;
+    std::string message;
+    OrderInfo order;
+};
+
 /**
  * @brief 订单服务
  * 
@@ -55,6 +113,10 @@ struct OrderInfo {
 class OrderService {
 public:
     using OrderCallback = std::function<void(bool success, const std::string& message, const OrderInfo& order)>;
+    using BatchOrderCallback = std::function<void(const std::vector<OrderResult>& results)>;
+
+    // 预留期限比订单超时多出的余量（秒），保证超时取消先于预留过期
+    static const int kReservationGrace;
 
     // 临时构造函数，后续会替换为完整版本
     OrderService(std::shared_ptr<void> db_pool = nullptr,
@@ -63,74 +125,332 @@ public:
     
     ~OrderService();
 
-    // 初始化和清理
-    bool initialize();
+    // 初始化和清理，store_shards为0时订单簿每个CPU核心一个分片；
+    // node_id写入订单ID，多实例部署时须各不相同
+    bool initialize(size_t store_shards = 0, uint16_t node_id = 0);
     void shutdown();
 
+    // 库存服务为空时跳过库存预留（Phase 1）
+    void setInventoryService(std::shared_ptr<InventoryService> inventory_service) {
+        inventory_service_ = std::move(inventory_service);
+    }
+
+    // 设置后订单变更先写入日志，落盘后才应答；为空时不写日志
+    void setJournal(std::shared_ptr<storage::OrderJournal> journal) {
+        journal_ = std::move(journal);
+    }
+
+    /**
+     * @brief 停止接受变更（热重启交出日志之前调用）
+     *
+     * 之后的下单和状态变更都以失败应答，不再追加日志；查询照常。
+     * 已追加的记录由日志close()提交，与其后的交接不冲突
+     */
+    void stopWrites() { writes_stopped_.store(true, std::memory_order_release); }
+
+    // 设置后新订单经批量持久化器写入数据库；有日志时异步写入，
+    // 否则等所在批次提交后才应答。为空时不写数据库
+    void setPersistenceBatcher(std::shared_ptr<storage::PersistenceBatcher> batcher) {
+        persistence_batcher_ = std::move(batcher);
+    }
+
+    // 设置后订单事件经流水线异步发布（不阻塞订单处理）；为空时不发布
+    void setEventPipeline(std::shared_ptr<message::OrderEventPipeline> pipeline) {
+        event_pipeline_ = std::move(pipeline);
+    }
+
+    // 设置后archiveClosedOrders()把已结束的旧订单移入冷归档；为空时不归档
+    void setArchive(std::shared_ptr<storage::OrderArchive> archive) {
+        archive_ = std::move(archive);
+    }
+
+    // 设置后createOrder按幂等键去重；为空时忽略幂等键
+    void setIdempotencyCache(std::shared_ptr<IdempotencyCache> cache) {
+        idempotency_cache_ = std::move(cache);
+    }
+
+    /**
+     * @brief 启用分级下单（见order_placement.h），在initialize()之前调用
+     *
+     * 启用后createOrder()/createOrders()把请求交给预留库存、落盘、完成三级
+     * 流水线后立即返回，各级把排队的请求合成一批处理，回调在完成级线程上
+     * 执行（Reactor线程用awaitCreateOrder()/awaitCreateOrders()回到本线程）；
+     * 入口队列已满时在调用线程内直接以SERVICE_UNAVAILABLE回调。
+     * 未启用时在调用线程内逐级执行并回调
+     */
+    void enableStagedPlacement(const PlacementOptions& options);
+    // 未启用分级下单时为空
+    const OrderPlacementPipeline* placementPipeline() const { return placement_.get(); }
+
+    // 未支付订单超时自动取消（秒），0表示不取消；在initialize()之前调用
+    void setOrderTimeout(int seconds) { order_timeout_ = seconds; }
+
+    /**
+     * @brief 库存预留期限（秒），在initialize()之前调用
+     *
+     * 预留只能在订单取消之后过期，否则期限与支付之间的订单仍可支付而库存
+     * 已退回（超卖）：自动取消时至少为order_timeout + kReservationGrace，
+     * 由取消订单释放预留，期限只是兜底；不自动取消时预留不过期。
+     * 0（默认）表示按订单超时推算
+     */
+    void setInventoryReserveTimeout(int seconds) { inventory_reserve_timeout_ = seconds; }
+    int inventoryReserveTimeout() const { return inventory_reserve_timeout_; }
+
+    /**
+     * @brief 取消到now为止超时仍未支付的订单并释放库存预留
+     *
+     * 超时期限保存在每个分片各自的时间轮中，每个订单O(1)，不扫描订单簿。
+     * 后台线程每秒调用一次
+     * @return 本次取消的订单数
+     */
+    size_t cancelExpiredOrders(time_t now);
+
+    /**
+     * @brief 从最新快照和其后的日志恢复订单簿
+     *
+     * 在initialize()和setJournal()之后、开始处理请求之前调用
+     */
+    bool recover(const std::string& snapshot_dir);
+
+    // 写快照，只保留最近两个，并删除已被保留快照覆盖的日志段
+    bool writeSnapshot(const std::string& snapshot_dir);
+
+    /**
+     * @brief 把最后变更早于cutoff的已结束订单移入冷归档并从订单簿删除
+     *
+     * 先写归档段并落盘，再在各分片线程内删除订单、追加归档日志记录，
+     * 只等待一次日志提交。收集之后又有变更的订单留在订单簿中，下次
+     * 重新归档；段写入后、删除前崩溃时同样重复归档，归档查询按订单ID
+     * 取最新的段
+     * @return 归档的订单数
+     */
+    size_t archiveClosedOrders(time_t cutoff);
+
     // 订单操作
     void createOrder(const OrderInfo& order_info, const OrderCallback& callback);
+
+    class CreateOrderAwaiter;
+    /**
+     * @brief 协程入口：在reactor线程中co_await，下单完成后在该线程继续
+     *
+     * 多步流程可以写成顺序代码，不再嵌套回调：
+     *
+     *     OrderOutcome outcome = co_await service.awaitCreateOrder(reactor, order);
+     *     if (outcome.success) { ... }
+     */
+    CreateOrderAwaiter awaitCreateOrder(network::Reactor& reactor, OrderInfo order_info);
+
+    /**
+     * @brief 带幂等键创建订单（客户端超时重试）
+     *
+     * 同一用户的同一幂等键只创建一次订单：已成功的返回原订单，
+     * 首个请求仍在执行时重试挂到首个请求上，callback在首个请求完成时由其线程
+     * 调用，不阻塞调用线程（此时本函数返回时callback尚未调用）。
+     * 首个请求失败时挂起的重试一并失败；失败的请求不被记住，之后的重试会重新执行。
+     * 幂等键为空或未设置去重表时等同于createOrder()
+     */
+    void createOrder(const OrderInfo& order_info, std::string_view idempotency_key, const OrderCallback& callback);
+    
+    /**
+     * @brief 批量创建订单
+     *
+     * 摊薄单订单开销：一次遍历完成校验，一次分配整段订单ID，
+     * 所有订单的库存在一次分组操作内预留，持久化合并为一次多行写入。
+     * 订单之间互不影响，results与orders一一对应
+     */
+    void createOrders(const std::vector<OrderInfo>& orders, const BatchOrderCallback& callback);
+
+    class CreateOrdersAwaiter;
+    // 协程入口：批量下单完成后在reactor线程继续，结果与orders一一对应
+    CreateOrdersAwaiter awaitCreateOrders(network::Reactor& reactor, std::vector<OrderInfo> orders);
+    // 状态转换按order_state_machine.h中的转换表校验，不允许的转换返回失败
     void updateOrderStatus(uint64_t order_id, OrderStatus status, const OrderCallback& callback);
+
+    /**
+     * @brief 批量状态转换（如仓库回传整批发货）
+     *
+     * 按分片分组在各分片线程内校验并应用，日志记录全部追加后只等待
+     * 一次提交，数据库一次批量操作。日志提交失败时整批回滚。
+     * results与order_ids一一对应：NOT_FOUND、INVALID_ORDER（不允许的转换）
+     * 或INTERNAL_ERROR
+     */
+    void updateOrderStatuses(const std::vector<uint64_t>& order_ids, OrderStatus status,
+                             const BatchOrderCallback& callback);
     void cancelOrder(uint64_t order_id, const std::string& reason, const OrderCallback& callback);
     
     // 查询操作
     void getOrder(uint64_t order_id, const OrderCallback& callback);
+    // 偏移分页，第page页仍需跳过之前的(page - 1) * page_size个订单；深翻页用getUserOrdersPage
     void getUserOrders(uint64_t user_id, int page, int page_size, 
                       const std::function<void(bool, const std::vector<OrderInfo>&)>& callback);
+
+    /**
+     * @brief 游标分页，从新到旧
+     *
+     * cursor为空时返回最新的一页，否则返回上一页next_cursor之后的订单；
+     * next_cursor为空表示没有更多订单。每页代价与页大小相关，与翻页深度无关
+     */
+    void getUserOrdersPage(uint64_t user_id, std::string_view cursor, int limit,
+                           const std::function<void(bool success, const std::vector<OrderInfo>& orders,
+                                                    const std::string& next_cursor)>& callback);
     
-    // 统计信息
-    uint64_t getTotalOrderCount() const { return total_order_count_.load(); }
-    uint64_t getTodayOrderCount() const { return today_order_count_.load(); }
-    double getTodayRevenue() const { return today_revenue_.load(); }
+    /**
+     * @brief 按状态和创建时间查询（对应orders表的idx_status_created），不访问数据库
+     *
+     * 返回created_at在[from, to)内、当前处于status的订单，从旧到新。cursor为空时
+     * 从from开始，否则从上一页next_cursor之后继续；next_cursor为空表示没有更多订单
+     */
+    void getOrdersByStatus(OrderStatus status, time_t from, time_t to, std::string_view cursor, int limit,
+                           const std::function<void(bool success, const std::vector<OrderInfo>& orders,
+                                                    const std::string& next_cursor)>& callback);
+    // created_at在[from, to)内、当前处于status的订单数（如超过10分钟仍未支付的订单）
+    size_t countOrdersByStatus(OrderStatus status, time_t from, time_t to);
+    
+    // 统计信息（分槽计数器，读取时汇总）
+    uint64_t getTotalOrderCount() const;
+    uint64_t getTodayOrderCount() const;
+    double getTodayRevenue() const;
+    // 最近一分钟/一小时/当天的订单数、金额及各状态转换数
+    const OrderMetrics& metrics() const { return *metrics_; }
+    const OrderStore& orderStore() const { return *order_store_; }
 
 private:
     // 内部处理方法
     bool validateOrder(const OrderInfo& order_info, std::string& error_msg);
     bool checkInventory(const std::vector<uint64_t>& product_ids, 
                        const std::vector<uint32_t>& quantities);
-    bool reserveInventory(const std::vector<uint64_t>& product_ids, 
-                         const std::vector<uint32_t>& quantities);
-    void releaseInventory(const std::vector<uint64_t>& product_ids, 
-                         const std::vector<uint32_t>& quantities);
+    bool reserveInventory(const OrderInfo& order, std::string& reservation_id);
+    void releaseInventory(const std::string& reservation_id);
+    // 支付后把预留转为实际扣减，预留不再随超时退回
+    void confirmInventory(const std::string& reservation_id);
     
     uint64_t generateOrderId();
-    std::string generateOrderNumber();
+    // 一次分配连续count个ID（不超过IdGenerator::kMaxBlockSize），返回第一个
+    uint64_t generateOrderIdBlock(size_t count);
+    // 写入IdGenerator::kOrderNumberLength字节的可读订单号
+    size_t generateOrderNumber(uint64_t order_id, char* buffer) const;
     
+    // 下单各级：在整个批次上执行，跳过结果码已非SUCCESS的订单
+    void reserveStage(PlacementBatch& batch);
+    void persistStage(PlacementBatch& batch);
+    void completeStage(PlacementBatch& batch);
+
     // 事件发布
-    void publishOrderEvent(const std::string& event_type, const OrderInfo& order);
+    void publishOrderEvent(message::OrderEventType type, const OrderInfo& order);
     
+    // 按用户索引在各分片取比cursor旧的最多limit个订单，合并后从新到旧排列
+    std::vector<OrderInfo> collectUserOrders(uint64_t user_id, const UserOrderKey* cursor, size_t limit);
+
     // 缓存操作
     void cacheOrder(const OrderInfo& order);
     bool getCachedOrder(uint64_t order_id, OrderInfo& order);
     void invalidateOrderCache(uint64_t order_id);
     
+    // 预写日志：在订单所属分片线程内追加，使日志顺序与分片写入顺序一致，
+    // 应答前再等待落盘。未设置日志时lsn保持0，两者都直接返回true
+    bool appendOrderRecord(const OrderInfo& order, std::string_view reservation_id, uint64_t& lsn);
+    bool appendStatusRecord(uint64_t order_id, OrderStatus status, time_t updated_at, uint64_t& lsn);
+    bool waitJournal(uint64_t lsn);
+    // 从订单簿删除下单失败的订单，journaled为true时追加撤销记录
+    void abortOrders(const std::vector<uint64_t>& order_ids, bool journaled);
+    // 日志提交失败时撤销已应用到订单簿的状态变更。取消时清空的预留ID由调用方
+    // 保存的副本恢复（previous中的string_view可能已随分片整理失效），为空时不改动
+    void rollbackStatus(const StoredOrder& previous, const std::string& reservation_id);
+    void rollbackStatuses(const std::vector<StoredOrder>& previous, const std::vector<std::string>& reservation_ids);
+
+    // 在订单所属分片线程内登记支付期限
+    void scheduleTimeout(uint64_t order_id, time_t created_at);
+    void startExpiryThread();
+    void stopExpiryThread();
+
     // 数据库操作
     bool insertOrderToDB(const OrderInfo& order);
+    // 多行写入，整体成功或失败
+    bool insertOrdersToDB(const std::vector<const OrderInfo*>& orders);
     bool updateOrderInDB(const OrderInfo& order);
+    bool updateOrdersInDB(const std::vector<const OrderInfo*>& orders);
     bool selectOrderFromDB(uint64_t order_id, OrderInfo& order);
     
     // 临时成员变量，后续会替换为正确类型
     std::shared_ptr<void> db_pool_;
     std::shared_ptr<void> cache_manager_;
     std::shared_ptr<void> kafka_producer_;
+    std::shared_ptr<InventoryService> inventory_service_;
+    std::shared_ptr<storage::OrderJournal> journal_;
+    std::shared_ptr<storage::PersistenceBatcher> persistence_batcher_;
+    std::shared_ptr<storage::OrderArchive> archive_;
+    std::shared_ptr<IdempotencyCache> idempotency_cache_;
+    std::shared_ptr<message::OrderEventPipeline> event_pipeline_;
+    std::unique_ptr<PlacementOptions> placement_options_;
+    std::unique_ptr<OrderPlacementPipeline> placement_;
+    
+    // 进程内订单簿：按order_id分片，每个分片由独占线程单写
+    std::unique_ptr<OrderStore> order_store_;
     
-    // 统计信息
-    std::atomic<uint64_t> total_order_count_;
-    std::atomic<uint64_t> today_order_count_;
-    std::atomic<double> today_revenue_;
+    // 统计信息：每个线程写自己的计数槽，避免共享缓存行
+    std::unique_ptr<OrderMetrics> metrics_;
     
-    // 订单ID生成器
-    std::atomic<uint64_t> order_id_generator_;
-    std::mutex order_id_mutex_;
+    // 订单ID生成器（无锁）
+    utils::IdGenerator id_generator_;
     
     // 配置参数
     int max_products_per_order_;
     double max_order_amount_;
     int inventory_reserve_timeout_;
+    int order_timeout_;
+
+    // 每个订单簿分片一个时间轮，只在该分片线程内访问
+    std::vector<std::unique_ptr<utils::TimingWheel>> timeout_wheels_;
+    std::thread expiry_thread_;
+    std::atomic<bool> expiry_running_;
+    std::atomic<bool> writes_stopped_;
     
     static const std::string kOrderCachePrefix;
     static const std::string kUserOrdersCachePrefix;
     static const int kCacheExpireTime;
 };
 
+class OrderService::CreateOrderAwaiter : public network::CallbackAwaiter<OrderOutcome> {
+public:
+    CreateOrderAwaiter(OrderService* service, network::Reactor& reactor, OrderInfo order_info)
+        : CallbackAwaiter(&reactor), service_(service), order_info_(std::move(order_info)) {}
+
+protected:
+    void start() override {
+        service_->createOrder(order_info_, [this](bool success, const std::string& message, const OrderInfo& order) {
+            resolve(OrderOutcome{success, message, order});
+        });
+    }
+
+private:
+    OrderService* service_;
+    OrderInfo order_info_;
+};
+
+inline OrderService::CreateOrderAwaiter OrderService::awaitCreateOrder(network::Reactor& reactor,
+                                                                        OrderInfo order_info) {
+    return CreateOrderAwaiter(this, reactor, std::move(order_info));
+}
+
+class OrderService::CreateOrdersAwaiter : public network::CallbackAwaiter<std::vector<OrderResult>> {
+public:
+    CreateOrdersAwaiter(OrderService* service, network::Reactor& reactor, std::vector<OrderInfo> orders)
+        : CallbackAwaiter(&reactor), service_(service), orders_(std::move(orders)) {}
+
+protected:
+    void start() override {
+        service_->createOrders(orders_, [this](const std::vector<OrderResult>& results) { resolve(results); });
+    }
+
+private:
+    OrderService* service_;
+    std::vector<OrderInfo> orders_;
+};
+
+inline OrderService::CreateOrdersAwaiter OrderService::awaitCreateOrders(network::Reactor& reactor,
+                                                                          std::vector<OrderInfo> orders) {
+    return CreateOrdersAwaiter(this, reactor, std::move(orders));
+}
+
 } // namespace services
 } // namespace order_engine
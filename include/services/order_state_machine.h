@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "services/order_service.h"
+
+namespace order_engine {
+namespace services {
+
+constexpr size_t kOrderStatusCount = 6;
+
+constexpr uint8_t statusBit(OrderStatus status) {
+    return static_cast<uint8_t>(1u << static_cast<unsigned>(status));
+}
+
+/**
+ * @brief 订单状态转换表
+ *
+ * kOrderTransitions[from]为允许的目标状态位掩码，校验只需一次查表：
+ *
+ *     PENDING -> PAID | CANCELLED
+ *     PAID -> SHIPPED | CANCELLED | REFUNDED
+ *     SHIPPED -> DELIVERED | REFUNDED
+ *     DELIVERED -> REFUNDED
+ *     CANCELLED、REFUNDED为终态
+ */
+inline constexpr std::array<uint8_t, kOrderStatusCount> kOrderTransitions = {
+    /* PENDING   */ statusBit(OrderStatus::PAID) | statusBit(OrderStatus::CANCELLED),
+    /* PAID      */ statusBit(OrderStatus::SHIPPED) | statusBit(OrderStatus::CANCELLED) |
+                    statusBit(OrderStatus::REFUNDED),
+    /* SHIPPED   */ statusBit(OrderStatus::DELIVERED) | statusBit(OrderStatus::REFUNDED),
+    /* DELIVERED */ statusBit(OrderStatus::REFUNDED),
+    /* CANCELLED */ 0,
+    /* REFUNDED  */ 0,
+};
+
+constexpr bool canTransition(OrderStatus from, OrderStatus to) {
+    auto index = static_cast<size_t>(from);
+    return index < kOrderStatusCount && static_cast<size_t>(to) < kOrderStatusCount &&
+           (kOrderTransitions[index] & statusBit(to)) != 0;
+}
+
+constexpr bool isTerminal(OrderStatus status) {
+    return static_cast<size_t>(status) < kOrderStatusCount && kOrderTransitions[static_cast<size_t>(status)] == 0;
+}
+
+// 已结束：终态，或已送达（之后只剩退款），可移入冷归档
+constexpr bool isClosed(OrderStatus status) {
+    return status == OrderStatus::DELIVERED || isTerminal(status);
+}
+
+static_assert(canTransition(OrderStatus::PENDING, OrderStatus::PAID));
+static_assert(canTransition(OrderStatus::PAID, OrderStatus::SHIPPED));
+static_assert(!canTransition(OrderStatus::PENDING, OrderStatus::SHIPPED));
+static_assert(!canTransition(OrderStatus::SHIPPED, OrderStatus::CANCELLED));
+static_assert(isTerminal(OrderStatus::CANCELLED) && isTerminal(OrderStatus::REFUNDED));
+static_assert(isClosed(OrderStatus::DELIVERED) && !isClosed(OrderStatus::SHIPPED));
+
+} // namespace services
+} // namespace order_engine
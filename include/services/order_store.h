@@ -0,0 +1,184 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "services/compact_order.h"
+#include "services/status_order_index.h"
+#include "services/user_order_index.h"
+#include "network/reactor.h"
+#include "utils/string_arena.h"
+
+namespace order_engine {
+namespace services {
+
+/**
+ * @brief 订单簿中的一条记录：紧凑订单及其库存预留ID（指向分片的StringArena）
+ */
+struct StoredOrder {
+    CompactOrder order;
+    std::string_view reservation_id;
+};
+
+/**
+ * @brief 分片统计（任意线程可读）
+ */
+struct OrderShardStats {
+    size_t entries;
+    size_t memory_bytes;   // 估算值：节点、桶数组、溢出的订单行、StringArena及二级索引
+    uint64_t tasks;        // 已执行的任务数
+};
+
+/**
+ * @brief 订单簿分片
+ *
+ * 只由所属线程访问，内部不加锁；查找/修改都必须在
+ * OrderStore投递的任务中进行
+ *
+ * 删除订单或清空预留ID后，其字符串仍留在StringArena中。erase/modify
+ * 结束时若不再引用的字节超过仍在引用的字节（且不少于kCompactMinDeadBytes），
+ * 把在册订单的字符串拷贝到新一代内存区并释放旧的。因此调用erase/modify后，
+ * 之前从本分片取得的string_view都不再有效
+ */
+class OrderShard {
+public:
+    static constexpr size_t kCompactMinDeadBytes = 256 * 1024;
+
+    OrderShard() : entry_bytes_(0), string_bytes_(0), compactions_(0), entries_(0), memory_bytes_(0), tasks_(0) {}
+
+    StoredOrder* find(uint64_t order_id);
+    // 转换为紧凑表示，字符串拷贝到本分片的StringArena
+    bool insert(const OrderInfo& order, std::string_view reservation_id);
+    // 已是紧凑表示（如快照加载），地址和预留ID同样拷贝到本分片的StringArena
+    bool insert(const CompactOrder& order, std::string_view reservation_id);
+    // 预先分配桶数组，批量加载前调用
+    void reserve(size_t count);
+    bool erase(uint64_t order_id);
+
+    // 修改已有订单并重新计算内存占用，订单不存在时返回false。
+    // 字符串字段只能指向本分片的内存区（新值先经storeString拷贝）
+    bool modify(uint64_t order_id, const std::function<void(StoredOrder&)>& fn);
+    std::string_view storeString(std::string_view value) { return arena_.store(value); }
+
+    void forEach(const std::function<void(const StoredOrder&)>& fn) const;
+
+    // 按用户的(created_at, order_id)索引，随插入、删除和修改自动维护
+    const UserOrderIndex& userIndex() const { return user_index_; }
+    // 按状态的(created_at, order_id)索引，随状态转换自动维护
+    const StatusOrderIndex& statusIndex() const { return status_index_; }
+
+    OrderShardStats stats() const;
+    // 字符串内存区整理的累计次数
+    uint64_t compactions() const { return compactions_; }
+
+private:
+    friend class OrderStore;
+
+    static size_t footprint(const StoredOrder& order);
+    static size_t stringBytes(const StoredOrder& order) {
+        return order.order.shipping_address.size() + order.reservation_id.size();
+    }
+    // 不再引用的字符串足够多时整理到新一代内存区
+    void compactStrings();
+    void publishStats();
+
+    std::unordered_map<uint64_t, StoredOrder> orders_;
+    UserOrderIndex user_index_;
+    StatusOrderIndex status_index_;
+    // 地址和预留ID的存放区，按代整理回收
+    utils::StringArena arena_;
+    size_t entry_bytes_;
+    size_t string_bytes_;   // 在册订单引用的字符串字节数
+    uint64_t compactions_;
+
+    // 所属线程写、其他线程读
+    std::atomic<size_t> entries_;
+    std::atomic<size_t> memory_bytes_;
+    std::atomic<uint64_t> tasks_;
+
+    // 所属线程及其事件循环（在该线程内创建）
+    std::unique_ptr<network::Reactor> reactor_;
+    std::thread thread_;
+};
+
+/**
+ * @brief 进程内订单簿
+ *
+ * 按order_id分片，每个分片由一个独占的Reactor线程持有，所有读写都
+ * 作为任务投递到该线程的任务队列中执行（单写者），分片数据无锁。
+ * 跨分片操作（批量插入、全量扫描）按分片分组后并行执行。
+ *
+ * 启动前及停止后没有所属线程，任务在调用线程直接执行
+ */
+class OrderStore {
+public:
+    using ShardTask = std::function<void(OrderShard&)>;
+
+    // shard_count为0时每个CPU核心一个分片
+    explicit OrderStore(size_t shard_count = 0);
+    ~OrderStore();
+
+    OrderStore(const OrderStore&) = delete;
+    OrderStore& operator=(const OrderStore&) = delete;
+
+    void start();
+    void stop();
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+    size_t shardCount() const { return shards_.size(); }
+    size_t shardOf(uint64_t order_id) const { return shardIndex(order_id, shards_.size()); }
+    // 分片数为shard_count时订单所属的分片（恢复时按快照的分片数定位）
+    static size_t shardIndex(uint64_t order_id, size_t shard_count);
+
+    // 异步投递到订单所属分片，不等待
+    void post(uint64_t order_id, ShardTask task);
+
+    /**
+     * @brief 在所属分片线程执行并等待完成
+     *
+     * 调用方已在该分片线程时直接执行。任务中不得再同步等待其他分片
+     */
+    void execute(uint64_t order_id, const ShardTask& task);
+
+    // 每个分片各执行一次，分片之间并行，全部完成后返回
+    void executeAll(const std::function<void(size_t shard_index, OrderShard&)>& task);
+
+    /**
+     * @brief 按订单所属分片分组执行，每个分片只投递一次任务
+     *
+     * 在分片线程内按下标顺序对属于该分片的每个订单调用task(index, shard)，
+     * 分片之间并行，全部完成后返回
+     */
+    void executeBatch(const std::vector<uint64_t>& order_ids,
+                      const std::function<void(size_t index, OrderShard&)>& task);
+
+    /**
+     * @brief 批量插入，每个分片只投递一次任务
+     *
+     * admit非空时在分片线程内、插入每个订单前以其下标调用，返回false则跳过
+     * （用于在单写者线程内写日志，使日志顺序与分片写入顺序一致）
+     * @return 与orders一一对应，订单ID已存在或被跳过时为false
+     */
+    std::vector<bool> insertBatch(const std::vector<const OrderInfo*>& orders,
+                                  const std::vector<std::string_view>& reservation_ids,
+                                  const std::function<bool(size_t index)>& admit = nullptr);
+
+    std::vector<OrderShardStats> stats() const;
+
+private:
+    void runOnShard(size_t index, const std::function<void()>& task, bool wait);
+    void executeOn(const std::vector<size_t>& indexes,
+                   const std::function<void(size_t shard_index, OrderShard&)>& task);
+
+    std::vector<std::unique_ptr<OrderShard>> shards_;
+    std::atomic<bool> running_;
+};
+
+} // namespace services
+} // namespace order_engine
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+#include "services/order_state_machine.h"
+#include "services/user_order_index.h"
+
+namespace order_engine {
+namespace services {
+
+/**
+ * @brief 按(status, created_at)的订单二级索引，对应orders表的idx_status_created
+ *
+ * 每个状态按创建时间分成kBucketSeconds秒一个桶（有序map），桶内是按
+ * (created_at, order_id)升序的紧凑数组。状态变更时从旧状态的桶删除、
+ * 插入新状态的桶：新订单几乎总是追加在最新的桶末尾，桶的大小受时间
+ * 跨度限制，插入删除移动的元素数与订单总数无关。计数时中间的整桶直接
+ * 累加大小，只在区间两端的桶内二分查找。
+ *
+ * 不加锁，由所属分片线程维护
+ */
+class StatusOrderIndex {
+public:
+    static constexpr uint32_t kBucketSeconds = 60;
+
+    void add(OrderStatus status, const UserOrderKey& key);
+    bool remove(OrderStatus status, const UserOrderKey& key);
+
+    /**
+     * @brief created_at在[from, to)内的键，从旧到新最多limit个
+     *
+     * after非空时只取比*after更新的键（上一页的最后一个）
+     */
+    void range(OrderStatus status, uint32_t from, uint32_t to, const UserOrderKey* after, size_t limit,
+               std::vector<UserOrderKey>& out) const;
+
+    // created_at在[from, to)内的键数
+    size_t count(OrderStatus status, uint32_t from, uint32_t to) const;
+    size_t count(OrderStatus status) const;
+
+    // 估算值：map节点及各桶数组容量
+    size_t memoryBytes() const;
+
+private:
+    using Bucket = std::vector<UserOrderKey>;
+
+    struct StatusBuckets {
+        std::map<uint32_t, Bucket> buckets;   // 桶起始时间 -> 键
+        size_t size = 0;
+    };
+
+    static uint32_t bucketOf(uint32_t created_at) { return created_at - created_at % kBucketSeconds; }
+    const StatusBuckets* find(OrderStatus status) const;
+
+    std::array<StatusBuckets, kOrderStatusCount> statuses_;
+    size_t bucket_count_ = 0;
+    size_t key_capacity_ = 0;   // 所有桶数组的容量之和
+};
+
+} // namespace services
+} // namespace order_engine
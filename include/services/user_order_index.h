@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace order_engine {
+namespace services {
+
+/**
+ * @brief 用户订单索引键，按(created_at, order_id)排序
+ *
+ * 同一秒内的订单由order_id区分，因此键在整个订单簿中唯一，
+ * 可直接用作翻页游标
+ */
+struct UserOrderKey {
+    uint32_t created_at;
+    uint64_t order_id;
+
+    bool operator==(const UserOrderKey& other) const {
+        return created_at == other.created_at && order_id == other.order_id;
+    }
+    bool operator<(const UserOrderKey& other) const {
+        return created_at != other.created_at ? created_at < other.created_at : order_id < other.order_id;
+    }
+
+    // 游标文本形式："<created_at>-<order_id>"
+    std::string toCursor() const;
+    static bool fromCursor(std::string_view text, UserOrderKey& key);
+};
+
+/**
+ * @brief 按用户的订单二级索引
+ *
+ * 每个用户一个按键升序的紧凑数组。订单ID随时间递增，新订单几乎总是
+ * 追加在末尾；按游标向旧翻页是一次二分查找加顺序读取，
+ * 代价与页大小相关而与历史订单数无关。
+ *
+ * 不加锁，由所属分片线程维护
+ */
+class UserOrderIndex {
+public:
+    void add(uint64_t user_id, const UserOrderKey& key);
+    bool remove(uint64_t user_id, const UserOrderKey& key);
+
+    /**
+     * @brief 从新到旧取最多limit个键
+     *
+     * cursor为空时从最新的订单开始，否则只取比*cursor更旧的订单
+     */
+    void before(uint64_t user_id, const UserOrderKey* cursor, size_t limit,
+                std::vector<UserOrderKey>& out) const;
+
+    size_t count(uint64_t user_id) const;
+    size_t userCount() const { return users_.size(); }
+    // 估算值：节点、桶数组及各用户数组容量
+    size_t memoryBytes() const;
+
+private:
+    std::unordered_map<uint64_t, std::vector<UserOrderKey>> users_;
+    size_t key_capacity_ = 0;   // 所有用户数组的容量之和
+};
+
+} // namespace services
+} // namespace order_engine
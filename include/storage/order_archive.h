@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "services/order_service.h"
+#include "services/order_state_machine.h"
+#include "services/user_order_index.h"
+
+namespace order_engine {
+namespace storage {
+
+/**
+ * @brief 冷归档配置
+ */
+struct ArchiveOptions {
+    std::string dir = "./data/archive";
+    uint32_t block_rows = 4096;   // 每块行数，区间映射（zone map）和列解码的粒度
+};
+
+/**
+ * @brief 时间范围聚合结果
+ */
+struct ArchiveAggregate {
+    uint64_t orders = 0;
+    double revenue = 0;
+    std::array<uint64_t, services::kOrderStatusCount> status_orders{};
+    std::array<double, services::kOrderStatusCount> status_revenue{};
+    // 解码的块数 / 按区间映射跳过的块数（整段跳过的块也计入）
+    uint64_t scanned_blocks = 0;
+    uint64_t skipped_blocks = 0;
+};
+
+/**
+ * @brief 冷归档统计
+ */
+struct ArchiveStats {
+    size_t segments;
+    uint64_t orders;
+    uint64_t bytes;
+};
+
+/**
+ * @brief 已结束订单的列式冷归档
+ *
+ * 每次归档写一个不可变的段文件，段内行按(user_id, created_at, order_id)
+ * 排序并按block_rows行分块，每列单独存放，块内编码（小端）：
+ *
+ *     | magic(8) | header_crc(4) | block_rows(4) | rows(8) | block_count(4) | column_count(4) |
+ *     | min_created(4) | max_created(4) | min_user(8) | max_user(8) | written_at(8) |
+ *     | 列目录：column_count × { offset(8) | size(8) } |
+ *     | 块区间映射：block_count × { min_created(4) | max_created(4) | min_user(8) | max_user(8) } |
+ *     | 列0 | 列1 | ... |
+ *
+ * - order_id/created_at：与上一行的差值，zigzag变长整数
+ * - user_id：行已按用户排序，差值变长整数
+ * - updated_at：与created_at的差值；total_amount：金额（分）的变长整数
+ * - status：每行1字节
+ * - payment_method/shipping_address：段内字典（偏移表 + 字符串），行内存字典下标
+ * - items：商品数，再逐个商品的product_id和数量
+ *
+ * 数值列每块一个偏移，块之间互不依赖。读取经mmap，查询只解码用到的列中
+ * 区间映射与条件相交的块：用户历史先按min/max_user定位块，只解码
+ * user_id/created_at/order_id选出订单后再取其余列；时间范围聚合只读
+ * created_at/status/total_amount，整块落在范围内时连created_at都不读。
+ *
+ * 段文件先写临时文件，fsync后再rename，写入后只读；查询与写入可并发
+ */
+class OrderArchive {
+public:
+    static constexpr size_t kHeaderSize = 64;
+    static constexpr size_t kColumnEntrySize = 16;
+    static constexpr size_t kZoneEntrySize = 24;
+
+    explicit OrderArchive(ArchiveOptions options = ArchiveOptions());
+    ~OrderArchive();
+
+    OrderArchive(const OrderArchive&) = delete;
+    OrderArchive& operator=(const OrderArchive&) = delete;
+
+    // 映射目录中已有的段，删除上次未完成的临时文件；损坏的段跳过并记录错误
+    bool open();
+
+    /**
+     * @brief 把orders写成一个新段，落盘后立即可查询
+     *
+     * 地址和支付方式按段内字典编码；订单行只保留商品ID和数量
+     */
+    bool write(const std::vector<services::OrderInfo>& orders, std::string* path = nullptr);
+
+    /**
+     * @brief 用户的归档订单，从新到旧
+     *
+     * cursor为空时从最新的订单开始，否则只取比*cursor更旧的订单（与
+     * OrderService::getUserOrdersPage的游标格式相同）。同一订单出现在
+     * 多个段中时取最新的段
+     */
+    std::vector<services::OrderInfo> userHistory(uint64_t user_id, const services::UserOrderKey* cursor,
+                                                 size_t limit) const;
+
+    // created_at在[from, to)内的订单数和金额，按状态分组
+    ArchiveAggregate aggregate(time_t from, time_t to) const;
+
+    ArchiveStats stats() const;
+    const ArchiveOptions& options() const { return options_; }
+
+    // 段文件名：archive-<序号>.seg，序号定长补零
+    static std::string segmentName(uint64_t sequence);
+
+private:
+    struct Segment;
+
+    std::vector<std::shared_ptr<const Segment>> segmentList() const;
+
+    ArchiveOptions options_;
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<const Segment>> segments_;   // 按序号升序
+    uint64_t next_sequence_;
+};
+
+} // namespace storage
+} // namespace order_engine
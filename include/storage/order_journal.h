@@ -0,0 +1,196 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "services/order_service.h"
+
+namespace order_engine {
+namespace storage {
+
+/**
+ * @brief 日志记录类型
+ */
+enum class JournalRecordType : uint8_t {
+    kOrderCreated = 1,
+    kStatusChanged = 2,
+    kOrderArchived = 3,    // 已移入冷归档，从订单簿删除（payload只有order_id）
+    kOrderAborted = 4      // 创建记录已提交但下单失败回滚，从订单簿删除（payload只有order_id）
+};
+
+/**
+ * @brief 回放时交给调用方的一条记录，payload指向读缓冲，回调返回后失效
+ */
+struct JournalRecord {
+    uint64_t lsn;
+    JournalRecordType type;
+    std::string_view payload;
+};
+
+/**
+ * @brief 日志配置
+ */
+struct JournalOptions {
+    std::string dir = "./data/journal";
+    size_t segment_size = 64 * 1024 * 1024;   // 段文件预分配大小
+    // 组提交：第一条记录到达后最多再等待这么久，让并发写入并入同一次fdatasync。
+    // 0表示立即提交，提交期间到达的记录自然并入下一批；写入方都在等待应答时
+    // 这已足够，额外等待只增加延迟，仅在IOPS受限的设备上才值得调大
+    int commit_interval_us = 0;
+    size_t max_batch_bytes = 1024 * 1024;     // 达到后不再等待，立即提交
+    bool sync = true;                         // false时只write不fdatasync（测试/压测用）
+};
+
+/**
+ * @brief 只追加的订单预写日志（WAL）
+ *
+ * 记录格式（小端）：
+ *
+ *     | crc32c(4) | length(4) | lsn(8) | type(1) | reserved(7) | payload(length) |
+ *
+ * crc覆盖length之后的头部和payload。日志由若干段文件组成，文件名为
+ * journal-<首个LSN>.wal，创建时写零预分配到segment_size（后台线程提前
+ * 准备好下一段，切换时只写段头并改名），之后的追加
+ * 只改写已分配的数据块，fdatasync不需要刷元数据；记录不跨段。
+ * 扫描时遇到校验失败或全零的头部即视为日志尾。
+ * 写盘失败后拒绝后续追加，并在目录中记下最后一个已提交的LSN
+ * （journal.failed）；回放只到该LSN为止，下次open()时截断其后的记录。
+ *
+ * 写入方把记录追加到内存批次后由刷盘线程统一write + fdatasync（组提交），
+ * 提交完成后唤醒waitForCommit()的等待者并执行回调
+ */
+class OrderJournal {
+public:
+    using CommitCallback = std::function<void(bool success)>;
+    using ReplayCallback = std::function<void(const JournalRecord& record)>;
+
+    static constexpr size_t kRecordHeaderSize = 24;
+    static constexpr size_t kSegmentHeaderSize = 16;
+
+    explicit OrderJournal(JournalOptions options = JournalOptions());
+    ~OrderJournal();
+
+    OrderJournal(const OrderJournal&) = delete;
+    OrderJournal& operator=(const OrderJournal&) = delete;
+
+    // 定位已有日志的尾部并启动刷盘线程
+    bool open();
+    // 提交剩余记录后停止
+    void close();
+    bool isOpen() const { return running_.load(std::memory_order_acquire); }
+    const JournalOptions& options() const { return options_; }
+
+    /**
+     * @brief 追加一条记录，返回分配的LSN（失败返回0）
+     *
+     * 不等待落盘；callback在提交后于刷盘线程中执行
+     */
+    uint64_t append(JournalRecordType type, std::string_view payload,
+                    CommitCallback callback = CommitCallback());
+
+    // 等待lsn及之前的记录落盘，日志写入失败时返回false
+    bool waitForCommit(uint64_t lsn);
+
+    uint64_t appendOrderCreated(const services::OrderInfo& order, std::string_view reservation_id);
+    uint64_t appendStatusChanged(uint64_t order_id, services::OrderStatus status, time_t updated_at);
+    uint64_t appendOrderArchived(uint64_t order_id);
+    uint64_t appendOrderAborted(uint64_t order_id);
+
+    // 已分配的最后一个LSN / 已落盘的最后一个LSN
+    uint64_t lastLsn() const { return next_lsn_.load(std::memory_order_acquire) - 1; }
+    uint64_t committedLsn() const { return committed_lsn_.load(std::memory_order_acquire); }
+
+    // 统计
+    uint64_t getCommitCount() const { return commit_count_.load(std::memory_order_relaxed); }
+    uint64_t getCommittedRecords() const { return committed_records_.load(std::memory_order_relaxed); }
+    uint64_t getCommittedBytes() const { return committed_bytes_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 按LSN顺序回放dir下lsn >= from_lsn的记录
+     *
+     * 最后一段的尾部残缺记录视为未提交而忽略；中间段损坏时返回false
+     */
+    static bool replay(const std::string& dir, uint64_t from_lsn, const ReplayCallback& callback);
+
+    // 记录编解码
+    static void encodeOrderCreated(std::string& out, const services::OrderInfo& order,
+                                   std::string_view reservation_id);
+    static bool decodeOrderCreated(std::string_view payload, services::OrderInfo& order,
+                                   std::string& reservation_id);
+    static void encodeStatusChanged(std::string& out, uint64_t order_id, services::OrderStatus status,
+                                    time_t updated_at);
+    static bool decodeStatusChanged(std::string_view payload, uint64_t& order_id,
+                                    services::OrderStatus& status, time_t& updated_at);
+
+    // 所有记录类型的payload都以order_id开头，回放时按它分派到分片
+    static bool peekOrderId(std::string_view payload, uint64_t& order_id);
+
+    // 段文件列表（按首个LSN排序）
+    static std::vector<std::pair<uint64_t, std::string>> listSegments(const std::string& dir);
+
+    /**
+     * @brief 删除全部记录都不超过lsn的段（已被快照覆盖）
+     *
+     * 最后一段正在写入，始终保留。返回删除的段数
+     */
+    size_t removeSegmentsBefore(uint64_t lsn);
+
+private:
+    // 内存中的一段待写数据，new_segment表示写入前先切换到新段
+    struct Chunk {
+        bool new_segment;
+        uint64_t first_lsn;
+        std::string data;
+    };
+
+    void flushLoop();
+    void spareLoop();
+    bool writeChunks(std::vector<Chunk>& chunks);
+    bool openSegment(uint64_t first_lsn);
+    bool recover();
+    bool clearFailedMarker();
+
+    JournalOptions options_;
+
+    // 追加侧状态（mutex_保护）
+    std::mutex mutex_;
+    std::condition_variable flush_cv_;
+    std::vector<Chunk> pending_;
+    size_t pending_bytes_;
+    std::vector<std::pair<uint64_t, CommitCallback>> pending_callbacks_;
+    size_t segment_offset_;       // 按追加顺序推算的当前段写入位置
+    std::atomic<uint64_t> next_lsn_;
+    std::atomic<bool> failed_;  // 写盘失败后拒绝后续追加
+
+    // 提交等待
+    std::mutex commit_mutex_;
+    std::condition_variable commit_cv_;
+    std::atomic<uint64_t> committed_lsn_;
+
+    // 刷盘线程独占
+    int fd_;
+    size_t file_offset_;
+    std::thread flush_thread_;
+    std::atomic<bool> running_;
+
+    // 备用段：后台线程写零，刷盘线程切换段时取用（spare_mutex_保护）
+    std::mutex spare_mutex_;
+    std::condition_variable spare_cv_;
+    std::thread spare_thread_;
+    bool spare_ready_;
+    bool spare_wanted_;
+
+    std::atomic<uint64_t> commit_count_;
+    std::atomic<uint64_t> committed_records_;
+    std::atomic<uint64_t> committed_bytes_;
+};
+
+} // namespace storage
+} // namespace order_engine
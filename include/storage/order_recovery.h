@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "services/order_store.h"
+
+namespace order_engine {
+namespace storage {
+
+/**
+ * @brief 启动恢复结果
+ */
+struct RecoveryResult {
+    std::string snapshot_path;       // 为空表示没有快照
+    uint64_t snapshot_lsn = 0;
+    uint64_t snapshot_orders = 0;
+    uint64_t replayed_records = 0;   // 实际应用到订单簿的日志记录数
+    int64_t load_ms = 0;
+    int64_t replay_ms = 0;
+};
+
+/**
+ * @brief 订单簿启动恢复：mmap加载最新快照，再只回放其后的日志
+ *
+ * 回放分两步：调用线程顺序读取并校验日志，按order_id把记录分派到
+ * 各分片的缓冲区（保持LSN顺序）；然后各分片在自己的线程内并行应用。
+ * 快照中各分片包含的最后一个LSN不同，每条记录按其订单在快照时所属
+ * 分片的LSN判断是否已包含，已包含的跳过
+ */
+class OrderRecovery {
+public:
+    // 订单簿须为空；没有快照时从日志开头回放
+    static bool recover(const std::string& snapshot_dir, const std::string& journal_dir,
+                        services::OrderStore& store, RecoveryResult& result);
+
+    /**
+     * @brief 回放journal_dir中的日志
+     *
+     * shard_lsns[i]为快照时第i个分片已包含的最后一个LSN，为空表示没有快照
+     */
+    static bool replayJournal(const std::string& journal_dir, const std::vector<uint64_t>& shard_lsns,
+                              services::OrderStore& store, uint64_t& applied);
+};
+
+} // namespace storage
+} // namespace order_engine
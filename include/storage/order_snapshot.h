@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "services/order_store.h"
+
+namespace order_engine {
+namespace storage {
+
+class OrderJournal;
+
+/**
+ * @brief 快照写入/加载结果
+ */
+struct SnapshotInfo {
+    std::string path;
+    uint64_t lsn = 0;          // 所有分片都已包含lsn及之前的记录
+    uint64_t orders = 0;
+    size_t bytes = 0;
+    std::vector<uint64_t> shard_lsns;   // 各分片包含的最后一个LSN
+};
+
+/**
+ * @brief 订单簿快照
+ *
+ * 文件格式（小端）：
+ *
+ *     | magic(8) | header_crc(4) | shard_count(4) | lsn(8) | orders(8) | created_at(8) | reserved(24) |
+ *     | 分段表：shard_count × { offset(8) | size(8) | count(8) | lsn(8) | crc32c(4) | reserved(4) } |
+ *     | 分段0 | 分段1 | ... |
+ *
+ * 每个分片一段，段内是连续的订单记录。写快照时每个分片在所属线程内
+ * 把自身序列化到缓冲区（不fork，分片之间并行，单个分片只暂停序列化
+ * 自身的时间），同时记下此刻日志的最后一个LSN：由于订单变更的日志在
+ * 分片线程内追加，该分片所有LSN不超过它的记录都已包含在段内，更大的
+ * 都不包含。回放时从最小的分片LSN开始，每个分片跳过自己已包含的记录
+ */
+class OrderSnapshot {
+public:
+    static constexpr size_t kHeaderSize = 64;
+    static constexpr size_t kSectionEntrySize = 40;
+
+    /**
+     * @brief 写入dir/snapshot-<lsn>.snap
+     *
+     * 先写临时文件，fsync后再rename，不会留下半个快照。
+     * journal为空时各分片LSN记为0
+     */
+    static bool write(const std::string& dir, services::OrderStore& store, const OrderJournal* journal,
+                      SnapshotInfo* info = nullptr);
+
+    /**
+     * @brief mmap加载快照到空的订单簿
+     *
+     * 分段数与订单簿分片数一致时每个分片在自己的线程内解码自己的段（并行）；
+     * 否则按订单ID重新分组插入
+     */
+    static bool load(const std::string& path, services::OrderStore& store, SnapshotInfo* info = nullptr);
+
+    // 最新的快照文件，没有时返回空串
+    static std::string latest(const std::string& dir);
+
+    // 只保留最新的keep个快照，返回保留的最旧快照的LSN（其后的日志须保留）
+    static uint64_t prune(const std::string& dir, size_t keep);
+
+    // 单条订单记录编解码。decode从in头部取出一条并前移；地址和预留ID
+    // 指向输入缓冲，支付方式名称登记为进程内编码
+    static void encodeOrder(std::string& out, const services::StoredOrder& entry);
+    static bool decodeOrder(std::string_view& in, services::CompactOrder& order, std::string_view& reservation_id);
+};
+
+} // namespace storage
+} // namespace order_engine
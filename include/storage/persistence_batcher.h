@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "services/order_service.h"
+#include "utils/histogram.h"
+
+namespace order_engine {
+namespace storage {
+
+/**
+ * @brief 批量持久化配置
+ */
+struct PersistenceOptions {
+    int max_delay_ms = 5;      // 第一行入队后最多等待这么久再提交
+    size_t max_rows = 500;     // 单个事务最多的订单数，达到后立即提交
+    int retry_delay_ms = 100;         // 事务失败后首次重试的等待，之后每次翻倍
+    int max_retry_delay_ms = 5000;    // 重试等待的上限
+    // 同一订单失败这么多次后开始二分所在批次；单独成批仍失败即转入死信
+    int max_attempts = 5;
+    size_t max_pending = 100000;      // 队列上限，已满时submit()返回false
+    std::string dead_letter_file;     // 死信订单的SQL追加到此文件，为空时只记日志
+};
+
+/**
+ * @brief 订单批量持久化器
+ *
+ * 汇集所有线程提交的订单，最多等待max_delay_ms或攒够max_rows后在一个
+ * 事务中写入：按创建月份每张orders_YYYYMM表一条多行INSERT，全部订单行
+ * 一条多行INSERT写入order_items（只写商品ID和数量，名称、编码和价格在
+ * 商品目录接入前为NULL）。事务提交（或失败）后在刷写线程中
+ * 执行每个订单的回调。
+ *
+ * 以retry提交的订单在事务失败时不回调，放回队首，退避后与新订单一起
+ * 重试；只有停止时仍写不进去才以失败回调。其他订单失败即回调，由调用方
+ * 决定如何处理。
+ *
+ * 一行坏数据会使所在批次每次都失败：批次中有订单已失败max_attempts次时
+ * 下一批减半（二分），成功后逐步恢复批次大小，好的订单随之写入；单独成批
+ * 仍失败的订单转入死信（SQL写入dead_letter_file并以失败回调），不再阻塞
+ * 后续批次。队列超过max_pending时拒绝新订单并计数。
+ *
+ * 语句的执行交给TransactionExecutor（由数据库连接池提供），
+ * 本类只负责攒批、生成SQL和统计
+ */
+class PersistenceBatcher {
+public:
+    // 在一个事务中依次执行statements，全部成功并提交时返回true
+    using TransactionExecutor = std::function<bool(const std::vector<std::string>& statements)>;
+    using CommitCallback = std::function<void(bool success)>;
+
+    struct PendingOrder {
+        services::OrderInfo order;
+        std::string order_number;
+        CommitCallback callback;
+        std::chrono::steady_clock::time_point enqueued_at;
+        bool retry;
+        int attempts = 0;   // 已失败的次数
+    };
+
+    explicit PersistenceBatcher(TransactionExecutor executor, PersistenceOptions options = PersistenceOptions());
+    ~PersistenceBatcher();
+
+    PersistenceBatcher(const PersistenceBatcher&) = delete;
+    PersistenceBatcher& operator=(const PersistenceBatcher&) = delete;
+
+    void start();
+    // 写完已提交的订单后停止（此时失败的批次不再重试）
+    void stop();
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+    // 任意线程调用；未启动或队列已满时返回false且不执行回调。
+    // retry为true时事务失败后重试，直到成功、停止或转入死信
+    bool submit(const services::OrderInfo& order, std::string_view order_number,
+                CommitCallback callback = CommitCallback(), bool retry = false);
+
+    // 统计
+    uint64_t getBatchCount() const { return batch_count_.load(std::memory_order_relaxed); }
+    uint64_t getRowCount() const { return row_count_.load(std::memory_order_relaxed); }
+    uint64_t getFailedBatchCount() const { return failed_batch_count_.load(std::memory_order_relaxed); }
+    // 因事务失败放回队列等待重试的订单累计数
+    uint64_t getRetriedRowCount() const { return retried_row_count_.load(std::memory_order_relaxed); }
+    // 多次失败后转入死信的订单累计数
+    uint64_t getDeadLetterCount() const { return dead_letter_count_.load(std::memory_order_relaxed); }
+    // 队列已满被拒绝的订单累计数
+    uint64_t getRejectedCount() const { return rejected_count_.load(std::memory_order_relaxed); }
+    // 等待写入的订单数（含等待重试的）
+    size_t queueDepth() const { return queue_depth_.load(std::memory_order_relaxed); }
+    // 批次延迟（毫秒）：最早入队的订单到事务结束
+    const utils::Histogram& batchLatency() const { return batch_latency_ms_; }
+    // 批次大小（订单数）
+    const utils::Histogram& batchSize() const { return batch_size_; }
+
+    // 生成一个批次的SQL语句（orders_YYYYMM按表分组，之后是order_items）
+    static void buildStatements(const std::vector<PendingOrder>& batch, std::vector<std::string>& statements);
+    // 按本地时间的创建月份分表
+    static std::string ordersTable(time_t created_at);
+
+private:
+    void flushLoop();
+    void deadLetter(PendingOrder& pending);
+
+    TransactionExecutor executor_;
+    PersistenceOptions options_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<PendingOrder> pending_;
+
+    std::thread flush_thread_;
+    std::atomic<bool> running_;
+
+    std::atomic<uint64_t> batch_count_;
+    std::atomic<uint64_t> row_count_;
+    std::atomic<uint64_t> failed_batch_count_;
+    std::atomic<uint64_t> retried_row_count_;
+    std::atomic<uint64_t> dead_letter_count_;
+    std::atomic<uint64_t> rejected_count_;
+    std::atomic<size_t> queue_depth_;
+    utils::Histogram batch_latency_ms_;
+    utils::Histogram batch_size_;
+};
+
+} // namespace storage
+} // namespace order_engine
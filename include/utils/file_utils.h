@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <sys/types.h>
+
+namespace order_engine {
+namespace utils {
+
+// 在offset处写满len字节（处理短写和EINTR）
+bool writeFully(int fd, const char* data, size_t len, off_t offset);
+
+// 读取整个文件到content
+bool readFile(const std::string& path, std::string& content);
+
+// fsync目录，使其中新建/改名的文件项持久化
+bool syncDirectory(const std::string& dir);
+
+/**
+ * @brief 只读映射整个文件，析构时解除映射
+ */
+class MappedFile {
+public:
+    MappedFile() : data_(nullptr), size_(0) {}
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // 空文件或映射失败时返回false
+    bool open(const std::string& path);
+    // madvise访问模式提示（MADV_SEQUENTIAL、MADV_WILLNEED等）
+    void advise(int advice) const;
+
+    const char* data() const { return static_cast<const char*>(data_); }
+    size_t size() const { return size_; }
+
+private:
+    void* data_;
+    size_t size_;
+};
+
+} // namespace utils
+} // namespace order_engine
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace order_engine {
+namespace utils {
+
+/**
+ * @brief CRC32C（Castagnoli）校验
+ *
+ * 支持SSE4.2的CPU使用crc32指令，否则回退到查表实现；
+ * 用于协议帧和持久化记录的完整性校验
+ */
+uint32_t crc32c(const void* data, size_t len, uint32_t crc = 0);
+
+/**
+ * @brief 64位整数混洗（用于分片和哈希表定位）
+ */
+inline uint64_t mix64(uint64_t key) {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+/**
+ * @brief 字符串的64位哈希（FNV-1a + mix64收尾），非加密用途
+ */
+uint64_t hash64(const void* data, size_t len, uint64_t seed = 0);
+
+} // namespace utils
+} // namespace order_engine
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace order_engine {
+namespace utils {
+
+/**
+ * @brief 固定桶直方图
+ *
+ * 桶边界在构造时给定（升序），observe()无锁，任意线程可并发调用；
+ * 输出为Prometheus histogram格式（累计桶 + _sum + _count）
+ */
+class Histogram {
+public:
+    explicit Histogram(std::vector<double> bounds);
+
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+
+    void observe(double value);
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    double sum() const { return sum_.load(std::memory_order_relaxed); }
+    const std::vector<double>& bounds() const { return bounds_; }
+    // 第i个桶（不累计）的计数，i == bounds().size()为+Inf桶
+    uint64_t bucketCount(size_t i) const { return buckets_[i].load(std::memory_order_relaxed); }
+
+    // 追加"# TYPE name histogram"及各行，labels形如 shard="0"，可为空
+    void appendPrometheus(std::string& out, std::string_view name, std::string_view labels = {}) const;
+
+    // 从start开始每次乘factor，共count个边界
+    static std::vector<double> exponentialBounds(double start, double factor, size_t count);
+
+private:
+    std::vector<double> bounds_;
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets_;
+    std::atomic<uint64_t> count_;
+    std::atomic<double> sum_;
+};
+
+} // namespace utils
+} // namespace order_engine
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace order_engine {
+namespace utils {
+
+/**
+ * @brief Snowflake风格的64位订单ID生成器
+ *
+ *     | 1位保留 | 41位毫秒时间戳 | 10位节点ID | 12位序列号 |
+ *
+ * 时间戳相对kEpochMs（2024-01-01 UTC），可用约69年。
+ * (时间戳, 序列号)存在一个原子字中，用CAS无锁推进：新的毫秒从序列号0
+ * 开始，同一毫秒内递增，序列号用完或系统时钟回拨时沿用上次的时间戳
+ * 继续向后借用，生成的ID在整个进程内严格递增（对orders_YYYYMM表的
+ * B+树主键友好），时钟回拨期间也不会重复
+ */
+class IdGenerator {
+public:
+    static constexpr uint64_t kEpochMs = 1704067200000ULL;
+    static constexpr int kSequenceBits = 12;
+    static constexpr int kNodeBits = 10;
+    static constexpr int kTimestampShift = kSequenceBits + kNodeBits;
+    static constexpr uint64_t kMaxSequence = (1ULL << kSequenceBits) - 1;
+    static constexpr uint16_t kMaxNodeId = (1U << kNodeBits) - 1;
+    // 一次分配的ID不跨毫秒，保证整段连续
+    static constexpr size_t kMaxBlockSize = kMaxSequence + 1;
+
+    // "ORD" + YYYYMMDD + 当日毫秒(8位) + 节点ID(4位) + 序列号(4位)
+    static constexpr size_t kOrderNumberLength = 27;
+
+    explicit IdGenerator(uint16_t node_id = 0);
+
+    // 仅在开始分配ID之前调用
+    void setNodeId(uint16_t node_id);
+    uint16_t nodeId() const { return node_id_; }
+
+    uint64_t nextId() { return nextBlock(1); }
+
+    /**
+     * @brief 分配count个连续ID（1 <= count <= kMaxBlockSize），返回第一个
+     */
+    uint64_t nextBlock(size_t count);
+    // 指定当前时间（相对Unix纪元的毫秒），测试时钟回拨用
+    uint64_t nextBlock(size_t count, uint64_t now_ms);
+
+    /**
+     * @brief 保证之后分配的ID都大于id
+     *
+     * 恢复订单簿后用最大的已有订单ID调用：重启后系统时钟可能落后于
+     * 上次运行借用到的时间戳，不推进时会重新分配出已存在的ID
+     */
+    void advancePast(uint64_t id);
+
+    // 分配时时间戳领先系统时钟的次数（时钟回拨或单毫秒序列号耗尽）
+    uint64_t borrowCount() const { return borrow_count_.load(std::memory_order_relaxed); }
+
+    // ID各字段解码
+    static uint64_t timestampMs(uint64_t id) { return (id >> kTimestampShift) + kEpochMs; }
+    static uint16_t nodeOf(uint64_t id) { return (id >> kSequenceBits) & kMaxNodeId; }
+    static uint32_t sequenceOf(uint64_t id) { return id & kMaxSequence; }
+
+    /**
+     * @brief 生成可读订单号，写入buffer（至少kOrderNumberLength字节，不追加'\0'）
+     *
+     * 日期按本地时区计算，时区偏移在构造时取一次；只做整数运算和查表，
+     * 不经过snprintf/std::string
+     */
+    size_t formatOrderNumber(uint64_t id, char* buffer) const;
+
+private:
+    uint16_t node_id_;
+    int64_t utc_offset_ms_;
+    // (时间戳 << kSequenceBits) | 序列号，即最后分配出去的位置
+    std::atomic<uint64_t> state_;
+    std::atomic<uint64_t> borrow_count_;
+};
+
+} // namespace utils
+} // namespace order_engine
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+namespace order_engine {
+namespace utils {
+
+/**
+ * @brief 带内联存储的小数组
+ *
+ * 前N个元素放在对象内部，超出后整体搬到堆上（容量翻倍）。
+ * 只用于可平凡复制的类型，搬移用memcpy
+ */
+template <typename T, size_t N>
+class InlineVector {
+    static_assert(std::is_trivially_copyable_v<T>, "InlineVector requires trivially copyable elements");
+
+public:
+    static constexpr size_t kInlineCapacity = N;
+
+    InlineVector() : data_(inline_), size_(0), capacity_(N) {}
+
+    InlineVector(const InlineVector& other) : InlineVector() {
+        assign(other.data_, other.size_);
+    }
+
+    InlineVector(InlineVector&& other) noexcept : InlineVector() {
+        if (other.isInline()) {
+            std::memcpy(inline_, other.inline_, other.size_ * sizeof(T));
+        } else {
+            data_ = other.data_;
+            capacity_ = other.capacity_;
+            other.data_ = other.inline_;
+            other.capacity_ = N;
+        }
+        size_ = other.size_;
+        other.size_ = 0;
+    }
+
+    InlineVector& operator=(const InlineVector& other) {
+        if (this != &other) {
+            assign(other.data_, other.size_);
+        }
+        return *this;
+    }
+
+    InlineVector& operator=(InlineVector&& other) noexcept {
+        if (this != &other) {
+            this->~InlineVector();
+            new (this) InlineVector(std::move(other));
+        }
+        return *this;
+    }
+
+    ~InlineVector() {
+        if (!isInline()) {
+            std::free(data_);
+        }
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return capacity_; }
+    // 元素是否仍在对象内部（没有堆分配）
+    bool isInline() const { return data_ == inline_; }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+    T* begin() { return data_; }
+    T* end() { return data_ + size_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+    void clear() { size_ = 0; }
+
+    void reserve(size_t capacity) {
+        if (capacity <= capacity_) {
+            return;
+        }
+        T* data = static_cast<T*>(std::malloc(capacity * sizeof(T)));
+        if (data == nullptr) {
+            throw std::bad_alloc();
+        }
+        std::memcpy(data, data_, size_ * sizeof(T));
+        if (!isInline()) {
+            std::free(data_);
+        }
+        data_ = data;
+        capacity_ = capacity;
+    }
+
+    void push_back(const T& value) {
+        if (size_ == capacity_) {
+            reserve(capacity_ * 2);
+        }
+        data_[size_++] = value;
+    }
+
+    void assign(const T* values, size_t count) {
+        size_ = 0;
+        reserve(count);
+        std::memcpy(data_, values, count * sizeof(T));
+        size_ = count;
+    }
+
+    // 堆上占用的字节数
+    size_t heapBytes() const { return isInline() ? 0 : capacity_ * sizeof(T); }
+
+private:
+    T* data_;
+    size_t size_;
+    size_t capacity_;
+    T inline_[N];
+};
+
+} // namespace utils
+} // namespace order_engine
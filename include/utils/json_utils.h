@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "services/order_service.h"
+
+namespace order_engine {
+namespace utils {
+
+class JsonParser;
+
+enum class JsonType {
+    kInvalid,
+    kObject,
+    kArray,
+    kString,
+    kNumber,
+    kBool,
+    kNull
+};
+
+/**
+ * @brief 按需访问的JSON值
+ *
+ * 只是(解析器, 结构字符下标)的二元组，不持有数据；取字段、
+ * 取数组元素时沿结构索引跳跃，嵌套对象/数组通过预先算好的
+ * 配对下标整体跳过，不访问的部分不会被解析。
+ * 生命周期不超过所属JsonParser的下一次parse()
+ */
+class JsonValue {
+public:
+    JsonValue() : parser_(nullptr), index_(0) {}
+
+    bool valid() const { return parser_ != nullptr; }
+    JsonType type() const;
+
+    // 对象字段，不存在或类型不符时返回无效值
+    JsonValue operator[](std::string_view key) const;
+
+    // 数组遍历：for (auto e = array.firstElement(); e.valid(); e = e.nextElement())
+    JsonValue firstElement() const;
+    JsonValue nextElement() const;
+
+    bool getUint64(uint64_t& value) const;
+    bool getInt64(int64_t& value) const;
+    bool getDouble(double& value) const;
+    bool getBool(bool& value) const;
+    bool isNull() const;
+    // 原始字符串（不含引号、未反转义），无转义字符时可直接使用
+    bool getRawString(std::string_view& value) const;
+    // 反转义后的字符串（支持\uXXXX和代理对）
+    bool getString(std::string& value) const;
+
+private:
+    friend class JsonParser;
+
+    JsonValue(const JsonParser* parser, uint32_t index) : parser_(parser), index_(index) {}
+
+    // 跳过当前值，返回其后第一个结构字符的下标
+    uint32_t skip() const;
+    char tokenChar() const;
+    std::string_view scalarToken() const;
+
+    const JsonParser* parser_;
+    uint32_t index_;
+};
+
+/**
+ * @brief SIMD结构索引JSON解析器（simdjson思路）
+ *
+ * 第一阶段按64字节块扫描输入：AVX2一次比较32字节得到引号、反斜杠、
+ * 结构字符和空白的位掩码（不支持AVX2时逐字节构造同样的掩码），
+ * 再用位运算处理转义、字符串内部区间和标量起点，输出全部结构字符
+ * 的位置；第二阶段一次遍历索引校验括号配对并记录配对下标。
+ * 之后的字段访问都是按需的。
+ *
+ * 解析器可复用，索引数组的容量在多次parse()间保留。
+ * 输入须在JsonValue使用期间保持有效
+ */
+class JsonParser {
+public:
+    static constexpr size_t kMaxDepth = 64;
+    static constexpr size_t kMaxSize = UINT32_MAX - 64;
+
+    explicit JsonParser(bool allow_simd = true);
+
+    bool parse(std::string_view json);
+    JsonValue root() const { return JsonValue(this, 0); }
+    const char* error() const { return error_; }
+
+    // 本次解析是否使用了AVX2
+    bool usedSimd() const { return used_simd_; }
+    // 结构字符位置（测试和基准用）
+    const std::vector<uint32_t>& structurals() const { return structurals_; }
+
+    static bool simdSupported();
+
+private:
+    friend class JsonValue;
+
+    bool buildIndex();
+    bool matchBrackets();
+
+    std::string_view json_;
+    std::vector<uint32_t> structurals_;
+    std::vector<uint32_t> matches_;   // 开括号下标 -> 配对闭括号下标
+    bool allow_simd_;
+    bool used_simd_;
+    const char* error_;
+};
+
+/**
+ * @brief JSON序列化器
+ *
+ * 直接追加到调用方的输出缓冲区（例如HttpResponse::beginBody()返回的
+ * 连接输出缓冲），整数和浮点用to_chars写入，字符串转义时先用AVX2
+ * 找出需要转义的位置，其余部分整段追加
+ */
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) : out_(out), need_comma_(false) {}
+
+    void startObject();
+    void endObject();
+    void startArray();
+    void endArray();
+    void key(std::string_view name);
+
+    void writeString(std::string_view value);
+    void writeUint(uint64_t value);
+    void writeInt(int64_t value);
+    void writeDouble(double value);
+    void writeBool(bool value);
+    void writeNull();
+
+private:
+    void separator();
+
+    std::string& out_;
+    bool need_comma_;
+};
+
+// 追加转义后的字符串内容（不含两侧引号）
+void appendJsonEscaped(std::string& out, std::string_view value);
+
+/**
+ * @brief 从JSON请求体映射到OrderInfo
+ *
+ *     {"user_id": 42, "items": [{"product_id": 1001, "quantity": 2}, ...],
+ *      "total_amount": 199.99, "shipping_address": "...", "payment_method": "..."}
+ *
+ * 也接受product_ids/quantities平行数组的旧格式
+ */
+bool parseOrderInfo(JsonParser& parser, std::string_view json, services::OrderInfo& order,
+                    std::string& error);
+
+void writeOrderInfo(JsonWriter& writer, const services::OrderInfo& order);
+
+const char* orderStatusToString(services::OrderStatus status);
+// orderStatusToString的逆操作，不区分大小写
+bool orderStatusFromString(std::string_view name, services::OrderStatus& status);
+
+} // namespace utils
+} // namespace order_engine
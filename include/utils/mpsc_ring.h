@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace order_engine {
+namespace utils {
+
+/**
+ * @brief 有界多生产者单消费者无锁环形队列
+ *
+ * 每个槽带一个序号（Vyukov有界队列）：生产者CAS抢占写位置后写入数据，
+ * 再发布槽序号；消费者按序号判断槽是否已写好。生产者之间只竞争一个
+ * 原子计数，不加锁也不等待，队列满时tryPush()立即返回false。
+ * T须可平凡复制，容量向上取整到2的幂
+ */
+template <typename T>
+class MpscRing {
+    static_assert(std::is_trivially_copyable_v<T>, "MpscRing stores trivially copyable values");
+
+public:
+    explicit MpscRing(size_t capacity)
+        : mask_(roundUp(capacity) - 1)
+        , cells_(new Cell[mask_ + 1])
+        , tail_(0)
+        , head_(0) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    // 任意线程调用，队列满时返回false
+    bool tryPush(const T& value) {
+        uint64_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            uint64_t sequence = cell.sequence.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // 消费者尚未取走一圈前的数据
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 只能由一个消费者线程调用，队列空时返回false
+    bool tryPop(T& value) {
+        uint64_t pos = head_.load(std::memory_order_relaxed);
+        Cell& cell = cells_[pos & mask_];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+            return false;  // 空，或生产者已占位但尚未写完
+        }
+        value = cell.value;
+        cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+        head_.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // 近似长度（统计用）
+    size_t size() const {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        return tail > head ? static_cast<size_t>(tail - head) : 0;
+    }
+
+private:
+    struct Cell {
+        std::atomic<uint64_t> sequence;
+        T value;
+    };
+
+    static size_t roundUp(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<uint64_t> tail_;   // 生产者竞争
+    alignas(64) std::atomic<uint64_t> head_;   // 只有消费者写
+};
+
+} // namespace utils
+} // namespace order_engine
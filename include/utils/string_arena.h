@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace order_engine {
+namespace utils {
+
+/**
+ * @brief 字符串追加式内存区
+ *
+ * 按块（默认64KB）批量申请内存，字符串依次拷贝进去，返回指向区内的
+ * string_view；单个字符串不能释放，整个内存区随所有者一起释放。
+ * 非线程安全，由所属线程（例如订单簿分片）独占使用
+ */
+class StringArena {
+public:
+    static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+    explicit StringArena(size_t block_size = kDefaultBlockSize)
+        : block_size_(block_size), used_(0), capacity_(0), allocated_bytes_(0), stored_bytes_(0) {}
+
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+
+    // 拷贝到内存区，空串不占空间
+    std::string_view store(std::string_view value);
+
+    // 已申请的总字节数（含块内未用空间）
+    size_t allocatedBytes() const { return allocated_bytes_; }
+    // 已存入的字符串字节数（含所有者已不再引用的）
+    size_t storedBytes() const { return stored_bytes_; }
+
+    // 交换两个内存区的全部内容，已返回的string_view仍指向原来的块
+    void swap(StringArena& other) noexcept;
+
+private:
+    size_t block_size_;
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    size_t used_;       // 当前块已用字节
+    size_t capacity_;   // 当前块大小
+    size_t allocated_bytes_;
+    size_t stored_bytes_;
+};
+
+} // namespace utils
+} // namespace order_engine
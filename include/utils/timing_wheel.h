@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <vector>
+
+namespace order_engine {
+namespace utils {
+
+/**
+ * @brief 分层时间轮（秒级）
+ *
+ * 4层，每层64个槽，覆盖约194天；第L层每个槽跨64^L秒。添加是O(1)的
+ * 追加，推进时第0层到期的槽整槽触发，高层的槽在轮转到时下沉到低层，
+ * 每个条目最多下沉3次。超出范围的条目放在最高层，触发时未到期则重新放入。
+ *
+ * 不支持删除：条目到期时由调用方检查是否仍然有效（惰性删除）。
+ * 不加锁，只能由一个线程使用
+ */
+class TimingWheel {
+public:
+    explicit TimingWheel(time_t now);
+
+    // deadline不晚于当前时间时在下次推进时触发
+    void schedule(uint64_t id, time_t deadline);
+
+    // 推进到now，逐秒对到期的id调用fn（同一秒内不保证顺序），fn中可以再schedule
+    void advance(time_t now, const std::function<void(uint64_t id)>& fn);
+
+    size_t size() const { return size_; }
+    time_t current() const { return static_cast<time_t>(current_); }
+
+private:
+    static constexpr size_t kLevels = 4;
+    static constexpr unsigned kSlotBits = 6;
+    static constexpr size_t kSlots = size_t(1) << kSlotBits;
+
+    struct Entry {
+        uint64_t id;
+        int64_t deadline;
+    };
+
+    void place(const Entry& entry);
+    // 将第level层当前轮到的槽下沉到低层
+    void cascade(size_t level);
+
+    std::array<std::array<std::vector<Entry>, kSlots>, kLevels> slots_;
+    std::vector<Entry> firing_;
+    int64_t current_;   // 已推进到的秒
+    size_t size_;
+};
+
+} // namespace utils
+} // namespace order_engine
@@ -99,11 +99,11 @@ CREATE TABLE IF NOT EXISTS order_items (
     item_id BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT '明细ID',
     order_id BIGINT UNSIGNED NOT NULL COMMENT '订单ID',
     product_id BIGINT UNSIGNED NOT NULL COMMENT '商品ID',
-    product_name VARCHAR(256) NOT NULL COMMENT '商品名称',
-    product_code VARCHAR(64) NOT NULL COMMENT '商品编码',
-    unit_price DECIMAL(10,2) NOT NULL COMMENT '单价',
+    product_name VARCHAR(256) DEFAULT NULL COMMENT '商品名称（商品目录接入前为NULL）',
+    product_code VARCHAR(64) DEFAULT NULL COMMENT '商品编码（商品目录接入前为NULL）',
+    unit_price DECIMAL(10,2) DEFAULT NULL COMMENT '单价（商品目录接入前为NULL）',
     quantity INT UNSIGNED NOT NULL COMMENT '数量',
-    total_price DECIMAL(10,2) NOT NULL COMMENT '小计',
+    total_price DECIMAL(10,2) DEFAULT NULL COMMENT '小计（商品目录接入前为NULL）',
     created_at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP COMMENT '创建时间',
     PRIMARY KEY (item_id),
     KEY idx_order_id (order_id),
@@ -132,31 +132,31 @@ void Logger::critical(const std::string& message) {
 // 简单格式化日志接口实现
 void Logger::debug_fmt(const std::string& format, const std::string& arg) {
     if (logger_) {
-        logger_->debug(format, arg);
+        logger_->debug(fmt::runtime(format), arg);
     }
 }
 
 void Logger::info_fmt(const std::string& format, const std::string& arg) {
     if (logger_) {
-        logger_->info(format, arg);
+        logger_->info(fmt::runtime(format), arg);
     }
 }
 
 void Logger::error_fmt(const std::string& format, const std::string& arg) {
     if (logger_) {
-        logger_->error(format, arg);
+        logger_->error(fmt::runtime(format), arg);
     }
 }
 
 void Logger::debug_fmt(const std::string& format, const std::string& arg1, const std::string& arg2) {
     if (logger_) {
-        logger_->debug(format, arg1, arg2);
+        logger_->debug(fmt::runtime(format), arg1, arg2);
     }
 }
 
 void Logger::info_fmt(const std::string& format, int arg) {
     if (logger_) {
-        logger_->info(format, arg);
+        logger_->info(fmt::runtime(format), arg);
     }
 }
 
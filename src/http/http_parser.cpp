@@ -0,0 +1,258 @@
+#include "http/http_parser.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace order_engine {
+namespace http {
+
+namespace {
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        char x = a[i];
+        char y = b[i];
+        if (x >= 'A' && x <= 'Z') x = static_cast<char>(x - 'A' + 'a');
+        if (y >= 'A' && y <= 'Z') y = static_cast<char>(y - 'A' + 'a');
+        if (x != y) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+Method parseMethod(std::string_view name) {
+    switch (name.size()) {
+        case 3:
+            if (name == "GET") return Method::kGet;
+            if (name == "PUT") return Method::kPut;
+            break;
+        case 4:
+            if (name == "HEAD") return Method::kHead;
+            if (name == "POST") return Method::kPost;
+            break;
+        case 5:
+            if (name == "PATCH") return Method::kPatch;
+            break;
+        case 6:
+            if (name == "DELETE") return Method::kDelete;
+            break;
+        case 7:
+            if (name == "OPTIONS") return Method::kOptions;
+            break;
+        default:
+            break;
+    }
+    return Method::kUnknown;
+}
+
+// 在[data+from, data+len)中查找"\r\n\r\n"，返回头部总长度，未找到返回0
+size_t findHeaderEnd(const char* data, size_t len, size_t from) {
+    size_t start = from >= 3 ? from - 3 : 0;
+    const char* p = data + start;
+    const char* end = data + len;
+    while (p + 4 <= end) {
+        const char* cr = static_cast<const char*>(std::memchr(p, '\r', end - p));
+        if (!cr || cr + 4 > end) {
+            break;
+        }
+        if (cr[1] == '\n' && cr[2] == '\r' && cr[3] == '\n') {
+            return static_cast<size_t>(cr - data) + 4;
+        }
+        p = cr + 1;
+    }
+    return 0;
+}
+
+// 读取一行（不含CRLF），line_end指向下一行开头
+bool nextLine(std::string_view& rest, std::string_view& line) {
+    size_t pos = rest.find("\r\n");
+    if (pos == std::string_view::npos) {
+        return false;
+    }
+    line = rest.substr(0, pos);
+    rest.remove_prefix(pos + 2);
+    return true;
+}
+
+} // namespace
+
+const char* methodToString(Method method) {
+    switch (method) {
+        case Method::kGet:     return "GET";
+        case Method::kHead:    return "HEAD";
+        case Method::kPost:    return "POST";
+        case Method::kPut:     return "PUT";
+        case Method::kDelete:  return "DELETE";
+        case Method::kPatch:   return "PATCH";
+        case Method::kOptions: return "OPTIONS";
+        default:               return "UNKNOWN";
+    }
+}
+
+std::string_view HttpRequest::header(std::string_view name) const {
+    for (size_t i = 0; i < header_count; ++i) {
+        if (equalsIgnoreCase(headers[i].name, name)) {
+            return headers[i].value;
+        }
+    }
+    return std::string_view();
+}
+
+std::string_view HttpRequest::queryParam(std::string_view name) const {
+    std::string_view rest = query;
+    while (!rest.empty()) {
+        size_t amp = rest.find('&');
+        std::string_view pair = rest.substr(0, amp);
+        size_t eq = pair.find('=');
+        if (pair.substr(0, eq) == name) {
+            return eq == std::string_view::npos ? std::string_view() : pair.substr(eq + 1);
+        }
+        if (amp == std::string_view::npos) {
+            break;
+        }
+        rest.remove_prefix(amp + 1);
+    }
+    return std::string_view();
+}
+
+void HttpParser::reset() {
+    scanned_ = 0;
+    header_len_ = 0;
+    body_len_ = 0;
+}
+
+ParseStatus HttpParser::parse(const char* data, size_t len, HttpRequest& request, size_t& consumed) {
+    consumed = 0;
+
+    bool head_parsed = false;
+    if (header_len_ == 0) {
+        size_t header_len = findHeaderEnd(data, std::min(len, kMaxHeaderSize), scanned_);
+        if (header_len == 0) {
+            if (len >= kMaxHeaderSize) {
+                return ParseStatus::kHeadersTooLarge;
+            }
+            scanned_ = len;
+            return ParseStatus::kNeedMore;
+        }
+
+        ParseStatus status = parseHead(data, header_len, request);
+        if (status != ParseStatus::kComplete) {
+            return status;
+        }
+        header_len_ = header_len;
+        head_parsed = true;
+    }
+
+    if (len < header_len_ + body_len_) {
+        return ParseStatus::kNeedMore;
+    }
+
+    // 头部在之前的调用中解析过：缓冲区可能已搬移，重新生成视图
+    if (!head_parsed) {
+        size_t body_len = body_len_;
+        ParseStatus status = parseHead(data, header_len_, request);
+        if (status != ParseStatus::kComplete || body_len_ != body_len) {
+            return ParseStatus::kBadRequest;
+        }
+    }
+
+    request.body = std::string_view(data + header_len_, body_len_);
+    consumed = header_len_ + body_len_;
+    reset();
+    return ParseStatus::kComplete;
+}
+
+ParseStatus HttpParser::parseHead(const char* data, size_t header_len, HttpRequest& request) {
+    std::string_view rest(data, header_len);
+    std::string_view line;
+
+    // 容忍请求之间多余的空行（RFC 7230 3.5）
+    while (rest.size() >= 2 && rest[0] == '\r' && rest[1] == '\n') {
+        rest.remove_prefix(2);
+    }
+
+    // 请求行：METHOD SP target SP HTTP/1.x
+    if (!nextLine(rest, line)) {
+        return ParseStatus::kBadRequest;
+    }
+    size_t sp1 = line.find(' ');
+    size_t sp2 = line.rfind(' ');
+    if (sp1 == std::string_view::npos || sp2 == sp1) {
+        return ParseStatus::kBadRequest;
+    }
+    std::string_view method = line.substr(0, sp1);
+    std::string_view target = line.substr(sp1 + 1, sp2 - sp1 - 1);
+    std::string_view version = line.substr(sp2 + 1);
+    if (target.empty() || version.size() != 8 || version.substr(0, 7) != "HTTP/1." ||
+        version[7] < '0' || version[7] > '9') {
+        return ParseStatus::kBadRequest;
+    }
+
+    request.method = parseMethod(method);
+    if (request.method == Method::kUnknown) {
+        return ParseStatus::kNotImplemented;
+    }
+    request.target = target;
+    size_t question = target.find('?');
+    request.path = target.substr(0, question);
+    request.query = question == std::string_view::npos ? std::string_view() : target.substr(question + 1);
+    request.version_minor = version[7] - '0';
+    request.header_count = 0;
+    request.body = std::string_view();
+
+    bool has_length = false;
+    bool close = false;
+    bool keep_alive = false;
+    body_len_ = 0;
+
+    while (nextLine(rest, line) && !line.empty()) {
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos || colon == 0) {
+            return ParseStatus::kBadRequest;
+        }
+        if (request.header_count == HttpRequest::kMaxHeaders) {
+            return ParseStatus::kHeadersTooLarge;
+        }
+        HttpHeader& header = request.headers[request.header_count++];
+        header.name = line.substr(0, colon);
+        header.value = trim(line.substr(colon + 1));
+
+        if (equalsIgnoreCase(header.name, "Content-Length")) {
+            size_t length = 0;
+            auto result = std::from_chars(header.value.data(), header.value.data() + header.value.size(), length);
+            if (result.ec != std::errc() || result.ptr != header.value.data() + header.value.size() ||
+                (has_length && length != body_len_)) {
+                return ParseStatus::kBadRequest;
+            }
+            if (length > kMaxBodySize) {
+                return ParseStatus::kBodyTooLarge;
+            }
+            has_length = true;
+            body_len_ = length;
+        } else if (equalsIgnoreCase(header.name, "Transfer-Encoding")) {
+            if (!equalsIgnoreCase(header.value, "identity")) {
+                return ParseStatus::kNotImplemented;
+            }
+        } else if (equalsIgnoreCase(header.name, "Connection")) {
+            close = equalsIgnoreCase(header.value, "close");
+            keep_alive = equalsIgnoreCase(header.value, "keep-alive");
+        }
+    }
+
+    // HTTP/1.1默认长连接，HTTP/1.0需显式keep-alive
+    request.keep_alive = request.version_minor >= 1 ? !close : keep_alive;
+    return ParseStatus::kComplete;
+}
+
+} // namespace http
+} // namespace order_engine
@@ -0,0 +1,174 @@
+#include "http/http_response.h"
+#include "network/tcp_connection.h"
+#include "network/channel.h"
+#include <charconv>
+#include <cstring>
+
+namespace order_engine {
+namespace http {
+
+namespace {
+
+// Content-Length占位宽度（十进制位数），足够表示kMaxBodySize以上的长度
+const size_t kLengthFieldWidth = 10;
+
+void appendNumber(std::string& out, size_t value, int base = 10) {
+    char buf[24];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value, base);
+    out.append(buf, result.ptr - buf);
+}
+
+} // namespace
+
+HttpResponse::HttpResponse(std::string& out, network::TcpConnection* conn, bool keep_alive, bool head_only)
+    : out_(out)
+    , conn_(conn)
+    , keep_alive_(keep_alive)
+    , head_only_(head_only)
+    , status_(200)
+    , head_written_(false)
+    , chunked_(false)
+    , finished_(false)
+    , length_offset_(0)
+    , body_offset_(0) {
+}
+
+void HttpResponse::setStatus(int code) {
+    if (!head_written_) {
+        status_ = code;
+    }
+}
+
+void HttpResponse::addHeader(std::string_view name, std::string_view value) {
+    writeStatusLine();
+    out_.append(name);
+    out_.append(": ");
+    out_.append(value);
+    out_.append("\r\n");
+}
+
+void HttpResponse::send(std::string_view body, std::string_view content_type) {
+    if (finished_ || chunked_ || length_offset_ != 0) {
+        return;
+    }
+    writeStatusLine();
+    writeCommonHeaders(content_type);
+    out_.append("Content-Length: ");
+    appendNumber(out_, body.size());
+    out_.append("\r\n\r\n");
+    if (!head_only_) {
+        out_.append(body);
+    }
+    finished_ = true;
+}
+
+void HttpResponse::beginChunked(std::string_view content_type) {
+    if (finished_ || chunked_ || length_offset_ != 0) {
+        return;
+    }
+    writeStatusLine();
+    writeCommonHeaders(content_type);
+    out_.append("Transfer-Encoding: chunked\r\n\r\n");
+    chunked_ = true;
+}
+
+void HttpResponse::writeChunk(std::string_view data) {
+    // 空块表示结束，不能在这里写出
+    if (!chunked_ || finished_ || head_only_ || data.empty()) {
+        return;
+    }
+    appendNumber(out_, data.size(), 16);
+    out_.append("\r\n");
+    out_.append(data);
+    out_.append("\r\n");
+
+    if (conn_ && out_.size() >= kFlushThreshold) {
+        conn_->send(out_);
+        out_.clear();
+    }
+}
+
+void HttpResponse::endChunked() {
+    if (!chunked_ || finished_) {
+        return;
+    }
+    if (!head_only_) {
+        out_.append("0\r\n\r\n");
+    }
+    finished_ = true;
+}
+
+std::string& HttpResponse::beginBody(std::string_view content_type) {
+    if (!finished_ && !chunked_ && length_offset_ == 0) {
+        writeStatusLine();
+        writeCommonHeaders(content_type);
+        out_.append("Content-Length: ");
+        length_offset_ = out_.size();
+        out_.append(kLengthFieldWidth, '0');
+        out_.append("\r\n\r\n");
+        body_offset_ = out_.size();
+    }
+    return out_;
+}
+
+void HttpResponse::endBody() {
+    if (finished_ || length_offset_ == 0) {
+        return;
+    }
+    // 前导零补齐到定宽，1*DIGIT语法允许
+    size_t length = out_.size() - body_offset_;
+    char digits[kLengthFieldWidth];
+    std::memset(digits, '0', sizeof(digits));
+    for (size_t i = kLengthFieldWidth; i > 0 && length > 0; --i, length /= 10) {
+        digits[i - 1] = static_cast<char>('0' + length % 10);
+    }
+    out_.replace(length_offset_, kLengthFieldWidth, digits, kLengthFieldWidth);
+    if (head_only_) {
+        out_.resize(body_offset_);
+    }
+    finished_ = true;
+}
+
+void HttpResponse::writeStatusLine() {
+    if (head_written_) {
+        return;
+    }
+    out_.append("HTTP/1.1 ");
+    appendNumber(out_, static_cast<size_t>(status_));
+    out_.push_back(' ');
+    out_.append(reasonPhrase(status_));
+    out_.append("\r\n");
+    head_written_ = true;
+}
+
+void HttpResponse::writeCommonHeaders(std::string_view content_type) {
+    out_.append("Content-Type: ");
+    out_.append(content_type);
+    out_.append("\r\n");
+    if (!keep_alive_) {
+        out_.append("Connection: close\r\n");
+    }
+}
+
+const char* HttpResponse::reasonPhrase(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 201: return "Created";
+        case 202: return "Accepted";
+        case 204: return "No Content";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 422: return "Unprocessable Entity";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        default:  return "Unknown";
+    }
+}
+
+} // namespace http
+} // namespace order_engine
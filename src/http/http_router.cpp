@@ -0,0 +1,178 @@
+#include "http/http_router.h"
+
+namespace order_engine {
+namespace http {
+
+namespace {
+
+// 取出下一个路径段，rest前进到段之后（不含'/'）
+std::string_view nextSegment(std::string_view& rest) {
+    while (!rest.empty() && rest.front() == '/') {
+        rest.remove_prefix(1);
+    }
+    size_t slash = rest.find('/');
+    std::string_view segment = rest.substr(0, slash);
+    rest.remove_prefix(slash == std::string_view::npos ? rest.size() : slash);
+    return segment;
+}
+
+} // namespace
+
+struct HttpRouter::Node {
+    std::string segment;
+    std::vector<std::unique_ptr<Node>> children;
+    std::unique_ptr<Node> param_child;
+    std::unique_ptr<Node> wildcard_child;
+    std::string param_name;
+    Handler handlers[kMethodCount];
+
+    bool hasHandler() const {
+        for (const auto& handler : handlers) {
+            if (handler) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+std::string_view RouteParams::get(std::string_view name) const {
+    for (size_t i = 0; i < count_; ++i) {
+        if (params_[i].name == name) {
+            return params_[i].value;
+        }
+    }
+    return std::string_view();
+}
+
+bool RouteParams::push(std::string_view name, std::string_view value) {
+    if (count_ == kMaxParams) {
+        return false;
+    }
+    params_[count_++] = Param{name, value};
+    return true;
+}
+
+HttpRouter::HttpRouter() : root_(std::make_unique<Node>()) {}
+
+HttpRouter::~HttpRouter() = default;
+
+bool HttpRouter::addRoute(Method method, std::string_view pattern, Handler handler) {
+    if (method == Method::kUnknown || !handler || pattern.empty() || pattern.front() != '/') {
+        return false;
+    }
+
+    Node* node = root_.get();
+    std::string_view rest = pattern;
+    size_t param_count = 0;
+    while (true) {
+        std::string_view segment = nextSegment(rest);
+        if (segment.empty()) {
+            break;
+        }
+
+        if (segment.front() == ':' || segment.front() == '*') {
+            bool wildcard = segment.front() == '*';
+            std::string_view name = segment.substr(1);
+            if (name.empty() || ++param_count > RouteParams::kMaxParams ||
+                (wildcard && !nextSegment(rest).empty())) {
+                return false;
+            }
+            auto& child = wildcard ? node->wildcard_child : node->param_child;
+            if (!child) {
+                child = std::make_unique<Node>();
+                child->param_name.assign(name);
+            } else if (child->param_name != name) {
+                // 同一位置的参数名必须一致
+                return false;
+            }
+            node = child.get();
+            continue;
+        }
+
+        Node* next = nullptr;
+        for (auto& child : node->children) {
+            if (child->segment == segment) {
+                next = child.get();
+                break;
+            }
+        }
+        if (!next) {
+            node->children.push_back(std::make_unique<Node>());
+            next = node->children.back().get();
+            next->segment.assign(segment);
+        }
+        node = next;
+    }
+
+    Handler& slot = node->handlers[static_cast<size_t>(method)];
+    if (slot) {
+        return false;
+    }
+    slot = std::move(handler);
+    return true;
+}
+
+HttpRouter::MatchResult HttpRouter::match(Method method, std::string_view path, const Handler*& handler,
+                                          RouteParams& params) const {
+    handler = nullptr;
+    params.count_ = 0;
+    if (method == Method::kUnknown) {
+        return MatchResult::kMethodNotAllowed;
+    }
+
+    const Node* node = matchNode(root_.get(), path, params);
+    if (!node) {
+        return MatchResult::kNotFound;
+    }
+
+    const Handler* found = &node->handlers[static_cast<size_t>(method)];
+    if (!*found && method == Method::kHead) {
+        found = &node->handlers[static_cast<size_t>(Method::kGet)];
+    }
+    if (!*found) {
+        return MatchResult::kMethodNotAllowed;
+    }
+    handler = found;
+    return MatchResult::kMatched;
+}
+
+const HttpRouter::Node* HttpRouter::matchNode(const Node* node, std::string_view rest, RouteParams& params) const {
+    std::string_view remaining = rest;
+    std::string_view segment = nextSegment(remaining);
+    if (segment.empty()) {
+        return node->hasHandler() ? node : nullptr;
+    }
+
+    for (const auto& child : node->children) {
+        if (child->segment == segment) {
+            if (const Node* found = matchNode(child.get(), remaining, params)) {
+                return found;
+            }
+            break;
+        }
+    }
+
+    size_t saved = params.count_;
+    if (node->param_child && params.push(node->param_child->param_name, segment)) {
+        if (const Node* found = matchNode(node->param_child.get(), remaining, params)) {
+            return found;
+        }
+        params.count_ = saved;
+    }
+
+    if (node->wildcard_child && node->wildcard_child->hasHandler()) {
+        // 通配段捕获从当前段开始的剩余路径
+        std::string_view tail = rest;
+        while (!tail.empty() && tail.front() == '/') {
+            tail.remove_prefix(1);
+        }
+        if (params.push(node->wildcard_child->param_name, tail)) {
+            return node->wildcard_child.get();
+        }
+    }
+    return nullptr;
+}
+
+} // namespace http
+} // namespace order_engine
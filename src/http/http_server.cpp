@@ -0,0 +1,118 @@
+#include "http/http_server.h"
+#include "common/logger.h"
+
+namespace order_engine {
+namespace http {
+
+HttpServer::HttpServer(const std::string& ip, uint16_t port, int thread_num)
+    : server_(std::make_unique<network::TcpServer>(ip, port, thread_num))
+    , request_count_(0) {
+    server_->setBufferCallback([this](const network::TcpConnectionPtr& conn, const char* data, size_t len) {
+        return this->handleData(conn, data, len);
+    });
+}
+
+HttpServer::~HttpServer() {
+    stop();
+}
+
+bool HttpServer::start() {
+    return server_->start();
+}
+
+void HttpServer::stop() {
+    server_->stop();
+}
+
+size_t HttpServer::handleData(const network::TcpConnectionPtr& conn, const char* data, size_t len) {
+    // 解析进度挂在连接上，响应缓冲区按Reactor线程复用
+    std::any& context = conn->getContext();
+    HttpParser* parser = std::any_cast<HttpParser>(&context);
+    if (!parser) {
+        context = HttpParser();
+        parser = std::any_cast<HttpParser>(&context);
+    }
+
+    static thread_local std::string out;
+    static thread_local HttpRequest request;
+    out.clear();
+
+    size_t consumed = 0;
+    bool close = false;
+    while (consumed < len && !close) {
+        size_t n = 0;
+        ParseStatus status = parser->parse(data + consumed, len - consumed, request, n);
+        if (status == ParseStatus::kNeedMore) {
+            break;
+        }
+
+        if (status != ParseStatus::kComplete) {
+            // 请求边界已不可信，回复错误后关闭
+            HttpResponse response(out, conn.get(), false, false);
+            response.setStatus(statusForParseError(status));
+            response.send(HttpResponse::reasonPhrase(response.status()));
+            parser->reset();
+            consumed = len;
+            close = true;
+            break;
+        }
+
+        consumed += n;
+        request_count_.fetch_add(1, std::memory_order_relaxed);
+
+        HttpResponse response(out, conn.get(), request.keep_alive, request.method == Method::kHead);
+        dispatch(request, response);
+        if (!response.isFinished()) {
+            LOG_ERROR("HTTP handler did not finish response: " + std::string(request.path));
+            response.setStatus(500);
+            response.send("handler did not respond");
+        }
+        close = !request.keep_alive;
+    }
+
+    if (!out.empty()) {
+        conn->send(out);
+    }
+    if (close) {
+        conn->shutdown();
+    }
+    return consumed;
+}
+
+void HttpServer::dispatch(const HttpRequest& request, HttpResponse& response) {
+    const HttpRouter::Handler* handler = nullptr;
+    RouteParams params;
+    switch (router_.match(request.method, request.path, handler, params)) {
+        case HttpRouter::MatchResult::kMatched:
+            try {
+                (*handler)(request, params, response);
+            } catch (const std::exception& e) {
+                LOG_ERROR("HTTP handler error: " + std::string(e.what()));
+                if (!response.isFinished()) {
+                    response.setStatus(500);
+                    response.send("internal error");
+                }
+            }
+            break;
+        case HttpRouter::MatchResult::kMethodNotAllowed:
+            response.setStatus(405);
+            response.send("method not allowed");
+            break;
+        case HttpRouter::MatchResult::kNotFound:
+            response.setStatus(404);
+            response.send("not found");
+            break;
+    }
+}
+
+int HttpServer::statusForParseError(ParseStatus status) {
+    switch (status) {
+        case ParseStatus::kHeadersTooLarge: return 431;
+        case ParseStatus::kBodyTooLarge:    return 413;
+        case ParseStatus::kNotImplemented:  return 501;
+        default:                            return 400;
+    }
+}
+
+} // namespace http
+} // namespace order_engine
@@ -1,14 +1,36 @@
 #include <iostream>
 #include <signal.h>
 #include <memory>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+#include <latch>
+#include <unistd.h>
 #include "common/logger.h"
 #include "common/config.h"
 #include "network/tcp_server.h"
+#include "network/socket_handoff.h"
+#include "rpc/grpc_server.h"
+#include "http/http_server.h"
+#include "utils/json_utils.h"
+#include "protocol/order_protocol.h"
+#include "protocol/protobuf_codec.h"
+#include "order.pb.h"
 #include "services/order_service.h"
 #include "services/inventory_service.h"
+#include "services/idempotency_cache.h"
+#include "services/order_metrics.h"
+#include "services/order_placement.h"
+#include "services/order_store.h"
+#include "storage/order_archive.h"
+#include "storage/order_journal.h"
+#include "storage/persistence_batcher.h"
+#include "message/order_event_pipeline.h"
+#ifdef ORDER_ENGINE_WITH_KAFKA
+#include "message/kafka_producer.h"
+#endif
 // #include "database/connection_pool.h"  // TODO: 待实现
 // #include "cache/cache_manager.h"       // TODO: 待实现  
-// #include "message/kafka_producer.h"    // TODO: 待实现
 
 using namespace order_engine;
 
@@ -16,7 +38,7 @@ class OrderEngineApplication {
 public:
     OrderEngineApplication() : running_(true) {}
     
-    bool initialize(const std::string& config_file) {
+    bool initialize(const std::string& config_file, bool hot_restart = false) {
         // 初始化日志系统
         if (!common::Logger::getInstance().initialize(config_file)) {
             std::cerr << "Failed to initialize logger" << std::endl;
@@ -41,8 +63,86 @@ public:
         // TODO: 初始化Kafka生产者 (暂时跳过)
         LOG_INFO("Kafka producer initialization skipped in Phase 1");
         
-        // TODO: 初始化业务服务 (暂时跳过)
-        LOG_INFO("Business services initialization skipped in Phase 1");
+        // 初始化业务服务（Phase 1: 内存存储，数据库/缓存/消息队列接入前为空）
+        inventory_service_ = std::make_shared<services::InventoryService>(nullptr, nullptr,
+            static_cast<size_t>(config_->getInt("business.inventory_table_capacity",
+                static_cast<int>(services::InventoryService::kDefaultTableCapacity))));
+        inventory_service_->setHotStockThreshold(
+            static_cast<uint32_t>(config_->getInt("business.hot_stock_contention", 1000)));
+        order_service_ = std::make_shared<services::OrderService>();
+        order_service_->setInventoryService(inventory_service_);
+        
+        // 预写日志：订单变更落盘后才应答。日志、归档在openStorage()中打开，
+        // 热重启时推迟到旧进程交出日志之后
+        if (config_->getBool("journal.enabled", true)) {
+            storage::JournalOptions journal_options;
+            journal_options.dir = config_->getString("journal.dir", journal_options.dir);
+            journal_options.segment_size = static_cast<size_t>(
+                config_->getInt("journal.segment_size_mb", 64)) * 1024 * 1024;
+            journal_options.commit_interval_us = config_->getInt("journal.commit_interval_us",
+                                                                 journal_options.commit_interval_us);
+            journal_options.max_batch_bytes = static_cast<size_t>(
+                config_->getInt("journal.max_batch_kb", 1024)) * 1024;
+            journal_options.sync = config_->getBool("journal.sync", true);
+            journal_ = std::make_shared<storage::OrderJournal>(journal_options);
+            order_service_->setJournal(journal_);
+            snapshot_dir_ = config_->getString("journal.snapshot_dir", "./data/snapshot");
+            snapshot_interval_ = config_->getInt("journal.snapshot_interval", 300);
+        }
+        
+        // 冷归档：已结束超过after_days天的订单移入列式段文件，只读查询
+        if (config_->getBool("archive.enabled", true)) {
+            storage::ArchiveOptions archive_options;
+            archive_options.dir = config_->getString("archive.dir", archive_options.dir);
+            archive_options.block_rows = static_cast<uint32_t>(config_->getInt(
+                "archive.block_rows", static_cast<int>(archive_options.block_rows)));
+            archive_ = std::make_shared<storage::OrderArchive>(archive_options);
+            archive_after_days_ = config_->getInt("archive.after_days", 90);
+            archive_interval_ = config_->getInt("archive.interval", 3600);
+            order_service_->setArchive(archive_);
+        }
+        // TODO: 数据库连接池接入后创建批量持久化器 (Phase 2)
+        //   PersistenceOptions{database.batch_max_delay_ms, database.batch_max_rows,
+        //   database.batch_retry_delay_ms, database.batch_max_retry_delay_ms, database.batch_max_attempts,
+        //   database.batch_max_pending, database.dead_letter_file}，
+        //   执行器从连接池取连接，BEGIN/逐条执行/COMMIT，然后setPersistenceBatcher()
+        order_service_->setOrderTimeout(config_->getInt("business.order_timeout", 1800));
+        order_service_->setInventoryReserveTimeout(config_->getInt("business.inventory_reserve_timeout", 1860));
+        if (config_->getBool("business.staged_placement", true)) {
+            services::PlacementOptions placement_options;
+            placement_options.queue_capacity = static_cast<size_t>(config_->getInt(
+                "business.placement_queue_size", static_cast<int>(placement_options.queue_capacity)));
+            placement_options.max_batch = static_cast<size_t>(config_->getInt(
+                "business.placement_max_batch", static_cast<int>(placement_options.max_batch)));
+            placement_options.persist_workers = static_cast<size_t>(config_->getInt(
+                "business.placement_persist_workers", static_cast<int>(placement_options.persist_workers)));
+            order_service_->enableStagedPlacement(placement_options);
+        }
+        
+        // 订单事件发布流水线
+        if (!initEventPipeline()) {
+            return false;
+        }
+        
+        // 创建订单幂等键去重（Idempotency-Key请求头）
+        services::IdempotencyOptions idempotency_options;
+        idempotency_options.ttl_seconds = config_->getInt("business.idempotency_ttl", idempotency_options.ttl_seconds);
+        idempotency_options.capacity = static_cast<size_t>(
+            config_->getInt("business.idempotency_capacity", static_cast<int>(idempotency_options.capacity)));
+        if (idempotency_options.ttl_seconds > 0) {
+            idempotency_cache_ = std::make_shared<services::IdempotencyCache>(idempotency_options);
+            order_service_->setIdempotencyCache(idempotency_cache_);
+        }
+        if (!inventory_service_->initialize() ||
+            !order_service_->initialize(config_->getInt("business.order_store_shards", 0),
+                                        config_->getInt("server.node_id", 0))) {
+            LOG_ERROR("Failed to initialize business services");
+            return false;
+        }
+        
+        if (!hot_restart && !openStorage()) {
+            return false;
+        }
         
         // 初始化TCP服务器
         std::string server_ip = config_->getString("server.ip", "0.0.0.0");
@@ -51,20 +151,57 @@ public:
         
         tcp_server_ = std::make_shared<network::TcpServer>(server_ip, server_port, thread_num);
         
-        // 设置消息处理回调
-        tcp_server_->setMessageCallback([this](const network::TcpConnectionPtr& conn, const std::string& message) {
-            this->handleMessage(conn, message);
+        // 设置协议分帧回调：就地解码缓冲区中的完整帧
+        tcp_server_->setBufferCallback([this](const network::TcpConnectionPtr& conn, const char* data, size_t len) {
+            return this->handleData(conn, data, len);
         });
         
         tcp_server_->setConnectionCallback([this](const network::TcpConnectionPtr& conn) {
             this->handleConnection(conn);
         });
         
+        // 初始化gRPC服务器（内部调用方），与TCP协议共用业务服务
+        if (config_->getBool("grpc.enabled", true)) {
+            grpc_server_ = std::make_unique<rpc::GrpcServer>(
+                config_->getString("grpc.ip", "0.0.0.0"),
+                config_->getInt("grpc.port", 50051),
+                config_->getInt("grpc.completion_queues", 0),
+                order_service_, inventory_service_);
+        }
+        
+        // 初始化HTTP服务：REST接口、Prometheus指标、健康检查
+        initializeHttp();
+        
+        // 热重启：从旧进程接管监听socket和空闲连接
+        handoff_ = std::make_unique<network::SocketHandoff>(
+            config_->getString("server.hot_restart_socket", "/tmp/order_engine_handoff.sock"));
+        hot_restart_ = hot_restart;
+        if (hot_restart_) {
+            network::HandoffFds fds;
+            if (!handoff_->requestFrom(fds, config_->getInt("server.handoff_timeout_ms", 5000)) ||
+                fds.listen_fds.empty()) {
+                LOG_ERROR("Hot restart failed: no listen fd received from old process");
+                return false;
+            }
+            tcp_server_->adoptListenFd(fds.listen_fds[0]);
+            for (size_t i = 1; i < fds.listen_fds.size(); ++i) {
+                ::close(fds.listen_fds[i]);
+            }
+            inherited_connections_ = fds.connection_fds;
+        }
+        
         LOG_INFO("OrderEngine Application initialized successfully");
         return true;
     }
     
     void run() {
+        // 热重启：确认交接后旧进程停止写入并交出日志，本进程随即恢复订单簿并开始
+        // 服务，旧进程之后才排空存量连接；期间到达的新连接留在监听队列中
+        if (hot_restart_ && !takeOverStorage()) {
+            LOG_ERROR("Hot restart failed: could not take over order storage");
+            return;
+        }
+        
         // 注册信号处理
         signal(SIGINT, [](int) { 
             std::cout << "\nReceived SIGINT, shutting down..." << std::endl;
@@ -80,16 +217,56 @@ public:
             return;
         }
         
+        if (grpc_server_ && !grpc_server_->start()) {
+            LOG_ERROR("Failed to start gRPC server");
+            return;
+        }
+        
+        for (auto& http_server : http_servers_) {
+            if (!http_server->start()) {
+                LOG_ERROR("Failed to start HTTP server");
+                return;
+            }
+        }
+        
+        // 热重启：接管连接
+        if (hot_restart_) {
+            for (int fd : inherited_connections_) {
+                tcp_server_->adoptConnection(fd);
+            }
+            inherited_connections_.clear();
+        }
+        
+        // 等待下一次热重启的交接请求
+        bool handoff_enabled = handoff_->startListening();
+        
         LOG_INFO("OrderEngine Application started successfully");
         
         // 主循环
         while (running_) {
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            if (handoff_enabled) {
+                if (handoff_->hasPendingRequest(1000)) {
+                    handleHotRestart();
+                    continue;
+                }
+            } else {
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+            }
             
             // 打印统计信息
             if (++stats_counter_ % 60 == 0) {  // 每分钟打印一次
                 printStats();
             }
+            
+            // 定期快照，缩短重启时需要回放的日志
+            if (journal_ && snapshot_interval_ > 0 && stats_counter_ % snapshot_interval_ == 0) {
+                order_service_->writeSnapshot(snapshot_dir_);
+            }
+            
+            // 定期把已结束的旧订单移入冷归档
+            if (archive_ && archive_interval_ > 0 && stats_counter_ % archive_interval_ == 0) {
+                order_service_->archiveClosedOrders(time(nullptr) - static_cast<time_t>(archive_after_days_) * 86400);
+            }
         }
         
         LOG_INFO("OrderEngine Application shutting down...");
@@ -101,12 +278,1017 @@ public:
     }
 
 private:
-    void handleMessage(const network::TcpConnectionPtr& conn, const std::string& message) {
-        LOG_DEBUG_FMT2("Received message from {}: {}", conn->getPeerAddress(), message);
+    void initializeHttp() {
+        if (config_->getBool("http.enabled", true)) {
+            auto api = std::make_unique<http::HttpServer>(
+                config_->getString("http.ip", "0.0.0.0"),
+                config_->getInt("http.port", 8088),
+                config_->getInt("http.thread_num", 2));
+            api->router().addRoute(http::Method::kPost, "/api/v1/orders",
+                [this](const http::HttpRequest& request, const http::RouteParams&, http::HttpResponse& response) {
+                    handleCreateOrder(request, response);
+                });
+            api->router().addRoute(http::Method::kGet, "/api/v1/orders/:id",
+                [this](const http::HttpRequest&, const http::RouteParams& params, http::HttpResponse& response) {
+                    handleGetOrder(params, response);
+                });
+            api->router().addRoute(http::Method::kPost, "/api/v1/orders/:id/cancel",
+                [this](const http::HttpRequest& request, const http::RouteParams& params, http::HttpResponse& response) {
+                    handleCancelOrder(request, params, response);
+                });
+            api->router().addRoute(http::Method::kGet, "/api/v1/orders/status/:status",
+                [this](const http::HttpRequest& request, const http::RouteParams& params, http::HttpResponse& response) {
+                    handleGetOrdersByStatus(request, params, response);
+                });
+            api->router().addRoute(http::Method::kGet, "/api/v1/orders/status/:status/count",
+                [this](const http::HttpRequest& request, const http::RouteParams& params, http::HttpResponse& response) {
+                    handleCountOrdersByStatus(request, params, response);
+                });
+            api->router().addRoute(http::Method::kPost, "/api/v1/admin/inventory/:id/hot",
+                [this](const http::HttpRequest&, const http::RouteParams& params, http::HttpResponse& response) {
+                    handleEnableHotStock(params, response);
+                });
+            api->router().addRoute(http::Method::kGet, "/api/v1/users/:id/orders",
+                [this](const http::HttpRequest& request, const http::RouteParams& params, http::HttpResponse& response) {
+                    handleGetUserOrders(request, params, response);
+                });
+            if (archive_) {
+                api->router().addRoute(http::Method::kGet, "/api/v1/users/:id/orders/archive",
+                    [this](const http::HttpRequest& request, const http::RouteParams& params,
+                           http::HttpResponse& response) {
+                        handleGetArchivedUserOrders(request, params, response);
+                    });
+                api->router().addRoute(http::Method::kGet, "/api/v1/archive/summary",
+                    [this](const http::HttpRequest& request, const http::RouteParams&, http::HttpResponse& response) {
+                        handleArchiveSummary(request, response);
+                    });
+            }
+            http_servers_.push_back(std::move(api));
+        }
+        
+        if (config_->getBool("monitoring.metrics_enabled", true)) {
+            auto metrics = std::make_unique<http::HttpServer>(
+                "0.0.0.0", config_->getInt("monitoring.metrics_port", 9100));
+            metrics->router().addRoute(http::Method::kGet,
+                config_->getString("monitoring.prometheus_endpoint", "/metrics"),
+                [this](const http::HttpRequest&, const http::RouteParams&, http::HttpResponse& response) {
+                    writeMetrics(response);
+                });
+            http_servers_.push_back(std::move(metrics));
+        }
+        
+        if (config_->getBool("monitoring.health_check_enabled", true)) {
+            auto health = std::make_unique<http::HttpServer>(
+                "0.0.0.0", config_->getInt("monitoring.health_check_port", 8081));
+            health->router().addRoute(http::Method::kGet, "/health",
+                [](const http::HttpRequest&, const http::RouteParams&, http::HttpResponse& response) {
+                    response.send("ok");
+                });
+            health->router().addRoute(http::Method::kGet, "/ready",
+                [this](const http::HttpRequest&, const http::RouteParams&, http::HttpResponse& response) {
+                    if (!tcp_server_->isRunning()) {
+                        response.setStatus(503);
+                        response.send("not ready");
+                        return;
+                    }
+                    response.send("ready");
+                });
+            http_servers_.push_back(std::move(health));
+        }
+    }
+    
+    // 输出端由kafka.event_sink选择：kafka、file（本地分段文件）或none
+    bool initEventPipeline() {
+        std::string sink_type = config_->getString("kafka.event_sink", "file");
+        std::shared_ptr<message::EventSink> sink;
+        if (sink_type == "kafka") {
+#ifdef ORDER_ENGINE_WITH_KAFKA
+            message::KafkaConfig kafka_config;
+            kafka_config.brokers = config_->getString("kafka.brokers", kafka_config.brokers);
+            kafka_config.client_id = config_->getString("kafka.client_id", kafka_config.client_id);
+            kafka_config.compression_type = config_->getString("kafka.compression_type",
+                                                               kafka_config.compression_type);
+            kafka_config.batch_size = config_->getInt("kafka.batch_size", kafka_config.batch_size);
+            kafka_config.linger_ms = config_->getInt("kafka.linger_ms", kafka_config.linger_ms);
+            kafka_config.retries = config_->getInt("kafka.retries", kafka_config.retries);
+            kafka_config.request_timeout_ms = config_->getInt("kafka.request_timeout_ms",
+                                                              kafka_config.request_timeout_ms);
+            kafka_config.max_in_flight_requests = config_->getInt("kafka.max_in_flight_requests",
+                                                                  kafka_config.max_in_flight_requests);
+            auto producer = std::make_shared<message::KafkaProducer>(kafka_config);
+            if (!producer->connect()) {
+                LOG_ERROR("Failed to connect Kafka producer");
+                return false;
+            }
+            sink = producer;
+#else
+            LOG_ERROR("Built without Kafka support, writing order events to local files");
+            sink_type = "file";
+#endif
+        }
+        if (sink_type == "file") {
+            sink = std::make_shared<message::FileEventSink>(config_->getString("kafka.event_dir", "./data/events"));
+        }
+        if (!sink) {
+            return true;
+        }
+        
+        message::EventPipelineOptions options;
+        options.topic = config_->getString("kafka.order_events_topic", options.topic);
+        options.ring_capacity = static_cast<size_t>(
+            config_->getInt("kafka.event_queue_size", static_cast<int>(options.ring_capacity)));
+        options.partitions = static_cast<uint32_t>(
+            config_->getInt("kafka.event_partitions", static_cast<int>(options.partitions)));
+        options.batch_bytes = static_cast<size_t>(
+            config_->getInt("kafka.batch_size", static_cast<int>(options.batch_bytes)));
+        options.linger_ms = config_->getInt("kafka.linger_ms", options.linger_ms);
+        event_pipeline_ = std::make_shared<message::OrderEventPipeline>(sink, options);
+        event_pipeline_->start();
+        order_service_->setEventPipeline(event_pipeline_);
+        LOG_INFO("Order event pipeline started: " + sink_type);
+        return true;
+    }
+    
+    // REST处理函数：JSON直接序列化到连接输出缓冲，返回前须写好响应
+    void handleCreateOrder(const http::HttpRequest& request, http::HttpResponse& response) {
+        // 每个HTTP工作线程复用一个解析器，结构索引的容量跨请求保留
+        static thread_local utils::JsonParser parser;
+        services::OrderInfo order{};
+        std::string error;
+        if (!utils::parseOrderInfo(parser, request.body, order, error)) {
+            writeJsonError(response, 400, error);
+            return;
+        }
+        // 客户端超时重试时带相同的Idempotency-Key，返回首次创建的订单。
+        // 分级下单和挂到进行中请求上的重试都在其他线程回调
+        std::latch done(1);
+        order_service_->createOrder(order, request.header("Idempotency-Key"),
+            [this, &response, &done](bool success, const std::string& message, const services::OrderInfo& created) {
+                if (!success) {
+                    writeJsonError(response, 422, message);
+                } else {
+                    response.setStatus(201);
+                    writeOrderResponse(response, created);
+                }
+                done.count_down();
+            });
+        // TODO: HTTP响应支持异步发送后去掉等待，由回调直接发送 (Phase 2)
+        done.wait();
+    }
+    
+    void handleGetOrder(const http::RouteParams& params, http::HttpResponse& response) {
+        uint64_t order_id = 0;
+        if (!parseOrderId(params.get("id"), order_id)) {
+            writeJsonError(response, 400, "invalid order id");
+            return;
+        }
+        order_service_->getOrder(order_id,
+            [this, &response](bool success, const std::string& message, const services::OrderInfo& order) {
+                if (!success) {
+                    writeJsonError(response, 404, message);
+                    return;
+                }
+                writeOrderResponse(response, order);
+            });
+    }
+    
+    void handleCancelOrder(const http::HttpRequest& request, const http::RouteParams& params,
+                           http::HttpResponse& response) {
+        uint64_t order_id = 0;
+        if (!parseOrderId(params.get("id"), order_id)) {
+            writeJsonError(response, 400, "invalid order id");
+            return;
+        }
+        // 请求体可选：{"reason": "..."}
+        std::string reason = "user request";
+        if (!request.body.empty()) {
+            static thread_local utils::JsonParser parser;
+            if (!parser.parse(request.body)) {
+                writeJsonError(response, 400, parser.error());
+                return;
+            }
+            utils::JsonValue value = parser.root()["reason"];
+            if (value.valid() && !value.getString(reason)) {
+                writeJsonError(response, 400, "invalid reason");
+                return;
+            }
+        }
+        order_service_->cancelOrder(order_id, reason,
+            [this, &response](bool success, const std::string& message, const services::OrderInfo& order) {
+                if (!success) {
+                    writeJsonError(response, 409, message);
+                    return;
+                }
+                writeOrderResponse(response, order);
+            });
+    }
+    
+    // 秒杀前手动把商品切换为热点模式（流量上来后也会按CAS冲突自动切换）
+    void handleEnableHotStock(const http::RouteParams& params, http::HttpResponse& response) {
+        uint64_t product_id = 0;
+        if (!parseOrderId(params.get("id"), product_id)) {
+            writeJsonError(response, 400, "invalid product id");
+            return;
+        }
+        if (!inventory_service_->enableHotStock(product_id)) {
+            writeJsonError(response, 404, "product not found");
+            return;
+        }
+        utils::JsonWriter writer(response.beginBody());
+        writer.startObject();
+        writer.key("product_id");
+        writer.writeUint(product_id);
+        writer.key("hot");
+        writer.writeBool(true);
+        writer.endObject();
+        response.endBody();
+    }
+    
+    // 游标分页：?limit=20&cursor=<上一页的next_cursor>
+    void handleGetUserOrders(const http::HttpRequest& request, const http::RouteParams& params,
+                             http::HttpResponse& response) {
+        uint64_t user_id = 0;
+        if (!parseOrderId(params.get("id"), user_id)) {
+            writeJsonError(response, 400, "invalid user id");
+            return;
+        }
+        int limit = 20;
+        if (!parseLimit(request.queryParam("limit"), limit)) {
+            writeJsonError(response, 400, "invalid limit");
+            return;
+        }
+        order_service_->getUserOrdersPage(user_id, request.queryParam("cursor"), limit,
+            [&response](bool success, const std::vector<services::OrderInfo>& orders, const std::string& next_cursor) {
+                if (!success) {
+                    writeJsonError(response, 400, "invalid cursor");
+                    return;
+                }
+                utils::JsonWriter writer(response.beginBody());
+                writer.startObject();
+                writer.key("orders");
+                writer.startArray();
+                for (const auto& order : orders) {
+                    utils::writeOrderInfo(writer, order);
+                }
+                writer.endArray();
+                writer.key("next_cursor");
+                if (next_cursor.empty()) {
+                    writer.writeNull();
+                } else {
+                    writer.writeString(next_cursor);
+                }
+                writer.endObject();
+                response.endBody();
+            });
+    }
+    
+    // 按状态和创建时间查询订单簿：?from=&to=&limit=&cursor=，从旧到新
+    void handleGetOrdersByStatus(const http::HttpRequest& request, const http::RouteParams& params,
+                                 http::HttpResponse& response) {
+        services::OrderStatus status;
+        if (!utils::orderStatusFromString(params.get("status"), status)) {
+            writeJsonError(response, 400, "invalid status");
+            return;
+        }
+        int64_t from = 0;
+        int64_t to = INT64_MAX;
+        if (!parseTimeRange(request, from, to)) {
+            writeJsonError(response, 400, "invalid time range");
+            return;
+        }
+        int limit = 20;
+        if (!parseLimit(request.queryParam("limit"), limit)) {
+            writeJsonError(response, 400, "invalid limit");
+            return;
+        }
+        order_service_->getOrdersByStatus(status, static_cast<time_t>(from), static_cast<time_t>(to),
+            request.queryParam("cursor"), limit,
+            [&response](bool success, const std::vector<services::OrderInfo>& orders, const std::string& next_cursor) {
+                if (!success) {
+                    writeJsonError(response, 400, "invalid cursor");
+                    return;
+                }
+                utils::JsonWriter writer(response.beginBody());
+                writer.startObject();
+                writer.key("orders");
+                writer.startArray();
+                for (const auto& order : orders) {
+                    utils::writeOrderInfo(writer, order);
+                }
+                writer.endArray();
+                writer.key("next_cursor");
+                if (next_cursor.empty()) {
+                    writer.writeNull();
+                } else {
+                    writer.writeString(next_cursor);
+                }
+                writer.endObject();
+                response.endBody();
+            });
+    }
+    
+    // 如超过10分钟未支付的订单数：/api/v1/orders/status/pending/count?to=<now - 600>
+    void handleCountOrdersByStatus(const http::HttpRequest& request, const http::RouteParams& params,
+                                   http::HttpResponse& response) {
+        services::OrderStatus status;
+        if (!utils::orderStatusFromString(params.get("status"), status)) {
+            writeJsonError(response, 400, "invalid status");
+            return;
+        }
+        int64_t from = 0;
+        int64_t to = INT64_MAX;
+        if (!parseTimeRange(request, from, to)) {
+            writeJsonError(response, 400, "invalid time range");
+            return;
+        }
+        size_t count = order_service_->countOrdersByStatus(status, static_cast<time_t>(from), static_cast<time_t>(to));
+        utils::JsonWriter writer(response.beginBody());
+        writer.startObject();
+        writer.key("status");
+        writer.writeString(utils::orderStatusToString(status));
+        writer.key("count");
+        writer.writeUint(count);
+        writer.endObject();
+        response.endBody();
+    }
+    
+    // 冷归档中的用户订单，游标格式与/api/v1/users/:id/orders相同
+    void handleGetArchivedUserOrders(const http::HttpRequest& request, const http::RouteParams& params,
+                                     http::HttpResponse& response) {
+        uint64_t user_id = 0;
+        if (!parseOrderId(params.get("id"), user_id)) {
+            writeJsonError(response, 400, "invalid user id");
+            return;
+        }
+        int limit = 20;
+        if (!parseLimit(request.queryParam("limit"), limit)) {
+            writeJsonError(response, 400, "invalid limit");
+            return;
+        }
+        std::string_view cursor_text = request.queryParam("cursor");
+        services::UserOrderKey cursor{};
+        if (!cursor_text.empty() && !services::UserOrderKey::fromCursor(cursor_text, cursor)) {
+            writeJsonError(response, 400, "invalid cursor");
+            return;
+        }
+        
+        // 多取一个用于判断是否还有下一页
+        std::vector<services::OrderInfo> orders = archive_->userHistory(
+            user_id, cursor_text.empty() ? nullptr : &cursor, static_cast<size_t>(limit) + 1);
+        bool more = orders.size() > static_cast<size_t>(limit);
+        if (more) {
+            orders.resize(static_cast<size_t>(limit));
+        }
+        utils::JsonWriter writer(response.beginBody());
+        writer.startObject();
+        writer.key("orders");
+        writer.startArray();
+        for (const auto& order : orders) {
+            utils::writeOrderInfo(writer, order);
+        }
+        writer.endArray();
+        writer.key("next_cursor");
+        if (more) {
+            const services::OrderInfo& last = orders.back();
+            writer.writeString(services::UserOrderKey{static_cast<uint32_t>(last.created_at),
+                                                      last.order_id}.toCursor());
+        } else {
+            writer.writeNull();
+        }
+        writer.endObject();
+        response.endBody();
+    }
+    
+    // 冷归档按时间范围汇总：?from=<秒>&to=<秒>，区间[from, to)，默认全部
+    void handleArchiveSummary(const http::HttpRequest& request, http::HttpResponse& response) {
+        int64_t from = 0;
+        int64_t to = INT64_MAX;
+        if (!parseTimeRange(request, from, to)) {
+            writeJsonError(response, 400, "invalid time range");
+            return;
+        }
+        storage::ArchiveAggregate summary = archive_->aggregate(static_cast<time_t>(from), static_cast<time_t>(to));
+        utils::JsonWriter writer(response.beginBody());
+        writer.startObject();
+        writer.key("orders");
+        writer.writeUint(summary.orders);
+        writer.key("revenue");
+        writer.writeDouble(summary.revenue);
+        writer.key("by_status");
+        writer.startObject();
+        for (size_t i = 0; i < services::kOrderStatusCount; ++i) {
+            if (summary.status_orders[i] == 0) {
+                continue;
+            }
+            writer.key(utils::orderStatusToString(static_cast<services::OrderStatus>(i)));
+            writer.startObject();
+            writer.key("orders");
+            writer.writeUint(summary.status_orders[i]);
+            writer.key("revenue");
+            writer.writeDouble(summary.status_revenue[i]);
+            writer.endObject();
+        }
+        writer.endObject();
+        writer.key("scanned_blocks");
+        writer.writeUint(summary.scanned_blocks);
+        writer.key("skipped_blocks");
+        writer.writeUint(summary.skipped_blocks);
+        writer.endObject();
+        response.endBody();
+    }
+    
+    // 分页大小：1-100，为空时保持默认值
+    static bool parseLimit(std::string_view text, int& limit) {
+        if (text.empty()) {
+            return true;
+        }
+        auto result = std::from_chars(text.data(), text.data() + text.size(), limit);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size() && limit > 0 && limit <= 100;
+    }
+    
+    static bool parseInt(std::string_view text, int64_t& value) {
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+    
+    // ?from=<秒>&to=<秒>，区间[from, to)，缺省的一端保持原值
+    static bool parseTimeRange(const http::HttpRequest& request, int64_t& from, int64_t& to) {
+        std::string_view from_text = request.queryParam("from");
+        std::string_view to_text = request.queryParam("to");
+        return (from_text.empty() || parseInt(from_text, from)) && (to_text.empty() || parseInt(to_text, to)) &&
+               from <= to;
+    }
+    
+    static bool parseOrderId(std::string_view text, uint64_t& order_id) {
+        auto result = std::from_chars(text.data(), text.data() + text.size(), order_id);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size() && order_id != 0;
+    }
+    
+    static void writeOrderResponse(http::HttpResponse& response, const services::OrderInfo& order) {
+        utils::JsonWriter writer(response.beginBody());
+        utils::writeOrderInfo(writer, order);
+        response.endBody();
+    }
+    
+    static void writeJsonError(http::HttpResponse& response, int status, std::string_view message) {
+        response.setStatus(status);
+        utils::JsonWriter writer(response.beginBody());
+        writer.startObject();
+        writer.key("error");
+        writer.writeString(message);
+        writer.endObject();
+        response.endBody();
+    }
+    
+    // Prometheus文本格式，逐个指标分块写出
+    void writeMetrics(http::HttpResponse& response) {
+        response.beginChunked("text/plain; version=0.0.4");
+        
+        uint64_t http_requests = 0;
+        for (const auto& http_server : http_servers_) {
+            http_requests += http_server->getRequestCount();
+        }
+        
+        std::string line;
+        line = "# TYPE order_engine_tcp_connections gauge\norder_engine_tcp_connections " +
+               std::to_string(tcp_server_->getConnectionCount()) + "\n";
+        response.writeChunk(line);
+        line = "# TYPE order_engine_http_requests_total counter\norder_engine_http_requests_total " +
+               std::to_string(http_requests) + "\n";
+        response.writeChunk(line);
+        if (grpc_server_) {
+            line = "# TYPE order_engine_grpc_requests_total counter\norder_engine_grpc_requests_total " +
+                   std::to_string(grpc_server_->getHandledCount()) + "\n";
+            response.writeChunk(line);
+        }
+        
+        // 业务统计：累计、当天及最近一分钟/一小时
+        const services::OrderMetrics& order_metrics = order_service_->metrics();
+        time_t now = time(nullptr);
+        services::OrderWindowStats today = order_metrics.today(now);
+        line = "# TYPE order_engine_orders_total counter\norder_engine_orders_total " +
+               std::to_string(order_metrics.totalOrders()) + "\n";
+        line += "# TYPE order_engine_orders_today gauge\norder_engine_orders_today " +
+                std::to_string(today.orders) + "\n";
+        line += "# TYPE order_engine_revenue_today gauge\norder_engine_revenue_today " +
+                std::to_string(today.revenue) + "\n";
+        const std::pair<const char*, services::OrderWindowStats> windows[] = {
+            {"1m", order_metrics.lastMinute(now)}, {"1h", order_metrics.lastHour(now)}};
+        line += "# TYPE order_engine_orders_window gauge\n";
+        for (const auto& [window, stats] : windows) {
+            line += std::string("order_engine_orders_window{window=\"") + window + "\"} " +
+                    std::to_string(stats.orders) + "\n";
+        }
+        line += "# TYPE order_engine_revenue_window gauge\n";
+        for (const auto& [window, stats] : windows) {
+            line += std::string("order_engine_revenue_window{window=\"") + window + "\"} " +
+                    std::to_string(stats.revenue) + "\n";
+        }
+        line += "# TYPE order_engine_status_transitions_window gauge\n";
+        for (const auto& [window, stats] : windows) {
+            for (size_t i = 0; i < services::kOrderStatusCount; ++i) {
+                line += std::string("order_engine_status_transitions_window{window=\"") + window +
+                        "\",status=\"" + utils::orderStatusToString(static_cast<services::OrderStatus>(i)) +
+                        "\"} " + std::to_string(stats.transitions[i]) + "\n";
+            }
+        }
+        // 订单簿中各状态的订单数（状态索引计数，不扫描订单）
+        line += "# TYPE order_engine_orders_by_status gauge\n";
+        for (size_t i = 0; i < services::kOrderStatusCount; ++i) {
+            auto status = static_cast<services::OrderStatus>(i);
+            line += std::string("order_engine_orders_by_status{status=\"") + utils::orderStatusToString(status) +
+                    "\"} " + std::to_string(order_service_->countOrdersByStatus(status, 0, INT64_MAX)) + "\n";
+        }
+        response.writeChunk(line);
+        
+        // 热点库存：拆分的商品数和本地桶不足时的收回重分配次数
+        line = "# TYPE order_engine_inventory_hot_skus gauge\norder_engine_inventory_hot_skus " +
+               std::to_string(inventory_service_->getHotStockCount()) + "\n";
+        line += "# TYPE order_engine_inventory_hot_rebalances_total counter\n"
+                "order_engine_inventory_hot_rebalances_total " +
+                std::to_string(inventory_service_->getHotStockRebalances()) + "\n";
+        response.writeChunk(line);
+        
+        // 分级下单：各级排队订单数、批次数和处理订单数（平均批次大小 = orders / batches）
+        if (const services::OrderPlacementPipeline* placement = order_service_->placementPipeline()) {
+            std::vector<std::pair<std::string, services::PlacementStage::Stats>> stages;
+            for (const services::PlacementStage* stage : placement->stages()) {
+                stages.emplace_back(stage->name(), stage->stats());
+            }
+            line = "# TYPE order_engine_placement_queued_orders gauge\n";
+            for (const auto& [name, stats] : stages) {
+                line += "order_engine_placement_queued_orders{stage=\"" + name + "\"} " +
+                        std::to_string(stats.queued_orders) + "\n";
+            }
+            line += "# TYPE order_engine_placement_batches_total counter\n";
+            for (const auto& [name, stats] : stages) {
+                line += "order_engine_placement_batches_total{stage=\"" + name + "\"} " +
+                        std::to_string(stats.batches) + "\n";
+            }
+            line += "# TYPE order_engine_placement_orders_total counter\n";
+            for (const auto& [name, stats] : stages) {
+                line += "order_engine_placement_orders_total{stage=\"" + name + "\"} " +
+                        std::to_string(stats.orders) + "\n";
+            }
+            line += "# TYPE order_engine_placement_rejected_total counter\norder_engine_placement_rejected_total " +
+                    std::to_string(stages.front().second.rejected) + "\n";
+            response.writeChunk(line);
+        }
+        
+        // 订单簿分片
+        std::vector<services::OrderShardStats> shards = order_service_->orderStore().stats();
+        line = "# TYPE order_engine_order_store_entries gauge\n";
+        for (size_t i = 0; i < shards.size(); ++i) {
+            line += "order_engine_order_store_entries{shard=\"" + std::to_string(i) + "\"} " +
+                    std::to_string(shards[i].entries) + "\n";
+        }
+        line += "# TYPE order_engine_order_store_bytes gauge\n";
+        for (size_t i = 0; i < shards.size(); ++i) {
+            line += "order_engine_order_store_bytes{shard=\"" + std::to_string(i) + "\"} " +
+                    std::to_string(shards[i].memory_bytes) + "\n";
+        }
+        response.writeChunk(line);
+        
+        if (journal_) {
+            line = "# TYPE order_engine_journal_commits_total counter\norder_engine_journal_commits_total " +
+                   std::to_string(journal_->getCommitCount()) + "\n";
+            line += "# TYPE order_engine_journal_records_total counter\norder_engine_journal_records_total " +
+                    std::to_string(journal_->getCommittedRecords()) + "\n";
+            line += "# TYPE order_engine_journal_bytes_total counter\norder_engine_journal_bytes_total " +
+                    std::to_string(journal_->getCommittedBytes()) + "\n";
+            response.writeChunk(line);
+        }
+        if (idempotency_cache_) {
+            services::IdempotencyStats idempotency = idempotency_cache_->stats();
+            line = "# TYPE order_engine_idempotency_keys gauge\norder_engine_idempotency_keys " +
+                   std::to_string(idempotency.keys) + "\n";
+            line += "# TYPE order_engine_idempotency_bytes gauge\norder_engine_idempotency_bytes " +
+                    std::to_string(idempotency.memory_bytes) + "\n";
+            line += "# TYPE order_engine_idempotency_hits_total counter\norder_engine_idempotency_hits_total " +
+                    std::to_string(idempotency.hits) + "\n";
+            line += "# TYPE order_engine_idempotency_in_progress_total counter\n"
+                    "order_engine_idempotency_in_progress_total " + std::to_string(idempotency.in_progress) + "\n";
+            line += "# TYPE order_engine_idempotency_evicted_total counter\n"
+                    "order_engine_idempotency_evicted_total " + std::to_string(idempotency.evicted) + "\n";
+            response.writeChunk(line);
+        }
+        if (event_pipeline_) {
+            line = "# TYPE order_engine_events_published_total counter\norder_engine_events_published_total " +
+                   std::to_string(event_pipeline_->getPublishedCount()) + "\n";
+            line += "# TYPE order_engine_events_dropped_total counter\norder_engine_events_dropped_total " +
+                    std::to_string(event_pipeline_->getDroppedCount()) + "\n";
+            line += "# TYPE order_engine_events_sent_total counter\norder_engine_events_sent_total " +
+                    std::to_string(event_pipeline_->getSentCount()) + "\n";
+            line += "# TYPE order_engine_event_batches_failed_total counter\n"
+                    "order_engine_event_batches_failed_total " +
+                    std::to_string(event_pipeline_->getFailedBatchCount()) + "\n";
+            line += "# TYPE order_engine_event_queue_depth gauge\norder_engine_event_queue_depth " +
+                    std::to_string(event_pipeline_->queueDepth()) + "\n";
+            response.writeChunk(line);
+        }
+        if (archive_) {
+            storage::ArchiveStats archive = archive_->stats();
+            line = "# TYPE order_engine_archive_segments gauge\norder_engine_archive_segments " +
+                   std::to_string(archive.segments) + "\n";
+            line += "# TYPE order_engine_archive_orders gauge\norder_engine_archive_orders " +
+                    std::to_string(archive.orders) + "\n";
+            line += "# TYPE order_engine_archive_bytes gauge\norder_engine_archive_bytes " +
+                    std::to_string(archive.bytes) + "\n";
+            response.writeChunk(line);
+        }
+        if (persistence_batcher_) {
+            line = "# TYPE order_engine_db_batches_total counter\norder_engine_db_batches_total " +
+                   std::to_string(persistence_batcher_->getBatchCount()) + "\n";
+            line += "# TYPE order_engine_db_failed_batches_total counter\norder_engine_db_failed_batches_total " +
+                    std::to_string(persistence_batcher_->getFailedBatchCount()) + "\n";
+            line += "# TYPE order_engine_db_retried_rows_total counter\norder_engine_db_retried_rows_total " +
+                    std::to_string(persistence_batcher_->getRetriedRowCount()) + "\n";
+            line += "# TYPE order_engine_db_dead_letter_rows_total counter\norder_engine_db_dead_letter_rows_total " +
+                    std::to_string(persistence_batcher_->getDeadLetterCount()) + "\n";
+            line += "# TYPE order_engine_db_rejected_rows_total counter\norder_engine_db_rejected_rows_total " +
+                    std::to_string(persistence_batcher_->getRejectedCount()) + "\n";
+            line += "# TYPE order_engine_db_queue_depth gauge\norder_engine_db_queue_depth " +
+                    std::to_string(persistence_batcher_->queueDepth()) + "\n";
+            persistence_batcher_->batchLatency().appendPrometheus(line, "order_engine_db_batch_latency_ms");
+            persistence_batcher_->batchSize().appendPrometheus(line, "order_engine_db_batch_size");
+            response.writeChunk(line);
+        }
+        // TODO: 添加业务指标 (Phase 2)
+        response.endChunked();
+    }
+    
+    size_t handleData(const network::TcpConnectionPtr& conn, const char* data, size_t len) {
+        // 每个Reactor线程复用一块响应缓冲区，流水线请求的响应合并发送
+        static thread_local std::string response;
+        response.clear();
+        
+        size_t consumed = 0;
+        while (consumed < len) {
+            protocol::FrameView frame;
+            protocol::DecodeStatus status = protocol::decodeFrame(data + consumed, len - consumed, frame);
+            if (status == protocol::DecodeStatus::kNeedMore) {
+                break;
+            }
+            
+            if (status != protocol::DecodeStatus::kOk) {
+                // 帧边界已不可信，回复错误后断开
+                LOG_WARN("Bad frame from " + conn->getPeerAddress() + ": " + protocol::decodeStatusToString(status));
+                protocol::encodeResult(response, protocol::MessageType::kErrorResponse, 0, 0,
+                                       protocol::ResultCode::kInvalidRequest,
+                                       protocol::decodeStatusToString(status));
+                conn->send(response);
+                conn->closeConnection();
+                return len;
+            }
+            
+            if (frame.flags() & protocol::kFlagProtobuf) {
+                dispatchProtobufFrame(conn, frame, response);
+            } else {
+                dispatchFrame(conn, frame, response);
+            }
+            consumed += frame.frameSize();
+        }
+        
+        if (!response.empty()) {
+            conn->send(response);
+        }
+        return consumed;
+    }
+    
+    // 每个Reactor线程一个codec，请求消息和响应消息都分配在其arena上
+    static protocol::ProtobufCodec& protobufCodec() {
+        static thread_local protocol::ProtobufCodec codec;
+        return codec;
+    }
+    
+    void dispatchProtobufFrame(const network::TcpConnectionPtr& conn, const protocol::FrameView& frame,
+                               std::string& response) {
+        using protocol::MessageType;
+        using protocol::ResultCode;
         
-        // 这里应该解析协议消息并路由到相应的服务
-        // 简化示例：直接回显
-        conn->send("Echo: " + message);
+        protocol::ProtobufCodec& codec = protobufCodec();
+        
+        uint64_t request_id = frame.requestId();
+        auto reply = [&](MessageType type, uint64_t order_id, ResultCode code, const std::string& message) {
+            auto* result = codec.create<proto::Result>();
+            result->set_order_id(order_id);
+            result->set_code(static_cast<uint32_t>(code));
+            result->set_message(message);
+            codec.serialize(response, type, request_id, *result);
+        };
+        
+        // 下单由协程在落盘后单独应答，其余业务服务同步回调，回调内直接写入response
+        bool parsed = false;
+        MessageType response_type = MessageType::kErrorResponse;
+        switch (frame.type()) {
+            case MessageType::kCreateOrderRequest: {
+                response_type = MessageType::kCreateOrderResponse;
+                auto* request = codec.parse<proto::CreateOrderRequest>(frame);
+                if (request == nullptr) {
+                    break;
+                }
+                parsed = true;
+                services::OrderInfo order;
+                protocol::toOrderInfo(*request, order);
+                // 之前的响应先发出，下单协程完成后单独发送自己的响应
+                if (!response.empty()) {
+                    conn->send(response);
+                    response.clear();
+                }
+                network::spawn(createOrderProtobufFrame(conn, request_id, std::move(order)));
+                break;
+            }
+            case MessageType::kQueryOrderRequest: {
+                // 查询成功回复OrderRecord；失败回复Result，帧类型保持kErrorResponse以便区分
+                auto* request = codec.parse<proto::QueryOrderRequest>(frame);
+                if (request == nullptr) {
+                    break;
+                }
+                parsed = true;
+                order_service_->getOrder(request->order_id(),
+                    [&](bool success, const std::string& message, const services::OrderInfo& order) {
+                        if (success) {
+                            auto* record = codec.create<proto::OrderRecord>();
+                            protocol::fromOrderInfo(order, *record);
+                            codec.serialize(response, MessageType::kQueryOrderResponse, request_id, *record);
+                        } else {
+                            reply(response_type, order.order_id, ResultCode::kNotFound, message);
+                        }
+                    });
+                break;
+            }
+            case MessageType::kCancelOrderRequest: {
+                response_type = MessageType::kCancelOrderResponse;
+                auto* request = codec.parse<proto::CancelOrderRequest>(frame);
+                if (request == nullptr) {
+                    break;
+                }
+                parsed = true;
+                order_service_->cancelOrder(request->order_id(), request->reason(),
+                    [&](bool success, const std::string& message, const services::OrderInfo& order) {
+                        reply(response_type, order.order_id,
+                              success ? ResultCode::kOk : ResultCode::kInvalidRequest, message);
+                    });
+                break;
+            }
+            case MessageType::kReserveStockRequest: {
+                response_type = MessageType::kReserveStockResponse;
+                auto* request = codec.parse<proto::ReserveStockRequest>(frame);
+                if (request == nullptr) {
+                    break;
+                }
+                parsed = true;
+                uint64_t order_id = request->order_id();
+                std::vector<uint64_t> product_ids(request->items_size());
+                std::vector<uint32_t> quantities(request->items_size());
+                for (int i = 0; i < request->items_size(); ++i) {
+                    product_ids[i] = request->items(i).product_id();
+                    quantities[i] = request->items(i).quantity();
+                }
+                inventory_service_->reserveStock(product_ids, quantities, std::to_string(order_id),
+                                                 static_cast<int>(std::min<uint32_t>(request->timeout_seconds(), INT32_MAX)),
+                    [&](bool success, const std::string& message) {
+                        reply(response_type, order_id,
+                              success ? ResultCode::kOk : ResultCode::kInsufficientStock, message);
+                    });
+                break;
+            }
+            default:
+                break;
+        }
+        
+        if (!parsed) {
+            reply(response_type, 0, ResultCode::kInvalidRequest, "malformed protobuf payload");
+        }
+        codec.reset();
+    }
+    
+    // protobuf下单协程：与createOrderFrame相同，响应用本线程的codec编码
+    network::Task<void> createOrderProtobufFrame(network::TcpConnectionPtr conn, uint64_t request_id,
+                                                 services::OrderInfo order) {
+        services::OrderOutcome outcome = co_await order_service_->awaitCreateOrder(*conn->ownerReactor(),
+                                                                                    std::move(order));
+        // 在Reactor线程继续：消息留在codec的arena上，由下一帧处理结束时的reset()释放
+        auto* result = protobufCodec().create<proto::Result>();
+        result->set_order_id(outcome.order.order_id);
+        result->set_code(static_cast<uint32_t>(outcome.success ? protocol::ResultCode::kOk
+                                                               : protocol::ResultCode::kInvalidRequest));
+        result->set_message(outcome.message);
+        std::string response;
+        protobufCodec().serialize(response, protocol::MessageType::kCreateOrderResponse, request_id, *result);
+        conn->send(response);
+    }
+    
+    // 批量下单协程：整批落盘后在连接所属的Reactor线程中发送一个响应
+    network::Task<void> createOrdersFrame(network::TcpConnectionPtr conn, uint64_t request_id,
+                                          std::vector<services::OrderInfo> orders) {
+        std::vector<services::OrderResult> results =
+            co_await order_service_->awaitCreateOrders(*conn->ownerReactor(), std::move(orders));
+        std::string response;
+        protocol::encodeBatchCreateOrderResponse(response, request_id, results);
+        conn->send(response);
+    }
+    
+    // 下单协程：顺序等待下单结果，在连接所属的Reactor线程中继续并发送响应
+    network::Task<void> createOrderFrame(network::TcpConnectionPtr conn, uint64_t request_id,
+                                         services::OrderInfo order) {
+        services::OrderOutcome outcome = co_await order_service_->awaitCreateOrder(*conn->ownerReactor(),
+                                                                                    std::move(order));
+        std::string response;
+        protocol::encodeResult(response, protocol::MessageType::kCreateOrderResponse, request_id,
+                               outcome.order.order_id,
+                               outcome.success ? protocol::ResultCode::kOk : protocol::ResultCode::kInvalidRequest,
+                               outcome.message);
+        conn->send(response);
+    }
+    
+    void dispatchFrame(const network::TcpConnectionPtr& conn, const protocol::FrameView& frame,
+                       std::string& response) {
+        using protocol::DecodeStatus;
+        using protocol::MessageType;
+        using protocol::ResultCode;
+        
+        uint64_t request_id = frame.requestId();
+        MessageType response_type = MessageType::kErrorResponse;
+        uint64_t order_id = 0;
+        DecodeStatus status = DecodeStatus::kMalformed;
+        
+        // 下单由协程在落盘后单独应答，其余业务服务同步回调，回调内直接写入response
+        switch (frame.type()) {
+            case MessageType::kCreateOrderRequest: {
+                protocol::CreateOrderView view;
+                status = protocol::CreateOrderView::parse(frame, view);
+                response_type = MessageType::kCreateOrderResponse;
+                if (status == DecodeStatus::kOk) {
+                    services::OrderInfo order;
+                    view.toOrderInfo(order);
+                    // 之前的响应先发出，下单协程完成后单独发送自己的响应
+                    if (!response.empty()) {
+                        conn->send(response);
+                        response.clear();
+                    }
+                    network::spawn(createOrderFrame(conn, request_id, std::move(order)));
+                    return;
+                }
+                break;
+            }
+            case MessageType::kBatchCreateOrderRequest: {
+                protocol::BatchCreateOrderView view;
+                status = protocol::BatchCreateOrderView::parse(frame, view);
+                response_type = MessageType::kBatchCreateOrderResponse;
+                if (status == DecodeStatus::kOk) {
+                    std::vector<services::OrderInfo> orders;
+                    view.toOrderInfos(orders);
+                    if (!response.empty()) {
+                        conn->send(response);
+                        response.clear();
+                    }
+                    network::spawn(createOrdersFrame(conn, request_id, std::move(orders)));
+                    return;
+                }
+                break;
+            }
+            case MessageType::kQueryOrderRequest: {
+                protocol::QueryOrderView view;
+                status = protocol::QueryOrderView::parse(frame, view);
+                if (status == DecodeStatus::kOk) {
+                    order_service_->getOrder(view.orderId(),
+                        [&](bool success, const std::string& message, const services::OrderInfo& order) {
+                            if (success && protocol::encodeOrderRecord(response, request_id,
+                                                                       ResultCode::kOk, order)) {
+                                return;
+                            }
+                            if (success) {
+                                // 商品数或字段长度超出二进制协议的上限
+                                protocol::encodeResult(response, response_type, request_id, order.order_id,
+                                                       ResultCode::kInternalError, "order exceeds protocol limits");
+                            } else {
+                                protocol::encodeResult(response, response_type, request_id, order.order_id,
+                                                       ResultCode::kNotFound, message);
+                            }
+                        });
+                    return;
+                }
+                break;
+            }
+            case MessageType::kCancelOrderRequest: {
+                protocol::CancelOrderView view;
+                status = protocol::CancelOrderView::parse(frame, view);
+                response_type = MessageType::kCancelOrderResponse;
+                if (status == DecodeStatus::kOk) {
+                    order_service_->cancelOrder(view.orderId(), std::string(view.reason()),
+                        [&](bool success, const std::string& message, const services::OrderInfo& order) {
+                            protocol::encodeResult(response, response_type, request_id, order.order_id,
+                                                   success ? ResultCode::kOk : ResultCode::kInvalidRequest,
+                                                   message);
+                        });
+                    return;
+                }
+                break;
+            }
+            case MessageType::kReserveStockRequest: {
+                protocol::ReserveStockView view;
+                status = protocol::ReserveStockView::parse(frame, view);
+                response_type = MessageType::kReserveStockResponse;
+                if (status == DecodeStatus::kOk) {
+                    order_id = view.orderId();
+                    std::vector<uint64_t> product_ids(view.itemCount());
+                    std::vector<uint32_t> quantities(view.itemCount());
+                    for (size_t i = 0; i < product_ids.size(); ++i) {
+                        product_ids[i] = view.item(i).productId();
+                        quantities[i] = view.item(i).quantity();
+                    }
+                    inventory_service_->reserveStock(product_ids, quantities, std::to_string(order_id),
+                                                     static_cast<int>(std::min<uint32_t>(view.timeoutSeconds(), INT32_MAX)),
+                        [&](bool success, const std::string& message) {
+                            protocol::encodeResult(response, response_type, request_id, order_id,
+                                                   success ? ResultCode::kOk : ResultCode::kInsufficientStock,
+                                                   message);
+                        });
+                    return;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        
+        protocol::encodeResult(response, response_type, request_id, order_id,
+                               ResultCode::kInvalidRequest, protocol::decodeStatusToString(status));
+    }
+    
+    // 打开预写日志和冷归档，从快照和日志恢复订单簿（只有启用日志时快照才完整）
+    bool openStorage() {
+        if (journal_ && !journal_->open()) {
+            LOG_ERROR("Failed to open order journal");
+            return false;
+        }
+        if (archive_ && !archive_->open()) {
+            LOG_ERROR("Failed to open order archive");
+            return false;
+        }
+        if (journal_ && !order_service_->recover(snapshot_dir_)) {
+            LOG_ERROR("Failed to recover order store");
+            return false;
+        }
+        return true;
+    }
+    
+    // 热重启新进程：确认交接，等待旧进程停止写入并关闭日志后再打开
+    bool takeOverStorage() {
+        if (!handoff_->confirm()) {
+            return false;
+        }
+        uint64_t released_lsn = 0;
+        if (journal_) {
+            // 旧进程确认后立即停止写入并交出日志，不等存量连接排空
+            int timeout_ms = config_->getInt("server.journal_release_timeout_ms", 10000);
+            if (!handoff_->waitJournalRelease(released_lsn, timeout_ms)) {
+                return false;
+            }
+            LOG_INFO("Order journal released by old process at LSN " + std::to_string(released_lsn));
+        }
+        if (!openStorage()) {
+            return false;
+        }
+        if (journal_ && journal_->lastLsn() < released_lsn) {
+            LOG_ERROR("Order journal is behind the old process");
+            return false;
+        }
+        return true;
+    }
+    
+    void handleHotRestart() {
+        LOG_INFO("Hot restart requested, handing off listen socket...");
+        
+        network::HandoffFds fds;
+        fds.listen_fds.push_back(tcp_server_->getListenFd());
+        if (config_->getBool("server.handoff_idle_connections", false)) {
+            fds.connection_fds = tcp_server_->detachIdleConnections(
+                config_->getInt("server.handoff_idle_seconds", 5));
+        }
+        
+        bool ok = handoff_->serve(fds, config_->getInt("server.handoff_timeout_ms", 5000));
+        
+        // 已摘下的连接fd无论成败都在本进程关闭，成功时新进程持有副本
+        for (int fd : fds.connection_fds) {
+            ::close(fd);
+        }
+        
+        if (!ok) {
+            return;
+        }
+        
+        // 新进程已接管监听：先停止写入、提交剩余日志记录并交出日志，新进程随即
+        // 恢复并开始服务；本进程之后只应答查询，写请求失败由客户端重试到新进程
+        handoff_->stopListening();
+        order_service_->stopWrites();
+        if (journal_) {
+            journal_->close();
+        }
+        handoff_->releaseJournal(journal_ ? journal_->lastLsn() : 0);
+        tcp_server_->drain(config_->getInt("server.drain_timeout", 30));
+        running_ = false;
     }
     
     void handleConnection(const network::TcpConnectionPtr& conn) {
@@ -120,7 +1302,42 @@ private:
     void printStats() {
         LOG_INFO("=== OrderEngine Statistics ===");
         LOG_INFO_FMT_INT("Active connections: {}", tcp_server_->getConnectionCount());
-        // TODO: 添加业务统计 (Phase 2)
+        size_t store_entries = 0;
+        size_t store_bytes = 0;
+        for (const auto& shard : order_service_->orderStore().stats()) {
+            store_entries += shard.entries;
+            store_bytes += shard.memory_bytes;
+        }
+        LOG_INFO_FMT_INT("Order store entries: {}", static_cast<int>(store_entries));
+        LOG_INFO_FMT_INT("Order store memory (KB): {}", static_cast<int>(store_bytes / 1024));
+        const services::OrderMetrics& metrics = order_service_->metrics();
+        time_t now = time(nullptr);
+        services::OrderWindowStats today = metrics.today(now);
+        services::OrderWindowStats minute = metrics.lastMinute(now);
+        services::OrderWindowStats hour = metrics.lastHour(now);
+        LOG_INFO("Orders total: " + std::to_string(metrics.totalOrders()) +
+                 ", today: " + std::to_string(today.orders) + " (revenue " + std::to_string(today.revenue) + ")");
+        LOG_INFO("Orders last minute: " + std::to_string(minute.orders) + " (revenue " +
+                 std::to_string(minute.revenue) + "), last hour: " + std::to_string(hour.orders) +
+                 " (revenue " + std::to_string(hour.revenue) + ")");
+        std::string transitions = "Status transitions last hour:";
+        for (size_t i = 0; i < services::kOrderStatusCount; ++i) {
+            transitions += std::string(" ") + utils::orderStatusToString(static_cast<services::OrderStatus>(i)) +
+                           "=" + std::to_string(hour.transitions[i]);
+        }
+        LOG_INFO(transitions);
+        if (event_pipeline_) {
+            LOG_INFO("Order events published: " + std::to_string(event_pipeline_->getPublishedCount()) +
+                     ", sent: " + std::to_string(event_pipeline_->getSentCount()) +
+                     ", dropped: " + std::to_string(event_pipeline_->getDroppedCount()) +
+                     ", queue: " + std::to_string(event_pipeline_->queueDepth()));
+        }
+        if (idempotency_cache_) {
+            services::IdempotencyStats idempotency = idempotency_cache_->stats();
+            LOG_INFO("Idempotency keys: " + std::to_string(idempotency.keys) + " (" +
+                     std::to_string(idempotency.memory_bytes / 1024) + " KB), hits: " +
+                     std::to_string(idempotency.hits) + ", in progress: " + std::to_string(idempotency.in_progress));
+        }
         LOG_INFO("==============================");
     }
     
@@ -129,7 +1346,37 @@ private:
             tcp_server_->stop();
         }
         
-        // TODO: 关闭业务服务 (Phase 2)
+        if (grpc_server_) {
+            grpc_server_->stop();
+        }
+        
+        for (auto& http_server : http_servers_) {
+            http_server->stop();
+        }
+        
+        if (order_service_) {
+            // 正常退出时写快照，下次启动无需回放日志；热重启时日志已交给新进程
+            if (journal_ && journal_->isOpen()) {
+                order_service_->writeSnapshot(snapshot_dir_);
+            }
+            order_service_->shutdown();
+        }
+        if (persistence_batcher_) {
+            persistence_batcher_->stop();
+        }
+        if (event_pipeline_) {
+            event_pipeline_->stop();
+        }
+        if (journal_) {
+            journal_->close();
+        }
+        // 新进程在收到通知后才打开日志；热重启时已在handleHotRestart()中交出
+        if (handoff_) {
+            handoff_->releaseJournal(journal_ ? journal_->lastLsn() : 0);
+        }
+        if (inventory_service_) {
+            inventory_service_->shutdown();
+        }
         
         common::Logger::getInstance().shutdown();
     }
@@ -140,20 +1387,40 @@ private:
     // 核心组件
     std::shared_ptr<common::Config> config_;
     std::shared_ptr<network::TcpServer> tcp_server_;
+    std::unique_ptr<rpc::GrpcServer> grpc_server_;
+    std::vector<std::unique_ptr<http::HttpServer>> http_servers_;
+    
+    // 业务服务
+    std::shared_ptr<services::OrderService> order_service_;
+    std::shared_ptr<services::InventoryService> inventory_service_;
+    std::shared_ptr<storage::OrderJournal> journal_;
+    std::shared_ptr<storage::PersistenceBatcher> persistence_batcher_;
+    std::shared_ptr<services::IdempotencyCache> idempotency_cache_;
+    std::shared_ptr<message::OrderEventPipeline> event_pipeline_;
+    std::string snapshot_dir_;
+    int snapshot_interval_ = 0;   // 秒，0表示只在退出时写快照
+    std::shared_ptr<storage::OrderArchive> archive_;
+    int archive_after_days_ = 90;
+    int archive_interval_ = 0;    // 秒，0表示不归档
+    
+    // 热重启
+    std::unique_ptr<network::SocketHandoff> handoff_;
+    bool hot_restart_ = false;
+    std::vector<int> inherited_connections_;
     // TODO: 添加数据库、缓存、消息队列组件 (Phase 2)
-    // TODO: 添加业务服务组件 (Phase 2)
 };
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <config_file>" << std::endl;
+    bool hot_restart = argc == 3 && std::strcmp(argv[2], "--hot-restart") == 0;
+    if (argc != 2 && !hot_restart) {
+        std::cerr << "Usage: " << argv[0] << " <config_file> [--hot-restart]" << std::endl;
         return 1;
     }
     
     try {
         OrderEngineApplication app;
         
-        if (!app.initialize(argv[1])) {
+        if (!app.initialize(argv[1], hot_restart)) {
             std::cerr << "Failed to initialize application" << std::endl;
             return 1;
         }
@@ -0,0 +1,112 @@
+#include "message/kafka_producer.h"
+#include "common/logger.h"
+#include <librdkafka/rdkafka.h>
+#include <charconv>
+
+namespace order_engine {
+namespace message {
+
+namespace {
+
+void onDelivery(rd_kafka_t*, const rd_kafka_message_t* message, void* opaque) {
+    static_cast<KafkaProducer*>(opaque)->recordDelivery(message->err == RD_KAFKA_RESP_ERR_NO_ERROR);
+}
+
+bool setConf(rd_kafka_conf_t* conf, const char* name, const std::string& value) {
+    char error[512];
+    if (rd_kafka_conf_set(conf, name, value.c_str(), error, sizeof(error)) != RD_KAFKA_CONF_OK) {
+        LOG_ERROR_FMT("Kafka config error: {}", std::string(error));
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+KafkaProducer::KafkaProducer(KafkaConfig config)
+    : config_(std::move(config))
+    , producer_(nullptr)
+    , delivered_(0)
+    , failed_(0) {
+}
+
+KafkaProducer::~KafkaProducer() {
+    if (producer_) {
+        flush();
+        rd_kafka_destroy(producer_);
+    }
+}
+
+void KafkaProducer::recordDelivery(bool success) {
+    (success ? delivered_ : failed_).fetch_add(1, std::memory_order_relaxed);
+}
+
+bool KafkaProducer::connect() {
+    rd_kafka_conf_t* conf = rd_kafka_conf_new();
+    bool ok = setConf(conf, "bootstrap.servers", config_.brokers) &&
+              setConf(conf, "client.id", config_.client_id) &&
+              setConf(conf, "compression.type", config_.compression_type) &&
+              setConf(conf, "batch.size", std::to_string(config_.batch_size)) &&
+              setConf(conf, "linger.ms", std::to_string(config_.linger_ms)) &&
+              setConf(conf, "retries", std::to_string(config_.retries)) &&
+              setConf(conf, "request.timeout.ms", std::to_string(config_.request_timeout_ms)) &&
+              setConf(conf, "max.in.flight.requests.per.connection",
+                      std::to_string(config_.max_in_flight_requests)) &&
+              setConf(conf, "queue.buffering.max.messages",
+                      std::to_string(config_.queue_buffering_max_messages));
+    if (!ok) {
+        rd_kafka_conf_destroy(conf);
+        return false;
+    }
+    rd_kafka_conf_set_dr_msg_cb(conf, onDelivery);
+    rd_kafka_conf_set_opaque(conf, this);
+
+    char error[512];
+    producer_ = rd_kafka_new(RD_KAFKA_PRODUCER, conf, error, sizeof(error));
+    if (!producer_) {
+        // rd_kafka_new失败时conf仍归调用方
+        rd_kafka_conf_destroy(conf);
+        LOG_ERROR_FMT("Failed to create Kafka producer: {}", std::string(error));
+        return false;
+    }
+    LOG_INFO_FMT("Kafka producer connected: {}", config_.brokers);
+    return true;
+}
+
+bool KafkaProducer::write(const EventBatch& batch) {
+    if (!producer_) {
+        return false;
+    }
+    bool ok = true;
+    for (size_t i = 0; i < batch.count(); ++i) {
+        std::string_view record = batch.record(i);
+        record.remove_suffix(1);  // 去掉行尾换行
+        char key[24];
+        size_t key_len = static_cast<size_t>(std::to_chars(key, key + sizeof(key), batch.keys[i]).ptr - key);
+        rd_kafka_resp_err_t err = rd_kafka_producev(
+            producer_,
+            RD_KAFKA_V_TOPIC(batch.topic.c_str()),
+            RD_KAFKA_V_PARTITION(static_cast<int32_t>(batch.partition)),
+            RD_KAFKA_V_MSGFLAGS(RD_KAFKA_MSG_F_COPY),
+            RD_KAFKA_V_KEY(key, key_len),
+            RD_KAFKA_V_VALUE(const_cast<char*>(record.data()), record.size()),
+            RD_KAFKA_V_END);
+        if (err != RD_KAFKA_RESP_ERR_NO_ERROR) {
+            // 本地队列满（__QUEUE_FULL）等：不等待，计为失败
+            failed_.fetch_add(batch.count() - i, std::memory_order_relaxed);
+            ok = false;
+            break;
+        }
+    }
+    rd_kafka_poll(producer_, 0);  // 处理投递回调
+    return ok;
+}
+
+void KafkaProducer::flush() {
+    if (producer_) {
+        rd_kafka_flush(producer_, config_.request_timeout_ms);
+    }
+}
+
+} // namespace message
+} // namespace order_engine
@@ -0,0 +1,267 @@
+#include "message/order_event_pipeline.h"
+#include "common/logger.h"
+#include "utils/file_utils.h"
+#include "utils/hash_utils.h"
+#include "utils/json_utils.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <unistd.h>
+
+namespace order_engine {
+namespace message {
+
+namespace {
+
+// 序列化线程每轮最多取出的事件数，之后检查等待超时的分区
+constexpr size_t kMaxPopPerRound = 4096;
+
+std::string partitionKey(std::string_view topic, uint32_t partition) {
+    std::string key(topic);
+    key.push_back('-');
+    key += std::to_string(partition);
+    return key;
+}
+
+} // namespace
+
+// ==================== FileEventSink ====================
+
+FileEventSink::FileEventSink(std::string dir, size_t segment_size)
+    : dir_(std::move(dir))
+    , segment_size_(std::max<size_t>(segment_size, 4096)) {
+}
+
+FileEventSink::~FileEventSink() {
+    for (auto& [key, segment] : segments_) {
+        if (segment.fd >= 0) {
+            ::close(segment.fd);
+        }
+    }
+}
+
+std::string FileEventSink::segmentName(uint64_t base_offset) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%020llu.log", static_cast<unsigned long long>(base_offset));
+    return name;
+}
+
+uint64_t FileEventSink::nextOffset(std::string_view topic, uint32_t partition) const {
+    auto it = segments_.find(partitionKey(topic, partition));
+    return it == segments_.end() ? 0 : it->second.next_offset;
+}
+
+bool FileEventSink::write(const EventBatch& batch) {
+    if (batch.count() == 0) {
+        return true;
+    }
+    std::string key = partitionKey(batch.topic, batch.partition);
+    auto [it, inserted] = segments_.try_emplace(key);
+    Segment& segment = it->second;
+    std::string partition_dir = dir_ + "/" + key;
+
+    if (inserted) {
+        // 首次写入该分区：接着目录中最新的段继续追加
+        std::error_code ec;
+        std::filesystem::create_directories(partition_dir, ec);
+        uint64_t base = 0;
+        bool found = false;
+        for (const auto& entry : std::filesystem::directory_iterator(partition_dir, ec)) {
+            const std::string name = entry.path().filename().string();
+            if (name.size() == 24 && name.find_first_not_of("0123456789") == 20 && name.compare(20, 4, ".log") == 0) {
+                base = std::max<uint64_t>(base, std::stoull(name.substr(0, 20)));
+                found = true;
+            }
+        }
+        if (found) {
+            std::string content;
+            if (!utils::readFile(partition_dir + "/" + segmentName(base), content)) {
+                return false;
+            }
+            segment.fd = ::open((partition_dir + "/" + segmentName(base)).c_str(), O_WRONLY | O_CLOEXEC);
+            segment.bytes = content.size();
+            segment.next_offset = base + static_cast<uint64_t>(std::count(content.begin(), content.end(), '\n'));
+        }
+    }
+
+    if ((segment.fd < 0 || segment.bytes >= segment_size_) && !roll(partition_dir, segment)) {
+        return false;
+    }
+    if (!utils::writeFully(segment.fd, batch.payload.data(), batch.payload.size(),
+                           static_cast<off_t>(segment.bytes))) {
+        LOG_ERROR_FMT("FileEventSink write failed: {}", std::string(std::strerror(errno)));
+        return false;
+    }
+    segment.bytes += batch.payload.size();
+    segment.next_offset += batch.count();
+    return true;
+}
+
+bool FileEventSink::roll(const std::string& partition_dir, Segment& segment) {
+    if (segment.fd >= 0) {
+        ::close(segment.fd);
+    }
+    std::string path = partition_dir + "/" + segmentName(segment.next_offset);
+    segment.fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    segment.bytes = 0;
+    if (segment.fd < 0) {
+        LOG_ERROR_FMT("FileEventSink cannot open segment: {}", path);
+        return false;
+    }
+    return true;
+}
+
+// ==================== OrderEventPipeline ====================
+
+OrderEventPipeline::OrderEventPipeline(std::shared_ptr<EventSink> sink, EventPipelineOptions options)
+    : sink_(std::move(sink))
+    , options_(std::move(options))
+    , ring_(options_.ring_capacity)
+    , running_(false)
+    , published_(0)
+    , dropped_(0)
+    , sent_(0)
+    , batch_count_(0)
+    , failed_batch_count_(0) {
+    options_.partitions = std::max<uint32_t>(options_.partitions, 1);
+    batches_.resize(options_.partitions);
+    for (uint32_t i = 0; i < options_.partitions; ++i) {
+        batches_[i].topic = options_.topic;
+        batches_[i].partition = i;
+        batches_[i].payload.reserve(options_.batch_bytes + 256);
+    }
+}
+
+OrderEventPipeline::~OrderEventPipeline() {
+    stop();
+}
+
+void OrderEventPipeline::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    serializer_thread_ = std::thread([this]() { serializeLoop(); });
+}
+
+void OrderEventPipeline::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (serializer_thread_.joinable()) {
+        serializer_thread_.join();
+    }
+}
+
+bool OrderEventPipeline::publish(const OrderEvent& event) {
+    if (!ring_.tryPush(event)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    published_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+const char* OrderEventPipeline::eventTypeName(OrderEventType type) {
+    switch (type) {
+        case OrderEventType::kCreated: return "order_created";
+        case OrderEventType::kStatusChanged: return "order_status_changed";
+        case OrderEventType::kCancelled: return "order_cancelled";
+    }
+    return "unknown";
+}
+
+uint32_t OrderEventPipeline::partitionFor(uint64_t order_id, uint32_t partitions) {
+    return static_cast<uint32_t>(utils::mix64(order_id) % partitions);
+}
+
+void OrderEventPipeline::serialize(const OrderEvent& event, std::string& out) {
+    utils::JsonWriter writer(out);
+    writer.startObject();
+    writer.key("event");
+    writer.writeString(eventTypeName(event.type));
+    writer.key("order_id");
+    writer.writeUint(event.order_id);
+    writer.key("user_id");
+    writer.writeUint(event.user_id);
+    writer.key("status");
+    writer.writeString(utils::orderStatusToString(event.status));
+    writer.key("total_amount");
+    writer.writeDouble(event.total_amount);
+    writer.key("timestamp");
+    writer.writeInt(event.timestamp);
+    writer.endObject();
+    out.push_back('\n');
+}
+
+void OrderEventPipeline::serializeLoop() {
+    auto last_drop_log = std::chrono::steady_clock::now();
+    uint64_t logged_dropped = 0;
+
+    auto drain = [this]() {
+        size_t popped = 0;
+        OrderEvent event;
+        while (popped < kMaxPopPerRound && ring_.tryPop(event)) {
+            EventBatch& batch = batches_[partitionFor(event.order_id, options_.partitions)];
+            if (batch.offsets.empty()) {
+                batch.first_at = std::chrono::steady_clock::now();
+            }
+            batch.offsets.push_back(static_cast<uint32_t>(batch.payload.size()));
+            batch.keys.push_back(event.order_id);
+            serialize(event, batch.payload);
+            if (batch.payload.size() >= options_.batch_bytes) {
+                send(batch);
+            }
+            ++popped;
+        }
+        return popped;
+    };
+
+    while (running_.load(std::memory_order_acquire)) {
+        size_t popped = drain();
+        auto now = std::chrono::steady_clock::now();
+        flushReady(now, false);
+
+        uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped > logged_dropped && now - last_drop_log >= std::chrono::seconds(1)) {
+            LOG_ERROR_FMT("OrderEventPipeline queue full, dropped events: {}",
+                          std::to_string(dropped - logged_dropped));
+            logged_dropped = dropped;
+            last_drop_log = now;
+        }
+        if (popped == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // 停止：交出剩余事件
+    while (drain() > 0) {
+    }
+    flushReady(std::chrono::steady_clock::now(), true);
+    sink_->flush();
+}
+
+void OrderEventPipeline::flushReady(std::chrono::steady_clock::time_point now, bool force) {
+    auto linger = std::chrono::milliseconds(options_.linger_ms);
+    for (EventBatch& batch : batches_) {
+        if (!batch.offsets.empty() && (force || now - batch.first_at >= linger)) {
+            send(batch);
+        }
+    }
+}
+
+void OrderEventPipeline::send(EventBatch& batch) {
+    bool ok = sink_->write(batch);
+    batch_count_.fetch_add(1, std::memory_order_relaxed);
+    if (ok) {
+        sent_.fetch_add(batch.count(), std::memory_order_relaxed);
+    } else {
+        failed_batch_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+    batch.clear();
+}
+
+} // namespace message
+} // namespace order_engine
@@ -0,0 +1,115 @@
+#include "network/coroutine.h"
+#include "common/logger.h"
+#include <new>
+
+namespace order_engine {
+namespace network {
+
+namespace {
+
+thread_local FramePool* t_current_pool = nullptr;
+
+// 帧头部：记录分配来源，保持16字节对齐
+struct alignas(16) FrameHeader {
+    FramePool* owner;
+};
+
+} // namespace
+
+FramePool::~FramePool() {
+    for (size_t i = 0; i < kNumClasses; ++i) {
+        FreeBlock* block = free_lists_[i];
+        while (block) {
+            FreeBlock* next = block->next;
+            ::operator delete(block);
+            block = next;
+        }
+        free_lists_[i] = nullptr;
+        free_counts_[i] = 0;
+    }
+}
+
+void* FramePool::allocate(size_t size) {
+    ++alloc_count_;
+    size_t cls = sizeClass(size);
+    if (cls < kNumClasses && free_lists_[cls]) {
+        FreeBlock* block = free_lists_[cls];
+        free_lists_[cls] = block->next;
+        --free_counts_[cls];
+        ++reuse_count_;
+        return block;
+    }
+    // 按分级大小向上取整分配，保证归还后可被同级复用
+    size_t alloc_size = cls < kNumClasses ? cls * kGranularity : size;
+    return ::operator new(alloc_size);
+}
+
+void FramePool::deallocate(void* ptr, size_t size) {
+    size_t cls = sizeClass(size);
+    if (cls < kNumClasses && free_counts_[cls] < kMaxCachedPerClass) {
+        FreeBlock* block = static_cast<FreeBlock*>(ptr);
+        block->next = free_lists_[cls];
+        free_lists_[cls] = block;
+        ++free_counts_[cls];
+        return;
+    }
+    ::operator delete(ptr);
+}
+
+size_t FramePool::getCachedBlocks() const {
+    size_t total = 0;
+    for (size_t i = 0; i < kNumClasses; ++i) {
+        total += free_counts_[i];
+    }
+    return total;
+}
+
+FramePool* FramePool::current() {
+    return t_current_pool;
+}
+
+void FramePool::setCurrent(FramePool* pool) {
+    t_current_pool = pool;
+}
+
+namespace detail {
+
+void* allocateFrame(size_t size) {
+    FramePool* pool = t_current_pool;
+    size_t total = size + sizeof(FrameHeader);
+    void* raw = pool ? pool->allocate(total) : ::operator new(total);
+    auto* header = static_cast<FrameHeader*>(raw);
+    header->owner = pool;
+    return header + 1;
+}
+
+void deallocateFrame(void* ptr, size_t size) {
+    auto* header = static_cast<FrameHeader*>(ptr) - 1;
+    size_t total = size + sizeof(FrameHeader);
+    FramePool* owner = header->owner;
+    // 只有在所属线程上才能归还到池中；跨线程释放直接交还全局堆
+    if (owner && owner == t_current_pool) {
+        owner->deallocate(header, total);
+    } else {
+        ::operator delete(header);
+    }
+}
+
+void DetachedTask::promise_type::unhandled_exception() const noexcept {
+    try {
+        throw;
+    } catch (const std::exception& e) {
+        LOG_ERROR_FMT("Detached coroutine terminated by exception: {}", std::string(e.what()));
+    } catch (...) {
+        LOG_ERROR("Detached coroutine terminated by unknown exception");
+    }
+}
+
+DetachedTask runDetached(Task<void> task) {
+    co_await task;
+}
+
+} // namespace detail
+
+} // namespace network
+} // namespace order_engine
@@ -41,6 +41,8 @@ Reactor::Reactor()
 
 Reactor::~Reactor() {
     LOG_DEBUG("Reactor destroyed");
+    // 事件循环已退出，析构线程接管Reactor以注销唤醒通道
+    thread_id_ = std::this_thread::get_id();
     wakeup_channel_->disableAll();
     wakeup_channel_->remove();
 #ifdef _WIN32
@@ -73,15 +75,20 @@ int Reactor::createEventfd() {
 
 void Reactor::loop() {
     assert(!quit_);
-    assert(isInLoopThread());
+    
+    // TcpServer在启动线程中创建Reactor、在工作线程中loop，这里绑定到实际的事件循环线程
+    thread_id_ = std::this_thread::get_id();
     
     LOG_INFO("Reactor started looping");
     
+    // 本线程创建的协程帧从该Reactor的内存池分配
+    FramePool::setCurrent(&frame_pool_);
+    
     while (!quit_) {
         active_channels_.clear();
         
-        // 等待事件，超时时间1秒
-        poller_->poll(1000, &active_channels_);
+        // 等待事件，超时时间取最近的协程唤醒时间，最长1秒
+        poller_->poll(nextPollTimeout(), &active_channels_);
         
         // 处理活跃事件
         for (Channel* channel : active_channels_) {
@@ -90,8 +97,12 @@ void Reactor::loop() {
         
         // 处理待执行任务
         doPendingTasks();
+        
+        // 恢复到期的协程
+        resumeExpiredSleepers();
     }
     
+    FramePool::setCurrent(nullptr);
     LOG_INFO("Reactor stopped looping");
 }
 
@@ -172,6 +183,40 @@ void Reactor::runEvery(const Task& task, double interval_seconds) {
     }, interval_seconds);
 }
 
+Reactor::SleepAwaiter Reactor::sleep(double delay_seconds) {
+    auto delay = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(delay_seconds > 0 ? delay_seconds : 0));
+    return SleepAwaiter(this, Clock::now() + delay);
+}
+
+void Reactor::addSleeper(Clock::time_point deadline, std::coroutine_handle<> handle) {
+    // 只允许在Reactor线程中挂起，睡眠队列不加锁
+    sleepers_.push_back(Sleeper{deadline, handle});
+    std::push_heap(sleepers_.begin(), sleepers_.end(), std::greater<Sleeper>());
+}
+
+void Reactor::resumeExpiredSleepers() {
+    Clock::time_point now = Clock::now();
+    while (!sleepers_.empty() && sleepers_.front().deadline <= now) {
+        std::pop_heap(sleepers_.begin(), sleepers_.end(), std::greater<Sleeper>());
+        std::coroutine_handle<> handle = sleepers_.back().handle;
+        sleepers_.pop_back();
+        handle.resume();
+    }
+}
+
+int Reactor::nextPollTimeout() const {
+    if (sleepers_.empty()) {
+        return kMaxPollTimeoutMs;
+    }
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        sleepers_.front().deadline - Clock::now()).count();
+    if (remaining <= 0) {
+        return 0;
+    }
+    return remaining < kMaxPollTimeoutMs ? static_cast<int>(remaining) + 1 : kMaxPollTimeoutMs;
+}
+
 void Reactor::wakeup() {
 #ifdef _WIN32
     // Windows简化实现：通过socket发送数据
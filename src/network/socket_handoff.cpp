@@ -0,0 +1,338 @@
+#include "network/socket_handoff.h"
+#include "common/logger.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <cstring>
+#include <algorithm>
+
+namespace order_engine {
+namespace network {
+
+SocketHandoff::SocketHandoff(const std::string& socket_path)
+    : socket_path_(socket_path)
+    , listen_fd_(-1)
+    , client_fd_(-1)
+    , peer_fd_(-1) {
+}
+
+SocketHandoff::~SocketHandoff() {
+    close();
+}
+
+bool SocketHandoff::startListening() {
+    struct sockaddr_un addr;
+    if (socket_path_.size() >= sizeof(addr.sun_path)) {
+        LOG_ERROR_FMT("Handoff socket path too long: {}", socket_path_);
+        return false;
+    }
+
+    listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        LOG_ERROR("Create handoff socket failed");
+        return false;
+    }
+
+    // 旧进程交接完成后不会删除路径，这里接管
+    ::unlink(socket_path_.c_str());
+
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socket_path_.c_str(), sizeof(addr.sun_path) - 1);
+
+    if (::bind(listen_fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        ::listen(listen_fd_, 1) < 0) {
+        LOG_ERROR_FMT("Bind handoff socket failed: {}", socket_path_);
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    LOG_INFO_FMT("Hot restart handoff listening on: {}", socket_path_);
+    return true;
+}
+
+bool SocketHandoff::hasPendingRequest(int timeout_ms) {
+    return listen_fd_ >= 0 && waitReadable(listen_fd_, timeout_ms);
+}
+
+bool SocketHandoff::serve(const HandoffFds& fds, int ack_timeout_ms) {
+    int client_fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (client_fd < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            LOG_ERROR("Accept handoff request failed");
+        }
+        return false;
+    }
+
+    bool ok = sendFds(client_fd, fds);
+    if (ok) {
+        // 等待新进程确认完成初始化
+        char ack = 0;
+        ok = waitReadable(client_fd, ack_timeout_ms) &&
+             ::read(client_fd, &ack, 1) == 1 && ack == 'A';
+        if (!ok) {
+            LOG_WARN("Handoff not confirmed by new process, keep serving");
+        }
+    }
+
+    if (!ok) {
+        ::close(client_fd);
+        return false;
+    }
+    if (client_fd_ >= 0) {
+        ::close(client_fd_);
+    }
+    client_fd_ = client_fd;
+
+    char buffer[128];
+    snprintf(buffer, sizeof(buffer), "Handed off %zu listen fds and %zu connections",
+             fds.listen_fds.size(), fds.connection_fds.size());
+    LOG_INFO(buffer);
+    return true;
+}
+
+void SocketHandoff::stopListening() {
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+    }
+}
+
+bool SocketHandoff::releaseJournal(uint64_t last_lsn) {
+    if (client_fd_ < 0) {
+        return false;
+    }
+    char message[1 + sizeof(last_lsn)];
+    message[0] = kJournalReleased;
+    std::memcpy(message + 1, &last_lsn, sizeof(last_lsn));
+    // 新进程可能已退出，不能因SIGPIPE终止
+    bool ok = ::send(client_fd_, message, sizeof(message), MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(message));
+    ::close(client_fd_);
+    client_fd_ = -1;
+    if (!ok) {
+        LOG_WARN("Failed to notify new process of journal release");
+    }
+    return ok;
+}
+
+bool SocketHandoff::requestFrom(HandoffFds& fds, int timeout_ms) {
+    struct sockaddr_un addr;
+    if (socket_path_.size() >= sizeof(addr.sun_path)) {
+        LOG_ERROR_FMT("Handoff socket path too long: {}", socket_path_);
+        return false;
+    }
+
+    peer_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (peer_fd_ < 0) {
+        LOG_ERROR("Create handoff client socket failed");
+        return false;
+    }
+
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socket_path_.c_str(), sizeof(addr.sun_path) - 1);
+
+    if (::connect(peer_fd_, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        LOG_ERROR_FMT("Connect to old process failed: {}", socket_path_);
+        ::close(peer_fd_);
+        peer_fd_ = -1;
+        return false;
+    }
+
+    if (!waitReadable(peer_fd_, timeout_ms) || !recvFds(peer_fd_, fds)) {
+        LOG_ERROR("Receive handoff fds failed");
+        ::close(peer_fd_);
+        peer_fd_ = -1;
+        return false;
+    }
+
+    return true;
+}
+
+bool SocketHandoff::confirm() {
+    if (peer_fd_ < 0) {
+        return false;
+    }
+
+    // 连接保留到旧进程交出日志
+    char ack = 'A';
+    return ::write(peer_fd_, &ack, 1) == 1;
+}
+
+bool SocketHandoff::waitJournalRelease(uint64_t& last_lsn, int timeout_ms) {
+    if (peer_fd_ < 0) {
+        return false;
+    }
+    char message[1 + sizeof(last_lsn)];
+    bool ok = waitReadable(peer_fd_, timeout_ms) &&
+              ::recv(peer_fd_, message, sizeof(message), MSG_WAITALL) == static_cast<ssize_t>(sizeof(message)) &&
+              message[0] == kJournalReleased;
+    ::close(peer_fd_);
+    peer_fd_ = -1;
+    if (!ok) {
+        LOG_ERROR("Old process did not release the order journal");
+        return false;
+    }
+    std::memcpy(&last_lsn, message + 1, sizeof(last_lsn));
+    return true;
+}
+
+void SocketHandoff::close() {
+    stopListening();
+    if (client_fd_ >= 0) {
+        ::close(client_fd_);
+        client_fd_ = -1;
+    }
+    if (peer_fd_ >= 0) {
+        ::close(peer_fd_);
+        peer_fd_ = -1;
+    }
+}
+
+bool SocketHandoff::sendFds(int sock, const HandoffFds& fds) {
+    std::vector<int> all(fds.listen_fds);
+    all.insert(all.end(), fds.connection_fds.begin(), fds.connection_fds.end());
+
+    Header header;
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.listen_count = static_cast<uint32_t>(fds.listen_fds.size());
+    header.connection_count = static_cast<uint32_t>(fds.connection_fds.size());
+
+    // 首条消息携带协议头，后续消息携带1字节占位数据；每条最多kMaxFdsPerMessage个fd
+    size_t offset = 0;
+    bool first = true;
+    do {
+        size_t count = std::min(kMaxFdsPerMessage, all.size() - offset);
+        char placeholder = 0;
+        struct iovec iov;
+        iov.iov_base = first ? static_cast<void*>(&header) : static_cast<void*>(&placeholder);
+        iov.iov_len = first ? sizeof(header) : sizeof(placeholder);
+
+        char control[CMSG_SPACE(sizeof(int) * kMaxFdsPerMessage)];
+        std::memset(control, 0, sizeof(control));
+
+        struct msghdr msg;
+        std::memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+
+        if (count > 0) {
+            msg.msg_control = control;
+            msg.msg_controllen = CMSG_SPACE(sizeof(int) * count);
+            struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(int) * count);
+            std::memcpy(CMSG_DATA(cmsg), all.data() + offset, sizeof(int) * count);
+        }
+
+        ssize_t n;
+        do {
+            n = ::sendmsg(sock, &msg, MSG_NOSIGNAL);
+        } while (n < 0 && errno == EINTR);
+
+        if (n != static_cast<ssize_t>(iov.iov_len)) {
+            LOG_ERROR("sendmsg with SCM_RIGHTS failed");
+            return false;
+        }
+
+        offset += count;
+        first = false;
+    } while (offset < all.size());
+
+    return true;
+}
+
+bool SocketHandoff::recvFds(int sock, HandoffFds& fds) {
+    fds.listen_fds.clear();
+    fds.connection_fds.clear();
+
+    std::vector<int> all;
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    size_t expected = 0;
+    bool first = true;
+    bool failed = false;
+
+    do {
+        char placeholder = 0;
+        struct iovec iov;
+        iov.iov_base = first ? static_cast<void*>(&header) : static_cast<void*>(&placeholder);
+        iov.iov_len = first ? sizeof(header) : sizeof(placeholder);
+
+        char control[CMSG_SPACE(sizeof(int) * kMaxFdsPerMessage)];
+        struct msghdr msg;
+        std::memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        ssize_t n;
+        do {
+            n = ::recvmsg(sock, &msg, MSG_CMSG_CLOEXEC | MSG_WAITALL);
+        } while (n < 0 && errno == EINTR);
+
+        if (n != static_cast<ssize_t>(iov.iov_len) || (msg.msg_flags & MSG_CTRUNC)) {
+            LOG_ERROR("recvmsg for handoff failed");
+            failed = true;
+        }
+
+        // 即使失败也收集已到达的fd，统一关闭
+        for (struct cmsghdr* cmsg = n > 0 ? CMSG_FIRSTHDR(&msg) : nullptr; cmsg;
+             cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+                size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                const int* received = reinterpret_cast<const int*>(CMSG_DATA(cmsg));
+                all.insert(all.end(), received, received + count);
+            }
+        }
+
+        if (failed) {
+            break;
+        }
+
+        if (first) {
+            if (header.magic != kMagic || header.version != kVersion) {
+                LOG_ERROR("Invalid handoff header");
+                failed = true;
+                break;
+            }
+            expected = header.listen_count + header.connection_count;
+            first = false;
+        }
+    } while (all.size() < expected);
+
+    if (failed || all.size() != expected) {
+        for (int fd : all) {
+            ::close(fd);
+        }
+        return false;
+    }
+
+    fds.listen_fds.assign(all.begin(), all.begin() + header.listen_count);
+    fds.connection_fds.assign(all.begin() + header.listen_count, all.end());
+    return true;
+}
+
+bool SocketHandoff::waitReadable(int fd, int timeout_ms) {
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    int ret;
+    do {
+        ret = ::poll(&pfd, 1, timeout_ms);
+    } while (ret < 0 && errno == EINTR);
+
+    return ret > 0 && (pfd.revents & POLLIN);
+}
+
+} // namespace network
+} // namespace order_engine
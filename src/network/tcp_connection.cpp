@@ -1,6 +1,8 @@
 #include "network/tcp_connection.h"
 #include "network/reactor.h"
+#include "network/channel.h"
 #include "common/logger.h"
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 
@@ -11,6 +13,7 @@
 #include <unistd.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <errno.h>
 #endif
@@ -22,6 +25,7 @@ TcpConnection::TcpConnection(int sockfd, const struct sockaddr_in& peer_addr)
     : sockfd_(sockfd)
     , peer_addr_(peer_addr)
     , state_(kConnecting)
+    , shutdown_pending_(false)
     , last_active_time_(time(nullptr)) {
     
     LOG_DEBUG("TcpConnection created");
@@ -66,6 +70,20 @@ void TcpConnection::closeConnection() {
         
         setState(kDisconnected);
         LOG_INFO("Connection closed, fd: {}, peer: {}", sockfd_, getPeerAddress());
+        
+        // 唤醒挂起的协程，读返回0，写返回-1
+        resumeWaiter(read_waiter_);
+        resumeWaiter(write_waiter_);
+    }
+}
+
+void TcpConnection::shutdown() {
+    if (state_ != kConnected) {
+        return;
+    }
+    shutdown_pending_ = true;
+    if (output_buffer_.empty()) {
+        ::shutdown(sockfd_, SHUT_WR);
     }
 }
 
@@ -112,6 +130,11 @@ ssize_t TcpConnection::send(const char* data, size_t len) {
         output_buffer_.append(data + nwrote, remaining);
         LOG_TRACE("Add to output buffer, fd: {}, bytes: {}, buffer_size: {}", 
                   sockfd_, remaining, output_buffer_.size());
+        
+        // 关注可写事件，等待内核缓冲区腾出空间
+        if (channel_ && !channel_->isWriting()) {
+            channel_->enableWriting();
+        }
     }
     
     return fault_error ? -1 : static_cast<ssize_t>(len);
@@ -128,8 +151,14 @@ void TcpConnection::handleRead() {
         LOG_TRACE("Read data, fd: {}, bytes: {}, buffer_size: {}", 
                   sockfd_, n, input_buffer_.size());
         
-        // 处理接收到的数据
-        if (message_callback_) {
+        // 处理接收到的数据：优先交给挂起的读协程
+        if (read_waiter_) {
+            resumeWaiter(read_waiter_);
+        } else if (buffer_callback_) {
+            // 就地解析，只丢弃已消费的完整帧
+            size_t consumed = buffer_callback_(shared_from_this(), input_buffer_.data(), input_buffer_.size());
+            input_buffer_.erase(0, std::min(consumed, input_buffer_.size()));
+        } else if (message_callback_) {
             message_callback_(shared_from_this(), input_buffer_);
             input_buffer_.clear(); // 简化处理，清空缓冲区
         }
@@ -163,6 +192,13 @@ void TcpConnection::handleWrite() {
         if (output_buffer_.empty()) {
             // 输出缓冲区已清空，可以禁用写事件
             LOG_TRACE("Output buffer cleared, fd: {}", sockfd_);
+            if (channel_) {
+                channel_->disableWriting();
+            }
+            if (shutdown_pending_) {
+                ::shutdown(sockfd_, SHUT_WR);
+            }
+            resumeWaiter(write_waiter_);
         }
     } else {
         if (errno != EWOULDBLOCK && errno != EAGAIN) {
@@ -189,6 +225,50 @@ bool TcpConnection::isTimeout(int timeout_seconds) const {
     return (now - last_active) > timeout_seconds;
 }
 
+Reactor* TcpConnection::ownerReactor() const {
+    return channel_ ? channel_->ownerReactor() : nullptr;
+}
+
+int TcpConnection::detachForHandoff() {
+    if (state_ != kConnected || !input_buffer_.empty() || !output_buffer_.empty() ||
+        read_waiter_ || write_waiter_) {
+        return -1;
+    }
+    
+    // 复制fd后停止本进程的读写；本进程关闭原fd不会向对端发送FIN
+    int fd = ::dup(sockfd_);
+    if (fd < 0) {
+        LOG_ERROR("Dup connection fd failed, fd: {}, errno: {}", sockfd_, errno);
+        return -1;
+    }
+    
+    if (channel_) {
+        channel_->disableAll();
+        channel_->remove();
+    }
+    
+    closeConnection();
+    return fd;
+}
+
+size_t TcpConnection::consumeInput(char* buf, size_t len) {
+    size_t n = std::min(len, input_buffer_.size());
+    if (n > 0) {
+        std::memcpy(buf, input_buffer_.data(), n);
+        input_buffer_.erase(0, n);
+    }
+    return n;
+}
+
+void TcpConnection::resumeWaiter(std::coroutine_handle<>& waiter) {
+    if (waiter) {
+        // 先清空再恢复，协程可能在恢复过程中再次挂起
+        std::coroutine_handle<> handle = waiter;
+        waiter = nullptr;
+        handle.resume();
+    }
+}
+
 void TcpConnection::handleError() {
     int err = 0;
     socklen_t optlen = sizeof(err);
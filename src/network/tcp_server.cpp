@@ -7,6 +7,9 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <cassert>
+#include <cstring>
+#include <chrono>
+#include <future>
 
 namespace order_engine {
 namespace network {
@@ -33,49 +36,16 @@ bool TcpServer::start() {
         return true;
     }
     
-    // 创建监听socket
-    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
-    if (listen_fd_ < 0) {
-        LOG_ERROR("Create listen socket failed, errno: {}", errno);
-        return false;
-    }
-    
-    // 设置socket选项
-    int on = 1;
-    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
-    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
-    
-    // 绑定地址
-    struct sockaddr_in server_addr;
-    std::memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(port_);
-    
-    if (ip_ == "0.0.0.0") {
-        server_addr.sin_addr.s_addr = INADDR_ANY;
-    } else {
-        if (::inet_pton(AF_INET, ip_.c_str(), &server_addr.sin_addr) <= 0) {
-            LOG_ERROR("Invalid IP address: {}", ip_);
-            ::close(listen_fd_);
-            return false;
-        }
-    }
-    
-    if (::bind(listen_fd_, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
-        LOG_ERROR("Bind address {}:{} failed, errno: {}", ip_, port_, errno);
-        ::close(listen_fd_);
-        return false;
-    }
-    
-    // 开始监听
-    if (::listen(listen_fd_, SOMAXCONN) < 0) {
-        LOG_ERROR("Listen failed, errno: {}", errno);
-        ::close(listen_fd_);
+    if (listen_fd_ >= 0) {
+        // 热重启：沿用旧进程交来的监听socket
+        int flags = ::fcntl(listen_fd_, F_GETFL, 0);
+        ::fcntl(listen_fd_, F_SETFL, flags | O_NONBLOCK);
+        ::fcntl(listen_fd_, F_SETFD, FD_CLOEXEC);
+        LOG_INFO("Adopted listen fd: {} for {}:{}", listen_fd_, ip_, port_);
+    } else if (!createListenSocket()) {
         return false;
     }
     
-    LOG_INFO("Listen on {}:{}, fd: {}", ip_, port_, listen_fd_);
-    
     // 创建主Reactor
     main_reactor_ = std::make_unique<Reactor>();
     
@@ -123,11 +93,7 @@ void TcpServer::stop() {
     LOG_INFO("TcpServer stopping...");
     
     // 停止接受新连接
-    if (accept_channel_) {
-        accept_channel_->disableAll();
-        accept_channel_->remove();
-        accept_channel_.reset();
-    }
+    stopAccepting();
     
     // 关闭监听socket
     if (listen_fd_ >= 0) {
@@ -167,6 +133,55 @@ void TcpServer::stop() {
     LOG_INFO("TcpServer stopped");
 }
 
+bool TcpServer::createListenSocket() {
+    // 创建监听socket
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (listen_fd_ < 0) {
+        LOG_ERROR("Create listen socket failed, errno: {}", errno);
+        return false;
+    }
+    
+    // 设置socket选项
+    int on = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+    
+    // 绑定地址
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(port_);
+    
+    if (ip_ == "0.0.0.0") {
+        server_addr.sin_addr.s_addr = INADDR_ANY;
+    } else {
+        if (::inet_pton(AF_INET, ip_.c_str(), &server_addr.sin_addr) <= 0) {
+            LOG_ERROR("Invalid IP address: {}", ip_);
+            ::close(listen_fd_);
+            listen_fd_ = -1;
+            return false;
+        }
+    }
+    
+    if (::bind(listen_fd_, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
+        LOG_ERROR("Bind address {}:{} failed, errno: {}", ip_, port_, errno);
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    
+    // 开始监听
+    if (::listen(listen_fd_, SOMAXCONN) < 0) {
+        LOG_ERROR("Listen failed, errno: {}", errno);
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+    
+    LOG_INFO("Listen on {}:{}, fd: {}", ip_, port_, listen_fd_);
+    return true;
+}
+
 void TcpServer::acceptConnection() {
     struct sockaddr_in peer_addr;
     socklen_t addrlen = sizeof(peer_addr);
@@ -201,6 +216,7 @@ void TcpServer::handleNewConnection(int connfd, const struct sockaddr_in& peer_a
     
     // 设置回调函数
     conn->setMessageCallback(message_callback_);
+    conn->setBufferCallback(buffer_callback_);
     conn->setCloseCallback([this](const TcpConnectionPtr& conn) {
         removeConnection(conn);
         if (connection_callback_) {
@@ -254,6 +270,123 @@ void TcpServer::removeConnection(const TcpConnectionPtr& conn) {
               fd, conn->getPeerAddress(), getConnectionCount());
 }
 
+void TcpServer::adoptListenFd(int listen_fd) {
+    if (running_.load()) {
+        LOG_WARN("TcpServer already running, cannot adopt listen fd");
+        return;
+    }
+    listen_fd_ = listen_fd;
+}
+
+bool TcpServer::adoptConnection(int connfd) {
+    if (!running_.load()) {
+        LOG_WARN("TcpServer not running, cannot adopt connection fd: {}", connfd);
+        return false;
+    }
+    
+    struct sockaddr_in peer_addr;
+    socklen_t addrlen = sizeof(peer_addr);
+    std::memset(&peer_addr, 0, sizeof(peer_addr));
+    if (::getpeername(connfd, (struct sockaddr*)&peer_addr, &addrlen) < 0) {
+        LOG_ERROR("Adopted connection is not connected, fd: {}, errno: {}", connfd, errno);
+        ::close(connfd);
+        return false;
+    }
+    
+    int flags = ::fcntl(connfd, F_GETFL, 0);
+    ::fcntl(connfd, F_SETFL, flags | O_NONBLOCK);
+    
+    handleNewConnection(connfd, peer_addr);
+    return true;
+}
+
+std::vector<int> TcpServer::detachIdleConnections(int idle_seconds) {
+    std::vector<int> fds;
+    if (!running_.load()) {
+        return fds;
+    }
+    
+    std::vector<TcpConnectionPtr> candidates;
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        for (auto& pair : connections_) {
+            if (pair.second->isConnected() && pair.second->isTimeout(idle_seconds)) {
+                candidates.push_back(pair.second);
+            }
+        }
+    }
+    
+    // 摘除操作必须在连接所属的Reactor线程中执行
+    std::vector<std::future<int>> results;
+    results.reserve(candidates.size());
+    for (auto& conn : candidates) {
+        Reactor* reactor = conn->ownerReactor();
+        if (!reactor) {
+            continue;
+        }
+        auto promise = std::make_shared<std::promise<int>>();
+        results.push_back(promise->get_future());
+        reactor->queueInLoop([conn, promise]() {
+            promise->set_value(conn->detachForHandoff());
+        });
+    }
+    
+    for (auto& result : results) {
+        int fd = result.get();
+        if (fd >= 0) {
+            fds.push_back(fd);
+        }
+    }
+    
+    LOG_INFO("Detached {} idle connections for handoff", fds.size());
+    return fds;
+}
+
+void TcpServer::drain(int timeout_seconds) {
+    if (!running_.load()) {
+        return;
+    }
+    
+    LOG_INFO("TcpServer draining, timeout: {}s", timeout_seconds);
+    
+    stopAccepting();
+    
+    // 监听socket已交给新进程，这里只关闭本进程持有的副本
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+    }
+    
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeout_seconds);
+    while (getConnectionCount() > 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    
+    if (getConnectionCount() > 0) {
+        LOG_WARN("Drain timeout, {} connections will be closed", getConnectionCount());
+    }
+    
+    stop();
+}
+
+void TcpServer::stopAccepting() {
+    if (!main_reactor_) {
+        return;
+    }
+    
+    // accept Channel属于主Reactor，必须在其线程中注销
+    auto stopped = std::make_shared<std::promise<void>>();
+    main_reactor_->queueInLoop([this, stopped]() {
+        if (accept_channel_) {
+            accept_channel_->disableAll();
+            accept_channel_->remove();
+            accept_channel_.reset();
+        }
+        stopped->set_value();
+    });
+    stopped->get_future().wait();
+}
+
 int TcpServer::getConnectionCount() const {
     std::lock_guard<std::mutex> lock(connections_mutex_);
     return static_cast<int>(connections_.size());
@@ -0,0 +1,491 @@
+#include "protocol/order_protocol.h"
+#include "utils/hash_utils.h"
+#include <algorithm>
+#include <cmath>
+
+namespace order_engine {
+namespace protocol {
+
+namespace {
+
+template <typename T>
+inline void append(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+inline void appendZeros(std::string& out, size_t n) {
+    out.append(n, '\0');
+}
+
+template <typename T>
+inline void storeAt(std::string& out, size_t offset, T value) {
+    std::memcpy(&out[offset], &value, sizeof(T));
+}
+
+inline int64_t toCents(double amount) {
+    return static_cast<int64_t>(std::llround(amount * 100.0));
+}
+
+void appendItems(std::string& out, const std::vector<uint64_t>& product_ids,
+                 const std::vector<uint32_t>& quantities, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        append<uint64_t>(out, product_ids[i]);
+        append<uint32_t>(out, quantities[i]);
+        append<uint32_t>(out, 0);  // 单价由服务端按商品表计算
+    }
+}
+
+void fillItems(const char* items, size_t count, services::OrderInfo& order) {
+    order.product_ids.resize(count);
+    order.quantities.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        LineItemView item(items + i * LineItemView::kSize);
+        order.product_ids[i] = item.productId();
+        order.quantities[i] = item.quantity();
+    }
+}
+
+// 商品与数量一一对应，条数在解码端接受的范围内
+bool validItems(const std::vector<uint64_t>& product_ids, const std::vector<uint32_t>& quantities) {
+    return product_ids.size() == quantities.size() &&
+           !product_ids.empty() && product_ids.size() <= kMaxItemsPerOrder;
+}
+
+bool validCreateOrder(const services::OrderInfo& order) {
+    return validItems(order.product_ids, order.quantities) &&
+           order.shipping_address.size() <= UINT16_MAX &&
+           order.payment_method.size() <= UINT8_MAX;
+}
+
+void appendCreateOrderBody(std::string& out, const services::OrderInfo& order) {
+    size_t items = order.product_ids.size();
+    append<uint64_t>(out, order.user_id);
+    append<int64_t>(out, toCents(order.total_amount));
+    append<uint16_t>(out, static_cast<uint16_t>(items));
+    append<uint16_t>(out, static_cast<uint16_t>(order.shipping_address.size()));
+    append<uint8_t>(out, static_cast<uint8_t>(order.payment_method.size()));
+    appendZeros(out, 3);
+    appendItems(out, order.product_ids, order.quantities, items);
+    out.append(order.shipping_address);
+    out.append(order.payment_method);
+}
+
+} // namespace
+
+size_t beginFrame(std::string& out, MessageType type, uint64_t request_id, uint16_t flags) {
+    size_t start = out.size();
+    append<uint16_t>(out, kProtocolMagic);
+    append<uint8_t>(out, kProtocolVersion);
+    append<uint8_t>(out, static_cast<uint8_t>(type));
+    append<uint32_t>(out, 0);           // length，回填
+    append<uint64_t>(out, request_id);
+    append<uint32_t>(out, 0);           // crc32c，回填
+    append<uint16_t>(out, flags);
+    append<uint16_t>(out, 0);           // reserved
+    return start;
+}
+
+void endFrame(std::string& out, size_t start) {
+    size_t payload_offset = start + kFrameHeaderSize;
+    uint32_t length = static_cast<uint32_t>(out.size() - payload_offset);
+    uint32_t crc = utils::crc32c(out.data() + payload_offset, length);
+    storeAt<uint32_t>(out, start + 4, length);
+    storeAt<uint32_t>(out, start + 16, crc);
+}
+
+const char* decodeStatusToString(DecodeStatus status) {
+    switch (status) {
+        case DecodeStatus::kOk:          return "ok";
+        case DecodeStatus::kNeedMore:    return "need more data";
+        case DecodeStatus::kBadMagic:    return "bad magic";
+        case DecodeStatus::kBadVersion:  return "unsupported version";
+        case DecodeStatus::kTooLarge:    return "frame too large";
+        case DecodeStatus::kBadChecksum: return "checksum mismatch";
+        case DecodeStatus::kMalformed:   return "malformed payload";
+        default:                         return "unknown";
+    }
+}
+
+DecodeStatus decodeFrame(const char* data, size_t len, FrameView& frame) {
+    if (len < kFrameHeaderSize) {
+        // 尽早拒绝错误的魔数，避免等待永远不会到来的数据
+        if (len >= 2 && detail::load<uint16_t>(data) != kProtocolMagic) {
+            return DecodeStatus::kBadMagic;
+        }
+        return DecodeStatus::kNeedMore;
+    }
+
+    FrameView view(data);
+    if (detail::load<uint16_t>(data) != kProtocolMagic) {
+        return DecodeStatus::kBadMagic;
+    }
+    if (view.version() != kProtocolVersion) {
+        return DecodeStatus::kBadVersion;
+    }
+    if (view.payloadSize() > kMaxPayloadSize) {
+        return DecodeStatus::kTooLarge;
+    }
+    if (len < view.frameSize()) {
+        return DecodeStatus::kNeedMore;
+    }
+    if (utils::crc32c(view.payload(), view.payloadSize()) != view.checksum()) {
+        return DecodeStatus::kBadChecksum;
+    }
+
+    frame = view;
+    return DecodeStatus::kOk;
+}
+
+// CreateOrderView
+DecodeStatus CreateOrderView::parse(const FrameView& frame, CreateOrderView& view) {
+    if (frame.type() != MessageType::kCreateOrderRequest) {
+        return DecodeStatus::kMalformed;
+    }
+    size_t body_size = 0;
+    CreateOrderView candidate;
+    DecodeStatus status = parseBody(frame.payload(), frame.payloadSize(), candidate, body_size);
+    if (status != DecodeStatus::kOk || body_size != frame.payloadSize()) {
+        return DecodeStatus::kMalformed;
+    }
+    view = candidate;
+    return DecodeStatus::kOk;
+}
+
+DecodeStatus CreateOrderView::parseBody(const char* data, size_t available, CreateOrderView& view,
+                                        size_t& body_size) {
+    if (available < kFixedSize) {
+        return DecodeStatus::kMalformed;
+    }
+
+    CreateOrderView candidate;
+    candidate.data_ = data;
+    size_t items = candidate.itemCount();
+    if (items == 0 || items > kMaxItemsPerOrder) {
+        return DecodeStatus::kMalformed;
+    }
+
+    size_t expected = kFixedSize + items * LineItemView::kSize +
+                      candidate.addressLength() + candidate.paymentLength();
+    if (expected > available) {
+        return DecodeStatus::kMalformed;
+    }
+
+    view = candidate;
+    body_size = expected;
+    return DecodeStatus::kOk;
+}
+
+std::string_view CreateOrderView::shippingAddress() const {
+    const char* p = data_ + kFixedSize + itemCount() * LineItemView::kSize;
+    return std::string_view(p, addressLength());
+}
+
+std::string_view CreateOrderView::paymentMethod() const {
+    const char* p = data_ + kFixedSize + itemCount() * LineItemView::kSize + addressLength();
+    return std::string_view(p, paymentLength());
+}
+
+void CreateOrderView::toOrderInfo(services::OrderInfo& order) const {
+    order.order_id = 0;
+    order.user_id = userId();
+    fillItems(data_ + kFixedSize, itemCount(), order);
+    order.total_amount = static_cast<double>(totalAmountCents()) / 100.0;
+    order.status = services::OrderStatus::PENDING;
+    order.created_at = 0;
+    order.updated_at = 0;
+    order.shipping_address.assign(shippingAddress());
+    order.payment_method.assign(paymentMethod());
+}
+
+// BatchCreateOrderView
+DecodeStatus BatchCreateOrderView::parse(const FrameView& frame, BatchCreateOrderView& view) {
+    size_t size = frame.payloadSize();
+    if (frame.type() != MessageType::kBatchCreateOrderRequest || size < kFixedSize) {
+        return DecodeStatus::kMalformed;
+    }
+
+    // 一次遍历校验全部订单体，之后next()无需再检查边界
+    const char* payload = frame.payload();
+    size_t count = detail::load<uint16_t>(payload);
+    if (count == 0 || count > kMaxOrdersPerBatch) {
+        return DecodeStatus::kMalformed;
+    }
+    size_t offset = kFixedSize;
+    for (size_t i = 0; i < count; ++i) {
+        CreateOrderView order;
+        size_t body_size = 0;
+        if (CreateOrderView::parseBody(payload + offset, size - offset, order, body_size) != DecodeStatus::kOk) {
+            return DecodeStatus::kMalformed;
+        }
+        offset += body_size;
+    }
+    if (offset != size) {
+        return DecodeStatus::kMalformed;
+    }
+
+    view.data_ = payload;
+    view.size_ = size;
+    return DecodeStatus::kOk;
+}
+
+bool BatchCreateOrderView::next(size_t& offset, CreateOrderView& order) const {
+    if (offset < kFixedSize) {
+        offset = kFixedSize;
+    }
+    if (offset >= size_) {
+        return false;
+    }
+    size_t body_size = 0;
+    CreateOrderView::parseBody(data_ + offset, size_ - offset, order, body_size);
+    offset += body_size;
+    return true;
+}
+
+void BatchCreateOrderView::toOrderInfos(std::vector<services::OrderInfo>& orders) const {
+    orders.resize(orderCount());
+    size_t offset = 0;
+    CreateOrderView order;
+    for (size_t i = 0; next(offset, order); ++i) {
+        order.toOrderInfo(orders[i]);
+    }
+}
+
+// QueryOrderView
+DecodeStatus QueryOrderView::parse(const FrameView& frame, QueryOrderView& view) {
+    if (frame.type() != MessageType::kQueryOrderRequest || frame.payloadSize() != kFixedSize) {
+        return DecodeStatus::kMalformed;
+    }
+    view.data_ = frame.payload();
+    return DecodeStatus::kOk;
+}
+
+// CancelOrderView
+DecodeStatus CancelOrderView::parse(const FrameView& frame, CancelOrderView& view) {
+    size_t size = frame.payloadSize();
+    if (frame.type() != MessageType::kCancelOrderRequest || size < kFixedSize) {
+        return DecodeStatus::kMalformed;
+    }
+    const char* payload = frame.payload();
+    if (kFixedSize + detail::load<uint16_t>(payload + 8) != size) {
+        return DecodeStatus::kMalformed;
+    }
+    view.data_ = payload;
+    return DecodeStatus::kOk;
+}
+
+// ReserveStockView
+DecodeStatus ReserveStockView::parse(const FrameView& frame, ReserveStockView& view) {
+    size_t size = frame.payloadSize();
+    if (frame.type() != MessageType::kReserveStockRequest || size < kFixedSize) {
+        return DecodeStatus::kMalformed;
+    }
+    ReserveStockView candidate;
+    candidate.data_ = frame.payload();
+    size_t items = candidate.itemCount();
+    if (items == 0 || items > kMaxItemsPerOrder ||
+        kFixedSize + items * LineItemView::kSize != size) {
+        return DecodeStatus::kMalformed;
+    }
+    view = candidate;
+    return DecodeStatus::kOk;
+}
+
+// OrderRecordView
+DecodeStatus OrderRecordView::parse(const FrameView& frame, OrderRecordView& view) {
+    size_t size = frame.payloadSize();
+    if (frame.type() != MessageType::kQueryOrderResponse || size < kFixedSize) {
+        return DecodeStatus::kMalformed;
+    }
+    OrderRecordView candidate;
+    candidate.data_ = frame.payload();
+    size_t items = candidate.itemCount();
+    size_t expected = kFixedSize + items * LineItemView::kSize +
+                      candidate.addressLength() + candidate.paymentLength();
+    if (items > kMaxItemsPerOrder || expected != size) {
+        return DecodeStatus::kMalformed;
+    }
+    view = candidate;
+    return DecodeStatus::kOk;
+}
+
+std::string_view OrderRecordView::shippingAddress() const {
+    const char* p = data_ + kFixedSize + itemCount() * LineItemView::kSize;
+    return std::string_view(p, addressLength());
+}
+
+std::string_view OrderRecordView::paymentMethod() const {
+    const char* p = data_ + kFixedSize + itemCount() * LineItemView::kSize + addressLength();
+    return std::string_view(p, paymentLength());
+}
+
+void OrderRecordView::toOrderInfo(services::OrderInfo& order) const {
+    order.order_id = orderId();
+    order.user_id = userId();
+    fillItems(data_ + kFixedSize, itemCount(), order);
+    order.total_amount = static_cast<double>(totalAmountCents()) / 100.0;
+    order.status = status();
+    order.created_at = static_cast<time_t>(createdAt());
+    order.updated_at = static_cast<time_t>(updatedAt());
+    order.shipping_address.assign(shippingAddress());
+    order.payment_method.assign(paymentMethod());
+}
+
+// ResultView
+DecodeStatus ResultView::parse(const FrameView& frame, ResultView& view) {
+    size_t size = frame.payloadSize();
+    MessageType type = frame.type();
+    bool is_result = type == MessageType::kCreateOrderResponse ||
+                     type == MessageType::kCancelOrderResponse ||
+                     type == MessageType::kReserveStockResponse ||
+                     type == MessageType::kErrorResponse;
+    if (!is_result || size < kFixedSize) {
+        return DecodeStatus::kMalformed;
+    }
+    const char* payload = frame.payload();
+    if (kFixedSize + detail::load<uint16_t>(payload + 10) != size) {
+        return DecodeStatus::kMalformed;
+    }
+    view.data_ = payload;
+    return DecodeStatus::kOk;
+}
+
+// BatchResultView
+DecodeStatus BatchResultView::parse(const FrameView& frame, BatchResultView& view) {
+    size_t size = frame.payloadSize();
+    if (frame.type() != MessageType::kBatchCreateOrderResponse || size < kFixedSize) {
+        return DecodeStatus::kMalformed;
+    }
+    const char* payload = frame.payload();
+    if (kFixedSize + detail::load<uint16_t>(payload) * kEntrySize != size) {
+        return DecodeStatus::kMalformed;
+    }
+    view.data_ = payload;
+    return DecodeStatus::kOk;
+}
+
+// 编码
+bool encodeCreateOrderRequest(std::string& out, uint64_t request_id, const services::OrderInfo& order) {
+    if (!validCreateOrder(order)) {
+        return false;
+    }
+    size_t start = beginFrame(out, MessageType::kCreateOrderRequest, request_id);
+    appendCreateOrderBody(out, order);
+    endFrame(out, start);
+    return true;
+}
+
+bool encodeBatchCreateOrderRequest(std::string& out, uint64_t request_id,
+                                   const std::vector<services::OrderInfo>& orders) {
+    if (orders.empty() || orders.size() > kMaxOrdersPerBatch ||
+        !std::all_of(orders.begin(), orders.end(), validCreateOrder)) {
+        return false;
+    }
+    size_t start = beginFrame(out, MessageType::kBatchCreateOrderRequest, request_id);
+    append<uint16_t>(out, static_cast<uint16_t>(orders.size()));
+    appendZeros(out, 6);
+    for (const auto& order : orders) {
+        appendCreateOrderBody(out, order);
+    }
+    // 单个订单都合法时合计仍可能超过帧上限，对端会整帧拒绝
+    if (out.size() - start - kFrameHeaderSize > kMaxPayloadSize) {
+        out.resize(start);
+        return false;
+    }
+    endFrame(out, start);
+    return true;
+}
+
+void encodeBatchCreateOrderResponse(std::string& out, uint64_t request_id,
+                                    const std::vector<services::OrderResult>& results) {
+    size_t count = std::min(results.size(), kMaxOrdersPerBatch);
+    size_t start = beginFrame(out, MessageType::kBatchCreateOrderResponse, request_id);
+    out.reserve(out.size() + BatchResultView::kFixedSize + count * BatchResultView::kEntrySize);
+    append<uint16_t>(out, static_cast<uint16_t>(count));
+    appendZeros(out, 6);
+    for (size_t i = 0; i < count; ++i) {
+        append<uint64_t>(out, results[i].order_id);
+        append<uint16_t>(out, static_cast<uint16_t>(results[i].code));
+        appendZeros(out, 6);
+    }
+    endFrame(out, start);
+}
+
+void encodeQueryOrderRequest(std::string& out, uint64_t request_id, uint64_t order_id) {
+    size_t start = beginFrame(out, MessageType::kQueryOrderRequest, request_id);
+    append<uint64_t>(out, order_id);
+    endFrame(out, start);
+}
+
+void encodeCancelOrderRequest(std::string& out, uint64_t request_id, uint64_t order_id,
+                              std::string_view reason) {
+    size_t reason_len = std::min<size_t>(reason.size(), UINT16_MAX);
+    size_t start = beginFrame(out, MessageType::kCancelOrderRequest, request_id);
+    append<uint64_t>(out, order_id);
+    append<uint16_t>(out, static_cast<uint16_t>(reason_len));
+    appendZeros(out, 6);
+    out.append(reason.data(), reason_len);
+    endFrame(out, start);
+}
+
+bool encodeReserveStockRequest(std::string& out, uint64_t request_id, uint64_t order_id,
+                               const std::vector<uint64_t>& product_ids,
+                               const std::vector<uint32_t>& quantities,
+                               uint32_t timeout_seconds) {
+    if (!validItems(product_ids, quantities)) {
+        return false;
+    }
+    size_t items = product_ids.size();
+    size_t start = beginFrame(out, MessageType::kReserveStockRequest, request_id);
+    append<uint64_t>(out, order_id);
+    append<uint32_t>(out, timeout_seconds);
+    append<uint16_t>(out, static_cast<uint16_t>(items));
+    append<uint16_t>(out, 0);
+    appendItems(out, product_ids, quantities, items);
+    endFrame(out, start);
+    return true;
+}
+
+bool encodeOrderRecord(std::string& out, uint64_t request_id, ResultCode result,
+                       const services::OrderInfo& order) {
+    // 查询结果允许没有商品，其余限制与创建请求相同
+    if (order.product_ids.size() != order.quantities.size() ||
+        order.product_ids.size() > kMaxItemsPerOrder ||
+        order.shipping_address.size() > UINT16_MAX || order.payment_method.size() > UINT8_MAX) {
+        return false;
+    }
+    size_t items = order.product_ids.size();
+    size_t address_len = order.shipping_address.size();
+    size_t payment_len = order.payment_method.size();
+
+    size_t start = beginFrame(out, MessageType::kQueryOrderResponse, request_id);
+    append<uint64_t>(out, order.order_id);
+    append<uint64_t>(out, order.user_id);
+    append<int64_t>(out, toCents(order.total_amount));
+    append<int64_t>(out, static_cast<int64_t>(order.created_at));
+    append<int64_t>(out, static_cast<int64_t>(order.updated_at));
+    append<uint16_t>(out, static_cast<uint16_t>(result));
+    append<uint8_t>(out, static_cast<uint8_t>(order.status));
+    append<uint8_t>(out, static_cast<uint8_t>(payment_len));
+    append<uint16_t>(out, static_cast<uint16_t>(items));
+    append<uint16_t>(out, static_cast<uint16_t>(address_len));
+    appendItems(out, order.product_ids, order.quantities, items);
+    out.append(order.shipping_address.data(), address_len);
+    out.append(order.payment_method.data(), payment_len);
+    endFrame(out, start);
+    return true;
+}
+
+void encodeResult(std::string& out, MessageType type, uint64_t request_id, uint64_t order_id,
+                  ResultCode result, std::string_view message) {
+    size_t message_len = std::min<size_t>(message.size(), UINT16_MAX);
+    size_t start = beginFrame(out, type, request_id);
+    append<uint64_t>(out, order_id);
+    append<uint16_t>(out, static_cast<uint16_t>(result));
+    append<uint16_t>(out, static_cast<uint16_t>(message_len));
+    append<uint32_t>(out, 0);
+    out.append(message.data(), message_len);
+    endFrame(out, start);
+}
+
+} // namespace protocol
+} // namespace order_engine
@@ -0,0 +1,87 @@
+#include "protocol/protobuf_codec.h"
+#include "order.pb.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace order_engine {
+namespace protocol {
+
+ProtobufCodec::ProtobufCodec(size_t initial_block_size)
+    : block_size_(0)
+    , grow_count_(0)
+    , reset_count_(0) {
+    rebuildArena(std::clamp<size_t>(initial_block_size, 1024, kMaxBlockSize));
+}
+
+ProtobufCodec::~ProtobufCodec() {
+    // arena_必须先于block_析构
+    arena_.reset();
+}
+
+void ProtobufCodec::serialize(std::string& out, MessageType type, uint64_t request_id,
+                              const google::protobuf::MessageLite& message) {
+    size_t start = beginFrame(out, type, request_id, kFlagProtobuf);
+    size_t size = message.ByteSizeLong();
+    size_t payload_offset = out.size();
+    out.resize(payload_offset + size);
+    // ByteSizeLong已缓存各字段长度，直接写入输出缓冲区
+    message.SerializeWithCachedSizesToArray(reinterpret_cast<uint8_t*>(&out[payload_offset]));
+    endFrame(out, start);
+}
+
+void ProtobufCodec::reset() {
+    ++reset_count_;
+    size_t used = arena_->SpaceAllocated();
+    if (used > block_size_ && block_size_ < kMaxBlockSize) {
+        // 本次请求溢出初始块：按峰值扩容，后续同规模请求不再分配
+        ++grow_count_;
+        rebuildArena(std::min(std::bit_ceil(used), kMaxBlockSize));
+        return;
+    }
+    arena_->Reset();
+}
+
+void ProtobufCodec::rebuildArena(size_t block_size) {
+    arena_.reset();
+    block_.reset(new char[block_size]);
+    block_size_ = block_size;
+    arena_.emplace(block_.get(), block_size_);
+}
+
+void toOrderInfo(const proto::CreateOrderRequest& request, services::OrderInfo& order) {
+    order.order_id = 0;
+    order.user_id = request.user_id();
+    order.product_ids.resize(request.items_size());
+    order.quantities.resize(request.items_size());
+    for (int i = 0; i < request.items_size(); ++i) {
+        order.product_ids[i] = request.items(i).product_id();
+        order.quantities[i] = request.items(i).quantity();
+    }
+    order.total_amount = static_cast<double>(request.total_amount_cents()) / 100.0;
+    order.status = services::OrderStatus::PENDING;
+    order.created_at = 0;
+    order.updated_at = 0;
+    order.shipping_address = request.shipping_address();
+    order.payment_method = request.payment_method();
+}
+
+void fromOrderInfo(const services::OrderInfo& order, proto::OrderRecord& record) {
+    record.set_order_id(order.order_id);
+    record.set_user_id(order.user_id);
+    record.set_total_amount_cents(static_cast<int64_t>(std::llround(order.total_amount * 100.0)));
+    record.set_created_at(static_cast<int64_t>(order.created_at));
+    record.set_updated_at(static_cast<int64_t>(order.updated_at));
+    record.set_status(static_cast<uint32_t>(order.status));
+    size_t items = std::min(order.product_ids.size(), order.quantities.size());
+    for (size_t i = 0; i < items; ++i) {
+        proto::LineItem* item = record.add_items();
+        item->set_product_id(order.product_ids[i]);
+        item->set_quantity(order.quantities[i]);
+    }
+    record.set_shipping_address(order.shipping_address);
+    record.set_payment_method(order.payment_method);
+}
+
+} // namespace protocol
+} // namespace order_engine
@@ -0,0 +1,313 @@
+#include "rpc/grpc_server.h"
+#include "protocol/protobuf_codec.h"
+#include "common/logger.h"
+#include "order.pb.h"
+#include <grpcpp/impl/codegen/proto_utils.h>
+#include <grpcpp/security/server_credentials.h>
+#include <grpcpp/server_builder.h>
+#include <google/protobuf/arena.h>
+#include <algorithm>
+#include <cstdint>
+
+namespace order_engine {
+namespace rpc {
+
+namespace {
+
+const char kCreateOrderMethod[] = "/order_engine.proto.OrderService/CreateOrder";
+const char kQueryOrderMethod[] = "/order_engine.proto.OrderService/QueryOrder";
+const char kCancelOrderMethod[] = "/order_engine.proto.OrderService/CancelOrder";
+const char kReserveStockMethod[] = "/order_engine.proto.OrderService/ReserveStock";
+
+using Serializer = grpc::SerializationTraits<google::protobuf::MessageLite>;
+
+} // namespace
+
+/**
+ * @brief 单个RPC调用的状态机
+ *
+ * kRequest（等待新调用）-> kRead（读取请求）-> 业务处理 -> kFinish（响应发出）
+ * 完成队列的tag即Call指针，自身在kFinish完成后释放
+ */
+class GrpcServer::Call {
+public:
+    Call(GrpcServer* server, grpc::ServerCompletionQueue* cq)
+        : server_(server)
+        , cq_(cq)
+        , stream_(&ctx_)
+        , state_(State::kRequest) {
+        server_->generic_service_.RequestCall(&ctx_, &stream_, cq_, cq_, this);
+    }
+
+    void proceed(bool ok) {
+        switch (state_) {
+            case State::kRequest:
+                if (!ok) {
+                    // 服务器关闭，未接收到调用
+                    delete this;
+                    return;
+                }
+                server_->postCall(cq_);
+                state_ = State::kRead;
+                stream_.Read(&request_, this);
+                break;
+            case State::kRead:
+                if (!ok) {
+                    finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "missing request message"));
+                    return;
+                }
+                dispatch();
+                break;
+            case State::kFinish:
+                delete this;
+                break;
+        }
+    }
+
+private:
+    enum class State { kRequest, kRead, kFinish };
+
+    void dispatch() {
+        const std::string& method = ctx_.method();
+        if (method == kCreateOrderMethod) {
+            handleCreateOrder();
+        } else if (method == kQueryOrderMethod) {
+            handleQueryOrder();
+        } else if (method == kCancelOrderMethod) {
+            handleCancelOrder();
+        } else if (method == kReserveStockMethod) {
+            handleReserveStock();
+        } else {
+            finish(grpc::Status(grpc::StatusCode::UNIMPLEMENTED, "unknown method: " + method));
+        }
+    }
+
+    void handleCreateOrder() {
+        auto* request = parseRequest<proto::CreateOrderRequest>();
+        if (!request || !requireService(server_->order_service_)) {
+            return;
+        }
+        services::OrderInfo order;
+        protocol::toOrderInfo(*request, order);
+        // 分级下单时在完成级线程回调，完成队列线程不等待落盘；WriteAndFinish可在任意线程调用
+        server_->order_service_->createOrder(order,
+            [this](bool success, const std::string& message, const services::OrderInfo& created) {
+                replyResult(created.order_id,
+                            success ? protocol::ResultCode::kOk : protocol::ResultCode::kInvalidRequest,
+                            message);
+            });
+    }
+
+    void handleQueryOrder() {
+        auto* request = parseRequest<proto::QueryOrderRequest>();
+        if (!request || !requireService(server_->order_service_)) {
+            return;
+        }
+        server_->order_service_->getOrder(request->order_id(),
+            [this](bool success, const std::string& message, const services::OrderInfo& order) {
+                if (!success) {
+                    finish(grpc::Status(grpc::StatusCode::NOT_FOUND, message));
+                    return;
+                }
+                auto* record = create<proto::OrderRecord>();
+                protocol::fromOrderInfo(order, *record);
+                reply(*record);
+            });
+    }
+
+    void handleCancelOrder() {
+        auto* request = parseRequest<proto::CancelOrderRequest>();
+        if (!request || !requireService(server_->order_service_)) {
+            return;
+        }
+        uint64_t order_id = request->order_id();
+        server_->order_service_->cancelOrder(order_id, request->reason(),
+            [this, order_id](bool success, const std::string& message, const services::OrderInfo&) {
+                replyResult(order_id,
+                            success ? protocol::ResultCode::kOk : protocol::ResultCode::kNotFound,
+                            message);
+            });
+    }
+
+    void handleReserveStock() {
+        auto* request = parseRequest<proto::ReserveStockRequest>();
+        if (!request || !requireService(server_->inventory_service_)) {
+            return;
+        }
+        std::vector<uint64_t> product_ids(request->items_size());
+        std::vector<uint32_t> quantities(request->items_size());
+        for (int i = 0; i < request->items_size(); ++i) {
+            product_ids[i] = request->items(i).product_id();
+            quantities[i] = request->items(i).quantity();
+        }
+        uint64_t order_id = request->order_id();
+        server_->inventory_service_->reserveStock(product_ids, quantities, std::to_string(order_id),
+            static_cast<int>(std::min<uint32_t>(request->timeout_seconds(), INT32_MAX)),
+            [this, order_id](bool success, const std::string& message) {
+                replyResult(order_id,
+                            success ? protocol::ResultCode::kOk : protocol::ResultCode::kInsufficientStock,
+                            message);
+            });
+    }
+
+    template <typename Message>
+    Message* create() {
+        return google::protobuf::Arena::CreateMessage<Message>(&arena_);
+    }
+
+    // 解析失败时直接以INVALID_ARGUMENT结束调用
+    template <typename Message>
+    Message* parseRequest() {
+        Message* request = create<Message>();
+        if (!Serializer::Deserialize(&request_, request).ok()) {
+            finish(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "malformed request message"));
+            return nullptr;
+        }
+        return request;
+    }
+
+    template <typename Service>
+    bool requireService(const std::shared_ptr<Service>& service) {
+        if (!service) {
+            finish(grpc::Status(grpc::StatusCode::UNAVAILABLE, "business services not initialized"));
+            return false;
+        }
+        return true;
+    }
+
+    void replyResult(uint64_t order_id, protocol::ResultCode code, const std::string& message) {
+        auto* result = create<proto::Result>();
+        result->set_order_id(order_id);
+        result->set_code(static_cast<uint32_t>(code));
+        result->set_message(message);
+        reply(*result);
+    }
+
+    void reply(const google::protobuf::MessageLite& response) {
+        grpc::ByteBuffer buffer;
+        bool own_buffer = false;
+        grpc::Status status = Serializer::Serialize(response, &buffer, &own_buffer);
+        if (!status.ok()) {
+            finish(status);
+            return;
+        }
+        state_ = State::kFinish;
+        server_->handled_count_.fetch_add(1, std::memory_order_relaxed);
+        stream_.WriteAndFinish(buffer, grpc::WriteOptions(), grpc::Status::OK, this);
+    }
+
+    void finish(const grpc::Status& status) {
+        state_ = State::kFinish;
+        server_->handled_count_.fetch_add(1, std::memory_order_relaxed);
+        stream_.Finish(status, this);
+    }
+
+    GrpcServer* server_;
+    grpc::ServerCompletionQueue* cq_;
+    grpc::GenericServerContext ctx_;
+    grpc::GenericServerAsyncReaderWriter stream_;
+    grpc::ByteBuffer request_;
+    google::protobuf::Arena arena_;
+    State state_;
+};
+
+GrpcServer::GrpcServer(const std::string& ip, int port, int queue_num,
+                       std::shared_ptr<services::OrderService> order_service,
+                       std::shared_ptr<services::InventoryService> inventory_service)
+    : ip_(ip)
+    , port_(port)
+    , queue_num_(queue_num)
+    , selected_port_(0)
+    , order_service_(std::move(order_service))
+    , inventory_service_(std::move(inventory_service))
+    , shutdown_(false)
+    , running_(false)
+    , handled_count_(0) {
+    if (queue_num_ <= 0) {
+        queue_num_ = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+}
+
+GrpcServer::~GrpcServer() {
+    stop();
+}
+
+bool GrpcServer::start() {
+    if (running_.exchange(true)) {
+        return true;
+    }
+    shutdown_ = false;
+
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort(ip_ + ":" + std::to_string(port_),
+                             grpc::InsecureServerCredentials(), &selected_port_);
+    builder.RegisterAsyncGenericService(&generic_service_);
+    builder.SetMaxReceiveMessageSize(static_cast<int>(protocol::kMaxPayloadSize));
+    for (int i = 0; i < queue_num_; ++i) {
+        queues_.push_back(builder.AddCompletionQueue());
+    }
+
+    server_ = builder.BuildAndStart();
+    if (!server_ || selected_port_ == 0) {
+        LOG_ERROR("Failed to start gRPC server on " + ip_ + ":" + std::to_string(port_));
+        server_.reset();
+        queues_.clear();
+        running_ = false;
+        return false;
+    }
+
+    for (auto& cq : queues_) {
+        for (int i = 0; i < kPendingCallsPerQueue; ++i) {
+            postCall(cq.get());
+        }
+        threads_.emplace_back(&GrpcServer::pollQueue, this, cq.get());
+    }
+
+    LOG_INFO("gRPC server started on " + ip_ + ":" + std::to_string(selected_port_) +
+             " with " + std::to_string(queues_.size()) + " completion queues");
+    return true;
+}
+
+void GrpcServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    server_->Shutdown();
+    {
+        std::lock_guard<std::mutex> lock(shutdown_mutex_);
+        shutdown_ = true;
+        for (auto& cq : queues_) {
+            cq->Shutdown();
+        }
+    }
+
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+    server_.reset();
+    queues_.clear();
+
+    LOG_INFO("gRPC server stopped");
+}
+
+void GrpcServer::postCall(grpc::ServerCompletionQueue* cq) {
+    std::lock_guard<std::mutex> lock(shutdown_mutex_);
+    if (!shutdown_) {
+        new Call(this, cq);
+    }
+}
+
+void GrpcServer::pollQueue(grpc::ServerCompletionQueue* cq) {
+    void* tag = nullptr;
+    bool ok = false;
+    while (cq->Next(&tag, &ok)) {
+        static_cast<Call*>(tag)->proceed(ok);
+    }
+}
+
+} // namespace rpc
+} // namespace order_engine
@@ -0,0 +1,133 @@
+#include "services/compact_order.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+namespace order_engine {
+namespace services {
+
+namespace {
+
+constexpr size_t kMaxPaymentMethods = 256;
+
+/**
+ * @brief 支付方式登记表
+ *
+ * 只增不删；读者无锁（原子指针），登记新名称时加锁。
+ * 名称字符串在进程生命周期内有效
+ */
+class PaymentMethodTable {
+public:
+    PaymentMethodTable() : next_(static_cast<size_t>(PaymentMethod::kFirstInterned)) {
+        for (auto& name : names_) {
+            name.store(nullptr, std::memory_order_relaxed);
+        }
+        names_[static_cast<size_t>(PaymentMethod::ALIPAY)] = new std::string("alipay");
+        names_[static_cast<size_t>(PaymentMethod::WECHAT)] = new std::string("wechat");
+        names_[static_cast<size_t>(PaymentMethod::CREDIT_CARD)] = new std::string("credit_card");
+        names_[static_cast<size_t>(PaymentMethod::BANK_TRANSFER)] = new std::string("bank_transfer");
+        names_[static_cast<size_t>(PaymentMethod::CASH_ON_DELIVERY)] = new std::string("cash_on_delivery");
+    }
+
+    uint8_t intern(std::string_view name) {
+        if (name.empty()) {
+            return static_cast<uint8_t>(PaymentMethod::UNKNOWN);
+        }
+        size_t limit = next_.load(std::memory_order_acquire);
+        int code = find(name, limit);
+        if (code >= 0) {
+            return static_cast<uint8_t>(code);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        limit = next_.load(std::memory_order_relaxed);
+        code = find(name, limit);
+        if (code >= 0) {
+            return static_cast<uint8_t>(code);
+        }
+        if (limit >= kMaxPaymentMethods) {
+            return static_cast<uint8_t>(PaymentMethod::UNKNOWN);
+        }
+        names_[limit].store(new std::string(name), std::memory_order_release);
+        next_.store(limit + 1, std::memory_order_release);
+        return static_cast<uint8_t>(limit);
+    }
+
+    std::string_view name(uint8_t code) const {
+        const std::string* name = names_[code].load(std::memory_order_acquire);
+        return name ? std::string_view(*name) : std::string_view();
+    }
+
+private:
+    int find(std::string_view name, size_t limit) const {
+        for (size_t i = 1; i < limit; ++i) {
+            const std::string* existing = names_[i].load(std::memory_order_acquire);
+            if (existing && *existing == name) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    std::array<std::atomic<const std::string*>, kMaxPaymentMethods> names_;
+    std::atomic<size_t> next_;
+    std::mutex mutex_;
+};
+
+PaymentMethodTable& paymentMethods() {
+    // 有意不析构，避免退出时与其他静态对象的析构顺序问题
+    static PaymentMethodTable* table = new PaymentMethodTable();
+    return *table;
+}
+
+} // namespace
+
+uint8_t internPaymentMethod(std::string_view name) {
+    return paymentMethods().intern(name);
+}
+
+std::string_view paymentMethodName(uint8_t code) {
+    return paymentMethods().name(code);
+}
+
+CompactOrder CompactOrder::fromOrderInfo(const OrderInfo& order, utils::StringArena& arena) {
+    CompactOrder compact;
+    compact.order_id = order.order_id;
+    compact.user_id = order.user_id;
+    compact.total_amount = order.total_amount;
+    compact.created_at = static_cast<uint32_t>(order.created_at);
+    compact.updated_at = static_cast<uint32_t>(order.updated_at);
+    compact.status = order.status;
+    compact.payment_method = internPaymentMethod(order.payment_method);
+    compact.shipping_address = arena.store(order.shipping_address);
+
+    size_t count = std::min(order.product_ids.size(), order.quantities.size());
+    compact.items.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        compact.items.push_back(LineItem{order.product_ids[i], order.quantities[i], 0});
+    }
+    return compact;
+}
+
+void CompactOrder::toOrderInfo(OrderInfo& order) const {
+    order.order_id = order_id;
+    order.user_id = user_id;
+    order.total_amount = total_amount;
+    order.created_at = static_cast<time_t>(created_at);
+    order.updated_at = static_cast<time_t>(updated_at);
+    order.status = status;
+    order.payment_method = paymentMethodName(payment_method);
+    order.shipping_address = shipping_address;
+
+    order.product_ids.resize(items.size());
+    order.quantities.resize(items.size());
+    for (size_t i = 0; i < items.size(); ++i) {
+        order.product_ids[i] = items[i].product_id;
+        order.quantities[i] = items[i].quantity;
+    }
+}
+
+} // namespace services
+} // namespace order_engine
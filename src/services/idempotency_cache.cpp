@@ -0,0 +1,156 @@
+#include "services/idempotency_cache.h"
+#include "utils/hash_utils.h"
+#include <algorithm>
+
+namespace order_engine {
+namespace services {
+
+namespace {
+
+// unordered_map节点：next指针 + 键值对（整数键不缓存哈希值）
+constexpr size_t kNodeBytes = sizeof(void*) + sizeof(uint64_t) + 16;
+
+} // namespace
+
+IdempotencyCache::IdempotencyCache(IdempotencyOptions options)
+    : options_(options)
+    , hits_(0)
+    , in_progress_(0)
+    , evicted_(0) {
+    options_.shards = std::max<size_t>(options_.shards, 1);
+    shard_capacity_ = std::max<size_t>(options_.capacity / options_.shards, 1);
+    shards_.reserve(options_.shards);
+    for (size_t i = 0; i < options_.shards; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+}
+
+uint64_t IdempotencyCache::makeKey(uint64_t user_id, std::string_view idempotency_key) {
+    return utils::hash64(idempotency_key.data(), idempotency_key.size(), user_id);
+}
+
+IdempotencyCache::BeginResult IdempotencyCache::begin(uint64_t key, time_t now, uint64_t& order_id,
+                                                      Waiter waiter) {
+    Shard& shard = shardFor(key);
+    uint32_t now32 = static_cast<uint32_t>(now);
+    std::vector<Waiter> orphaned;
+    BeginResult result = BeginResult::kNew;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        trim(shard, now32, orphaned);
+
+        auto it = shard.entries.find(key);
+        if (it != shard.entries.end() && it->second.expires_at > now32) {
+            if (it->second.state == State::kDone) {
+                order_id = it->second.order_id;
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                result = BeginResult::kDone;
+            } else {
+                if (waiter) {
+                    shard.waiters[key].push_back(std::move(waiter));
+                }
+                in_progress_.fetch_add(1, std::memory_order_relaxed);
+                result = BeginResult::kInProgress;
+            }
+        } else {
+            uint32_t expires_at = now32 + static_cast<uint32_t>(options_.ttl_seconds);
+            shard.entries[key] = Entry{0, expires_at, State::kInFlight};
+            shard.fifo.push_back(Expiry{key, expires_at});
+        }
+    }
+    // 首个请求一直未完成、键已过期：挂起的重试以失败结束
+    for (auto& orphan : orphaned) {
+        orphan(false, 0);
+    }
+    return result;
+}
+
+void IdempotencyCache::complete(uint64_t key, bool success, uint64_t order_id, time_t now) {
+    Shard& shard = shardFor(key);
+    std::vector<Waiter> waiters;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end() || it->second.state != State::kInFlight) {
+            return;
+        }
+        auto waiting = shard.waiters.find(key);
+        if (waiting != shard.waiters.end()) {
+            waiters = std::move(waiting->second);
+            shard.waiters.erase(waiting);
+        }
+        if (!success) {
+            shard.entries.erase(it);
+        } else {
+            // 有效期从完成时算起；队列中的旧过期时间不再匹配，出队时跳过
+            uint32_t expires_at = static_cast<uint32_t>(now) + static_cast<uint32_t>(options_.ttl_seconds);
+            if (expires_at != it->second.expires_at) {
+                shard.fifo.push_back(Expiry{key, expires_at});
+            }
+            it->second = Entry{order_id, expires_at, State::kDone};
+        }
+    }
+    // 锁外回调：waiter里可能再次访问去重表
+    for (auto& waiter : waiters) {
+        waiter(success, order_id);
+    }
+}
+
+void IdempotencyCache::trim(Shard& shard, uint32_t now, std::vector<Waiter>& orphaned) {
+    // 过期：队头起依次删除
+    while (!shard.fifo.empty()) {
+        const Expiry& front = shard.fifo.front();
+        auto it = shard.entries.find(front.key);
+        bool current = it != shard.entries.end() && it->second.expires_at == front.expires_at;
+        if (current && front.expires_at > now) {
+            break;
+        }
+        if (current) {
+            if (it->second.state == State::kInFlight) {
+                auto waiting = shard.waiters.find(front.key);
+                if (waiting != shard.waiters.end()) {
+                    for (auto& waiter : waiting->second) {
+                        orphaned.push_back(std::move(waiter));
+                    }
+                    shard.waiters.erase(waiting);
+                }
+            }
+            shard.entries.erase(it);
+        }
+        shard.fifo.pop_front();  // 已过期、已被删除或已续期
+    }
+
+    // 容量：跳过进行中的键（淘汰后重试会重复执行），淘汰最早的已完成键。
+    // 进行中的键数受并发请求数限制，跳过的只是队头附近的少数几项
+    size_t i = 0;
+    while (shard.entries.size() > shard_capacity_ && i < shard.fifo.size()) {
+        const Expiry& expiry = shard.fifo[i];
+        auto it = shard.entries.find(expiry.key);
+        bool current = it != shard.entries.end() && it->second.expires_at == expiry.expires_at;
+        if (current && it->second.state == State::kInFlight) {
+            ++i;
+            continue;
+        }
+        if (current) {
+            shard.entries.erase(it);
+            evicted_.fetch_add(1, std::memory_order_relaxed);
+        }
+        shard.fifo.erase(shard.fifo.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+}
+
+IdempotencyStats IdempotencyCache::stats() const {
+    IdempotencyStats result{0, 0, hits_.load(std::memory_order_relaxed),
+                            in_progress_.load(std::memory_order_relaxed), evicted_.load(std::memory_order_relaxed)};
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        result.keys += shard->entries.size();
+        result.memory_bytes += shard->entries.size() * kNodeBytes +
+                               shard->entries.bucket_count() * sizeof(void*) +
+                               shard->fifo.size() * sizeof(Expiry);
+    }
+    return result;
+}
+
+} // namespace services
+} // namespace order_engine
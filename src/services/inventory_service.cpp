@@ -0,0 +1,368 @@
+#include "services/inventory_service.h"
+#include "common/logger.h"
+#include "utils/timing_wheel.h"
+#include <charconv>
+#include <chrono>
+#include <ctime>
+#include <iterator>
+
+namespace order_engine {
+namespace services {
+
+const std::string InventoryService::kInventoryCachePrefix = "inventory:";
+const std::string InventoryService::kLockPrefix = "lock:inventory:";
+const int InventoryService::kCacheExpireTime = 300;
+const int InventoryService::kLockExpireTime = 5;
+const int InventoryService::kReservationExpireTime = 900;
+
+namespace {
+
+// 从"RSV<time>-<seq>"中取出序号
+bool parseReservationSeq(const std::string& reservation_id, uint64_t& seq) {
+    size_t dash = reservation_id.rfind('-');
+    if (dash == std::string::npos) {
+        return false;
+    }
+    const char* first = reservation_id.data() + dash + 1;
+    const char* last = reservation_id.data() + reservation_id.size();
+    auto [ptr, ec] = std::from_chars(first, last, seq);
+    return ec == std::errc() && ptr == last;
+}
+
+} // namespace
+
+InventoryService::InventoryService(std::shared_ptr<void> db_pool,
+                                   std::shared_ptr<void> cache_manager,
+                                   size_t table_capacity)
+    : db_pool_(std::move(db_pool))
+    , cache_manager_(std::move(cache_manager))
+    , inventory_(table_capacity)
+    , reservation_seq_(0)
+    , cleanup_running_(false)
+    , total_reservations_(0)
+    , successful_reservations_(0)
+    , failed_reservations_(0) {
+    time_t now = time(nullptr);
+    reservation_shards_.reserve(kReservationShards);
+    for (size_t i = 0; i < kReservationShards; ++i) {
+        reservation_shards_.push_back(std::make_unique<ReservationShard>());
+        reservation_shards_.back()->wheel = std::make_unique<utils::TimingWheel>(now);
+    }
+}
+
+InventoryService::~InventoryService() {
+    shutdown();
+}
+
+bool InventoryService::initialize() {
+    if (cleanup_running_.exchange(true)) {
+        return true;
+    }
+
+    // 定时释放超时未确认的预留
+    cleanup_thread_ = std::thread([this] {
+        while (cleanup_running_.load()) {
+            for (int i = 0; i < 10 && cleanup_running_.load(); ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            expireReservations(time(nullptr));
+        }
+    });
+
+    LOG_INFO("InventoryService initialized");
+    return true;
+}
+
+void InventoryService::shutdown() {
+    if (!cleanup_running_.exchange(false)) {
+        return;
+    }
+    if (cleanup_thread_.joinable()) {
+        cleanup_thread_.join();
+    }
+    LOG_INFO("InventoryService shutdown");
+}
+
+void InventoryService::getInventory(uint64_t product_id, const QueryCallback& callback) {
+    InventoryInfo info{};
+    if (getInventoryFromCache(product_id, info) || getInventoryFromDB(product_id, info)) {
+        callback(true, info);
+        return;
+    }
+    info.product_id = product_id;
+    callback(false, info);
+}
+
+void InventoryService::batchGetInventory(const std::vector<uint64_t>& product_ids,
+                                         const std::function<void(bool, const std::vector<InventoryInfo>&)>& callback) {
+    std::vector<InventoryInfo> infos;
+    infos.reserve(product_ids.size());
+    bool all_found = true;
+    for (uint64_t product_id : product_ids) {
+        InventoryInfo info{};
+        if (!inventory_.get(product_id, info)) {
+            all_found = false;
+            continue;
+        }
+        infos.push_back(info);
+    }
+    callback(all_found, infos);
+}
+
+bool InventoryService::checkStock(uint64_t product_id, uint32_t quantity) {
+    return inventory_.hasAvailable(product_id, quantity);
+}
+
+bool InventoryService::batchCheckStock(const std::vector<uint64_t>& product_ids,
+                                       const std::vector<uint32_t>& quantities) {
+    if (product_ids.size() != quantities.size()) {
+        return false;
+    }
+
+    // 同一商品可能出现多次，按合计数量检查
+    std::unordered_map<uint64_t, uint64_t> required;
+    for (size_t i = 0; i < product_ids.size(); ++i) {
+        required[product_ids[i]] += quantities[i];
+    }
+
+    for (const auto& [product_id, quantity] : required) {
+        if (!inventory_.hasAvailable(product_id, quantity)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void InventoryService::reserveStock(const std::vector<uint64_t>& product_ids,
+                                    const std::vector<uint32_t>& quantities,
+                                    const std::string& order_id,
+                                    int timeout_seconds,
+                                    const InventoryCallback& callback) {
+    std::string reservation_id;
+    bool success = tryReserve(product_ids, quantities, order_id, timeout_seconds, reservation_id);
+
+    total_reservations_.fetch_add(1, std::memory_order_relaxed);
+    if (success) {
+        successful_reservations_.fetch_add(1, std::memory_order_relaxed);
+        callback(true, reservation_id);
+    } else {
+        failed_reservations_.fetch_add(1, std::memory_order_relaxed);
+        callback(false, "insufficient stock");
+    }
+}
+
+void InventoryService::batchReserveStock(const std::vector<StockRequest>& requests,
+                                         int timeout_seconds,
+                                         std::vector<std::string>& reservation_ids) {
+    reservation_ids.assign(requests.size(), std::string());
+
+    uint64_t succeeded = 0;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const StockRequest& request = requests[i];
+        if (tryReserve(*request.product_ids, *request.quantities, request.order_id,
+                       timeout_seconds, reservation_ids[i])) {
+            ++succeeded;
+        }
+    }
+
+    total_reservations_.fetch_add(requests.size(), std::memory_order_relaxed);
+    successful_reservations_.fetch_add(succeeded, std::memory_order_relaxed);
+    failed_reservations_.fetch_add(requests.size() - succeeded, std::memory_order_relaxed);
+}
+
+void InventoryService::confirmReservation(const std::string& reservation_id,
+                                          const InventoryCallback& callback) {
+    std::vector<ReservationInfo> items;
+    if (!takeReservation(reservation_id, items)) {
+        callback(false, "reservation not found");
+        return;
+    }
+
+    for (const auto& item : items) {
+        inventory_.commit(item.product_id, item.quantity);
+    }
+    callback(true, reservation_id);
+}
+
+void InventoryService::releaseReservation(const std::string& reservation_id,
+                                          const InventoryCallback& callback) {
+    std::vector<ReservationInfo> items;
+    if (!takeReservation(reservation_id, items)) {
+        callback(false, "reservation not found");
+        return;
+    }
+
+    for (const auto& item : items) {
+        inventory_.release(item.product_id, item.quantity);
+    }
+    callback(true, reservation_id);
+}
+
+void InventoryService::addStock(uint64_t product_id, uint32_t quantity,
+                                const InventoryCallback& callback) {
+    InventoryInfo snapshot{};
+    if (!inventory_.add(product_id, quantity, &snapshot)) {
+        LOG_ERROR_FMT("Failed to add stock for product {}: stock limit exceeded or inventory table full",
+                      std::to_string(product_id));
+        callback(false, "stock limit exceeded or inventory table full");
+        return;
+    }
+
+    if (!updateInventoryInDB(snapshot)) {
+        callback(false, "failed to persist inventory");
+        return;
+    }
+    invalidateInventoryCache(product_id);
+    callback(true, "ok");
+}
+
+void InventoryService::syncInventoryFromDB(uint64_t product_id) {
+    // TODO: 数据库接入后从inventory表加载 (Phase 2)
+    LOG_DEBUG_FMT("Inventory sync skipped for product {}", std::to_string(product_id));
+}
+
+void InventoryService::syncAllInventoryFromDB() {
+    // TODO: 数据库接入后全量加载 (Phase 2)
+    LOG_DEBUG("Full inventory sync skipped in Phase 1");
+}
+
+bool InventoryService::enableHotStock(uint64_t product_id) {
+    // TODO: Redis接入后热点商品同样按桶拆分库存键 (Phase 2)
+    return inventory_.enableHot(product_id);
+}
+
+bool InventoryService::getInventoryFromCache(uint64_t, InventoryInfo&) {
+    // TODO: 缓存管理器接入后实现 (Phase 2)
+    return false;
+}
+
+void InventoryService::setInventoryToCache(const InventoryInfo&) {
+    // TODO: 缓存管理器接入后实现 (Phase 2)
+}
+
+void InventoryService::invalidateInventoryCache(uint64_t) {
+    // TODO: 缓存管理器接入后实现 (Phase 2)
+}
+
+bool InventoryService::getInventoryFromDB(uint64_t product_id, InventoryInfo& info) {
+    // Phase 1: 以内存库存表代替数据库
+    return inventory_.get(product_id, info);
+}
+
+bool InventoryService::updateInventoryInDB(const InventoryInfo&) {
+    // TODO: 数据库接入后写入inventory表 (Phase 2)
+    return true;
+}
+
+bool InventoryService::acquireDistributedLock(uint64_t, int) {
+    // TODO: Redis接入后实现 (Phase 2)，单进程内由库存表的CAS保证不超卖
+    return true;
+}
+
+void InventoryService::releaseDistributedLock(uint64_t) {
+    // TODO: Redis接入后实现 (Phase 2)
+}
+
+std::string InventoryService::generateReservationId(time_t now, uint64_t& seq) {
+    seq = reservation_seq_.fetch_add(1, std::memory_order_relaxed) + 1;
+    return "RSV" + std::to_string(now) + "-" + std::to_string(seq);
+}
+
+bool InventoryService::tryReserve(const std::vector<uint64_t>& product_ids,
+                                  const std::vector<uint32_t>& quantities,
+                                  const std::string& order_id,
+                                  int timeout_seconds,
+                                  std::string& reservation_id) {
+    if (product_ids.empty() || product_ids.size() != quantities.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < product_ids.size(); ++i) {
+        if (!inventory_.reserve(product_ids[i], quantities[i])) {
+            for (size_t j = 0; j < i; ++j) {
+                inventory_.release(product_ids[j], quantities[j]);
+            }
+            return false;
+        }
+    }
+
+    time_t now = time(nullptr);
+    time_t expires_at = 0;
+    if (timeout_seconds >= 0) {
+        expires_at = now + (timeout_seconds > 0 ? timeout_seconds : kReservationExpireTime);
+    }
+    uint64_t seq = 0;
+    reservation_id = generateReservationId(now, seq);
+
+    std::vector<ReservationInfo> items;
+    items.reserve(product_ids.size());
+    for (size_t i = 0; i < product_ids.size(); ++i) {
+        items.push_back(ReservationInfo{reservation_id, product_ids[i], quantities[i],
+                                        now, expires_at, order_id});
+    }
+    saveReservation(seq, std::move(items));
+    return true;
+}
+
+void InventoryService::saveReservation(uint64_t seq, std::vector<ReservationInfo> items) {
+    ReservationShard& shard = reservationShard(seq);
+    time_t expires_at = items.front().expires_at;
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (expires_at != 0) {
+        shard.wheel->schedule(seq, expires_at);
+    }
+    shard.reservations[seq] = std::move(items);
+}
+
+bool InventoryService::takeReservation(const std::string& reservation_id, std::vector<ReservationInfo>& items) {
+    uint64_t seq = 0;
+    if (!parseReservationSeq(reservation_id, seq)) {
+        return false;
+    }
+    ReservationShard& shard = reservationShard(seq);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.reservations.find(seq);
+    // 序号在重启后从头分配，比较完整ID，重启前的预留ID不会取到新预留
+    if (it == shard.reservations.end() || it->second.front().reservation_id != reservation_id) {
+        return false;
+    }
+    items = std::move(it->second);
+    shard.reservations.erase(it);
+    return true;
+}
+
+size_t InventoryService::expireReservations(time_t now) {
+    size_t count = 0;
+    std::vector<ReservationInfo> expired;
+    for (auto& shard : reservation_shards_) {
+        expired.clear();
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->wheel->advance(now, [&](uint64_t seq) {
+                auto it = shard->reservations.find(seq);
+                if (it == shard->reservations.end()) {
+                    return;  // 已确认或已释放
+                }
+                expired.insert(expired.end(), std::make_move_iterator(it->second.begin()),
+                               std::make_move_iterator(it->second.end()));
+                shard->reservations.erase(it);
+                ++count;
+            });
+        }
+        for (const auto& item : expired) {
+            inventory_.release(item.product_id, item.quantity);
+        }
+    }
+    if (count > 0) {
+        LOG_INFO_FMT_INT("Released {} expired reservations", static_cast<int>(count));
+    }
+    return count;
+}
+
+bool InventoryService::compareAndSwapStock(uint64_t product_id, uint32_t expected_available,
+                                           uint32_t new_available, uint32_t expected_version) {
+    return inventory_.compareAndSwap(product_id, expected_available, new_available, expected_version);
+}
+
+} // namespace services
+} // namespace order_engine
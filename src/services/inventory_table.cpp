@@ -0,0 +1,424 @@
+#include "services/inventory_table.h"
+#include "common/logger.h"
+#include "utils/hash_utils.h"
+#include <algorithm>
+#include <thread>
+
+namespace order_engine {
+namespace services {
+
+namespace {
+
+// 线程编号，按到达顺序分配，决定线程扣哪个热点子桶
+std::atomic<size_t> g_next_thread_index{0};
+
+size_t threadIndex() {
+    thread_local size_t index = g_next_thread_index.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+} // namespace
+
+InventoryTable::InventoryTable(size_t capacity, size_t hot_buckets)
+    : capacity_(capacity)
+    , mask_(1)
+    , size_(0)
+    , hot_buckets_(hot_buckets ? hot_buckets : std::max(1u, std::thread::hardware_concurrency()))
+    , hot_threshold_(0)
+    , hot_rebalances_(0) {
+    size_t slots = 2;
+    while (slots / 4 * 3 < capacity) {
+        slots <<= 1;
+    }
+    mask_ = slots - 1;
+    slots_ = std::make_unique<Slot[]>(slots);
+}
+
+InventoryTable::Slot* InventoryTable::find(uint64_t product_id) const {
+    if (product_id == 0) {
+        return nullptr;
+    }
+    size_t index = utils::mix64(product_id) & mask_;
+    for (size_t probe = 0; probe <= mask_; ++probe) {
+        Slot& slot = slots_[(index + probe) & mask_];
+        uint64_t key = slot.product_id.load(std::memory_order_acquire);
+        if (key == product_id) {
+            return &slot;
+        }
+        if (key == 0) {
+            return nullptr;
+        }
+    }
+    return nullptr;
+}
+
+InventoryTable::Slot* InventoryTable::findOrInsert(uint64_t product_id) {
+    if (product_id == 0) {
+        return nullptr;
+    }
+    size_t index = utils::mix64(product_id) & mask_;
+    for (size_t probe = 0; probe <= mask_; ++probe) {
+        Slot& slot = slots_[(index + probe) & mask_];
+        uint64_t key = slot.product_id.load(std::memory_order_acquire);
+        if (key == 0) {
+            if (size_.load(std::memory_order_relaxed) >= capacity_) {
+                return nullptr;
+            }
+            // 失败时key为其他线程刚插入的商品，继续比较
+            if (slot.product_id.compare_exchange_strong(key, product_id, std::memory_order_acq_rel)) {
+                size_.fetch_add(1, std::memory_order_relaxed);
+                return &slot;
+            }
+        }
+        if (key == product_id) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+void InventoryTable::touch(Slot& slot) {
+    slot.updated_at.store(static_cast<int64_t>(time(nullptr)), std::memory_order_relaxed);
+}
+
+uint32_t InventoryTable::takeSlotAvailable(Slot& slot) {
+    uint64_t state = slot.state.load(std::memory_order_acquire);
+    while (availableOf(state) > 0 &&
+           !slot.state.compare_exchange_weak(state, pack(0, reservedOf(state), state), std::memory_order_acq_rel)) {
+    }
+    return availableOf(state);
+}
+
+InventoryTable::HotBucket& InventoryTable::localBucket(HotStock& hot) const {
+    return hot.buckets[threadIndex() % hot.bucket_count];
+}
+
+bool InventoryTable::get(uint64_t product_id, InventoryInfo& info) const {
+    Slot* slot = find(product_id);
+    if (!slot) {
+        return false;
+    }
+    uint64_t state = slot->state.load(std::memory_order_acquire);
+    info.product_id = product_id;
+    info.total_stock = slot->total.load(std::memory_order_relaxed);
+    info.available_stock = availableOf(state);
+    info.reserved_stock = reservedOf(state);
+    info.sold_stock = slot->sold.load(std::memory_order_relaxed);
+    info.updated_at = static_cast<time_t>(slot->updated_at.load(std::memory_order_relaxed));
+    info.version = versionOf(state);
+
+    // 热点商品逐桶读取，并发修改时各项为近似值
+    if (HotStock* hot = slot->hot.load(std::memory_order_acquire)) {
+        int64_t reserved = info.reserved_stock;
+        int64_t sold = info.sold_stock;
+        for (size_t i = 0; i < hot->bucket_count; ++i) {
+            const HotBucket& bucket = hot->buckets[i];
+            info.available_stock += static_cast<uint32_t>(bucket.available.load(std::memory_order_relaxed));
+            reserved += bucket.reserved.load(std::memory_order_relaxed);
+            sold += bucket.sold.load(std::memory_order_relaxed);
+        }
+        info.reserved_stock = static_cast<uint32_t>(std::max<int64_t>(reserved, 0));
+        info.sold_stock = static_cast<uint32_t>(std::max<int64_t>(sold, 0));
+    }
+    return true;
+}
+
+bool InventoryTable::hasAvailable(uint64_t product_id, uint64_t quantity) const {
+    Slot* slot = find(product_id);
+    if (!slot) {
+        return false;
+    }
+    uint64_t available = availableOf(slot->state.load(std::memory_order_acquire));
+    HotStock* hot = slot->hot.load(std::memory_order_acquire);
+    if (!hot || available >= quantity) {
+        return available >= quantity;
+    }
+    // 先看本地桶，不够再累加其他桶
+    HotBucket& local = localBucket(*hot);
+    available += local.available.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < hot->bucket_count && available < quantity; ++i) {
+        if (&hot->buckets[i] != &local) {
+            available += hot->buckets[i].available.load(std::memory_order_relaxed);
+        }
+    }
+    return available >= quantity;
+}
+
+bool InventoryTable::reserve(uint64_t product_id, uint32_t quantity) {
+    Slot* slot = find(product_id);
+    if (!slot) {
+        return false;
+    }
+    if (HotStock* hot = slot->hot.load(std::memory_order_acquire)) {
+        return reserveHot(*slot, *hot, quantity);
+    }
+    uint64_t state = slot->state.load(std::memory_order_acquire);
+    uint32_t failures = 0;
+    for (;;) {
+        if (availableOf(state) < quantity) {
+            return false;
+        }
+        if (slot->state.compare_exchange_weak(state, pack(availableOf(state) - quantity,
+                                                          reservedOf(state) + quantity, state),
+                                              std::memory_order_acq_rel)) {
+            break;
+        }
+        ++failures;
+    }
+    touch(*slot);
+    if (failures > 0) {
+        noteContention(*slot, failures, time(nullptr));
+    }
+    return true;
+}
+
+bool InventoryTable::reserveHot(Slot& slot, HotStock& hot, uint32_t quantity) {
+    HotBucket& local = localBucket(hot);
+    uint64_t available = local.available.load(std::memory_order_acquire);
+    while (available >= quantity) {
+        if (local.available.compare_exchange_weak(available, available - quantity, std::memory_order_acq_rel)) {
+            local.reserved.fetch_add(quantity, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    // 售罄后的预留直接失败，不再逐个排队进锁收回各桶
+    if (hotSoldOut(slot, hot, quantity)) {
+        return false;
+    }
+    return rebalance(slot, hot, local, quantity);
+}
+
+bool InventoryTable::hotSoldOut(const Slot& slot, const HotStock& hot, uint32_t quantity) {
+    // 同seqlock的读者：合计不是快照，但没有搬移时各处的可用库存只会被预留减少，
+    // 不会转到别处，合计不足即确实不足；读取期间有搬移则交给加锁路径判定
+    uint64_t moves = hot.moves.load(std::memory_order_acquire);
+    if (moves & 1) {
+        return false;
+    }
+    uint64_t visible = availableOf(slot.state.load(std::memory_order_relaxed));
+    for (size_t i = 0; i < hot.bucket_count; ++i) {
+        visible += hot.buckets[i].available.load(std::memory_order_relaxed);
+        if (visible >= quantity) {
+            return false;
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return hot.moves.load(std::memory_order_relaxed) == moves;
+}
+
+void InventoryTable::beginMove(HotStock& hot) {
+    hot.moves.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void InventoryTable::endMove(HotStock& hot) {
+    hot.moves.fetch_add(1, std::memory_order_release);
+}
+
+bool InventoryTable::rebalance(Slot& slot, HotStock& hot, HotBucket& local, uint32_t quantity) {
+    std::lock_guard<std::mutex> lock(hot.rebalance_mutex);
+    hot_rebalances_.fetch_add(1, std::memory_order_relaxed);
+    beginMove(hot);
+
+    // 反复收回直到一轮没有新到的库存：收回期间其他线程的退回可能落在已收回的桶，
+    // 只在所有桶都已取空时才判定不足
+    uint64_t total = 0;
+    uint64_t taken;
+    do {
+        taken = takeSlotAvailable(slot);
+        for (size_t i = 0; i < hot.bucket_count; ++i) {
+            taken += hot.buckets[i].available.exchange(0, std::memory_order_acq_rel);
+        }
+        total += taken;
+    } while (taken > 0 && total < quantity);
+
+    bool reserved = total >= quantity;
+    if (reserved) {
+        total -= quantity;
+        local.reserved.fetch_add(quantity, std::memory_order_relaxed);
+    }
+    // 平均分回各桶，余数留在本地桶
+    uint64_t share = total / hot.bucket_count;
+    for (size_t i = 0; i < hot.bucket_count; ++i) {
+        if (share > 0) {
+            hot.buckets[i].available.fetch_add(share, std::memory_order_release);
+        }
+    }
+    if (total % hot.bucket_count) {
+        local.available.fetch_add(total % hot.bucket_count, std::memory_order_release);
+    }
+    endMove(hot);
+    if (reserved) {
+        touch(slot);
+    }
+    return reserved;
+}
+
+uint32_t InventoryTable::takeHotReserved(Slot& slot, HotStock& hot, HotBucket& local, uint32_t quantity) {
+    // 退回、确认互斥，并发的预留只会增加合计，读到的合计不大于实际预留
+    std::lock_guard<std::mutex> lock(hot.rebalance_mutex);
+    int64_t reserved = reservedOf(slot.state.load(std::memory_order_acquire));
+    for (size_t i = 0; i < hot.bucket_count; ++i) {
+        reserved += hot.buckets[i].reserved.load(std::memory_order_relaxed);
+    }
+    uint32_t moved = static_cast<uint32_t>(std::clamp<int64_t>(reserved, 0, quantity));
+    local.reserved.fetch_sub(moved, std::memory_order_relaxed);
+    return moved;
+}
+
+void InventoryTable::release(uint64_t product_id, uint32_t quantity) {
+    Slot* slot = find(product_id);
+    if (!slot) {
+        return;
+    }
+    if (HotStock* hot = slot->hot.load(std::memory_order_acquire)) {
+        HotBucket& local = localBucket(*hot);
+        uint32_t moved = takeHotReserved(*slot, *hot, local, quantity);
+        local.available.fetch_add(moved, std::memory_order_release);
+        return;
+    }
+    uint64_t state = slot->state.load(std::memory_order_acquire);
+    uint32_t moved;
+    do {
+        // 可用与预留之和不超过kMaxStock，退回不会溢出
+        moved = std::min(quantity, reservedOf(state));
+    } while (!slot->state.compare_exchange_weak(
+        state, pack(availableOf(state) + moved, reservedOf(state) - moved, state), std::memory_order_acq_rel));
+    touch(*slot);
+}
+
+void InventoryTable::commit(uint64_t product_id, uint32_t quantity) {
+    Slot* slot = find(product_id);
+    if (!slot) {
+        return;
+    }
+    if (HotStock* hot = slot->hot.load(std::memory_order_acquire)) {
+        HotBucket& local = localBucket(*hot);
+        uint32_t moved = takeHotReserved(*slot, *hot, local, quantity);
+        local.sold.fetch_add(moved, std::memory_order_relaxed);
+        return;
+    }
+    uint64_t state = slot->state.load(std::memory_order_acquire);
+    uint32_t moved;
+    do {
+        moved = std::min(quantity, reservedOf(state));
+    } while (!slot->state.compare_exchange_weak(
+        state, pack(availableOf(state), reservedOf(state) - moved, state), std::memory_order_acq_rel));
+    slot->sold.fetch_add(moved, std::memory_order_relaxed);
+    touch(*slot);
+}
+
+bool InventoryTable::add(uint64_t product_id, uint32_t quantity, InventoryInfo* info) {
+    Slot* slot = findOrInsert(product_id);
+    if (!slot) {
+        return false;
+    }
+    if (HotStock* hot = slot->hot.load(std::memory_order_acquire)) {
+        // 补货不频繁，上限按当前合计近似检查
+        InventoryInfo current{};
+        get(product_id, current);
+        if (static_cast<uint64_t>(current.available_stock) + current.reserved_stock + quantity > kMaxStock) {
+            return false;
+        }
+        localBucket(*hot).available.fetch_add(quantity, std::memory_order_release);
+    } else {
+        uint64_t state = slot->state.load(std::memory_order_acquire);
+        do {
+            if (static_cast<uint64_t>(availableOf(state)) + reservedOf(state) + quantity > kMaxStock) {
+                return false;
+            }
+        } while (!slot->state.compare_exchange_weak(
+            state, pack(availableOf(state) + quantity, reservedOf(state), state), std::memory_order_acq_rel));
+    }
+    slot->total.fetch_add(quantity, std::memory_order_relaxed);
+    touch(*slot);
+    if (info) {
+        get(product_id, *info);
+    }
+    return true;
+}
+
+bool InventoryTable::compareAndSwap(uint64_t product_id, uint32_t expected_available,
+                                    uint32_t new_available, uint32_t expected_version) {
+    Slot* slot = find(product_id);
+    if (!slot || slot->hot.load(std::memory_order_acquire)) {
+        return false;
+    }
+    uint64_t state = slot->state.load(std::memory_order_acquire);
+    if (availableOf(state) != expected_available || versionOf(state) != (expected_version & kVersionMask) ||
+        static_cast<uint64_t>(new_available) + reservedOf(state) > kMaxStock) {
+        return false;
+    }
+    if (!slot->state.compare_exchange_strong(state, pack(new_available, reservedOf(state), state),
+                                             std::memory_order_acq_rel)) {
+        return false;
+    }
+    touch(*slot);
+    return true;
+}
+
+bool InventoryTable::enableHot(uint64_t product_id) {
+    Slot* slot = find(product_id);
+    if (!slot) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(hot_mutex_);
+    if (slot->hot.load(std::memory_order_acquire)) {
+        return true;
+    }
+    hot_stocks_.push_back(std::make_unique<HotStock>(hot_buckets_));
+    HotStock* hot = hot_stocks_.back().get();
+
+    // 持有分桶锁发布：期间本地桶为空的预留会等待库存分到各桶
+    std::lock_guard<std::mutex> rebalance_lock(hot->rebalance_mutex);
+    beginMove(*hot);
+    slot->hot.store(hot, std::memory_order_release);
+    uint64_t available = takeSlotAvailable(*slot);
+    uint64_t share = available / hot->bucket_count;
+    for (size_t i = 0; i < hot->bucket_count; ++i) {
+        hot->buckets[i].available.store(share + (i < available % hot->bucket_count ? 1 : 0),
+                                        std::memory_order_release);
+    }
+    endMove(*hot);
+    LOG_INFO_FMT("Hot stock mode enabled for product {}", std::to_string(product_id));
+    return true;
+}
+
+bool InventoryTable::isHot(uint64_t product_id) const {
+    Slot* slot = find(product_id);
+    return slot && slot->hot.load(std::memory_order_acquire);
+}
+
+size_t InventoryTable::hotCount() const {
+    std::lock_guard<std::mutex> lock(hot_mutex_);
+    return hot_stocks_.size();
+}
+
+void InventoryTable::noteContention(uint64_t product_id, uint32_t failures, time_t now) {
+    if (Slot* slot = find(product_id)) {
+        noteContention(*slot, failures, now);
+    }
+}
+
+void InventoryTable::noteContention(Slot& slot, uint32_t failures, time_t now) {
+    uint32_t threshold = hot_threshold_.load(std::memory_order_relaxed);
+    if (threshold == 0) {
+        return;
+    }
+    uint32_t second = static_cast<uint32_t>(now);
+    uint32_t window = slot.contention_second.load(std::memory_order_relaxed);
+    uint32_t count;
+    if (window != second && slot.contention_second.compare_exchange_strong(window, second,
+                                                                           std::memory_order_relaxed)) {
+        slot.contention.store(failures, std::memory_order_relaxed);
+        count = failures;
+    } else {
+        count = slot.contention.fetch_add(failures, std::memory_order_relaxed) + failures;
+    }
+    if (count >= threshold) {
+        enableHot(slot.product_id.load(std::memory_order_relaxed));
+    }
+}
+
+} // namespace services
+} // namespace order_engine
@@ -0,0 +1,150 @@
+#include "services/order_metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace order_engine {
+namespace services {
+
+namespace {
+
+// 线程编号，按到达顺序分配，决定线程写哪个槽
+std::atomic<size_t> g_next_thread_index{0};
+
+size_t threadIndex() {
+    thread_local size_t index = g_next_thread_index.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+int64_t localUtcOffset() {
+    time_t now = time(nullptr);
+    struct tm tm_buf;
+    localtime_r(&now, &tm_buf);
+    return static_cast<int64_t>(tm_buf.tm_gmtoff);
+}
+
+} // namespace
+
+OrderMetrics::OrderMetrics(size_t slot_count)
+    : slot_count_(slot_count ? slot_count : std::max(1u, std::thread::hardware_concurrency()))
+    , slots_(new Slot[slot_count_])
+    , base_total_(0)
+    , utc_offset_(localUtcOffset()) {
+}
+
+OrderMetrics::~OrderMetrics() = default;
+
+OrderMetrics::Slot& OrderMetrics::localSlot() {
+    return slots_[threadIndex() % slot_count_];
+}
+
+OrderMetrics::Bucket& OrderMetrics::advance(Bucket& bucket, int64_t epoch) {
+    int64_t current = bucket.epoch.load(std::memory_order_acquire);
+    if (current < epoch &&
+        bucket.epoch.compare_exchange_strong(current, epoch, std::memory_order_acq_rel)) {
+        // 同槽的其他线程可能在清零前已累加到新时间段，这部分计数会丢失；
+        // 只在线程数超过槽数时发生，统计可以接受
+        bucket.orders.store(0, std::memory_order_relaxed);
+        bucket.revenue_cents.store(0, std::memory_order_relaxed);
+        for (auto& count : bucket.transitions) {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+    return bucket;
+}
+
+void OrderMetrics::recordCreated(uint64_t count, double revenue, time_t now) {
+    Slot& slot = localSlot();
+    int64_t cents = std::llround(revenue * 100.0);
+    int64_t second = static_cast<int64_t>(now);
+    int64_t minute = second / 60;
+    slot.total_orders.fetch_add(count, std::memory_order_relaxed);
+    for (Bucket* bucket : {&advance(slot.seconds[second % kBuckets], second),
+                           &advance(slot.minutes[minute % kBuckets], minute),
+                           &advance(slot.day, dayOf(now))}) {
+        bucket->orders.fetch_add(count, std::memory_order_relaxed);
+        bucket->revenue_cents.fetch_add(cents, std::memory_order_relaxed);
+        bucket->transitions[static_cast<size_t>(OrderStatus::PENDING)].fetch_add(count, std::memory_order_relaxed);
+    }
+}
+
+void OrderMetrics::recordTransition(OrderStatus status, uint64_t count, time_t now) {
+    auto index = static_cast<size_t>(status);
+    if (index >= kOrderStatusCount) {
+        return;
+    }
+    Slot& slot = localSlot();
+    int64_t second = static_cast<int64_t>(now);
+    int64_t minute = second / 60;
+    for (Bucket* bucket : {&advance(slot.seconds[second % kBuckets], second),
+                           &advance(slot.minutes[minute % kBuckets], minute),
+                           &advance(slot.day, dayOf(now))}) {
+        bucket->transitions[index].fetch_add(count, std::memory_order_relaxed);
+    }
+}
+
+void OrderMetrics::setTotalOrders(uint64_t total) {
+    uint64_t counted = 0;
+    for (size_t i = 0; i < slot_count_; ++i) {
+        counted += slots_[i].total_orders.load(std::memory_order_relaxed);
+    }
+    base_total_.store(total - counted, std::memory_order_relaxed);
+}
+
+uint64_t OrderMetrics::totalOrders() const {
+    uint64_t total = base_total_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < slot_count_; ++i) {
+        total += slots_[i].total_orders.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void OrderMetrics::accumulate(const Bucket& bucket, OrderWindowStats& stats) {
+    stats.orders += bucket.orders.load(std::memory_order_relaxed);
+    stats.revenue += static_cast<double>(bucket.revenue_cents.load(std::memory_order_relaxed)) / 100.0;
+    for (size_t i = 0; i < kOrderStatusCount; ++i) {
+        stats.transitions[i] += bucket.transitions[i].load(std::memory_order_relaxed);
+    }
+}
+
+OrderWindowStats OrderMetrics::lastMinute(time_t now) const {
+    OrderWindowStats stats;
+    int64_t second = static_cast<int64_t>(now);
+    for (size_t i = 0; i < slot_count_; ++i) {
+        for (const Bucket& bucket : slots_[i].seconds) {
+            int64_t epoch = bucket.epoch.load(std::memory_order_acquire);
+            if (epoch > second - static_cast<int64_t>(kBuckets) && epoch <= second) {
+                accumulate(bucket, stats);
+            }
+        }
+    }
+    return stats;
+}
+
+OrderWindowStats OrderMetrics::lastHour(time_t now) const {
+    OrderWindowStats stats;
+    int64_t minute = static_cast<int64_t>(now) / 60;
+    for (size_t i = 0; i < slot_count_; ++i) {
+        for (const Bucket& bucket : slots_[i].minutes) {
+            int64_t epoch = bucket.epoch.load(std::memory_order_acquire);
+            if (epoch > minute - static_cast<int64_t>(kBuckets) && epoch <= minute) {
+                accumulate(bucket, stats);
+            }
+        }
+    }
+    return stats;
+}
+
+OrderWindowStats OrderMetrics::today(time_t now) const {
+    OrderWindowStats stats;
+    int64_t day = dayOf(now);
+    for (size_t i = 0; i < slot_count_; ++i) {
+        if (slots_[i].day.epoch.load(std::memory_order_acquire) == day) {
+            accumulate(slots_[i].day, stats);
+        }
+    }
+    return stats;
+}
+
+} // namespace services
+} // namespace order_engine
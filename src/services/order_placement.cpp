@@ -0,0 +1,186 @@
+#include "services/order_placement.h"
+#include <algorithm>
+
+namespace order_engine {
+namespace services {
+
+// ==================== PlacementBatch ====================
+
+void PlacementBatch::add(std::vector<OrderInfo> request_orders, Completion done) {
+    size_t begin = orders.size();
+    for (auto& order : request_orders) {
+        orders.push_back(std::move(order));
+    }
+    results.resize(orders.size(), OrderResult{0, OrderResultCode::SUCCESS, std::string()});
+    reservation_ids.resize(orders.size());
+    requests.push_back(Request{begin, orders.size(), std::move(done)});
+}
+
+void PlacementBatch::append(PlacementBatch&& other) {
+    size_t offset = orders.size();
+    orders.insert(orders.end(), std::make_move_iterator(other.orders.begin()),
+                  std::make_move_iterator(other.orders.end()));
+    results.insert(results.end(), std::make_move_iterator(other.results.begin()),
+                   std::make_move_iterator(other.results.end()));
+    reservation_ids.insert(reservation_ids.end(), std::make_move_iterator(other.reservation_ids.begin()),
+                           std::make_move_iterator(other.reservation_ids.end()));
+    for (auto& request : other.requests) {
+        requests.push_back(Request{request.begin + offset, request.end + offset, std::move(request.done)});
+    }
+    other = PlacementBatch();
+}
+
+void PlacementBatch::complete() {
+    for (auto& request : requests) {
+        if (request.done) {
+            request.done(*this, request.begin, request.end);
+        }
+    }
+}
+
+// ==================== PlacementStage ====================
+
+PlacementStage::PlacementStage(std::string name, size_t workers, const PlacementOptions& options,
+                               Handler handler, PlacementStage* next)
+    : name_(std::move(name))
+    , worker_count_(std::max<size_t>(workers, 1))
+    , capacity_(std::max<size_t>(options.queue_capacity, 1))
+    , max_batch_(std::max<size_t>(options.max_batch, 1))
+    , handler_(std::move(handler))
+    , next_(next)
+    , queued_orders_(0)
+    , stopping_(true)
+    , batches_(0)
+    , orders_(0)
+    , rejected_(0) {
+}
+
+PlacementStage::~PlacementStage() {
+    stop();
+}
+
+void PlacementStage::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!workers_.empty()) {
+        return;
+    }
+    stopping_ = false;
+    for (size_t i = 0; i < worker_count_; ++i) {
+        workers_.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+void PlacementStage::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    not_empty_.notify_all();
+    not_full_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+}
+
+bool PlacementStage::tryPush(PlacementBatch&& batch) {
+    size_t count = batch.size();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || !hasRoom(count)) {
+            rejected_.fetch_add(count, std::memory_order_relaxed);
+            return false;
+        }
+        queue_.push_back(std::move(batch));
+        queued_orders_ += count;
+    }
+    not_empty_.notify_one();
+    return true;
+}
+
+void PlacementStage::push(PlacementBatch&& batch) {
+    size_t count = batch.size();
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this, count]() { return hasRoom(count); });
+        queue_.push_back(std::move(batch));
+        queued_orders_ += count;
+    }
+    not_empty_.notify_one();
+}
+
+void PlacementStage::workerLoop() {
+    for (;;) {
+        PlacementBatch batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            not_empty_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;  // 已停止且队列已空
+            }
+            // 合并排队的批次，至少取一个
+            batch = std::move(queue_.front());
+            queue_.pop_front();
+            while (!queue_.empty() && batch.size() + queue_.front().size() <= max_batch_) {
+                batch.append(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+            queued_orders_ -= batch.size();
+        }
+        not_full_.notify_all();
+
+        handler_(batch);
+        batches_.fetch_add(1, std::memory_order_relaxed);
+        orders_.fetch_add(batch.size(), std::memory_order_relaxed);
+        if (next_) {
+            next_->push(std::move(batch));
+        } else {
+            batch.complete();
+        }
+    }
+}
+
+PlacementStage::Stats PlacementStage::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return Stats{queued_orders_, batches_.load(std::memory_order_relaxed), orders_.load(std::memory_order_relaxed),
+                 rejected_.load(std::memory_order_relaxed)};
+}
+
+// ==================== OrderPlacementPipeline ====================
+
+OrderPlacementPipeline::OrderPlacementPipeline(const PlacementOptions& options, PlacementStage::Handler reserve,
+                                               PlacementStage::Handler persist, PlacementStage::Handler complete)
+    : complete_(std::make_unique<PlacementStage>("complete", 1, options, std::move(complete), nullptr))
+    , persist_(std::make_unique<PlacementStage>("persist", options.persist_workers, options, std::move(persist),
+                                                complete_.get()))
+    , reserve_(std::make_unique<PlacementStage>("reserve", 1, options, std::move(reserve), persist_.get())) {
+}
+
+OrderPlacementPipeline::~OrderPlacementPipeline() {
+    stop();
+}
+
+void OrderPlacementPipeline::start() {
+    complete_->start();
+    persist_->start();
+    reserve_->start();
+}
+
+void OrderPlacementPipeline::stop() {
+    reserve_->stop();
+    persist_->stop();
+    complete_->stop();
+}
+
+bool OrderPlacementPipeline::submit(PlacementBatch&& batch) {
+    return reserve_->tryPush(std::move(batch));
+}
+
+std::vector<const PlacementStage*> OrderPlacementPipeline::stages() const {
+    return {reserve_.get(), persist_.get(), complete_.get()};
+}
+
+} // namespace services
+} // namespace order_engine
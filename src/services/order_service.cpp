@@ -0,0 +1,1204 @@
+#include "services/order_service.h"
+#include "services/idempotency_cache.h"
+#include "services/order_metrics.h"
+#include "services/order_placement.h"
+#include "services/order_state_machine.h"
+#include "services/order_store.h"
+#include "message/order_event_pipeline.h"
+#include "storage/order_archive.h"
+#include "storage/order_journal.h"
+#include "storage/order_recovery.h"
+#include "storage/order_snapshot.h"
+#include "storage/persistence_batcher.h"
+#include "utils/timing_wheel.h"
+#include "common/logger.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <latch>
+
+namespace order_engine {
+namespace services {
+
+const std::string OrderService::kOrderCachePrefix = "order:";
+const std::string OrderService::kUserOrdersCachePrefix = "user_orders:";
+const int OrderService::kCacheExpireTime = 3600;
+const int OrderService::kReservationGrace = 60;
+
+namespace {
+
+// 超时取消每批的订单数
+constexpr size_t kExpireBatchSize = 1024;
+
+// time_t -> 订单簿中的32位秒数，超出范围时截断
+uint32_t clampTime(time_t value) {
+    if (value <= 0) {
+        return 0;
+    }
+    return value >= static_cast<time_t>(UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(value);
+}
+
+} // namespace
+
+OrderService::OrderService(std::shared_ptr<void> db_pool,
+                           std::shared_ptr<void> cache_manager,
+                           std::shared_ptr<void> kafka_producer)
+    : db_pool_(std::move(db_pool))
+    , cache_manager_(std::move(cache_manager))
+    , kafka_producer_(std::move(kafka_producer))
+    , metrics_(std::make_unique<OrderMetrics>())
+    , max_products_per_order_(50)
+    , max_order_amount_(100000.0)
+    , inventory_reserve_timeout_(0)
+    , order_timeout_(1800)
+    , expiry_running_(false)
+    , writes_stopped_(false) {
+    order_store_ = std::make_unique<OrderStore>();
+}
+
+OrderService::~OrderService() {
+    shutdown();
+}
+
+void OrderService::enableStagedPlacement(const PlacementOptions& options) {
+    placement_options_ = std::make_unique<PlacementOptions>(options);
+}
+
+bool OrderService::initialize(size_t store_shards, uint16_t node_id) {
+    if (node_id > utils::IdGenerator::kMaxNodeId) {
+        LOG_ERROR_FMT("Invalid node id: {}", std::to_string(node_id));
+        return false;
+    }
+    id_generator_.setNodeId(node_id);
+    if (order_timeout_ <= 0) {
+        inventory_reserve_timeout_ = InventoryService::kNoExpiry;
+    } else if (inventory_reserve_timeout_ == 0) {
+        inventory_reserve_timeout_ = order_timeout_ + kReservationGrace;
+    } else if (inventory_reserve_timeout_ < order_timeout_ + kReservationGrace) {
+        LOG_WARN("Inventory reserve timeout " + std::to_string(inventory_reserve_timeout_) +
+                 " s is shorter than order timeout " + std::to_string(order_timeout_) + " s, raised to " +
+                 std::to_string(order_timeout_ + kReservationGrace) + " s");
+        inventory_reserve_timeout_ = order_timeout_ + kReservationGrace;
+    }
+    if (store_shards != 0 && store_shards != order_store_->shardCount() && !order_store_->isRunning()) {
+        order_store_ = std::make_unique<OrderStore>(store_shards);
+    }
+    order_store_->start();
+    if (order_timeout_ > 0 && timeout_wheels_.empty()) {
+        time_t now = time(nullptr);
+        for (size_t i = 0; i < order_store_->shardCount(); ++i) {
+            timeout_wheels_.push_back(std::make_unique<utils::TimingWheel>(now));
+        }
+        startExpiryThread();
+    }
+    if (placement_options_ && !placement_) {
+        placement_ = std::make_unique<OrderPlacementPipeline>(*placement_options_,
+            [this](PlacementBatch& batch) { reserveStage(batch); },
+            [this](PlacementBatch& batch) { persistStage(batch); },
+            [this](PlacementBatch& batch) { completeStage(batch); });
+        placement_->start();
+    }
+    LOG_INFO("OrderService initialized");
+    return true;
+}
+
+void OrderService::shutdown() {
+    // TODO: 等待进行中的订单并刷出缓存/消息 (Phase 2)
+    if (placement_) {
+        placement_->stop();  // 已接受的下单请求全部完成
+        placement_.reset();
+    }
+    stopExpiryThread();
+    order_store_->stop();
+}
+
+void OrderService::startExpiryThread() {
+    if (expiry_running_.exchange(true)) {
+        return;
+    }
+    expiry_thread_ = std::thread([this] {
+        while (expiry_running_.load()) {
+            for (int i = 0; i < 10 && expiry_running_.load(); ++i) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            if (expiry_running_.load()) {
+                cancelExpiredOrders(time(nullptr));
+            }
+        }
+    });
+}
+
+void OrderService::stopExpiryThread() {
+    if (!expiry_running_.exchange(false)) {
+        return;
+    }
+    if (expiry_thread_.joinable()) {
+        expiry_thread_.join();
+    }
+}
+
+void OrderService::scheduleTimeout(uint64_t order_id, time_t created_at) {
+    if (!timeout_wheels_.empty()) {
+        timeout_wheels_[order_store_->shardOf(order_id)]->schedule(order_id, created_at + order_timeout_);
+    }
+}
+
+size_t OrderService::cancelExpiredOrders(time_t now) {
+    if (timeout_wheels_.empty() || writes_stopped_.load(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    // 1. 各分片推进自己的时间轮；已支付或已取消的订单在到期时跳过（惰性删除）
+    std::vector<std::vector<uint64_t>> per_shard(order_store_->shardCount());
+    order_store_->executeAll([&](size_t shard_index, OrderShard& shard) {
+        timeout_wheels_[shard_index]->advance(now, [&](uint64_t order_id) {
+            const StoredOrder* entry = shard.find(order_id);
+            if (entry && entry->order.status == OrderStatus::PENDING) {
+                per_shard[shard_index].push_back(order_id);
+            }
+        });
+    });
+    std::vector<uint64_t> expired;
+    for (const auto& order_ids : per_shard) {
+        expired.insert(expired.end(), order_ids.begin(), order_ids.end());
+    }
+
+    // 2. 分批取消：每批一次日志提交，库存预留随取消释放
+    size_t cancelled = 0;
+    for (size_t begin = 0; begin < expired.size(); begin += kExpireBatchSize) {
+        size_t end = std::min(expired.size(), begin + kExpireBatchSize);
+        std::vector<uint64_t> batch(expired.begin() + static_cast<std::ptrdiff_t>(begin),
+                                    expired.begin() + static_cast<std::ptrdiff_t>(end));
+        updateOrderStatuses(batch, OrderStatus::CANCELLED, [&cancelled](const std::vector<OrderResult>& results) {
+            for (const auto& result : results) {
+                if (result.code == OrderResultCode::SUCCESS) {
+                    ++cancelled;
+                }
+            }
+        });
+    }
+    if (cancelled > 0) {
+        LOG_INFO("Cancelled " + std::to_string(cancelled) + " unpaid orders after " +
+                 std::to_string(order_timeout_) + " s");
+    }
+    return cancelled;
+}
+
+bool OrderService::recover(const std::string& snapshot_dir) {
+    storage::RecoveryResult result;
+    std::string journal_dir = journal_ ? journal_->options().dir : std::string();
+    if (!storage::OrderRecovery::recover(snapshot_dir, journal_dir, *order_store_, result)) {
+        LOG_ERROR("Order store recovery failed");
+        return false;
+    }
+
+    if (journal_ && journal_->lastLsn() < result.snapshot_lsn) {
+        // 日志被清空而快照还在：新日志的LSN会与快照重叠
+        LOG_ERROR("Order journal is behind the latest snapshot");
+        return false;
+    }
+
+    uint64_t orders = 0;
+    for (const auto& shard : order_store_->stats()) {
+        orders += shard.entries;
+    }
+    metrics_->setTotalOrders(orders);
+
+    // 新订单ID从恢复出的最大ID之后分配
+    std::atomic<uint64_t> max_order_id{0};
+    order_store_->executeAll([&max_order_id](size_t, OrderShard& shard) {
+        uint64_t shard_max = 0;
+        shard.forEach([&shard_max](const StoredOrder& entry) {
+            shard_max = std::max(shard_max, entry.order.order_id);
+        });
+        uint64_t current = max_order_id.load(std::memory_order_relaxed);
+        while (current < shard_max && !max_order_id.compare_exchange_weak(current, shard_max)) {
+        }
+    });
+    id_generator_.advancePast(max_order_id.load());
+
+    // 恢复出的待支付订单重新登记支付期限，已超时的在下一秒取消
+    if (!timeout_wheels_.empty()) {
+        order_store_->executeAll([this](size_t, OrderShard& shard) {
+            shard.forEach([this](const StoredOrder& entry) {
+                if (entry.order.status == OrderStatus::PENDING) {
+                    scheduleTimeout(entry.order.order_id, entry.order.created_at);
+                }
+            });
+        });
+    }
+
+    if (!result.snapshot_path.empty()) {
+        LOG_INFO_FMT("Loaded snapshot: {}", result.snapshot_path);
+    }
+    LOG_INFO("Order store recovered: " + std::to_string(result.snapshot_orders) + " orders from snapshot in " +
+             std::to_string(result.load_ms) + " ms, " + std::to_string(result.replayed_records) +
+             " journal records in " + std::to_string(result.replay_ms) + " ms");
+    return true;
+}
+
+bool OrderService::writeSnapshot(const std::string& snapshot_dir) {
+    storage::SnapshotInfo info;
+    auto start = std::chrono::steady_clock::now();
+    if (!storage::OrderSnapshot::write(snapshot_dir, *order_store_, journal_.get(), &info)) {
+        return false;
+    }
+    int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("Snapshot written: " + info.path + " (" + std::to_string(info.orders) + " orders, " +
+             std::to_string(info.bytes / 1024) + " KB, " + std::to_string(elapsed) + " ms)");
+
+    // 保留上一个快照作为备份，日志删到它为止
+    uint64_t oldest_lsn = storage::OrderSnapshot::prune(snapshot_dir, 2);
+    if (journal_ && oldest_lsn > 0) {
+        journal_->removeSegmentsBefore(oldest_lsn);
+    }
+    return true;
+}
+
+size_t OrderService::archiveClosedOrders(time_t cutoff) {
+    if (!archive_ || writes_stopped_.load(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    // 1. 各分片收集已结束且最后变更早于cutoff的订单
+    std::vector<std::vector<OrderInfo>> per_shard(order_store_->shardCount());
+    order_store_->executeAll([&per_shard, cutoff](size_t shard_index, OrderShard& shard) {
+        shard.forEach([&](const StoredOrder& entry) {
+            if (isClosed(entry.order.status) && static_cast<time_t>(entry.order.updated_at) < cutoff) {
+                per_shard[shard_index].emplace_back();
+                entry.order.toOrderInfo(per_shard[shard_index].back());
+            }
+        });
+    });
+    std::vector<OrderInfo> orders;
+    for (auto& shard_orders : per_shard) {
+        orders.insert(orders.end(), std::make_move_iterator(shard_orders.begin()),
+                      std::make_move_iterator(shard_orders.end()));
+    }
+    if (orders.empty()) {
+        return 0;
+    }
+
+    // 2. 归档段落盘后才删除，崩溃时最多重复归档，不会丢失
+    auto start = std::chrono::steady_clock::now();
+    std::string path;
+    if (!archive_->write(orders, &path)) {
+        LOG_ERROR("Order archiving failed");
+        return 0;
+    }
+
+    // 3. 在分片线程内删除并追加日志记录，跳过收集之后又有变更的订单
+    std::vector<uint64_t> order_ids;
+    order_ids.reserve(orders.size());
+    for (const OrderInfo& order : orders) {
+        order_ids.push_back(order.order_id);
+    }
+    std::vector<uint64_t> lsns(orders.size(), 0);
+    std::vector<char> archived(orders.size(), 0);
+    order_store_->executeBatch(order_ids, [&](size_t i, OrderShard& shard) {
+        const StoredOrder* entry = shard.find(order_ids[i]);
+        if (!entry || entry->order.status != orders[i].status ||
+            static_cast<time_t>(entry->order.updated_at) != orders[i].updated_at) {
+            return;
+        }
+        if (journal_ && (lsns[i] = journal_->appendOrderArchived(order_ids[i])) == 0) {
+            LOG_ERROR("Order journal append failed");
+            return;
+        }
+        archived[i] = shard.erase(order_ids[i]) ? 1 : 0;
+    });
+    uint64_t lsn = *std::max_element(lsns.begin(), lsns.end());
+    if (!waitJournal(lsn)) {
+        // 订单已在归档段中，重启后会回到订单簿并在下次重复归档
+        LOG_ERROR("Order journal commit failed while archiving");
+    }
+
+    size_t count = static_cast<size_t>(std::count(archived.begin(), archived.end(), 1));
+    int64_t elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("Archived " + std::to_string(count) + " closed orders to " + path + " in " +
+             std::to_string(elapsed) + " ms");
+    return count;
+}
+
+void OrderService::createOrder(const OrderInfo& order_info, const OrderCallback& callback) {
+    if (placement_) {
+        // 完成级线程回调，调用线程不等待落盘
+        PlacementBatch batch;
+        batch.add({order_info}, [callback](PlacementBatch& completed, size_t begin, size_t) {
+            callback(completed.results[begin].code == OrderResultCode::SUCCESS, completed.results[begin].message,
+                     completed.orders[begin]);
+        });
+        if (!placement_->submit(std::move(batch))) {
+            callback(false, "service busy", order_info);
+        }
+        return;
+    }
+
+    OrderInfo order = order_info;
+    std::string error_msg;
+    if (!validateOrder(order, error_msg)) {
+        callback(false, error_msg, order);
+        return;
+    }
+
+    order.order_id = generateOrderId();
+    order.status = OrderStatus::PENDING;
+    order.created_at = time(nullptr);
+    order.updated_at = order.created_at;
+
+    std::string reservation_id;
+    if (!reserveInventory(order, reservation_id)) {
+        callback(false, "insufficient stock", order);
+        return;
+    }
+
+    // 日志在分片线程内追加，与订单簿写入同序；落盘后才应答
+    bool stored = false;
+    uint64_t lsn = 0;
+    order_store_->execute(order.order_id, [&](OrderShard& shard) {
+        stored = !shard.find(order.order_id) && appendOrderRecord(order, reservation_id, lsn) &&
+                 shard.insert(order, reservation_id);
+        if (stored) {
+            scheduleTimeout(order.order_id, order.created_at);
+        }
+    });
+    bool journaled = stored && waitJournal(lsn);
+    if (stored && (!journaled || !insertOrderToDB(order))) {
+        abortOrders({order.order_id}, journaled);
+        stored = false;
+    }
+    if (!stored) {
+        releaseInventory(reservation_id);
+        callback(false, "failed to persist order", order);
+        return;
+    }
+
+    cacheOrder(order);
+    publishOrderEvent(message::OrderEventType::kCreated, order);
+
+    metrics_->recordCreated(1, order.total_amount, order.created_at);
+
+    callback(true, "order created", order);
+}
+
+void OrderService::createOrder(const OrderInfo& order_info, std::string_view idempotency_key,
+                               const OrderCallback& callback) {
+    if (!idempotency_cache_ || idempotency_key.empty()) {
+        createOrder(order_info, callback);
+        return;
+    }
+
+    // TODO: 多实例部署时在本地去重表之前加一层Redis SET NX EX，跨节点去重 (Phase 2)
+    uint64_t key = IdempotencyCache::makeKey(order_info.user_id, idempotency_key);
+    uint64_t order_id = 0;
+    // 首个请求仍在执行：重试挂到首个请求上，complete()时在其线程上应答，不占用当前线程
+    uint64_t user_id = order_info.user_id;
+    auto attach = [this, user_id, callback](bool success, uint64_t original_id) {
+        if (success) {
+            getOrder(original_id, callback);
+            return;
+        }
+        OrderInfo failed{};
+        failed.user_id = user_id;
+        callback(false, "original request failed", failed);
+    };
+    switch (idempotency_cache_->begin(key, time(nullptr), order_id, attach)) {
+    case IdempotencyCache::BeginResult::kDone:
+        getOrder(order_id, callback);
+        return;
+    case IdempotencyCache::BeginResult::kInProgress:
+        return;
+    case IdempotencyCache::BeginResult::kNew:
+        break;
+    }
+
+    // 分级下单时回调在完成级线程上执行，按值捕获
+    createOrder(order_info, [this, key, callback](bool success, const std::string& message, const OrderInfo& order) {
+        // 先登记结果再应答，应答后到达的重试一定能看到
+        idempotency_cache_->complete(key, success, order.order_id, time(nullptr));
+        callback(success, message, order);
+    });
+}
+
+void OrderService::createOrders(const std::vector<OrderInfo>& orders, const BatchOrderCallback& callback) {
+    if (placement_) {
+        PlacementBatch batch;
+        batch.add(orders, [callback](PlacementBatch& completed, size_t begin, size_t end) {
+            callback(std::vector<OrderResult>(completed.results.begin() + static_cast<std::ptrdiff_t>(begin),
+                                              completed.results.begin() + static_cast<std::ptrdiff_t>(end)));
+        });
+        if (!placement_->submit(std::move(batch))) {
+            callback(std::vector<OrderResult>(orders.size(),
+                                              OrderResult{0, OrderResultCode::SERVICE_UNAVAILABLE, "service busy"}));
+        }
+        return;
+    }
+
+    PlacementBatch batch;
+    batch.add(orders, PlacementBatch::Completion());
+    reserveStage(batch);
+    persistStage(batch);
+    completeStage(batch);
+    callback(batch.results);
+}
+
+void OrderService::reserveStage(PlacementBatch& batch) {
+    // 1. 一次遍历完成校验
+    std::vector<size_t> accepted;
+    accepted.reserve(batch.size());
+    std::string error_msg;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (batch.results[i].code != OrderResultCode::SUCCESS) {
+            continue;
+        }
+        if (!validateOrder(batch.orders[i], error_msg)) {
+            batch.results[i].code = OrderResultCode::INVALID_ORDER;
+            batch.results[i].message = error_msg;
+            continue;
+        }
+        accepted.push_back(i);
+    }
+    if (accepted.empty()) {
+        return;
+    }
+
+    // 2. 整段分配订单ID（超过一段的批次分多段）
+    uint64_t first_id = 0;
+    time_t now = time(nullptr);
+    for (size_t i = 0; i < accepted.size(); ++i) {
+        size_t offset = i % utils::IdGenerator::kMaxBlockSize;
+        if (offset == 0) {
+            first_id = generateOrderIdBlock(
+                std::min(accepted.size() - i, utils::IdGenerator::kMaxBlockSize));
+        }
+        OrderInfo& order = batch.orders[accepted[i]];
+        order.order_id = first_id + offset;
+        order.status = OrderStatus::PENDING;
+        order.created_at = now;
+        order.updated_at = now;
+        batch.results[accepted[i]].order_id = order.order_id;
+    }
+
+    // 3. 一次分组操作预留全部订单的库存
+    if (!inventory_service_) {
+        return;
+    }
+    std::vector<StockRequest> requests;
+    std::vector<std::string> reservation_ids(accepted.size());
+    requests.reserve(accepted.size());
+    for (size_t index : accepted) {
+        const OrderInfo& order = batch.orders[index];
+        requests.push_back(StockRequest{&order.product_ids, &order.quantities, std::to_string(order.order_id)});
+    }
+    inventory_service_->batchReserveStock(requests, inventory_reserve_timeout_, reservation_ids);
+    for (size_t i = 0; i < accepted.size(); ++i) {
+        if (reservation_ids[i].empty()) {
+            OrderResult& result = batch.results[accepted[i]];
+            result.code = OrderResultCode::INSUFFICIENT_STOCK;
+            result.message = "insufficient stock";
+        } else {
+            batch.reservation_ids[accepted[i]] = std::move(reservation_ids[i]);
+        }
+    }
+}
+
+void OrderService::persistStage(PlacementBatch& batch) {
+    // 一次多行写入，日志全部追加后只等待一次提交
+    std::vector<size_t> positions;
+    std::vector<const OrderInfo*> to_persist;
+    std::vector<std::string_view> entry_reservations;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (batch.results[i].code == OrderResultCode::SUCCESS) {
+            positions.push_back(i);
+            to_persist.push_back(&batch.orders[i]);
+            entry_reservations.push_back(batch.reservation_ids[i]);
+        }
+    }
+    if (to_persist.empty()) {
+        return;
+    }
+
+    // 订单簿按分片分组插入，每个分片一次任务
+    std::vector<uint64_t> lsns(to_persist.size(), 0);
+    std::vector<bool> inserted = order_store_->insertBatch(to_persist, entry_reservations,
+        [&](size_t index) {
+            if (!appendOrderRecord(*to_persist[index], entry_reservations[index], lsns[index])) {
+                return false;
+            }
+            scheduleTimeout(to_persist[index]->order_id, to_persist[index]->created_at);
+            return true;
+        });
+    std::vector<const OrderInfo*> stored_orders;
+    stored_orders.reserve(inserted.size());
+    for (size_t i = 0; i < inserted.size(); ++i) {
+        if (inserted[i]) {
+            stored_orders.push_back(to_persist[i]);
+        }
+    }
+    bool journaled = waitJournal(*std::max_element(lsns.begin(), lsns.end()));
+    bool committed = journaled && (stored_orders.empty() || insertOrdersToDB(stored_orders));
+
+    std::vector<uint64_t> aborted;
+    for (size_t i = 0; i < inserted.size(); ++i) {
+        if (committed && inserted[i]) {
+            continue;
+        }
+        if (inserted[i]) {
+            aborted.push_back(to_persist[i]->order_id);
+        }
+        releaseInventory(batch.reservation_ids[positions[i]]);
+        OrderResult& result = batch.results[positions[i]];
+        result.code = OrderResultCode::INTERNAL_ERROR;
+        result.message = "failed to persist order";
+    }
+    abortOrders(aborted, journaled);
+}
+
+void OrderService::completeStage(PlacementBatch& batch) {
+    std::vector<const OrderInfo*> created;
+    created.reserve(batch.size());
+    double revenue = 0.0;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        OrderResult& result = batch.results[i];
+        if (result.code != OrderResultCode::SUCCESS) {
+            continue;
+        }
+        result.message = "order created";
+        created.push_back(&batch.orders[i]);
+        revenue += batch.orders[i].total_amount;
+    }
+    if (created.empty()) {
+        return;
+    }
+
+    for (const OrderInfo* order : created) {
+        cacheOrder(*order);
+        publishOrderEvent(message::OrderEventType::kCreated, *order);
+    }
+    // 统计按批次更新一次
+    metrics_->recordCreated(created.size(), revenue, created.front()->created_at);
+}
+
+void OrderService::updateOrderStatus(uint64_t order_id, OrderStatus status, const OrderCallback& callback) {
+    OrderInfo order{};
+    order.order_id = order_id;
+    bool cancelling = status == OrderStatus::CANCELLED;
+    // 取消退回预留库存，支付确认扣减；两者都结清预留，订单不再持有预留ID
+    bool settling = cancelling || status == OrderStatus::PAID;
+    std::string reservation_id;
+    bool found = false;
+    bool allowed = false;
+    bool journaled = false;
+    uint64_t lsn = 0;
+    StoredOrder previous{};
+    time_t now = time(nullptr);
+    order_store_->execute(order_id, [&](OrderShard& shard) {
+        found = shard.modify(order_id, [&](StoredOrder& entry) {
+            allowed = canTransition(entry.order.status, status);
+            journaled = allowed && appendStatusRecord(order_id, status, now, lsn);
+            if (journaled) {
+                previous = entry;
+                entry.order.status = status;
+                entry.order.updated_at = static_cast<uint32_t>(now);
+                // 经由状态更新取消与cancelOrder一样要退回预留库存
+                if (settling) {
+                    reservation_id = entry.reservation_id;
+                    entry.reservation_id = std::string_view();
+                }
+            }
+            entry.order.toOrderInfo(order);
+        });
+    });
+    if (!found) {
+        callback(false, "order not found", order);
+        return;
+    }
+    if (!allowed) {
+        callback(false, "invalid status transition", order);
+        return;
+    }
+
+    if (!journaled || !waitJournal(lsn)) {
+        if (journaled) {
+            rollbackStatus(previous, reservation_id);
+        }
+        callback(false, "failed to persist order", order);
+        return;
+    }
+    if (cancelling) {
+        releaseInventory(reservation_id);
+    } else if (settling) {
+        confirmInventory(reservation_id);
+    }
+    if (!updateOrderInDB(order)) {
+        callback(false, "failed to persist order", order);
+        return;
+    }
+    invalidateOrderCache(order_id);
+    publishOrderEvent(message::OrderEventType::kStatusChanged, order);
+    metrics_->recordTransition(status, 1, now);
+    callback(true, "status updated", order);
+}
+
+void OrderService::cancelOrder(uint64_t order_id, const std::string& reason, const OrderCallback& callback) {
+    OrderInfo order{};
+    order.order_id = order_id;
+    std::string reservation_id;
+    bool found = false;
+    bool cancellable = false;
+    bool journaled = false;
+    uint64_t lsn = 0;
+    StoredOrder previous{};
+    time_t now = time(nullptr);
+    order_store_->execute(order_id, [&](OrderShard& shard) {
+        found = shard.modify(order_id, [&](StoredOrder& entry) {
+            cancellable = canTransition(entry.order.status, OrderStatus::CANCELLED);
+            journaled = cancellable && appendStatusRecord(order_id, OrderStatus::CANCELLED, now, lsn);
+            if (journaled) {
+                previous = entry;
+                entry.order.status = OrderStatus::CANCELLED;
+                entry.order.updated_at = static_cast<uint32_t>(now);
+                reservation_id = entry.reservation_id;
+                entry.reservation_id = std::string_view();
+            }
+            entry.order.toOrderInfo(order);
+        });
+    });
+    if (!found) {
+        callback(false, "order not found", order);
+        return;
+    }
+    if (!cancellable) {
+        callback(false, "order cannot be cancelled", order);
+        return;
+    }
+
+    if (!journaled || !waitJournal(lsn)) {
+        if (journaled) {
+            rollbackStatus(previous, reservation_id);
+        }
+        callback(false, "failed to persist order", order);
+        return;
+    }
+    releaseInventory(reservation_id);
+    updateOrderInDB(order);
+    invalidateOrderCache(order_id);
+    publishOrderEvent(message::OrderEventType::kCancelled, order);
+    metrics_->recordTransition(OrderStatus::CANCELLED, 1, now);
+    LOG_INFO("Order " + std::to_string(order_id) + " cancelled: " + reason);
+    callback(true, "order cancelled", order);
+}
+
+void OrderService::updateOrderStatuses(const std::vector<uint64_t>& order_ids, OrderStatus status,
+                                       const BatchOrderCallback& callback) {
+    std::vector<OrderResult> results;
+    results.reserve(order_ids.size());
+    for (uint64_t order_id : order_ids) {
+        results.push_back(OrderResult{order_id, OrderResultCode::NOT_FOUND, "order not found"});
+    }
+    std::vector<OrderInfo> orders(order_ids.size());
+    std::vector<StoredOrder> previous(order_ids.size());
+    std::vector<char> applied(order_ids.size(), 0);
+    std::vector<uint64_t> lsns(order_ids.size(), 0);
+    bool cancelling = status == OrderStatus::CANCELLED;
+    bool settling = cancelling || status == OrderStatus::PAID;
+    std::vector<std::string> reservation_ids(settling ? order_ids.size() : 0);
+    time_t now = time(nullptr);
+
+    // 1. 各分片线程内校验、追加日志并应用，每个分片一次任务
+    order_store_->executeBatch(order_ids, [&](size_t i, OrderShard& shard) {
+        shard.modify(order_ids[i], [&](StoredOrder& entry) {
+            OrderResult& result = results[i];
+            if (!canTransition(entry.order.status, status)) {
+                result.code = OrderResultCode::INVALID_ORDER;
+                result.message = "invalid status transition";
+                return;
+            }
+            if (!appendStatusRecord(order_ids[i], status, now, lsns[i])) {
+                result.code = OrderResultCode::INTERNAL_ERROR;
+                result.message = "failed to persist order";
+                return;
+            }
+            previous[i] = entry;
+            entry.order.status = status;
+            entry.order.updated_at = static_cast<uint32_t>(now);
+            if (settling) {
+                reservation_ids[i] = entry.reservation_id;
+                entry.reservation_id = std::string_view();
+            }
+            entry.order.toOrderInfo(orders[i]);
+            applied[i] = 1;
+            result.code = OrderResultCode::SUCCESS;
+            result.message = "status updated";
+        });
+    });
+
+    std::vector<size_t> changed;
+    for (size_t i = 0; i < order_ids.size(); ++i) {
+        if (applied[i]) {
+            changed.push_back(i);
+        }
+    }
+    if (changed.empty()) {
+        callback(results);
+        return;
+    }
+
+    // 2. 日志按LSN顺序提交，只等待一次
+    if (!waitJournal(*std::max_element(lsns.begin(), lsns.end()))) {
+        std::vector<StoredOrder> rollback;
+        std::vector<std::string> rollback_reservations(changed.size());
+        rollback.reserve(changed.size());
+        for (size_t k = 0; k < changed.size(); ++k) {
+            size_t i = changed[k];
+            rollback.push_back(previous[i]);
+            if (settling) {
+                rollback_reservations[k] = std::move(reservation_ids[i]);
+            }
+            results[i].code = OrderResultCode::INTERNAL_ERROR;
+            results[i].message = "failed to persist order";
+        }
+        rollbackStatuses(rollback, rollback_reservations);
+        callback(results);
+        return;
+    }
+
+    // 3. 数据库一次批量操作
+    std::vector<const OrderInfo*> changed_orders;
+    changed_orders.reserve(changed.size());
+    for (size_t i : changed) {
+        changed_orders.push_back(&orders[i]);
+        if (cancelling) {
+            releaseInventory(reservation_ids[i]);
+        } else if (settling) {
+            confirmInventory(reservation_ids[i]);
+        }
+    }
+    updateOrdersInDB(changed_orders);
+    for (const OrderInfo* order : changed_orders) {
+        invalidateOrderCache(order->order_id);
+        publishOrderEvent(cancelling ? message::OrderEventType::kCancelled : message::OrderEventType::kStatusChanged,
+                          *order);
+    }
+    metrics_->recordTransition(status, changed.size(), now);
+    callback(results);
+}
+
+uint64_t OrderService::getTotalOrderCount() const {
+    return metrics_->totalOrders();
+}
+
+uint64_t OrderService::getTodayOrderCount() const {
+    return metrics_->today(time(nullptr)).orders;
+}
+
+double OrderService::getTodayRevenue() const {
+    return metrics_->today(time(nullptr)).revenue;
+}
+
+void OrderService::getOrder(uint64_t order_id, const OrderCallback& callback) {
+    OrderInfo order{};
+    bool found = false;
+    order_store_->execute(order_id, [&](OrderShard& shard) {
+        if (const StoredOrder* entry = shard.find(order_id)) {
+            entry->order.toOrderInfo(order);
+            found = true;
+        }
+    });
+    // 订单簿未命中时再查缓存和数据库
+    if (found || getCachedOrder(order_id, order) || selectOrderFromDB(order_id, order)) {
+        callback(true, "ok", order);
+        return;
+    }
+    order.order_id = order_id;
+    callback(false, "order not found", order);
+}
+
+void OrderService::getUserOrders(uint64_t user_id, int page, int page_size,
+                                 const std::function<void(bool, const std::vector<OrderInfo>&)>& callback) {
+    std::vector<OrderInfo> result;
+    if (page < 1 || page_size <= 0) {
+        callback(false, result);
+        return;
+    }
+
+    // 每个分片最多取前page * page_size个，合并后跳过偏移
+    size_t offset = static_cast<size_t>(page - 1) * page_size;
+    result = collectUserOrders(user_id, nullptr, offset + page_size);
+    if (offset >= result.size()) {
+        result.clear();
+    } else {
+        result.erase(result.begin(), result.begin() + offset);
+    }
+    callback(true, result);
+}
+
+void OrderService::getUserOrdersPage(uint64_t user_id, std::string_view cursor, int limit,
+                                     const std::function<void(bool, const std::vector<OrderInfo>&,
+                                                              const std::string&)>& callback) {
+    UserOrderKey after{};
+    if (limit <= 0 || (!cursor.empty() && !UserOrderKey::fromCursor(cursor, after))) {
+        callback(false, std::vector<OrderInfo>(), std::string());
+        return;
+    }
+
+    // 多取一个用于判断是否还有下一页
+    std::vector<OrderInfo> result = collectUserOrders(user_id, cursor.empty() ? nullptr : &after,
+                                                      static_cast<size_t>(limit) + 1);
+    std::string next_cursor;
+    if (result.size() > static_cast<size_t>(limit)) {
+        result.resize(static_cast<size_t>(limit));
+        const OrderInfo& last = result.back();
+        next_cursor = UserOrderKey{static_cast<uint32_t>(last.created_at), last.order_id}.toCursor();
+    }
+    callback(true, result, next_cursor);
+}
+
+std::vector<OrderInfo> OrderService::collectUserOrders(uint64_t user_id, const UserOrderKey* cursor, size_t limit) {
+    // 订单按order_id分片，同一用户的订单分散在各分片：每个分片最多取limit个
+    std::vector<std::vector<OrderInfo>> per_shard(order_store_->shardCount());
+    order_store_->executeAll([&per_shard, user_id, cursor, limit](size_t shard_index, OrderShard& shard) {
+        std::vector<UserOrderKey> keys;
+        shard.userIndex().before(user_id, cursor, limit, keys);
+        std::vector<OrderInfo>& orders = per_shard[shard_index];
+        orders.resize(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            shard.find(keys[i].order_id)->order.toOrderInfo(orders[i]);
+        }
+    });
+
+    std::vector<OrderInfo> result;
+    for (auto& orders : per_shard) {
+        result.insert(result.end(), std::make_move_iterator(orders.begin()),
+                      std::make_move_iterator(orders.end()));
+    }
+
+    // 最新的订单在前
+    auto newer = [](const OrderInfo& a, const OrderInfo& b) {
+        return a.created_at != b.created_at ? a.created_at > b.created_at : a.order_id > b.order_id;
+    };
+    if (result.size() > limit) {
+        std::partial_sort(result.begin(), result.begin() + static_cast<std::ptrdiff_t>(limit), result.end(), newer);
+        result.resize(limit);
+    } else {
+        std::sort(result.begin(), result.end(), newer);
+    }
+    return result;
+}
+
+void OrderService::getOrdersByStatus(OrderStatus status, time_t from, time_t to, std::string_view cursor, int limit,
+                                     const std::function<void(bool, const std::vector<OrderInfo>&,
+                                                              const std::string&)>& callback) {
+    UserOrderKey after{};
+    if (limit <= 0 || static_cast<size_t>(status) >= kOrderStatusCount ||
+        (!cursor.empty() && !UserOrderKey::fromCursor(cursor, after))) {
+        callback(false, std::vector<OrderInfo>(), std::string());
+        return;
+    }
+
+    // 每个分片最多取limit + 1个（多取一个用于判断是否还有下一页），合并后从旧到新
+    size_t wanted = static_cast<size_t>(limit) + 1;
+    uint32_t begin = clampTime(from);
+    uint32_t end = clampTime(to);
+    const UserOrderKey* after_ptr = cursor.empty() ? nullptr : &after;
+    std::vector<std::vector<OrderInfo>> per_shard(order_store_->shardCount());
+    order_store_->executeAll([&](size_t shard_index, OrderShard& shard) {
+        std::vector<UserOrderKey> keys;
+        shard.statusIndex().range(status, begin, end, after_ptr, wanted, keys);
+        std::vector<OrderInfo>& orders = per_shard[shard_index];
+        orders.resize(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            shard.find(keys[i].order_id)->order.toOrderInfo(orders[i]);
+        }
+    });
+
+    std::vector<OrderInfo> result;
+    for (auto& orders : per_shard) {
+        result.insert(result.end(), std::make_move_iterator(orders.begin()), std::make_move_iterator(orders.end()));
+    }
+    auto older = [](const OrderInfo& a, const OrderInfo& b) {
+        return a.created_at != b.created_at ? a.created_at < b.created_at : a.order_id < b.order_id;
+    };
+    if (result.size() > wanted) {
+        std::partial_sort(result.begin(), result.begin() + static_cast<std::ptrdiff_t>(wanted), result.end(), older);
+        result.resize(wanted);
+    } else {
+        std::sort(result.begin(), result.end(), older);
+    }
+
+    std::string next_cursor;
+    if (result.size() > static_cast<size_t>(limit)) {
+        result.resize(static_cast<size_t>(limit));
+        const OrderInfo& last = result.back();
+        next_cursor = UserOrderKey{static_cast<uint32_t>(last.created_at), last.order_id}.toCursor();
+    }
+    callback(true, result, next_cursor);
+}
+
+size_t OrderService::countOrdersByStatus(OrderStatus status, time_t from, time_t to) {
+    uint32_t begin = clampTime(from);
+    uint32_t end = clampTime(to);
+    std::vector<size_t> per_shard(order_store_->shardCount(), 0);
+    order_store_->executeAll([&](size_t shard_index, OrderShard& shard) {
+        per_shard[shard_index] = shard.statusIndex().count(status, begin, end);
+    });
+    size_t total = 0;
+    for (size_t count : per_shard) {
+        total += count;
+    }
+    return total;
+}
+
+bool OrderService::validateOrder(const OrderInfo& order_info, std::string& error_msg) {
+    if (order_info.user_id == 0) {
+        error_msg = "invalid user id";
+        return false;
+    }
+    if (order_info.product_ids.empty() || order_info.product_ids.size() != order_info.quantities.size()) {
+        error_msg = "invalid order items";
+        return false;
+    }
+    if (order_info.product_ids.size() > static_cast<size_t>(max_products_per_order_)) {
+        error_msg = "too many products in order";
+        return false;
+    }
+    for (uint32_t quantity : order_info.quantities) {
+        if (quantity == 0) {
+            error_msg = "invalid quantity";
+            return false;
+        }
+    }
+    if (order_info.total_amount <= 0.0 || order_info.total_amount > max_order_amount_) {
+        error_msg = "invalid order amount";
+        return false;
+    }
+    return true;
+}
+
+bool OrderService::checkInventory(const std::vector<uint64_t>& product_ids,
+                                  const std::vector<uint32_t>& quantities) {
+    return !inventory_service_ || inventory_service_->batchCheckStock(product_ids, quantities);
+}
+
+bool OrderService::reserveInventory(const OrderInfo& order, std::string& reservation_id) {
+    if (!inventory_service_) {
+        return true;
+    }
+
+    // Phase 1的库存服务同步回调
+    bool reserved = false;
+    inventory_service_->reserveStock(order.product_ids, order.quantities, std::to_string(order.order_id),
+                                     inventory_reserve_timeout_,
+                                     [&reserved, &reservation_id](bool success, const std::string& message) {
+                                         reserved = success;
+                                         if (success) {
+                                             reservation_id = message;
+                                         }
+                                     });
+    return reserved;
+}
+
+void OrderService::confirmInventory(const std::string& reservation_id) {
+    if (!inventory_service_ || reservation_id.empty()) {
+        return;
+    }
+    inventory_service_->confirmReservation(reservation_id, [reservation_id](bool success, const std::string&) {
+        if (!success) {
+            LOG_WARN("Failed to confirm reservation " + reservation_id);
+        }
+    });
+}
+
+void OrderService::releaseInventory(const std::string& reservation_id) {
+    if (!inventory_service_ || reservation_id.empty()) {
+        return;
+    }
+    inventory_service_->releaseReservation(reservation_id, [reservation_id](bool success, const std::string&) {
+        if (!success) {
+            LOG_WARN("Failed to release reservation " + reservation_id);
+        }
+    });
+}
+
+uint64_t OrderService::generateOrderId() {
+    return id_generator_.nextId();
+}
+
+uint64_t OrderService::generateOrderIdBlock(size_t count) {
+    return id_generator_.nextBlock(count);
+}
+
+size_t OrderService::generateOrderNumber(uint64_t order_id, char* buffer) const {
+    return id_generator_.formatOrderNumber(order_id, buffer);
+}
+
+void OrderService::publishOrderEvent(message::OrderEventType type, const OrderInfo& order) {
+    if (!event_pipeline_) {
+        return;
+    }
+    // 队列满时丢弃，由流水线计数和告警，订单处理不受影响
+    event_pipeline_->publish(message::OrderEvent{order.order_id, order.user_id, order.total_amount,
+                                                 static_cast<int64_t>(order.updated_at), type, order.status});
+}
+
+void OrderService::cacheOrder(const OrderInfo&) {
+    // TODO: 缓存管理器接入后实现，批量路径届时合并为一次管道SET (Phase 2)
+}
+
+bool OrderService::getCachedOrder(uint64_t, OrderInfo&) {
+    // TODO: 缓存管理器接入后实现 (Phase 2)
+    return false;
+}
+
+void OrderService::invalidateOrderCache(uint64_t) {
+    // TODO: 缓存管理器接入后实现，批量路径届时合并为一次管道DEL (Phase 2)
+}
+
+bool OrderService::appendOrderRecord(const OrderInfo& order, std::string_view reservation_id, uint64_t& lsn) {
+    if (writes_stopped_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    if (!journal_) {
+        return true;
+    }
+    lsn = journal_->appendOrderCreated(order, reservation_id);
+    if (lsn == 0) {
+        LOG_ERROR("Order journal append failed");
+        return false;
+    }
+    return true;
+}
+
+bool OrderService::appendStatusRecord(uint64_t order_id, OrderStatus status, time_t updated_at, uint64_t& lsn) {
+    if (writes_stopped_.load(std::memory_order_acquire)) {
+        return false;
+    }
+    if (!journal_) {
+        return true;
+    }
+    lsn = journal_->appendStatusChanged(order_id, status, updated_at);
+    if (lsn == 0) {
+        LOG_ERROR("Order journal append failed");
+        return false;
+    }
+    return true;
+}
+
+void OrderService::abortOrders(const std::vector<uint64_t>& order_ids, bool journaled) {
+    // 创建记录已提交时追加撤销记录，否则回放会恢复出未应答成功、预留已释放的订单；
+    // 未提交时日志已失败，重新打开时截断到最后一个已提交的LSN
+    std::vector<uint64_t> lsns(order_ids.size(), 0);
+    for (size_t i = 0; i < order_ids.size(); ++i) {
+        uint64_t order_id = order_ids[i];
+        uint64_t& lsn = lsns[i];
+        order_store_->execute(order_id, [this, order_id, journaled, &lsn](OrderShard& shard) {
+            shard.erase(order_id);
+            if (journaled && journal_) {
+                lsn = journal_->appendOrderAborted(order_id);
+            }
+        });
+    }
+    if (journaled && journal_ && !lsns.empty() &&
+        !journal_->waitForCommit(*std::max_element(lsns.begin(), lsns.end()))) {
+        LOG_ERROR("Order journal abort record not committed");
+    }
+}
+
+bool OrderService::waitJournal(uint64_t lsn) {
+    // 日志按LSN顺序提交，等待最大的LSN即覆盖之前的全部记录
+    return lsn == 0 || journal_->waitForCommit(lsn);
+}
+
+void OrderService::rollbackStatus(const StoredOrder& previous, const std::string& reservation_id) {
+    rollbackStatuses({previous}, {reservation_id});
+}
+
+void OrderService::rollbackStatuses(const std::vector<StoredOrder>& previous,
+                                    const std::vector<std::string>& reservation_ids) {
+    std::vector<uint64_t> order_ids;
+    order_ids.reserve(previous.size());
+    for (const StoredOrder& entry : previous) {
+        order_ids.push_back(entry.order.order_id);
+    }
+    order_store_->executeBatch(order_ids, [&](size_t i, OrderShard& shard) {
+        shard.modify(order_ids[i], [&](StoredOrder& entry) {
+            entry.order.status = previous[i].order.status;
+            entry.order.updated_at = previous[i].order.updated_at;
+            if (!reservation_ids[i].empty()) {
+                entry.reservation_id = shard.storeString(reservation_ids[i]);
+            }
+        });
+    });
+}
+
+bool OrderService::insertOrderToDB(const OrderInfo& order) {
+    return insertOrdersToDB({&order});
+}
+
+bool OrderService::insertOrdersToDB(const std::vector<const OrderInfo*>& orders) {
+    if (!persistence_batcher_) {
+        // Phase 1: 订单只保存在进程内订单簿和预写日志
+        return true;
+    }
+
+    char order_number[utils::IdGenerator::kOrderNumberLength];
+    if (journal_) {
+        // 日志已落盘，数据库只是派生副本：异步写入，不在应答路径上。
+        // 事务失败时批量持久化器退避重试，停止时仍未写入或转入死信才回调失败
+        for (const OrderInfo* order : orders) {
+            size_t len = generateOrderNumber(order->order_id, order_number);
+            uint64_t order_id = order->order_id;
+            bool submitted = persistence_batcher_->submit(*order, std::string_view(order_number, len),
+                [order_id](bool success) {
+                    if (!success) {
+                        LOG_ERROR_FMT("Order not persisted to database, kept in journal: {}",
+                                      std::to_string(order_id));
+                    }
+                }, true);
+            if (!submitted) {
+                LOG_ERROR_FMT("Order not persisted to database, kept in journal: {}", std::to_string(order_id));
+            }
+        }
+        return true;
+    }
+
+    // 没有日志时数据库是唯一的持久化副本，等所在批次提交后再应答
+    std::atomic<bool> ok(true);
+    std::latch done(static_cast<std::ptrdiff_t>(orders.size()));
+    for (const OrderInfo* order : orders) {
+        size_t len = generateOrderNumber(order->order_id, order_number);
+        bool submitted = persistence_batcher_->submit(*order, std::string_view(order_number, len),
+            [&ok, &done](bool success) {
+                if (!success) {
+                    ok.store(false, std::memory_order_relaxed);
+                }
+                done.count_down();
+            });
+        if (!submitted) {
+            ok.store(false, std::memory_order_relaxed);
+            done.count_down();
+        }
+    }
+    done.wait();
+    return ok.load(std::memory_order_relaxed);
+}
+
+bool OrderService::updateOrderInDB(const OrderInfo&) {
+    // TODO: 数据库接入后由日志异步写入orders表 (Phase 2)
+    return true;
+}
+
+bool OrderService::updateOrdersInDB(const std::vector<const OrderInfo*>&) {
+    // TODO: 数据库接入后合并为一条UPDATE ... CASE order_id语句 (Phase 2)
+    return true;
+}
+
+bool OrderService::selectOrderFromDB(uint64_t, OrderInfo&) {
+    // TODO: 数据库接入后查询orders表，用于订单簿之外的历史订单 (Phase 2)
+    return false;
+}
+
+} // namespace services
+} // namespace order_engine
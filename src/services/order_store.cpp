@@ -0,0 +1,335 @@
+#include "services/order_store.h"
+#include "common/logger.h"
+#include "utils/hash_utils.h"
+#include <algorithm>
+#include <latch>
+
+namespace order_engine {
+namespace services {
+
+namespace {
+
+// unordered_map节点：next指针 + 缓存的哈希值 + 键值对
+constexpr size_t kNodeOverhead = sizeof(void*) + sizeof(size_t) + sizeof(uint64_t);
+
+UserOrderKey userKey(const CompactOrder& order) {
+    return UserOrderKey{order.created_at, order.order_id};
+}
+
+} // namespace
+
+// ==================== OrderShard ====================
+
+StoredOrder* OrderShard::find(uint64_t order_id) {
+    auto it = orders_.find(order_id);
+    return it == orders_.end() ? nullptr : &it->second;
+}
+
+bool OrderShard::insert(const OrderInfo& order, std::string_view reservation_id) {
+    if (orders_.count(order.order_id)) {
+        return false;
+    }
+    auto it = orders_.try_emplace(order.order_id,
+                                  StoredOrder{CompactOrder::fromOrderInfo(order, arena_),
+                                              arena_.store(reservation_id)}).first;
+    user_index_.add(order.user_id, userKey(it->second.order));
+    status_index_.add(order.status, userKey(it->second.order));
+    entry_bytes_ += footprint(it->second);
+    string_bytes_ += stringBytes(it->second);
+    publishStats();
+    return true;
+}
+
+bool OrderShard::insert(const CompactOrder& order, std::string_view reservation_id) {
+    auto [it, inserted] = orders_.try_emplace(order.order_id, StoredOrder{order, std::string_view()});
+    if (!inserted) {
+        return false;
+    }
+    it->second.order.shipping_address = arena_.store(order.shipping_address);
+    it->second.reservation_id = arena_.store(reservation_id);
+    user_index_.add(order.user_id, userKey(order));
+    status_index_.add(order.status, userKey(order));
+    entry_bytes_ += footprint(it->second);
+    string_bytes_ += stringBytes(it->second);
+    publishStats();
+    return true;
+}
+
+void OrderShard::reserve(size_t count) {
+    orders_.reserve(count);
+    publishStats();
+}
+
+bool OrderShard::erase(uint64_t order_id) {
+    auto it = orders_.find(order_id);
+    if (it == orders_.end()) {
+        return false;
+    }
+    entry_bytes_ -= footprint(it->second);
+    string_bytes_ -= stringBytes(it->second);
+    user_index_.remove(it->second.order.user_id, userKey(it->second.order));
+    status_index_.remove(it->second.order.status, userKey(it->second.order));
+    orders_.erase(it);
+    compactStrings();
+    publishStats();
+    return true;
+}
+
+bool OrderShard::modify(uint64_t order_id, const std::function<void(StoredOrder&)>& fn) {
+    auto it = orders_.find(order_id);
+    if (it == orders_.end()) {
+        return false;
+    }
+    size_t before = footprint(it->second);
+    size_t strings_before = stringBytes(it->second);
+    uint64_t user_id = it->second.order.user_id;
+    OrderStatus status = it->second.order.status;
+    UserOrderKey key = userKey(it->second.order);
+    fn(it->second);
+    // 用户或创建时间被改动时重建该订单的用户索引项，状态或创建时间改动时重建状态索引项
+    bool key_changed = !(userKey(it->second.order) == key);
+    if (it->second.order.user_id != user_id || key_changed) {
+        user_index_.remove(user_id, key);
+        user_index_.add(it->second.order.user_id, userKey(it->second.order));
+    }
+    if (it->second.order.status != status || key_changed) {
+        status_index_.remove(status, key);
+        status_index_.add(it->second.order.status, userKey(it->second.order));
+    }
+    entry_bytes_ = entry_bytes_ - before + footprint(it->second);
+    string_bytes_ = string_bytes_ - strings_before + stringBytes(it->second);
+    compactStrings();
+    publishStats();
+    return true;
+}
+
+void OrderShard::forEach(const std::function<void(const StoredOrder&)>& fn) const {
+    for (const auto& [order_id, order] : orders_) {
+        fn(order);
+    }
+}
+
+OrderShardStats OrderShard::stats() const {
+    return OrderShardStats{entries_.load(std::memory_order_relaxed),
+                           memory_bytes_.load(std::memory_order_relaxed),
+                           tasks_.load(std::memory_order_relaxed)};
+}
+
+size_t OrderShard::footprint(const StoredOrder& entry) {
+    return kNodeOverhead + sizeof(StoredOrder) + entry.order.items.heapBytes();
+}
+
+void OrderShard::compactStrings() {
+    size_t dead = arena_.storedBytes() - string_bytes_;
+    if (dead < kCompactMinDeadBytes || dead <= string_bytes_) {
+        return;
+    }
+    utils::StringArena next;
+    for (auto& [order_id, entry] : orders_) {
+        entry.order.shipping_address = next.store(entry.order.shipping_address);
+        entry.reservation_id = next.store(entry.reservation_id);
+    }
+    arena_.swap(next);
+    ++compactions_;
+    LOG_DEBUG("Order shard strings compacted: " + std::to_string(next.allocatedBytes()) + " -> " +
+              std::to_string(arena_.allocatedBytes()) + " bytes");
+}
+
+void OrderShard::publishStats() {
+    entries_.store(orders_.size(), std::memory_order_relaxed);
+    memory_bytes_.store(entry_bytes_ + orders_.bucket_count() * sizeof(void*) + arena_.allocatedBytes() +
+                        user_index_.memoryBytes() + status_index_.memoryBytes(), std::memory_order_relaxed);
+}
+
+// ==================== OrderStore ====================
+
+OrderStore::OrderStore(size_t shard_count)
+    : running_(false) {
+    if (shard_count == 0) {
+        shard_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    shards_.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i) {
+        shards_.push_back(std::make_unique<OrderShard>());
+    }
+}
+
+OrderStore::~OrderStore() {
+    stop();
+}
+
+void OrderStore::start() {
+    if (running_.load()) {
+        return;
+    }
+
+    // Reactor在各自线程内创建，构造完成即绑定到所属线程
+    std::latch ready(static_cast<std::ptrdiff_t>(shards_.size()));
+    for (auto& shard_ptr : shards_) {
+        OrderShard* shard = shard_ptr.get();
+        shard->thread_ = std::thread([shard, &ready]() {
+            shard->reactor_ = std::make_unique<network::Reactor>();
+            network::Reactor* reactor = shard->reactor_.get();
+            ready.count_down();
+            reactor->loop();
+        });
+    }
+    ready.wait();
+    running_.store(true, std::memory_order_release);
+
+    LOG_INFO_FMT_INT("OrderStore started with {} shards", static_cast<int>(shards_.size()));
+}
+
+void OrderStore::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    // quit排在已投递任务之后，等待中的execute()都能完成
+    for (auto& shard : shards_) {
+        network::Reactor* reactor = shard->reactor_.get();
+        reactor->queueInLoop([reactor]() { reactor->quit(); });
+    }
+    for (auto& shard : shards_) {
+        if (shard->thread_.joinable()) {
+            shard->thread_.join();
+        }
+        shard->reactor_.reset();
+    }
+
+    LOG_INFO("OrderStore stopped");
+}
+
+size_t OrderStore::shardIndex(uint64_t order_id, size_t shard_count) {
+    return utils::mix64(order_id) % shard_count;
+}
+
+void OrderStore::post(uint64_t order_id, ShardTask task) {
+    size_t index = shardOf(order_id);
+    OrderShard* shard = shards_[index].get();
+    runOnShard(index, [shard, task = std::move(task)]() {
+        shard->tasks_.fetch_add(1, std::memory_order_relaxed);
+        task(*shard);
+    }, false);
+}
+
+void OrderStore::execute(uint64_t order_id, const ShardTask& task) {
+    size_t index = shardOf(order_id);
+    OrderShard* shard = shards_[index].get();
+    runOnShard(index, [shard, &task]() {
+        shard->tasks_.fetch_add(1, std::memory_order_relaxed);
+        task(*shard);
+    }, true);
+}
+
+void OrderStore::executeAll(const std::function<void(size_t shard_index, OrderShard&)>& task) {
+    std::vector<size_t> indexes(shards_.size());
+    for (size_t i = 0; i < indexes.size(); ++i) {
+        indexes[i] = i;
+    }
+    executeOn(indexes, task);
+}
+
+void OrderStore::executeBatch(const std::vector<uint64_t>& order_ids,
+                              const std::function<void(size_t index, OrderShard&)>& task) {
+    std::vector<std::vector<size_t>> groups(shards_.size());
+    for (size_t i = 0; i < order_ids.size(); ++i) {
+        groups[shardOf(order_ids[i])].push_back(i);
+    }
+
+    std::vector<size_t> targets;
+    for (size_t i = 0; i < groups.size(); ++i) {
+        if (!groups[i].empty()) {
+            targets.push_back(i);
+        }
+    }
+
+    executeOn(targets, [&](size_t shard_index, OrderShard& shard) {
+        for (size_t i : groups[shard_index]) {
+            task(i, shard);
+        }
+    });
+}
+
+std::vector<bool> OrderStore::insertBatch(const std::vector<const OrderInfo*>& orders,
+                                         const std::vector<std::string_view>& reservation_ids,
+                                         const std::function<bool(size_t index)>& admit) {
+    std::vector<uint64_t> order_ids;
+    order_ids.reserve(orders.size());
+    for (const OrderInfo* order : orders) {
+        order_ids.push_back(order->order_id);
+    }
+
+    // 每个分片只写自己那部分下标，不共享字节
+    std::vector<char> inserted(orders.size(), 0);
+    executeBatch(order_ids, [&](size_t i, OrderShard& shard) {
+        if (admit && (shard.find(orders[i]->order_id) || !admit(i))) {
+            return;
+        }
+        inserted[i] = shard.insert(*orders[i], reservation_ids[i]) ? 1 : 0;
+    });
+    return std::vector<bool>(inserted.begin(), inserted.end());
+}
+
+std::vector<OrderShardStats> OrderStore::stats() const {
+    std::vector<OrderShardStats> result;
+    result.reserve(shards_.size());
+    for (const auto& shard : shards_) {
+        result.push_back(shard->stats());
+    }
+    return result;
+}
+
+void OrderStore::runOnShard(size_t index, const std::function<void()>& task, bool wait) {
+    network::Reactor* reactor = shards_[index]->reactor_.get();
+    if (!isRunning() || reactor->isInLoopThread()) {
+        task();
+        return;
+    }
+    if (!wait) {
+        reactor->queueInLoop(task);
+        return;
+    }
+
+    std::latch done(1);
+    reactor->queueInLoop([&task, &done]() {
+        task();
+        done.count_down();
+    });
+    done.wait();
+}
+
+void OrderStore::executeOn(const std::vector<size_t>& indexes,
+                           const std::function<void(size_t shard_index, OrderShard&)>& task) {
+    std::latch done(static_cast<std::ptrdiff_t>(indexes.size()));
+    size_t local = shards_.size();  // 调用方所在的分片，其余分片投递后在本线程执行
+    bool running = isRunning();
+    for (size_t index : indexes) {
+        OrderShard* shard = shards_[index].get();
+        if (!running) {
+            shard->tasks_.fetch_add(1, std::memory_order_relaxed);
+            task(index, *shard);
+            done.count_down();
+            continue;
+        }
+        if (shard->reactor_->isInLoopThread()) {
+            local = index;
+            continue;
+        }
+        shard->reactor_->queueInLoop([shard, index, &task, &done]() {
+            shard->tasks_.fetch_add(1, std::memory_order_relaxed);
+            task(index, *shard);
+            done.count_down();
+        });
+    }
+    if (local < shards_.size()) {
+        OrderShard* shard = shards_[local].get();
+        shard->tasks_.fetch_add(1, std::memory_order_relaxed);
+        task(local, *shard);
+        done.count_down();
+    }
+    done.wait();
+}
+
+} // namespace services
+} // namespace order_engine
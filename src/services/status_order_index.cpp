@@ -0,0 +1,119 @@
+#include "services/status_order_index.h"
+#include <algorithm>
+
+namespace order_engine {
+namespace services {
+
+void StatusOrderIndex::add(OrderStatus status, const UserOrderKey& key) {
+    size_t index = static_cast<size_t>(status);
+    if (index >= kOrderStatusCount) {
+        return;
+    }
+    StatusBuckets& entry = statuses_[index];
+    auto [bucket_it, inserted] = entry.buckets.try_emplace(bucketOf(key.created_at));
+    Bucket& bucket = bucket_it->second;
+    bucket_count_ += inserted ? 1 : 0;
+    size_t capacity = bucket.capacity();
+    if (bucket.empty() || bucket.back() < key) {
+        bucket.push_back(key);
+    } else {
+        // 乱序到达（快照加载、同一秒内的不同节点ID、回滚）
+        auto it = std::lower_bound(bucket.begin(), bucket.end(), key);
+        if (it != bucket.end() && *it == key) {
+            return;
+        }
+        bucket.insert(it, key);
+    }
+    ++entry.size;
+    key_capacity_ += bucket.capacity() - capacity;
+}
+
+bool StatusOrderIndex::remove(OrderStatus status, const UserOrderKey& key) {
+    size_t index = static_cast<size_t>(status);
+    if (index >= kOrderStatusCount) {
+        return false;
+    }
+    StatusBuckets& entry = statuses_[index];
+    auto bucket_it = entry.buckets.find(bucketOf(key.created_at));
+    if (bucket_it == entry.buckets.end()) {
+        return false;
+    }
+    Bucket& bucket = bucket_it->second;
+    auto it = std::lower_bound(bucket.begin(), bucket.end(), key);
+    if (it == bucket.end() || !(*it == key)) {
+        return false;
+    }
+    bucket.erase(it);
+    --entry.size;
+    if (bucket.empty()) {
+        key_capacity_ -= bucket.capacity();
+        entry.buckets.erase(bucket_it);
+        --bucket_count_;
+    }
+    return true;
+}
+
+const StatusOrderIndex::StatusBuckets* StatusOrderIndex::find(OrderStatus status) const {
+    size_t index = static_cast<size_t>(status);
+    return index < kOrderStatusCount ? &statuses_[index] : nullptr;
+}
+
+void StatusOrderIndex::range(OrderStatus status, uint32_t from, uint32_t to, const UserOrderKey* after,
+                             size_t limit, std::vector<UserOrderKey>& out) const {
+    const StatusBuckets* entry = find(status);
+    if (!entry || from >= to || limit == 0) {
+        return;
+    }
+    UserOrderKey lower{from, 0};
+    uint32_t start = after ? std::max(from, after->created_at) : from;
+    size_t taken = 0;
+    for (auto it = entry->buckets.lower_bound(bucketOf(start)); it != entry->buckets.end() && it->first < to;
+         ++it) {
+        const Bucket& bucket = it->second;
+        auto key = std::lower_bound(bucket.begin(), bucket.end(), lower);
+        if (after) {
+            key = std::max(key, std::upper_bound(bucket.begin(), bucket.end(), *after));
+        }
+        for (; key != bucket.end() && key->created_at < to; ++key) {
+            if (taken == limit) {
+                return;
+            }
+            out.push_back(*key);
+            ++taken;
+        }
+    }
+}
+
+size_t StatusOrderIndex::count(OrderStatus status, uint32_t from, uint32_t to) const {
+    const StatusBuckets* entry = find(status);
+    if (!entry || from >= to) {
+        return 0;
+    }
+    size_t total = 0;
+    for (auto it = entry->buckets.lower_bound(bucketOf(from)); it != entry->buckets.end() && it->first < to; ++it) {
+        const Bucket& bucket = it->second;
+        if (it->first >= from && static_cast<uint64_t>(it->first) + kBucketSeconds <= to) {
+            total += bucket.size();
+            continue;
+        }
+        // 区间两端的桶
+        auto first = std::lower_bound(bucket.begin(), bucket.end(), UserOrderKey{from, 0});
+        auto last = std::lower_bound(first, bucket.end(), UserOrderKey{to, 0});
+        total += static_cast<size_t>(last - first);
+    }
+    return total;
+}
+
+size_t StatusOrderIndex::count(OrderStatus status) const {
+    const StatusBuckets* entry = find(status);
+    return entry ? entry->size : 0;
+}
+
+size_t StatusOrderIndex::memoryBytes() const {
+    // 红黑树节点：三个指针、颜色、键和桶数组
+    constexpr size_t kNodeBytes = 4 * sizeof(void*) + sizeof(uint32_t) + sizeof(Bucket);
+    return bucket_count_ * kNodeBytes + key_capacity_ * sizeof(UserOrderKey);
+}
+
+} // namespace services
+} // namespace order_engine
@@ -0,0 +1,88 @@
+#include "services/user_order_index.h"
+#include <algorithm>
+#include <charconv>
+
+namespace order_engine {
+namespace services {
+
+std::string UserOrderKey::toCursor() const {
+    return std::to_string(created_at) + "-" + std::to_string(order_id);
+}
+
+bool UserOrderKey::fromCursor(std::string_view text, UserOrderKey& key) {
+    size_t dash = text.find('-');
+    if (dash == std::string_view::npos) {
+        return false;
+    }
+    const char* end = text.data() + dash;
+    auto result = std::from_chars(text.data(), end, key.created_at);
+    if (result.ec != std::errc() || result.ptr != end) {
+        return false;
+    }
+    end = text.data() + text.size();
+    result = std::from_chars(text.data() + dash + 1, end, key.order_id);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+void UserOrderIndex::add(uint64_t user_id, const UserOrderKey& key) {
+    std::vector<UserOrderKey>& keys = users_[user_id];
+    size_t capacity = keys.capacity();
+    if (keys.empty() || keys.back() < key) {
+        keys.push_back(key);
+    } else {
+        // 乱序到达（快照加载、同一秒内的不同节点ID）
+        auto it = std::lower_bound(keys.begin(), keys.end(), key);
+        if (it != keys.end() && *it == key) {
+            return;
+        }
+        keys.insert(it, key);
+    }
+    key_capacity_ += keys.capacity() - capacity;
+}
+
+bool UserOrderIndex::remove(uint64_t user_id, const UserOrderKey& key) {
+    auto user = users_.find(user_id);
+    if (user == users_.end()) {
+        return false;
+    }
+    std::vector<UserOrderKey>& keys = user->second;
+    auto it = std::lower_bound(keys.begin(), keys.end(), key);
+    if (it == keys.end() || !(*it == key)) {
+        return false;
+    }
+    keys.erase(it);
+    if (keys.empty()) {
+        key_capacity_ -= keys.capacity();
+        users_.erase(user);
+    }
+    return true;
+}
+
+void UserOrderIndex::before(uint64_t user_id, const UserOrderKey* cursor, size_t limit,
+                            std::vector<UserOrderKey>& out) const {
+    auto user = users_.find(user_id);
+    if (user == users_.end()) {
+        return;
+    }
+    const std::vector<UserOrderKey>& keys = user->second;
+    auto end = cursor ? std::lower_bound(keys.begin(), keys.end(), *cursor) : keys.end();
+    size_t available = static_cast<size_t>(end - keys.begin());
+    for (size_t i = 0; i < std::min(limit, available); ++i) {
+        out.push_back(*--end);
+    }
+}
+
+size_t UserOrderIndex::count(uint64_t user_id) const {
+    auto user = users_.find(user_id);
+    return user == users_.end() ? 0 : user->second.size();
+}
+
+size_t UserOrderIndex::memoryBytes() const {
+    constexpr size_t kNodeBytes = sizeof(void*) + sizeof(size_t) + sizeof(uint64_t) +
+                                  sizeof(std::vector<UserOrderKey>);
+    return users_.size() * kNodeBytes + users_.bucket_count() * sizeof(void*) +
+           key_capacity_ * sizeof(UserOrderKey);
+}
+
+} // namespace services
+} // namespace order_engine
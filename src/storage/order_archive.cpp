@@ -0,0 +1,719 @@
+#include "storage/order_archive.h"
+#include "common/logger.h"
+#include "utils/file_utils.h"
+#include "utils/hash_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <string_view>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace order_engine {
+namespace storage {
+
+namespace {
+
+constexpr char kArchiveMagic[8] = {'O', 'E', 'A', 'R', 'C', 'H', '0', '1'};
+
+// 列顺序即列目录顺序；kPaymentDict之前的列按块编码
+enum Column : uint32_t {
+    kOrderIdColumn = 0,
+    kUserIdColumn,
+    kCreatedAtColumn,
+    kUpdatedAtColumn,
+    kStatusColumn,
+    kTotalColumn,
+    kPaymentColumn,
+    kAddressColumn,
+    kItemsColumn,
+    kPaymentDict,
+    kAddressDict,
+    kColumnCount
+};
+constexpr uint32_t kBlockColumnCount = kPaymentDict;
+
+struct Zone {
+    uint32_t min_created;
+    uint32_t max_created;
+    uint64_t min_user;
+    uint64_t max_user;
+
+    void add(uint64_t user_id, uint32_t created_at) {
+        min_created = std::min(min_created, created_at);
+        max_created = std::max(max_created, created_at);
+        min_user = std::min(min_user, user_id);
+        max_user = std::max(max_user, user_id);
+    }
+};
+
+constexpr Zone kEmptyZone{UINT32_MAX, 0, UINT64_MAX, 0};
+
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void putAt(char* out, T value) {
+    std::memcpy(out, &value, sizeof(T));
+}
+
+template <typename T>
+T getAt(const char* in) {
+    T value;
+    std::memcpy(&value, in, sizeof(T));
+    return value;
+}
+
+void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/**
+ * @brief 顺序读取块内的变长整数，越界时ok()为false
+ */
+class VarintReader {
+public:
+    explicit VarintReader(std::string_view data) : p_(data.data()), end_(data.data() + data.size()), ok_(true) {}
+
+    uint64_t next() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64 && p_ < end_; shift += 7) {
+            uint8_t byte = static_cast<uint8_t>(*p_++);
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        ok_ = false;
+        return 0;
+    }
+    int64_t nextSigned() { return unzigzag(next()); }
+    bool ok() const { return ok_; }
+
+private:
+    const char* p_;
+    const char* end_;
+    bool ok_;
+};
+
+/**
+ * @brief 按块编码的列：| 块偏移表 block_count × u32 | 块数据 |
+ */
+struct ColumnBuilder {
+    std::string offsets;
+    std::string data;
+
+    void startBlock() { put<uint32_t>(offsets, static_cast<uint32_t>(data.size())); }
+    size_t size() const { return offsets.size() + data.size(); }
+};
+
+/**
+ * @brief 段内字典：| count(4) | (count + 1) × 偏移(4) | 字符串 |，按下标O(1)取出
+ */
+class DictionaryBuilder {
+public:
+    // 返回字符串的下标；string_view须在finish()之前有效
+    uint32_t add(std::string_view value) {
+        auto [it, inserted] = index_.try_emplace(value, static_cast<uint32_t>(values_.size()));
+        if (inserted) {
+            values_.push_back(value);
+        }
+        return it->second;
+    }
+
+    std::string finish() const {
+        std::string out;
+        put<uint32_t>(out, static_cast<uint32_t>(values_.size()));
+        uint32_t offset = 0;
+        for (std::string_view value : values_) {
+            put<uint32_t>(out, offset);
+            offset += static_cast<uint32_t>(value.size());
+        }
+        put<uint32_t>(out, offset);
+        for (std::string_view value : values_) {
+            out.append(value.data(), value.size());
+        }
+        return out;
+    }
+
+private:
+    std::unordered_map<std::string_view, uint32_t> index_;
+    std::vector<std::string_view> values_;
+};
+
+bool dictionaryEntry(std::string_view dict, uint64_t index, std::string_view& value) {
+    if (dict.size() < sizeof(uint32_t)) {
+        return false;
+    }
+    uint64_t count = getAt<uint32_t>(dict.data());
+    size_t table_end = sizeof(uint32_t) * (count + 2);
+    if (index >= count || dict.size() < table_end) {
+        return false;
+    }
+    const char* entry = dict.data() + sizeof(uint32_t) * (index + 1);
+    uint32_t begin = getAt<uint32_t>(entry);
+    uint32_t end = getAt<uint32_t>(entry + sizeof(uint32_t));
+    if (begin > end || end > dict.size() - table_end) {
+        return false;
+    }
+    value = dict.substr(table_end + begin, end - begin);
+    return true;
+}
+
+std::string segmentPath(const std::string& dir, uint64_t sequence) {
+    return (std::filesystem::path(dir) / OrderArchive::segmentName(sequence)).string();
+}
+
+// 段序号，不是段文件名时返回false
+bool parseSegmentName(const std::string& name, uint64_t& sequence) {
+    if (name.size() != 32 || name.compare(0, 8, "archive-") != 0 || name.compare(28, 4, ".seg") != 0 ||
+        name.find_first_not_of("0123456789", 8) != 28) {
+        return false;
+    }
+    sequence = std::stoull(name.substr(8, 20));
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief 一个已映射的段
+ */
+struct OrderArchive::Segment {
+    uint64_t sequence = 0;
+    std::string path;
+    utils::MappedFile file;
+    uint32_t block_rows = 0;
+    uint32_t block_count = 0;
+    uint64_t rows = 0;
+    Zone range = kEmptyZone;
+    std::vector<Zone> zones;
+    std::array<std::string_view, kColumnCount> columns;
+
+    bool open(const std::string& segment_path) {
+        path = segment_path;
+        if (!file.open(path) || file.size() < kHeaderSize ||
+            std::memcmp(file.data(), kArchiveMagic, sizeof(kArchiveMagic)) != 0) {
+            return false;
+        }
+        const char* base = file.data();
+        block_rows = getAt<uint32_t>(base + 12);
+        rows = getAt<uint64_t>(base + 16);
+        block_count = getAt<uint32_t>(base + 24);
+        uint32_t column_count = getAt<uint32_t>(base + 28);
+        size_t data_start = kHeaderSize + static_cast<size_t>(column_count) * kColumnEntrySize +
+                            static_cast<size_t>(block_count) * kZoneEntrySize;
+        if (column_count != kColumnCount || block_rows == 0 || file.size() < data_start ||
+            utils::crc32c(base + 12, data_start - 12) != getAt<uint32_t>(base + 8) ||
+            rows > static_cast<uint64_t>(block_count) * block_rows ||
+            (block_count > 0 && rows <= static_cast<uint64_t>(block_count - 1) * block_rows)) {
+            return false;
+        }
+        range = Zone{getAt<uint32_t>(base + 32), getAt<uint32_t>(base + 36), getAt<uint64_t>(base + 40),
+                     getAt<uint64_t>(base + 48)};
+
+        for (uint32_t i = 0; i < kColumnCount; ++i) {
+            const char* entry = base + kHeaderSize + i * kColumnEntrySize;
+            uint64_t offset = getAt<uint64_t>(entry);
+            uint64_t size = getAt<uint64_t>(entry + 8);
+            if (offset < data_start || offset > file.size() || size > file.size() - offset ||
+                (i < kBlockColumnCount && size < sizeof(uint32_t) * static_cast<uint64_t>(block_count))) {
+                return false;
+            }
+            columns[i] = std::string_view(base + offset, size);
+        }
+
+        zones.resize(block_count);
+        const char* zone = base + kHeaderSize + kColumnCount * kColumnEntrySize;
+        for (uint32_t b = 0; b < block_count; ++b, zone += kZoneEntrySize) {
+            zones[b] = Zone{getAt<uint32_t>(zone), getAt<uint32_t>(zone + 4), getAt<uint64_t>(zone + 8),
+                            getAt<uint64_t>(zone + 16)};
+        }
+        // 查询只读少数块，关闭预读
+        file.advise(MADV_RANDOM);
+        return true;
+    }
+
+    size_t blockRows(uint32_t block) const {
+        uint64_t first = static_cast<uint64_t>(block) * block_rows;
+        return static_cast<size_t>(std::min<uint64_t>(block_rows, rows - first));
+    }
+
+    // 某列某块的数据，偏移越界时返回false
+    bool block(uint32_t column, uint32_t index, std::string_view& data) const {
+        std::string_view col = columns[column];
+        size_t table = sizeof(uint32_t) * block_count;
+        std::string_view body = col.substr(table);
+        uint32_t begin = getAt<uint32_t>(col.data() + sizeof(uint32_t) * index);
+        uint32_t end = index + 1 < block_count ? getAt<uint32_t>(col.data() + sizeof(uint32_t) * (index + 1))
+                                               : static_cast<uint32_t>(body.size());
+        if (begin > end || end > body.size()) {
+            return false;
+        }
+        data = body.substr(begin, end - begin);
+        return true;
+    }
+
+    // 差值编码的列：order_id/created_at为zigzag差值，user_id为非负差值
+    bool decodeDeltas(uint32_t column, uint32_t index, std::vector<uint64_t>& out) const {
+        std::string_view data;
+        if (!block(column, index, data)) {
+            return false;
+        }
+        size_t n = blockRows(index);
+        out.resize(n);
+        VarintReader reader(data);
+        uint64_t value = 0;
+        for (size_t i = 0; i < n; ++i) {
+            value += column == kUserIdColumn ? reader.next() : static_cast<uint64_t>(reader.nextSigned());
+            out[i] = value;
+        }
+        return reader.ok();
+    }
+
+    bool decodeVarints(uint32_t column, uint32_t index, std::vector<uint64_t>& out) const {
+        std::string_view data;
+        if (!block(column, index, data)) {
+            return false;
+        }
+        size_t n = blockRows(index);
+        out.resize(n);
+        VarintReader reader(data);
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = reader.next();
+        }
+        return reader.ok();
+    }
+
+    bool decodeStatuses(uint32_t index, std::string_view& statuses) const {
+        return block(kStatusColumn, index, statuses) && statuses.size() == blockRows(index);
+    }
+};
+
+OrderArchive::OrderArchive(ArchiveOptions options)
+    : options_(std::move(options))
+    , next_sequence_(1) {
+    options_.block_rows = std::max<uint32_t>(options_.block_rows, 1);
+}
+
+OrderArchive::~OrderArchive() = default;
+
+std::string OrderArchive::segmentName(uint64_t sequence) {
+    char name[40];
+    std::snprintf(name, sizeof(name), "archive-%020llu.seg", static_cast<unsigned long long>(sequence));
+    return name;
+}
+
+bool OrderArchive::open() {
+    std::error_code ec;
+    std::filesystem::create_directories(options_.dir, ec);
+    if (ec) {
+        LOG_ERROR_FMT("Failed to create archive directory: {}", options_.dir);
+        return false;
+    }
+
+    std::vector<std::pair<uint64_t, std::string>> paths;
+    for (const auto& entry : std::filesystem::directory_iterator(options_.dir, ec)) {
+        std::string name = entry.path().filename().string();
+        uint64_t sequence = 0;
+        if (parseSegmentName(name, sequence)) {
+            paths.emplace_back(sequence, entry.path().string());
+        } else if (name.size() > 8 && name.compare(name.size() - 8, 8, ".seg.tmp") == 0) {
+            // 上次写入未完成
+            std::filesystem::remove(entry.path(), ec);
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+
+    std::vector<std::shared_ptr<const Segment>> segments;
+    uint64_t next_sequence = 1;
+    for (const auto& [sequence, path] : paths) {
+        next_sequence = std::max(next_sequence, sequence + 1);
+        auto segment = std::make_shared<Segment>();
+        segment->sequence = sequence;
+        if (!segment->open(path)) {
+            LOG_ERROR_FMT("Skipping invalid archive segment: {}", path);
+            continue;
+        }
+        segments.push_back(std::move(segment));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    segments_ = std::move(segments);
+    next_sequence_ = std::max(next_sequence_, next_sequence);
+    return true;
+}
+
+bool OrderArchive::write(const std::vector<services::OrderInfo>& orders, std::string* path) {
+    if (orders.empty()) {
+        return true;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(options_.dir, ec);
+
+    // 1. 按(user_id, created_at, order_id)排序：同一用户的订单相邻，user_id差值多为0
+    std::vector<const services::OrderInfo*> rows;
+    rows.reserve(orders.size());
+    for (const auto& order : orders) {
+        rows.push_back(&order);
+    }
+    std::sort(rows.begin(), rows.end(), [](const services::OrderInfo* a, const services::OrderInfo* b) {
+        if (a->user_id != b->user_id) {
+            return a->user_id < b->user_id;
+        }
+        return a->created_at != b->created_at ? a->created_at < b->created_at : a->order_id < b->order_id;
+    });
+
+    // 2. 逐块编码各列，块首行的差值相对0，块之间互不依赖
+    uint32_t block_rows = options_.block_rows;
+    uint32_t block_count = static_cast<uint32_t>((rows.size() + block_rows - 1) / block_rows);
+    std::array<ColumnBuilder, kBlockColumnCount> columns;
+    DictionaryBuilder payment_methods;
+    DictionaryBuilder addresses;
+    std::vector<Zone> zones(block_count, kEmptyZone);
+    Zone range = kEmptyZone;
+    for (uint32_t b = 0; b < block_count; ++b) {
+        for (auto& column : columns) {
+            column.startBlock();
+        }
+        uint64_t prev_order_id = 0;
+        uint64_t prev_user_id = 0;
+        int64_t prev_created = 0;
+        size_t end = std::min(rows.size(), static_cast<size_t>(b + 1) * block_rows);
+        for (size_t i = static_cast<size_t>(b) * block_rows; i < end; ++i) {
+            const services::OrderInfo& order = *rows[i];
+            int64_t created = static_cast<uint32_t>(order.created_at);
+            int64_t updated = static_cast<uint32_t>(order.updated_at);
+            putVarint(columns[kOrderIdColumn].data, zigzag(static_cast<int64_t>(order.order_id - prev_order_id)));
+            putVarint(columns[kUserIdColumn].data, order.user_id - prev_user_id);
+            putVarint(columns[kCreatedAtColumn].data, zigzag(created - prev_created));
+            putVarint(columns[kUpdatedAtColumn].data, zigzag(updated - created));
+            columns[kStatusColumn].data.push_back(static_cast<char>(order.status));
+            putVarint(columns[kTotalColumn].data, zigzag(std::llround(order.total_amount * 100)));
+            putVarint(columns[kPaymentColumn].data, payment_methods.add(order.payment_method));
+            putVarint(columns[kAddressColumn].data, addresses.add(order.shipping_address));
+            size_t items = std::min(order.product_ids.size(), order.quantities.size());
+            std::string& item_data = columns[kItemsColumn].data;
+            putVarint(item_data, items);
+            for (size_t k = 0; k < items; ++k) {
+                putVarint(item_data, order.product_ids[k]);
+                putVarint(item_data, order.quantities[k]);
+            }
+            prev_order_id = order.order_id;
+            prev_user_id = order.user_id;
+            prev_created = created;
+            zones[b].add(order.user_id, static_cast<uint32_t>(created));
+        }
+        range.add(zones[b].min_user, zones[b].min_created);
+        range.add(zones[b].max_user, zones[b].max_created);
+    }
+    std::array<std::string, 2> dictionaries = {payment_methods.finish(), addresses.finish()};
+
+    // 3. 头部、列目录和区间映射
+    size_t data_start = kHeaderSize + kColumnCount * kColumnEntrySize + block_count * kZoneEntrySize;
+    std::string header(data_start, '\0');
+    uint64_t offset = data_start;
+    for (uint32_t i = 0; i < kColumnCount; ++i) {
+        uint64_t size = i < kBlockColumnCount ? columns[i].size() : dictionaries[i - kBlockColumnCount].size();
+        char* entry = header.data() + kHeaderSize + i * kColumnEntrySize;
+        putAt<uint64_t>(entry, offset);
+        putAt<uint64_t>(entry + 8, size);
+        offset += size;
+    }
+    for (uint32_t b = 0; b < block_count; ++b) {
+        char* entry = header.data() + kHeaderSize + kColumnCount * kColumnEntrySize + b * kZoneEntrySize;
+        putAt<uint32_t>(entry, zones[b].min_created);
+        putAt<uint32_t>(entry + 4, zones[b].max_created);
+        putAt<uint64_t>(entry + 8, zones[b].min_user);
+        putAt<uint64_t>(entry + 16, zones[b].max_user);
+    }
+    std::memcpy(header.data(), kArchiveMagic, sizeof(kArchiveMagic));
+    putAt<uint32_t>(header.data() + 12, block_rows);
+    putAt<uint64_t>(header.data() + 16, static_cast<uint64_t>(rows.size()));
+    putAt<uint32_t>(header.data() + 24, block_count);
+    putAt<uint32_t>(header.data() + 28, static_cast<uint32_t>(kColumnCount));
+    putAt<uint32_t>(header.data() + 32, range.min_created);
+    putAt<uint32_t>(header.data() + 36, range.max_created);
+    putAt<uint64_t>(header.data() + 40, range.min_user);
+    putAt<uint64_t>(header.data() + 48, range.max_user);
+    putAt<uint64_t>(header.data() + 56, static_cast<uint64_t>(time(nullptr)));
+    putAt<uint32_t>(header.data() + 8, utils::crc32c(header.data() + 12, header.size() - 12));
+
+    // 4. 写临时文件，落盘后改名
+    uint64_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sequence = next_sequence_++;
+    }
+    std::string segment_path = segmentPath(options_.dir, sequence);
+    std::string tmp_path = segment_path + ".tmp";
+    int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        LOG_ERROR_FMT("Failed to create archive segment: {}", tmp_path);
+        return false;
+    }
+    off_t position = 0;
+    auto append = [&fd, &position](const std::string& data) {
+        bool ok = utils::writeFully(fd, data.data(), data.size(), position);
+        position += static_cast<off_t>(data.size());
+        return ok;
+    };
+    bool ok = append(header);
+    for (uint32_t i = 0; ok && i < kBlockColumnCount; ++i) {
+        ok = append(columns[i].offsets) && append(columns[i].data);
+    }
+    for (size_t i = 0; ok && i < dictionaries.size(); ++i) {
+        ok = append(dictionaries[i]);
+    }
+    ok = ok && ::fsync(fd) == 0;
+    ::close(fd);
+    ok = ok && std::rename(tmp_path.c_str(), segment_path.c_str()) == 0 && utils::syncDirectory(options_.dir);
+    if (!ok) {
+        LOG_ERROR_FMT("Failed to write archive segment: {}", segment_path);
+        std::filesystem::remove(tmp_path, ec);
+        return false;
+    }
+
+    // 5. 映射新段，之后的查询可见
+    auto segment = std::make_shared<Segment>();
+    segment->sequence = sequence;
+    if (!segment->open(segment_path)) {
+        LOG_ERROR_FMT("Failed to map archive segment: {}", segment_path);
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        segments_.push_back(std::move(segment));
+        std::sort(segments_.begin(), segments_.end(),
+                  [](const auto& a, const auto& b) { return a->sequence < b->sequence; });
+    }
+    if (path) {
+        *path = segment_path;
+    }
+    return true;
+}
+
+std::vector<std::shared_ptr<const OrderArchive::Segment>> OrderArchive::segmentList() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return segments_;
+}
+
+std::vector<services::OrderInfo> OrderArchive::userHistory(uint64_t user_id, const services::UserOrderKey* cursor,
+                                                           size_t limit) const {
+    struct Candidate {
+        services::UserOrderKey key;
+        size_t segment;
+        uint32_t block;
+        uint32_t row;
+    };
+    std::vector<services::OrderInfo> result;
+    if (limit == 0) {
+        return result;
+    }
+    auto segments = segmentList();
+
+    // 1. 只解码user_id/created_at/order_id三列中可能包含该用户的块；从最新的段开始，
+    //    同一订单（归档中途崩溃后重复归档）保留最先遇到的
+    std::vector<Candidate> candidates;
+    std::vector<uint64_t> user_ids;
+    std::vector<uint64_t> created;
+    std::vector<uint64_t> order_ids;
+    for (size_t s = segments.size(); s-- > 0;) {
+        const Segment& segment = *segments[s];
+        if (segment.rows == 0 || user_id < segment.range.min_user || user_id > segment.range.max_user) {
+            continue;
+        }
+        for (uint32_t b = 0; b < segment.block_count; ++b) {
+            const Zone& zone = segment.zones[b];
+            if (user_id < zone.min_user || user_id > zone.max_user) {
+                continue;
+            }
+            if (!segment.decodeDeltas(kUserIdColumn, b, user_ids) ||
+                !segment.decodeDeltas(kCreatedAtColumn, b, created) ||
+                !segment.decodeDeltas(kOrderIdColumn, b, order_ids)) {
+                LOG_ERROR_FMT("Corrupted archive segment: {}", segment.path);
+                break;
+            }
+            auto first = std::lower_bound(user_ids.begin(), user_ids.end(), user_id);
+            for (auto it = first; it != user_ids.end() && *it == user_id; ++it) {
+                uint32_t row = static_cast<uint32_t>(it - user_ids.begin());
+                services::UserOrderKey key{static_cast<uint32_t>(created[row]), order_ids[row]};
+                if (!cursor || key < *cursor) {
+                    candidates.push_back(Candidate{key, s, b, row});
+                }
+            }
+        }
+    }
+    auto newer = [](const Candidate& a, const Candidate& b) { return b.key < a.key; };
+    std::stable_sort(candidates.begin(), candidates.end(), newer);
+    candidates.erase(std::unique(candidates.begin(), candidates.end(),
+                                 [](const Candidate& a, const Candidate& b) { return a.key == b.key; }),
+                     candidates.end());
+    if (candidates.size() > limit) {
+        candidates.resize(limit);
+    }
+
+    // 2. 按块取选中订单的其余列，每块只解码一次
+    result.resize(candidates.size());
+    std::vector<size_t> order(candidates.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&candidates](size_t a, size_t b) {
+        const Candidate& x = candidates[a];
+        const Candidate& y = candidates[b];
+        return x.segment != y.segment ? x.segment < y.segment : x.block < y.block;
+    });
+    std::vector<uint64_t> updated;
+    std::vector<uint64_t> totals;
+    std::vector<uint64_t> payments;
+    std::vector<uint64_t> address_ids;
+    std::vector<size_t> item_begin;
+    std::vector<std::pair<uint64_t, uint32_t>> items;
+    std::string_view statuses;
+    bool ok = true;
+    for (size_t i = 0; i < order.size(); ++i) {
+        const Candidate& candidate = candidates[order[i]];
+        const Segment& segment = *segments[candidate.segment];
+        if (i == 0 || candidate.segment != candidates[order[i - 1]].segment ||
+            candidate.block != candidates[order[i - 1]].block) {
+            uint32_t b = candidate.block;
+            ok = segment.decodeDeltas(kUserIdColumn, b, user_ids) &&
+                 segment.decodeVarints(kUpdatedAtColumn, b, updated) &&
+                 segment.decodeStatuses(b, statuses) &&
+                 segment.decodeVarints(kTotalColumn, b, totals) &&
+                 segment.decodeVarints(kPaymentColumn, b, payments) &&
+                 segment.decodeVarints(kAddressColumn, b, address_ids);
+            std::string_view item_data;
+            ok = ok && segment.block(kItemsColumn, b, item_data);
+            if (ok) {
+                VarintReader reader(item_data);
+                size_t n = segment.blockRows(b);
+                item_begin.assign(1, 0);
+                items.clear();
+                for (size_t row = 0; row < n && reader.ok(); ++row) {
+                    uint64_t count = reader.next();
+                    for (uint64_t k = 0; k < count && reader.ok(); ++k) {
+                        uint64_t product_id = reader.next();
+                        items.emplace_back(product_id, static_cast<uint32_t>(reader.next()));
+                    }
+                    item_begin.push_back(items.size());
+                }
+                ok = reader.ok() && item_begin.size() == n + 1;
+            }
+        }
+        std::string_view payment_method;
+        std::string_view address;
+        ok = ok && dictionaryEntry(segment.columns[kPaymentDict], payments[candidate.row], payment_method) &&
+             dictionaryEntry(segment.columns[kAddressDict], address_ids[candidate.row], address);
+        if (!ok) {
+            LOG_ERROR_FMT("Corrupted archive segment: {}", segment.path);
+            result.clear();
+            return result;
+        }
+
+        services::OrderInfo& info = result[order[i]];
+        uint32_t row = candidate.row;
+        info.order_id = candidate.key.order_id;
+        info.user_id = user_ids[row];
+        info.created_at = static_cast<time_t>(candidate.key.created_at);
+        info.updated_at = static_cast<time_t>(static_cast<int64_t>(candidate.key.created_at) +
+                                              unzigzag(updated[row]));
+        info.status = static_cast<services::OrderStatus>(static_cast<uint8_t>(statuses[row]));
+        info.total_amount = static_cast<double>(unzigzag(totals[row])) / 100.0;
+        info.payment_method.assign(payment_method);
+        info.shipping_address.assign(address);
+        for (size_t k = item_begin[row]; k < item_begin[row + 1]; ++k) {
+            info.product_ids.push_back(items[k].first);
+            info.quantities.push_back(items[k].second);
+        }
+    }
+    return result;
+}
+
+ArchiveAggregate OrderArchive::aggregate(time_t from, time_t to) const {
+    ArchiveAggregate result;
+    std::array<int64_t, services::kOrderStatusCount> cents{};
+    std::vector<uint64_t> created;
+    std::vector<uint64_t> totals;
+    std::string_view statuses;
+    int64_t begin = static_cast<int64_t>(from);
+    int64_t end = static_cast<int64_t>(to);
+    auto outside = [begin, end](const Zone& zone) {
+        return static_cast<int64_t>(zone.max_created) < begin || static_cast<int64_t>(zone.min_created) >= end;
+    };
+
+    for (const auto& segment_ptr : segmentList()) {
+        const Segment& segment = *segment_ptr;
+        if (segment.rows == 0 || outside(segment.range)) {
+            result.skipped_blocks += segment.block_count;
+            continue;
+        }
+        for (uint32_t b = 0; b < segment.block_count; ++b) {
+            const Zone& zone = segment.zones[b];
+            if (outside(zone)) {
+                ++result.skipped_blocks;
+                continue;
+            }
+            // 整块在范围内时不需要逐行比较created_at
+            bool contained = static_cast<int64_t>(zone.min_created) >= begin &&
+                             static_cast<int64_t>(zone.max_created) < end;
+            if ((!contained && !segment.decodeDeltas(kCreatedAtColumn, b, created)) ||
+                !segment.decodeStatuses(b, statuses) || !segment.decodeVarints(kTotalColumn, b, totals)) {
+                LOG_ERROR_FMT("Corrupted archive segment: {}", segment.path);
+                break;
+            }
+            ++result.scanned_blocks;
+            for (size_t row = 0; row < totals.size(); ++row) {
+                if (!contained && (static_cast<int64_t>(created[row]) < begin ||
+                                   static_cast<int64_t>(created[row]) >= end)) {
+                    continue;
+                }
+                size_t status = static_cast<uint8_t>(statuses[row]);
+                if (status >= services::kOrderStatusCount) {
+                    continue;
+                }
+                ++result.status_orders[status];
+                cents[status] += unzigzag(totals[row]);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < services::kOrderStatusCount; ++i) {
+        result.status_revenue[i] = static_cast<double>(cents[i]) / 100.0;
+        result.orders += result.status_orders[i];
+        result.revenue += result.status_revenue[i];
+    }
+    return result;
+}
+
+ArchiveStats OrderArchive::stats() const {
+    ArchiveStats stats{0, 0, 0};
+    for (const auto& segment : segmentList()) {
+        ++stats.segments;
+        stats.orders += segment->rows;
+        stats.bytes += segment->file.size();
+    }
+    return stats;
+}
+
+} // namespace storage
+} // namespace order_engine
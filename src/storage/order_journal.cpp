@@ -0,0 +1,716 @@
+#include "storage/order_journal.h"
+#include "common/logger.h"
+#include "utils/file_utils.h"
+#include "utils/hash_utils.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <unistd.h>
+
+namespace order_engine {
+namespace storage {
+
+namespace {
+
+constexpr char kSegmentMagic[8] = {'O', 'E', 'W', 'A', 'L', '0', '0', '1'};
+constexpr size_t kZeroFillChunk = 1024 * 1024;
+// 写盘失败时记录最后一个已提交的LSN，之后的记录可能部分写入了磁盘但从未应答
+constexpr char kFailedMarker[] = "journal.failed";
+
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void putAt(char* out, T value) {
+    std::memcpy(out, &value, sizeof(T));
+}
+
+template <typename T>
+T getAt(const char* in) {
+    T value;
+    std::memcpy(&value, in, sizeof(T));
+    return value;
+}
+
+/**
+ * @brief 带边界检查的顺序读取
+ */
+class Reader {
+public:
+    explicit Reader(std::string_view data) : data_(data), pos_(0), ok_(true) {}
+
+    template <typename T>
+    T get() {
+        if (!ok_ || data_.size() - pos_ < sizeof(T)) {
+            ok_ = false;
+            return T();
+        }
+        T value = getAt<T>(data_.data() + pos_);
+        pos_ += sizeof(T);
+        return value;
+    }
+
+    std::string_view bytes(size_t len) {
+        if (!ok_ || data_.size() - pos_ < len) {
+            ok_ = false;
+            return std::string_view();
+        }
+        std::string_view value = data_.substr(pos_, len);
+        pos_ += len;
+        return value;
+    }
+
+    bool ok() const { return ok_; }
+
+private:
+    std::string_view data_;
+    size_t pos_;
+    bool ok_;
+};
+
+std::string segmentPath(const std::string& dir, uint64_t first_lsn, const char* suffix = "wal") {
+    char name[48];
+    std::snprintf(name, sizeof(name), "journal-%020llu.%s", static_cast<unsigned long long>(first_lsn), suffix);
+    return (std::filesystem::path(dir) / name).string();
+}
+
+// 后台预先写零的备用段，切换段时只需写段头并改名
+std::string spareSegmentPath(const std::string& dir) {
+    return (std::filesystem::path(dir) / "journal-spare.tmp").string();
+}
+
+// 写零预分配：之后的追加都是覆盖写，fdatasync不涉及块分配和文件大小变化
+bool zeroFill(int fd, size_t size) {
+    std::string zeros(std::min(kZeroFillChunk, size), '\0');
+    for (size_t offset = 0; offset < size; offset += zeros.size()) {
+        size_t len = std::min(zeros.size(), size - offset);
+        if (!utils::writeFully(fd, zeros.data(), len, static_cast<off_t>(offset))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string failedMarkerPath(const std::string& dir) {
+    return (std::filesystem::path(dir) / kFailedMarker).string();
+}
+
+// 先写临时文件再改名，崩溃时不会留下残缺的标记
+bool writeFailedMarker(const std::string& dir, uint64_t committed_lsn) {
+    std::string path = failedMarkerPath(dir);
+    std::string temp_path = path + ".tmp";
+    int fd = ::open(temp_path.c_str(), O_CREAT | O_WRONLY | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    char data[sizeof(uint64_t)];
+    putAt<uint64_t>(data, committed_lsn);
+    bool ok = utils::writeFully(fd, data, sizeof(data), 0) && ::fsync(fd) == 0;
+    ::close(fd);
+    return ok && ::rename(temp_path.c_str(), path.c_str()) == 0 && utils::syncDirectory(dir);
+}
+
+bool readFailedMarker(const std::string& dir, uint64_t& committed_lsn) {
+    std::string content;
+    if (!utils::readFile(failedMarkerPath(dir), content) || content.size() != sizeof(uint64_t)) {
+        return false;
+    }
+    committed_lsn = getAt<uint64_t>(content.data());
+    return true;
+}
+
+/**
+ * @brief 扫描一个段文件
+ *
+ * 从段头开始逐条校验，遇到残缺/校验失败/LSN不连续或超过max_lsn的记录停止。
+ * 返回false表示段头无效
+ */
+bool scanSegment(const std::string& content, uint64_t first_lsn, size_t& end_offset, uint64_t& last_lsn,
+                 const OrderJournal::ReplayCallback* callback, uint64_t from_lsn,
+                 uint64_t max_lsn = UINT64_MAX) {
+    if (content.size() < OrderJournal::kSegmentHeaderSize ||
+        std::memcmp(content.data(), kSegmentMagic, sizeof(kSegmentMagic)) != 0 ||
+        getAt<uint64_t>(content.data() + 8) != first_lsn) {
+        return false;
+    }
+
+    size_t offset = OrderJournal::kSegmentHeaderSize;
+    uint64_t expected = first_lsn;
+    while (content.size() - offset >= OrderJournal::kRecordHeaderSize) {
+        const char* header = content.data() + offset;
+        uint32_t crc = getAt<uint32_t>(header);
+        uint32_t length = getAt<uint32_t>(header + 4);
+        uint64_t lsn = getAt<uint64_t>(header + 8);
+        if (lsn != expected || lsn > max_lsn ||
+            length > content.size() - offset - OrderJournal::kRecordHeaderSize) {
+            break;
+        }
+        if (utils::crc32c(header + 4, OrderJournal::kRecordHeaderSize - 4 + length) != crc) {
+            break;
+        }
+        if (callback && lsn >= from_lsn) {
+            JournalRecord record{lsn, static_cast<JournalRecordType>(header[16]),
+                                 std::string_view(header + OrderJournal::kRecordHeaderSize, length)};
+            (*callback)(record);
+        }
+        offset += OrderJournal::kRecordHeaderSize + length;
+        ++expected;
+    }
+
+    end_offset = offset;
+    last_lsn = expected - 1;
+    return true;
+}
+
+} // namespace
+
+OrderJournal::OrderJournal(JournalOptions options)
+    : options_(std::move(options))
+    , pending_bytes_(0)
+    , segment_offset_(0)
+    , next_lsn_(1)
+    , failed_(false)
+    , committed_lsn_(0)
+    , fd_(-1)
+    , file_offset_(0)
+    , running_(false)
+    , spare_ready_(false)
+    , spare_wanted_(false)
+    , commit_count_(0)
+    , committed_records_(0)
+    , committed_bytes_(0) {
+}
+
+OrderJournal::~OrderJournal() {
+    close();
+}
+
+bool OrderJournal::open() {
+    if (running_.load()) {
+        return true;
+    }
+    if (!recover()) {
+        return false;
+    }
+
+    running_.store(true, std::memory_order_release);
+    flush_thread_ = std::thread([this]() { flushLoop(); });
+    {
+        std::lock_guard<std::mutex> lock(spare_mutex_);
+        spare_wanted_ = true;
+    }
+    spare_thread_ = std::thread([this]() { spareLoop(); });
+
+    LOG_INFO_FMT("OrderJournal opened: {}", options_.dir);
+    LOG_INFO_FMT("OrderJournal next LSN: {}", std::to_string(next_lsn_.load()));
+    return true;
+}
+
+void OrderJournal::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_.exchange(false)) {
+            return;
+        }
+    }
+    flush_cv_.notify_one();
+    if (flush_thread_.joinable()) {
+        flush_thread_.join();
+    }
+    commit_cv_.notify_all();
+    {
+        // 持锁一次再通知：备用段线程不会在检查running_之后、开始等待之前错过通知
+        std::lock_guard<std::mutex> lock(spare_mutex_);
+    }
+    spare_cv_.notify_one();
+    if (spare_thread_.joinable()) {
+        spare_thread_.join();
+    }
+    spare_ready_ = false;
+
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    LOG_INFO("OrderJournal closed");
+}
+
+uint64_t OrderJournal::append(JournalRecordType type, std::string_view payload, CommitCallback callback) {
+    size_t record_size = kRecordHeaderSize + payload.size();
+    if (record_size + kSegmentHeaderSize > options_.segment_size || payload.size() > UINT32_MAX) {
+        return 0;
+    }
+
+    uint64_t lsn;
+    bool notify;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_.load(std::memory_order_relaxed) || failed_.load(std::memory_order_relaxed)) {
+            return 0;
+        }
+
+        // 在锁内分配LSN，批次中的记录与LSN顺序一致
+        lsn = next_lsn_.fetch_add(1, std::memory_order_acq_rel);
+        bool roll = segment_offset_ + record_size > options_.segment_size;
+        if (roll) {
+            segment_offset_ = kSegmentHeaderSize;
+        }
+        if (roll || pending_.empty()) {
+            pending_.push_back(Chunk{roll, lsn, std::string()});
+        }
+
+        std::string& out = pending_.back().data;
+        size_t start = out.size();
+        out.resize(start + kRecordHeaderSize);
+        char* header = out.data() + start;
+        putAt<uint32_t>(header + 4, static_cast<uint32_t>(payload.size()));
+        putAt<uint64_t>(header + 8, lsn);
+        header[16] = static_cast<char>(type);
+        std::memset(header + 17, 0, 7);
+        out.append(payload.data(), payload.size());
+        header = out.data() + start;
+        putAt<uint32_t>(header, utils::crc32c(header + 4, kRecordHeaderSize - 4 + payload.size()));
+
+        segment_offset_ += record_size;
+        pending_bytes_ += record_size;
+        if (callback) {
+            pending_callbacks_.emplace_back(lsn, std::move(callback));
+        }
+        notify = pending_bytes_ == record_size || pending_bytes_ >= options_.max_batch_bytes;
+    }
+
+    if (notify) {
+        flush_cv_.notify_one();
+    }
+    return lsn;
+}
+
+bool OrderJournal::waitForCommit(uint64_t lsn) {
+    if (lsn == 0) {
+        return false;
+    }
+    if (committed_lsn_.load(std::memory_order_acquire) >= lsn) {
+        return true;
+    }
+    // 已分配的LSN一定会被刷盘线程提交或判定失败（close()也会先刷完剩余记录）
+    std::unique_lock<std::mutex> lock(commit_mutex_);
+    commit_cv_.wait(lock, [this, lsn]() {
+        return committed_lsn_.load(std::memory_order_acquire) >= lsn || failed_.load(std::memory_order_acquire);
+    });
+    return committed_lsn_.load(std::memory_order_acquire) >= lsn;
+}
+
+uint64_t OrderJournal::appendOrderCreated(const services::OrderInfo& order, std::string_view reservation_id) {
+    static thread_local std::string payload;
+    payload.clear();
+    encodeOrderCreated(payload, order, reservation_id);
+    return append(JournalRecordType::kOrderCreated, payload);
+}
+
+uint64_t OrderJournal::appendStatusChanged(uint64_t order_id, services::OrderStatus status, time_t updated_at) {
+    std::string payload;
+    encodeStatusChanged(payload, order_id, status, updated_at);
+    return append(JournalRecordType::kStatusChanged, payload);
+}
+
+uint64_t OrderJournal::appendOrderArchived(uint64_t order_id) {
+    std::string payload;
+    put<uint64_t>(payload, order_id);
+    return append(JournalRecordType::kOrderArchived, payload);
+}
+
+uint64_t OrderJournal::appendOrderAborted(uint64_t order_id) {
+    std::string payload;
+    put<uint64_t>(payload, order_id);
+    return append(JournalRecordType::kOrderAborted, payload);
+}
+
+void OrderJournal::flushLoop() {
+    std::vector<Chunk> chunks;
+    std::vector<std::pair<uint64_t, CommitCallback>> callbacks;
+
+    while (true) {
+        uint64_t last_lsn;
+        size_t batch_bytes;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            flush_cv_.wait(lock, [this]() { return !pending_.empty() || !running_.load(); });
+            if (pending_.empty()) {
+                break;  // 已停止且没有剩余记录
+            }
+
+            // 组提交窗口：等更多记录并入本批，批次够大或停止时提前结束
+            if (options_.commit_interval_us > 0 && running_.load()) {
+                auto deadline = std::chrono::steady_clock::now() +
+                                std::chrono::microseconds(options_.commit_interval_us);
+                flush_cv_.wait_until(lock, deadline, [this]() {
+                    return pending_bytes_ >= options_.max_batch_bytes || !running_.load();
+                });
+            }
+
+            chunks.swap(pending_);
+            callbacks.swap(pending_callbacks_);
+            batch_bytes = pending_bytes_;
+            pending_bytes_ = 0;
+            last_lsn = next_lsn_.load(std::memory_order_acquire) - 1;
+        }
+
+        bool ok = !failed_.load() && writeChunks(chunks);
+        if (ok) {
+            uint64_t previous = committed_lsn_.load(std::memory_order_relaxed);
+            commit_count_.fetch_add(1, std::memory_order_relaxed);
+            committed_records_.fetch_add(last_lsn - previous, std::memory_order_relaxed);
+            committed_bytes_.fetch_add(batch_bytes, std::memory_order_relaxed);
+        } else if (!failed_.exchange(true)) {
+            LOG_ERROR_FMT("OrderJournal write failed: {}", std::string(std::strerror(errno)));
+            // 失败批次的记录可能已部分落盘，调用方已按失败回滚；下次打开时截断到这里
+            uint64_t committed = committed_lsn_.load(std::memory_order_relaxed);
+            if (!writeFailedMarker(options_.dir, committed)) {
+                LOG_ERROR_FMT("Failed to write journal failure marker, committed LSN {}", std::to_string(committed));
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(commit_mutex_);
+            if (ok) {
+                committed_lsn_.store(last_lsn, std::memory_order_release);
+            }
+        }
+        commit_cv_.notify_all();
+
+        for (auto& [lsn, callback] : callbacks) {
+            callback(ok);
+        }
+        chunks.clear();
+        callbacks.clear();
+    }
+}
+
+void OrderJournal::spareLoop() {
+    std::string path = spareSegmentPath(options_.dir);
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(spare_mutex_);
+            spare_cv_.wait(lock, [this]() { return spare_wanted_ || !running_.load(); });
+            if (!running_.load()) {
+                break;
+            }
+            spare_wanted_ = false;
+        }
+
+        int fd = ::open(path.c_str(), O_CREAT | O_RDWR | O_TRUNC | O_CLOEXEC, 0644);
+        bool ok = fd >= 0 && zeroFill(fd, options_.segment_size) && (!options_.sync || ::fdatasync(fd) == 0);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        if (!ok) {
+            // 切换段时退回到在刷盘线程内创建
+            LOG_WARN("Failed to preallocate spare journal segment: " + path);
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(spare_mutex_);
+        spare_ready_ = true;
+    }
+}
+
+bool OrderJournal::writeChunks(std::vector<Chunk>& chunks) {
+    for (Chunk& chunk : chunks) {
+        if (chunk.new_segment && !openSegment(chunk.first_lsn)) {
+            return false;
+        }
+        if (!utils::writeFully(fd_, chunk.data.data(), chunk.data.size(), static_cast<off_t>(file_offset_))) {
+            return false;
+        }
+        file_offset_ += chunk.data.size();
+    }
+    return !options_.sync || ::fdatasync(fd_) == 0;
+}
+
+bool OrderJournal::openSegment(uint64_t first_lsn) {
+    // 上一段的数据先落盘再切换
+    if (fd_ >= 0) {
+        if (options_.sync && ::fdatasync(fd_) != 0) {
+            return false;
+        }
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    // 先在临时文件中预分配并写好段头，落盘后再改名：崩溃时要么没有新段，
+    // 要么新段的段头完整，不会留下段头全零、回放无法通过的最后一段。
+    // 通常直接取后台线程已写零的备用段，刷盘线程只写段头，不在提交路径上写零
+    std::string path = segmentPath(options_.dir, first_lsn);
+    std::string temp_path;
+    {
+        std::lock_guard<std::mutex> lock(spare_mutex_);
+        if (spare_ready_) {
+            spare_ready_ = false;
+            temp_path = spareSegmentPath(options_.dir);
+        }
+    }
+    bool use_spare = !temp_path.empty();
+    if (!use_spare) {
+        temp_path = segmentPath(options_.dir, first_lsn, "tmp");
+    }
+    fd_ = ::open(temp_path.c_str(), use_spare ? O_RDWR | O_CLOEXEC : O_CREAT | O_RDWR | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        LOG_ERROR_FMT("Failed to create journal segment: {}", temp_path);
+        return false;
+    }
+    if (!use_spare) {
+        LOG_WARN("No spare journal segment ready, zero-filling inline");
+        if (!zeroFill(fd_, options_.segment_size)) {
+            return false;
+        }
+    }
+
+    char header[kSegmentHeaderSize];
+    std::memcpy(header, kSegmentMagic, sizeof(kSegmentMagic));
+    putAt<uint64_t>(header + 8, first_lsn);
+    if (!utils::writeFully(fd_, header, sizeof(header), 0)) {
+        return false;
+    }
+    if (options_.sync && ::fdatasync(fd_) != 0) {
+        return false;
+    }
+    if (::rename(temp_path.c_str(), path.c_str()) != 0) {
+        LOG_ERROR_FMT("Failed to rename journal segment: {}", path);
+        return false;
+    }
+    if (options_.sync && !utils::syncDirectory(options_.dir)) {
+        return false;
+    }
+
+    file_offset_ = kSegmentHeaderSize;
+    {
+        std::lock_guard<std::mutex> lock(spare_mutex_);
+        spare_wanted_ = true;
+    }
+    spare_cv_.notify_one();
+    LOG_INFO_FMT("Journal segment created: {}", path);
+    return true;
+}
+
+bool OrderJournal::recover() {
+    std::error_code ec;
+    std::filesystem::create_directories(options_.dir, ec);
+    if (ec) {
+        LOG_ERROR_FMT("Failed to create journal directory: {}", options_.dir);
+        return false;
+    }
+
+    // 创建段时崩溃留下的临时文件尚未改名，其中没有已提交的记录
+    for (const auto& entry : std::filesystem::directory_iterator(options_.dir, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.rfind("journal-", 0) == 0 && entry.path().extension() == ".tmp") {
+            std::filesystem::remove(entry.path(), ec);
+        }
+    }
+
+    // 上次写盘失败：丢弃最后一个已提交LSN之后的记录，它们从未应答
+    uint64_t max_lsn = UINT64_MAX;
+    bool truncate = readFailedMarker(options_.dir, max_lsn);
+    auto segments = listSegments(options_.dir);
+    while (truncate && !segments.empty() && segments.back().first > max_lsn) {
+        std::filesystem::remove(segments.back().second, ec);
+        segments.pop_back();
+    }
+
+    if (segments.empty()) {
+        // 第一条记录到达时创建段
+        next_lsn_ = truncate ? max_lsn + 1 : 1;
+        committed_lsn_ = truncate ? max_lsn : 0;
+        segment_offset_ = options_.segment_size;
+        return !truncate || clearFailedMarker();
+    }
+
+    // 只需定位最后一段的尾部
+    const auto& [first_lsn, path] = segments.back();
+    std::string content;
+    size_t end_offset = 0;
+    uint64_t last_lsn = 0;
+    if (!utils::readFile(path, content) ||
+        !scanSegment(content, first_lsn, end_offset, last_lsn, nullptr, 0, max_lsn)) {
+        LOG_ERROR_FMT("Corrupted journal segment: {}", path);
+        return false;
+    }
+
+    fd_ = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd_ < 0) {
+        return false;
+    }
+    if (truncate) {
+        // 清零到段尾：未提交的记录可能只写入了一部分，后续追加不能与残留数据拼接
+        std::string zeros(std::min(kZeroFillChunk, content.size() - end_offset), '\0');
+        for (size_t offset = end_offset; offset < content.size(); offset += zeros.size()) {
+            size_t len = std::min(zeros.size(), content.size() - offset);
+            if (!utils::writeFully(fd_, zeros.data(), len, static_cast<off_t>(offset))) {
+                return false;
+            }
+        }
+        if (::fdatasync(fd_) != 0 || !clearFailedMarker()) {
+            return false;
+        }
+        LOG_WARN("Journal truncated after failed write at LSN " + std::to_string(last_lsn));
+    }
+    file_offset_ = end_offset;
+    segment_offset_ = end_offset;
+    next_lsn_ = last_lsn + 1;
+    committed_lsn_ = last_lsn;
+    return true;
+}
+
+bool OrderJournal::clearFailedMarker() {
+    std::error_code ec;
+    std::filesystem::remove(failedMarkerPath(options_.dir), ec);
+    return !ec && utils::syncDirectory(options_.dir);
+}
+
+bool OrderJournal::replay(const std::string& dir, uint64_t from_lsn, const ReplayCallback& callback) {
+    // 日志未重新打开（未截断）时同样只回放到失败前最后一个已提交的LSN
+    uint64_t max_lsn = UINT64_MAX;
+    readFailedMarker(dir, max_lsn);
+    auto segments = listSegments(dir);
+    std::string content;
+    uint64_t expected = 0;
+    for (size_t i = 0; i < segments.size(); ++i) {
+        const auto& [first_lsn, path] = segments[i];
+        if (first_lsn > max_lsn) {
+            break;
+        }
+        // 整段都在from_lsn之前时跳过
+        if (i + 1 < segments.size() && segments[i + 1].first <= from_lsn) {
+            expected = segments[i + 1].first;
+            continue;
+        }
+        if (expected != 0 && first_lsn != expected) {
+            LOG_ERROR_FMT("Journal gap before segment: {}", path);
+            return false;
+        }
+
+        size_t end_offset = 0;
+        uint64_t last_lsn = 0;
+        if (!utils::readFile(path, content) ||
+            !scanSegment(content, first_lsn, end_offset, last_lsn, &callback, from_lsn, max_lsn)) {
+            LOG_ERROR_FMT("Corrupted journal segment: {}", path);
+            return false;
+        }
+        expected = last_lsn + 1;
+    }
+    return true;
+}
+
+std::vector<std::pair<uint64_t, std::string>> OrderJournal::listSegments(const std::string& dir) {
+    std::vector<std::pair<uint64_t, std::string>> segments;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        std::string name = entry.path().filename().string();
+        unsigned long long first_lsn = 0;
+        char suffix[8] = {0};
+        if (std::sscanf(name.c_str(), "journal-%20llu.%3s", &first_lsn, suffix) == 2 &&
+            std::strcmp(suffix, "wal") == 0) {
+            segments.emplace_back(first_lsn, entry.path().string());
+        }
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+size_t OrderJournal::removeSegmentsBefore(uint64_t lsn) {
+    auto segments = listSegments(options_.dir);
+    size_t removed = 0;
+    // 下一段的首个LSN不超过lsn + 1时，本段的记录都不超过lsn
+    for (size_t i = 0; i + 1 < segments.size() && segments[i + 1].first <= lsn + 1; ++i) {
+        std::error_code ec;
+        if (!std::filesystem::remove(segments[i].second, ec)) {
+            LOG_WARN("Failed to remove journal segment: " + segments[i].second);
+            break;
+        }
+        ++removed;
+    }
+    return removed;
+}
+
+bool OrderJournal::peekOrderId(std::string_view payload, uint64_t& order_id) {
+    if (payload.size() < sizeof(uint64_t)) {
+        return false;
+    }
+    order_id = getAt<uint64_t>(payload.data());
+    return true;
+}
+
+void OrderJournal::encodeOrderCreated(std::string& out, const services::OrderInfo& order,
+                                      std::string_view reservation_id) {
+    size_t items = std::min(order.product_ids.size(), order.quantities.size());
+    put<uint64_t>(out, order.order_id);
+    put<uint64_t>(out, order.user_id);
+    put<double>(out, order.total_amount);
+    put<int64_t>(out, static_cast<int64_t>(order.created_at));
+    put<int64_t>(out, static_cast<int64_t>(order.updated_at));
+    put<uint8_t>(out, static_cast<uint8_t>(order.status));
+    put<uint16_t>(out, static_cast<uint16_t>(items));
+    put<uint32_t>(out, static_cast<uint32_t>(order.shipping_address.size()));
+    put<uint16_t>(out, static_cast<uint16_t>(order.payment_method.size()));
+    put<uint16_t>(out, static_cast<uint16_t>(reservation_id.size()));
+    for (size_t i = 0; i < items; ++i) {
+        put<uint64_t>(out, order.product_ids[i]);
+        put<uint32_t>(out, order.quantities[i]);
+    }
+    out.append(order.shipping_address);
+    out.append(order.payment_method);
+    out.append(reservation_id.data(), reservation_id.size());
+}
+
+bool OrderJournal::decodeOrderCreated(std::string_view payload, services::OrderInfo& order,
+                                      std::string& reservation_id) {
+    Reader reader(payload);
+    order.order_id = reader.get<uint64_t>();
+    order.user_id = reader.get<uint64_t>();
+    order.total_amount = reader.get<double>();
+    order.created_at = static_cast<time_t>(reader.get<int64_t>());
+    order.updated_at = static_cast<time_t>(reader.get<int64_t>());
+    order.status = static_cast<services::OrderStatus>(reader.get<uint8_t>());
+    uint16_t items = reader.get<uint16_t>();
+    uint32_t address_len = reader.get<uint32_t>();
+    uint16_t payment_len = reader.get<uint16_t>();
+    uint16_t reservation_len = reader.get<uint16_t>();
+    if (!reader.ok()) {
+        return false;
+    }
+
+    order.product_ids.resize(items);
+    order.quantities.resize(items);
+    for (uint16_t i = 0; i < items; ++i) {
+        order.product_ids[i] = reader.get<uint64_t>();
+        order.quantities[i] = reader.get<uint32_t>();
+    }
+    order.shipping_address = reader.bytes(address_len);
+    order.payment_method = reader.bytes(payment_len);
+    reservation_id = reader.bytes(reservation_len);
+    return reader.ok();
+}
+
+void OrderJournal::encodeStatusChanged(std::string& out, uint64_t order_id, services::OrderStatus status,
+                                       time_t updated_at) {
+    put<uint64_t>(out, order_id);
+    put<int64_t>(out, static_cast<int64_t>(updated_at));
+    put<uint8_t>(out, static_cast<uint8_t>(status));
+}
+
+bool OrderJournal::decodeStatusChanged(std::string_view payload, uint64_t& order_id,
+                                       services::OrderStatus& status, time_t& updated_at) {
+    Reader reader(payload);
+    order_id = reader.get<uint64_t>();
+    updated_at = static_cast<time_t>(reader.get<int64_t>());
+    status = static_cast<services::OrderStatus>(reader.get<uint8_t>());
+    return reader.ok();
+}
+
+} // namespace storage
+} // namespace order_engine
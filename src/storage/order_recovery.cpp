@@ -0,0 +1,135 @@
+#include "storage/order_recovery.h"
+#include "storage/order_journal.h"
+#include "storage/order_snapshot.h"
+#include "common/logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace order_engine {
+namespace storage {
+
+namespace {
+
+int64_t elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 分派到分片缓冲区的记录：| type(1) | length(4) | payload |
+constexpr size_t kBucketHeaderSize = 5;
+
+void applyRecord(services::OrderShard& shard, JournalRecordType type, std::string_view payload, uint64_t& applied) {
+    if (type == JournalRecordType::kOrderCreated) {
+        services::OrderInfo order{};
+        std::string reservation_id;
+        if (OrderJournal::decodeOrderCreated(payload, order, reservation_id) &&
+            shard.insert(order, reservation_id)) {
+            ++applied;
+        }
+    } else if (type == JournalRecordType::kStatusChanged) {
+        uint64_t order_id = 0;
+        services::OrderStatus status = services::OrderStatus::PENDING;
+        time_t updated_at = 0;
+        if (!OrderJournal::decodeStatusChanged(payload, order_id, status, updated_at)) {
+            return;
+        }
+        bool found = shard.modify(order_id, [&](services::StoredOrder& entry) {
+            entry.order.status = status;
+            entry.order.updated_at = static_cast<uint32_t>(updated_at);
+            // 与OrderService一致：取消时库存预留已释放，支付时已确认扣减
+            if (status == services::OrderStatus::CANCELLED || status == services::OrderStatus::PAID) {
+                entry.reservation_id = std::string_view();
+            }
+        });
+        if (found) {
+            ++applied;
+        }
+    } else if (type == JournalRecordType::kOrderArchived || type == JournalRecordType::kOrderAborted) {
+        uint64_t order_id = 0;
+        if (OrderJournal::peekOrderId(payload, order_id) && shard.erase(order_id)) {
+            ++applied;
+        }
+    }
+}
+
+} // namespace
+
+bool OrderRecovery::recover(const std::string& snapshot_dir, const std::string& journal_dir,
+                            services::OrderStore& store, RecoveryResult& result) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint64_t> shard_lsns;
+    std::string path = OrderSnapshot::latest(snapshot_dir);
+    if (!path.empty()) {
+        SnapshotInfo info;
+        if (!OrderSnapshot::load(path, store, &info)) {
+            return false;
+        }
+        result.snapshot_path = path;
+        result.snapshot_lsn = info.lsn;
+        result.snapshot_orders = info.orders;
+        shard_lsns = std::move(info.shard_lsns);
+    }
+    result.load_ms = elapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    if (!journal_dir.empty() && !replayJournal(journal_dir, shard_lsns, store, result.replayed_records)) {
+        return false;
+    }
+    result.replay_ms = elapsedMs(start);
+    return true;
+}
+
+bool OrderRecovery::replayJournal(const std::string& journal_dir, const std::vector<uint64_t>& shard_lsns,
+                                  services::OrderStore& store, uint64_t& applied) {
+    uint64_t from_lsn = shard_lsns.empty() ? 1 : *std::min_element(shard_lsns.begin(), shard_lsns.end()) + 1;
+    auto segments = OrderJournal::listSegments(journal_dir);
+    if (!segments.empty() && segments.front().first > from_lsn) {
+        // 需要的日志段已被删除，回放会丢失订单
+        LOG_ERROR_FMT("Journal is missing records from LSN: {}", std::to_string(from_lsn));
+        return false;
+    }
+
+    // 1. 顺序读取，按订单所属分片分派
+    std::vector<std::string> buckets(store.shardCount());
+    bool ok = OrderJournal::replay(journal_dir, from_lsn, [&](const JournalRecord& record) {
+        uint64_t order_id = 0;
+        if (!OrderJournal::peekOrderId(record.payload, order_id)) {
+            return;
+        }
+        if (!shard_lsns.empty() &&
+            record.lsn <= shard_lsns[services::OrderStore::shardIndex(order_id, shard_lsns.size())]) {
+            return;  // 快照中已包含
+        }
+        std::string& bucket = buckets[store.shardOf(order_id)];
+        char header[kBucketHeaderSize];
+        header[0] = static_cast<char>(record.type);
+        uint32_t length = static_cast<uint32_t>(record.payload.size());
+        std::memcpy(header + 1, &length, sizeof(length));
+        bucket.append(header, sizeof(header));
+        bucket.append(record.payload.data(), record.payload.size());
+    });
+    if (!ok) {
+        return false;
+    }
+
+    // 2. 各分片并行应用
+    std::vector<uint64_t> counts(buckets.size(), 0);
+    store.executeAll([&](size_t index, services::OrderShard& shard) {
+        std::string_view data = buckets[index];
+        while (data.size() >= kBucketHeaderSize) {
+            uint32_t length;
+            std::memcpy(&length, data.data() + 1, sizeof(length));
+            applyRecord(shard, static_cast<JournalRecordType>(data[0]),
+                        data.substr(kBucketHeaderSize, length), counts[index]);
+            data.remove_prefix(kBucketHeaderSize + length);
+        }
+        std::string().swap(buckets[index]);
+    });
+    for (uint64_t count : counts) {
+        applied += count;
+    }
+    return true;
+}
+
+} // namespace storage
+} // namespace order_engine
@@ -0,0 +1,361 @@
+#include "storage/order_snapshot.h"
+#include "storage/order_journal.h"
+#include "common/logger.h"
+#include "utils/file_utils.h"
+#include "utils/hash_utils.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <filesystem>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace order_engine {
+namespace storage {
+
+namespace {
+
+constexpr char kSnapshotMagic[8] = {'O', 'E', 'S', 'N', 'A', 'P', '0', '1'};
+// order_id user_id total_amount created_at updated_at status item_count payment_len address_len reservation_len
+constexpr size_t kOrderFixedSize = 8 + 8 + 8 + 4 + 4 + 1 + 2 + 1 + 4 + 2;
+constexpr size_t kEstimatedOrderSize = 128;
+
+struct Section {
+    uint64_t offset;
+    uint64_t size;
+    uint64_t count;
+    uint64_t lsn;
+    uint32_t crc;
+};
+
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void putAt(char* out, T value) {
+    std::memcpy(out, &value, sizeof(T));
+}
+
+template <typename T>
+T getAt(const char* in) {
+    T value;
+    std::memcpy(&value, in, sizeof(T));
+    return value;
+}
+
+std::string snapshotPath(const std::string& dir, uint64_t lsn) {
+    char name[48];
+    std::snprintf(name, sizeof(name), "snapshot-%020llu.snap", static_cast<unsigned long long>(lsn));
+    return (std::filesystem::path(dir) / name).string();
+}
+
+std::vector<std::string> listSnapshots(const std::string& dir) {
+    std::vector<std::string> paths;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() == 34 && name.compare(0, 9, "snapshot-") == 0 &&
+            name.compare(name.size() - 5, 5, ".snap") == 0) {
+            paths.push_back(entry.path().string());
+        }
+    }
+    // 文件名中的LSN定长补零，字典序即LSN顺序
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+// 按分段表解析出各段，校验越界
+bool parseSections(const utils::MappedFile& file, std::vector<Section>& sections, uint64_t& orders) {
+    const char* base = file.data();
+    if (file.size() < OrderSnapshot::kHeaderSize || std::memcmp(base, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0) {
+        return false;
+    }
+    uint32_t shard_count = getAt<uint32_t>(base + 12);
+    size_t table_end = OrderSnapshot::kHeaderSize + shard_count * OrderSnapshot::kSectionEntrySize;
+    if (shard_count == 0 || file.size() < table_end ||
+        utils::crc32c(base + 12, table_end - 12) != getAt<uint32_t>(base + 8)) {
+        return false;
+    }
+    orders = getAt<uint64_t>(base + 24);
+
+    sections.resize(shard_count);
+    for (uint32_t i = 0; i < shard_count; ++i) {
+        const char* entry = base + OrderSnapshot::kHeaderSize + i * OrderSnapshot::kSectionEntrySize;
+        Section& section = sections[i];
+        section.offset = getAt<uint64_t>(entry);
+        section.size = getAt<uint64_t>(entry + 8);
+        section.count = getAt<uint64_t>(entry + 16);
+        section.lsn = getAt<uint64_t>(entry + 24);
+        section.crc = getAt<uint32_t>(entry + 32);
+        if (section.offset < table_end || section.offset > file.size() ||
+            section.size > file.size() - section.offset) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool OrderSnapshot::write(const std::string& dir, services::OrderStore& store, const OrderJournal* journal,
+                          SnapshotInfo* info) {
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) {
+        LOG_ERROR_FMT("Failed to create snapshot directory: {}", dir);
+        return false;
+    }
+
+    // 1. 每个分片在所属线程内序列化自身，同时记下日志位置
+    size_t shard_count = store.shardCount();
+    std::vector<std::string> buffers(shard_count);
+    std::vector<Section> sections(shard_count, Section{0, 0, 0, 0, 0});
+    store.executeAll([&](size_t index, services::OrderShard& shard) {
+        Section& section = sections[index];
+        section.lsn = journal ? journal->lastLsn() : 0;
+        std::string& buffer = buffers[index];
+        buffer.reserve(shard.stats().entries * kEstimatedOrderSize);
+        shard.forEach([&buffer, &section](const services::StoredOrder& entry) {
+            encodeOrder(buffer, entry);
+            ++section.count;
+        });
+    });
+
+    // 2. 校验和与分段表在调用线程计算，不占用分片线程
+    std::string header(kHeaderSize + shard_count * kSectionEntrySize, '\0');
+    uint64_t offset = header.size();
+    uint64_t min_lsn = UINT64_MAX;
+    uint64_t orders = 0;
+    for (size_t i = 0; i < shard_count; ++i) {
+        Section& section = sections[i];
+        section.offset = offset;
+        section.size = buffers[i].size();
+        section.crc = utils::crc32c(buffers[i].data(), buffers[i].size());
+        offset += section.size;
+        min_lsn = std::min(min_lsn, section.lsn);
+        orders += section.count;
+
+        char* entry = header.data() + kHeaderSize + i * kSectionEntrySize;
+        putAt<uint64_t>(entry, section.offset);
+        putAt<uint64_t>(entry + 8, section.size);
+        putAt<uint64_t>(entry + 16, section.count);
+        putAt<uint64_t>(entry + 24, section.lsn);
+        putAt<uint32_t>(entry + 32, section.crc);
+    }
+    if (shard_count == 0) {
+        min_lsn = 0;
+    }
+    std::memcpy(header.data(), kSnapshotMagic, sizeof(kSnapshotMagic));
+    putAt<uint32_t>(header.data() + 12, static_cast<uint32_t>(shard_count));
+    putAt<uint64_t>(header.data() + 16, min_lsn);
+    putAt<uint64_t>(header.data() + 24, orders);
+    putAt<uint64_t>(header.data() + 32, static_cast<uint64_t>(time(nullptr)));
+    putAt<uint32_t>(header.data() + 8, utils::crc32c(header.data() + 12, header.size() - 12));
+
+    // 3. 写临时文件，落盘后改名
+    std::string path = snapshotPath(dir, min_lsn);
+    std::string tmp_path = path + ".tmp";
+    int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        LOG_ERROR_FMT("Failed to create snapshot: {}", tmp_path);
+        return false;
+    }
+    bool ok = utils::writeFully(fd, header.data(), header.size(), 0);
+    for (size_t i = 0; ok && i < shard_count; ++i) {
+        ok = utils::writeFully(fd, buffers[i].data(), buffers[i].size(), static_cast<off_t>(sections[i].offset));
+        std::string().swap(buffers[i]);
+    }
+    ok = ok && ::fsync(fd) == 0;
+    ::close(fd);
+    ok = ok && std::rename(tmp_path.c_str(), path.c_str()) == 0 && utils::syncDirectory(dir);
+    if (!ok) {
+        LOG_ERROR_FMT("Failed to write snapshot: {}", path);
+        std::filesystem::remove(tmp_path, ec);
+        return false;
+    }
+
+    if (info) {
+        info->path = path;
+        info->lsn = min_lsn;
+        info->orders = orders;
+        info->bytes = offset;
+        info->shard_lsns.clear();
+        for (const auto& section : sections) {
+            info->shard_lsns.push_back(section.lsn);
+        }
+    }
+    return true;
+}
+
+bool OrderSnapshot::load(const std::string& path, services::OrderStore& store, SnapshotInfo* info) {
+    utils::MappedFile file;
+    std::vector<Section> sections;
+    uint64_t orders = 0;
+    if (!file.open(path) || !parseSections(file, sections, orders)) {
+        LOG_ERROR_FMT("Invalid snapshot: {}", path);
+        return false;
+    }
+    // 各分片顺序扫描自己的段，提前预读
+    file.advise(MADV_SEQUENTIAL);
+    file.advise(MADV_WILLNEED);
+
+    std::atomic<bool> ok(true);
+    size_t shard_count = store.shardCount();
+    if (sections.size() == shard_count) {
+        // 分片数未变：每个分片解码自己的段
+        store.executeAll([&](size_t index, services::OrderShard& shard) {
+            const Section& section = sections[index];
+            std::string_view data(file.data() + section.offset, section.size);
+            if (utils::crc32c(data.data(), data.size()) != section.crc) {
+                ok = false;
+                return;
+            }
+            shard.reserve(shard.stats().entries + section.count);
+            services::CompactOrder order;
+            std::string_view reservation_id;
+            for (uint64_t i = 0; i < section.count; ++i) {
+                if (!decodeOrder(data, order, reservation_id)) {
+                    ok = false;
+                    return;
+                }
+                shard.insert(order, reservation_id);
+            }
+        });
+    } else {
+        // 分片数变化：先并行校验各段，再由每个分片扫描全部段，只插入属于自己的订单
+        store.executeAll([&](size_t index, services::OrderShard&) {
+            for (size_t i = index; i < sections.size(); i += shard_count) {
+                if (utils::crc32c(file.data() + sections[i].offset, sections[i].size) != sections[i].crc) {
+                    ok = false;
+                }
+            }
+        });
+        if (ok) {
+            store.executeAll([&](size_t index, services::OrderShard& shard) {
+                shard.reserve(shard.stats().entries + orders / shard_count);
+                services::CompactOrder order;
+                std::string_view reservation_id;
+                for (const Section& section : sections) {
+                    std::string_view data(file.data() + section.offset, section.size);
+                    for (uint64_t i = 0; i < section.count; ++i) {
+                        if (!decodeOrder(data, order, reservation_id)) {
+                            ok = false;
+                            return;
+                        }
+                        if (store.shardOf(order.order_id) == index) {
+                            shard.insert(order, reservation_id);
+                        }
+                    }
+                }
+            });
+        }
+    }
+    if (!ok) {
+        LOG_ERROR_FMT("Corrupted snapshot: {}", path);
+        return false;
+    }
+
+    if (info) {
+        info->path = path;
+        info->lsn = getAt<uint64_t>(file.data() + 16);
+        info->orders = orders;
+        info->bytes = file.size();
+        info->shard_lsns.clear();
+        for (const auto& section : sections) {
+            info->shard_lsns.push_back(section.lsn);
+        }
+    }
+    return true;
+}
+
+std::string OrderSnapshot::latest(const std::string& dir) {
+    std::vector<std::string> paths = listSnapshots(dir);
+    return paths.empty() ? std::string() : paths.back();
+}
+
+uint64_t OrderSnapshot::prune(const std::string& dir, size_t keep) {
+    std::vector<std::string> paths = listSnapshots(dir);
+    size_t first_kept = paths.size() > keep ? paths.size() - keep : 0;
+    for (size_t i = 0; i < first_kept; ++i) {
+        std::error_code ec;
+        std::filesystem::remove(paths[i], ec);
+    }
+    if (first_kept >= paths.size()) {
+        return 0;
+    }
+    unsigned long long lsn = 0;
+    std::sscanf(std::filesystem::path(paths[first_kept]).filename().c_str(), "snapshot-%20llu.snap", &lsn);
+    return lsn;
+}
+
+void OrderSnapshot::encodeOrder(std::string& out, const services::StoredOrder& entry) {
+    const services::CompactOrder& order = entry.order;
+    std::string_view payment_method = services::paymentMethodName(order.payment_method);
+    put<uint64_t>(out, order.order_id);
+    put<uint64_t>(out, order.user_id);
+    put<double>(out, order.total_amount);
+    put<uint32_t>(out, order.created_at);
+    put<uint32_t>(out, order.updated_at);
+    put<uint8_t>(out, static_cast<uint8_t>(order.status));
+    put<uint16_t>(out, static_cast<uint16_t>(order.items.size()));
+    put<uint8_t>(out, static_cast<uint8_t>(payment_method.size()));
+    put<uint32_t>(out, static_cast<uint32_t>(order.shipping_address.size()));
+    put<uint16_t>(out, static_cast<uint16_t>(entry.reservation_id.size()));
+    for (const services::LineItem& item : order.items) {
+        put<uint64_t>(out, item.product_id);
+        put<uint32_t>(out, item.quantity);
+        put<uint32_t>(out, item.price_cents);
+    }
+    out.append(payment_method.data(), payment_method.size());
+    out.append(order.shipping_address.data(), order.shipping_address.size());
+    out.append(entry.reservation_id.data(), entry.reservation_id.size());
+}
+
+bool OrderSnapshot::decodeOrder(std::string_view& in, services::CompactOrder& order,
+                                std::string_view& reservation_id) {
+    if (in.size() < kOrderFixedSize) {
+        return false;
+    }
+    const char* p = in.data();
+    size_t item_count = getAt<uint16_t>(p + 33);
+    size_t payment_len = getAt<uint8_t>(p + 35);
+    size_t address_len = getAt<uint32_t>(p + 36);
+    size_t reservation_len = getAt<uint16_t>(p + 40);
+    size_t total = kOrderFixedSize + item_count * sizeof(services::LineItem) + payment_len + address_len +
+                   reservation_len;
+    if (in.size() < total) {
+        return false;
+    }
+
+    order.order_id = getAt<uint64_t>(p);
+    order.user_id = getAt<uint64_t>(p + 8);
+    order.total_amount = getAt<double>(p + 16);
+    order.created_at = getAt<uint32_t>(p + 24);
+    order.updated_at = getAt<uint32_t>(p + 28);
+    order.status = static_cast<services::OrderStatus>(getAt<uint8_t>(p + 32));
+    p += kOrderFixedSize;
+
+    order.items.clear();
+    order.items.reserve(item_count);
+    for (size_t i = 0; i < item_count; ++i) {
+        order.items.push_back(services::LineItem{getAt<uint64_t>(p), getAt<uint32_t>(p + 8),
+                                                 getAt<uint32_t>(p + 12)});
+        p += sizeof(services::LineItem);
+    }
+    order.payment_method = services::internPaymentMethod(std::string_view(p, payment_len));
+    p += payment_len;
+    order.shipping_address = std::string_view(p, address_len);
+    p += address_len;
+    reservation_id = std::string_view(p, reservation_len);
+
+    in.remove_prefix(total);
+    return true;
+}
+
+} // namespace storage
+} // namespace order_engine
@@ -0,0 +1,308 @@
+#include "storage/persistence_batcher.h"
+#include "common/logger.h"
+#include "utils/json_utils.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <ctime>
+#include <map>
+
+namespace order_engine {
+namespace storage {
+
+namespace {
+
+// MySQL字符串字面量转义（与mysql_real_escape_string对utf8mb4的处理一致）
+void appendSqlString(std::string& out, std::string_view value) {
+    out.push_back('\'');
+    for (char c : value) {
+        switch (c) {
+            case '\0': out += "\\0"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\\': out += "\\\\"; break;
+            case '\'': out += "\\'"; break;
+            case '"': out += "\\\""; break;
+            case '\x1a': out += "\\Z"; break;
+            default: out.push_back(c); break;
+        }
+    }
+    out.push_back('\'');
+}
+
+void appendAmount(std::string& out, double value) {
+    char buffer[32];
+    int len = std::snprintf(buffer, sizeof(buffer), "%.2f", value);
+    out.append(buffer, static_cast<size_t>(len));
+}
+
+void appendTimestamp(std::string& out, time_t value) {
+    out += "FROM_UNIXTIME(";
+    out += std::to_string(static_cast<int64_t>(value));
+    out.push_back(')');
+}
+
+} // namespace
+
+PersistenceBatcher::PersistenceBatcher(TransactionExecutor executor, PersistenceOptions options)
+    : executor_(std::move(executor))
+    , options_(options)
+    , running_(false)
+    , batch_count_(0)
+    , row_count_(0)
+    , failed_batch_count_(0)
+    , retried_row_count_(0)
+    , dead_letter_count_(0)
+    , rejected_count_(0)
+    , queue_depth_(0)
+    , batch_latency_ms_(utils::Histogram::exponentialBounds(0.5, 2.0, 14))
+    , batch_size_(utils::Histogram::exponentialBounds(1.0, 2.0, 12)) {
+    options_.max_rows = std::max<size_t>(options_.max_rows, 1);
+    options_.retry_delay_ms = std::max(options_.retry_delay_ms, 1);
+    options_.max_retry_delay_ms = std::max(options_.max_retry_delay_ms, options_.retry_delay_ms);
+    options_.max_attempts = std::max(options_.max_attempts, 1);
+    options_.max_pending = std::max(options_.max_pending, options_.max_rows);
+}
+
+PersistenceBatcher::~PersistenceBatcher() {
+    stop();
+}
+
+void PersistenceBatcher::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_.exchange(true)) {
+        return;
+    }
+    flush_thread_ = std::thread([this]() { flushLoop(); });
+}
+
+void PersistenceBatcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_.exchange(false)) {
+            return;
+        }
+    }
+    cv_.notify_one();
+    if (flush_thread_.joinable()) {
+        flush_thread_.join();
+    }
+}
+
+bool PersistenceBatcher::submit(const services::OrderInfo& order, std::string_view order_number,
+                                CommitCallback callback, bool retry) {
+    bool notify;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        if (pending_.size() >= options_.max_pending) {
+            rejected_count_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        pending_.push_back(PendingOrder{order, std::string(order_number), std::move(callback),
+                                        std::chrono::steady_clock::now(), retry});
+        queue_depth_.store(pending_.size(), std::memory_order_relaxed);
+        notify = pending_.size() == 1 || pending_.size() >= options_.max_rows;
+    }
+    if (notify) {
+        cv_.notify_one();
+    }
+    return true;
+}
+
+void PersistenceBatcher::flushLoop() {
+    std::vector<PendingOrder> batch;
+    std::vector<std::string> statements;
+    int retry_delay_ms = options_.retry_delay_ms;
+    // 二分坏数据时缩小的批次上限，成功后逐步翻倍恢复到max_rows
+    size_t batch_limit = options_.max_rows;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return !pending_.empty() || !running_.load(); });
+            if (pending_.empty()) {
+                break;  // 已停止且没有剩余订单
+            }
+
+            // 从最早的订单入队时算起，最多等max_delay_ms
+            auto deadline = pending_.front().enqueued_at + std::chrono::milliseconds(options_.max_delay_ms);
+            cv_.wait_until(lock, deadline, [this]() {
+                return pending_.size() >= options_.max_rows || !running_.load();
+            });
+
+            if (pending_.size() <= batch_limit) {
+                batch.swap(pending_);
+            } else {
+                // 超出部分留给下一批，先到的先写
+                auto split = pending_.begin() + static_cast<std::ptrdiff_t>(batch_limit);
+                batch.assign(std::make_move_iterator(pending_.begin()), std::make_move_iterator(split));
+                pending_.erase(pending_.begin(), split);
+            }
+            queue_depth_.store(pending_.size(), std::memory_order_relaxed);
+        }
+
+        statements.clear();
+        buildStatements(batch, statements);
+        bool ok = executor_(statements);
+
+        auto now = std::chrono::steady_clock::now();
+        double latency_ms = std::chrono::duration<double, std::milli>(now - batch.front().enqueued_at).count();
+        batch_latency_ms_.observe(latency_ms);
+        batch_size_.observe(static_cast<double>(batch.size()));
+        batch_count_.fetch_add(1, std::memory_order_relaxed);
+        if (ok) {
+            row_count_.fetch_add(batch.size(), std::memory_order_relaxed);
+            retry_delay_ms = options_.retry_delay_ms;
+            batch_limit = std::min(batch_limit * 2, options_.max_rows);
+        } else {
+            failed_batch_count_.fetch_add(1, std::memory_order_relaxed);
+            LOG_ERROR_FMT("Order persistence batch failed, orders: {}", std::to_string(batch.size()));
+        }
+
+        // 失败批次中要求重试的订单留下，其余回调；多次失败的订单所在批次二分，
+        // 单独成批仍失败的转入死信
+        std::vector<PendingOrder> retry;
+        bool bisect = false;
+        for (auto& pending : batch) {
+            if (!ok && pending.retry && running_.load()) {
+                if (++pending.attempts < options_.max_attempts) {
+                    retry.push_back(std::move(pending));
+                } else if (batch.size() > 1) {
+                    bisect = true;
+                    retry.push_back(std::move(pending));
+                } else {
+                    deadLetter(pending);
+                }
+            } else if (pending.callback) {
+                pending.callback(ok);
+            }
+        }
+        if (bisect) {
+            batch_limit = std::max<size_t>(batch.size() / 2, 1);
+        }
+        batch.clear();
+        if (retry.empty()) {
+            continue;
+        }
+
+        retried_row_count_.fetch_add(retry.size(), std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lock(mutex_);
+        // 放回队首保持先后顺序；停止时唤醒，剩余订单最后写一次
+        pending_.insert(pending_.begin(), std::make_move_iterator(retry.begin()),
+                        std::make_move_iterator(retry.end()));
+        queue_depth_.store(pending_.size(), std::memory_order_relaxed);
+        cv_.wait_for(lock, std::chrono::milliseconds(retry_delay_ms), [this]() { return !running_.load(); });
+        retry_delay_ms = std::min(retry_delay_ms * 2, options_.max_retry_delay_ms);
+    }
+}
+
+void PersistenceBatcher::deadLetter(PendingOrder& pending) {
+    dead_letter_count_.fetch_add(1, std::memory_order_relaxed);
+    LOG_ERROR("Order moved to dead letter after " + std::to_string(pending.attempts) +
+              " failed attempts: " + std::to_string(pending.order.order_id));
+    if (!options_.dead_letter_file.empty()) {
+        // 保存该订单的完整SQL，修复数据或表结构后可人工重放
+        std::vector<PendingOrder> single;
+        single.push_back(PendingOrder{pending.order, pending.order_number, nullptr, pending.enqueued_at, false});
+        std::vector<std::string> statements;
+        buildStatements(single, statements);
+        std::ofstream out(options_.dead_letter_file, std::ios::app);
+        for (const std::string& statement : statements) {
+            out << statement << ";\n";
+        }
+        if (!out) {
+            LOG_ERROR_FMT("Failed to write dead letter file: {}", options_.dead_letter_file);
+        }
+    }
+    if (pending.callback) {
+        pending.callback(false);
+    }
+}
+
+void PersistenceBatcher::buildStatements(const std::vector<PendingOrder>& batch,
+                                         std::vector<std::string>& statements) {
+    // 按月分表，同一张表的订单合并为一条INSERT
+    std::map<std::string, std::vector<const PendingOrder*>> tables;
+    size_t item_count = 0;
+    for (const auto& pending : batch) {
+        tables[ordersTable(pending.order.created_at)].push_back(&pending);
+        item_count += std::min(pending.order.product_ids.size(), pending.order.quantities.size());
+    }
+
+    for (const auto& [table, orders] : tables) {
+        std::string sql;
+        sql.reserve(256 + orders.size() * 256);
+        sql += "INSERT INTO " + table +
+               " (order_id, order_number, user_id, total_amount, actual_amount, status, payment_method,"
+               " shipping_address, created_at, updated_at) VALUES ";
+        for (size_t i = 0; i < orders.size(); ++i) {
+            const services::OrderInfo& order = orders[i]->order;
+            sql += i == 0 ? "(" : ",(";
+            sql += std::to_string(order.order_id);
+            sql.push_back(',');
+            appendSqlString(sql, orders[i]->order_number);
+            sql.push_back(',');
+            sql += std::to_string(order.user_id);
+            sql.push_back(',');
+            appendAmount(sql, order.total_amount);
+            sql.push_back(',');
+            appendAmount(sql, order.total_amount);
+            sql.push_back(',');
+            sql += std::to_string(static_cast<int>(order.status));
+            sql.push_back(',');
+            appendSqlString(sql, order.payment_method);
+            sql.push_back(',');
+            // shipping_address为JSON列，写入JSON字符串
+            std::string address_json;
+            utils::JsonWriter(address_json).writeString(order.shipping_address);
+            appendSqlString(sql, address_json);
+            sql.push_back(',');
+            appendTimestamp(sql, order.created_at);
+            sql.push_back(',');
+            appendTimestamp(sql, order.updated_at);
+            sql.push_back(')');
+        }
+        statements.push_back(std::move(sql));
+    }
+
+    if (item_count == 0) {
+        return;
+    }
+    // 商品名称、编码和价格留空（NULL），不写入伪造的空串和0价格
+    // TODO: 商品目录接入后填写商品名称、编码和单价 (Phase 2)
+    std::string sql;
+    sql.reserve(128 + item_count * 48);
+    sql += "INSERT INTO order_items (order_id, product_id, quantity, created_at) VALUES ";
+    bool first = true;
+    for (const auto& pending : batch) {
+        const services::OrderInfo& order = pending.order;
+        size_t count = std::min(order.product_ids.size(), order.quantities.size());
+        for (size_t i = 0; i < count; ++i) {
+            sql += first ? "(" : ",(";
+            first = false;
+            sql += std::to_string(order.order_id);
+            sql.push_back(',');
+            sql += std::to_string(order.product_ids[i]);
+            sql.push_back(',');
+            sql += std::to_string(order.quantities[i]);
+            sql.push_back(',');
+            appendTimestamp(sql, order.created_at);
+            sql.push_back(')');
+        }
+    }
+    statements.push_back(std::move(sql));
+}
+
+std::string PersistenceBatcher::ordersTable(time_t created_at) {
+    struct tm tm_buf;
+    localtime_r(&created_at, &tm_buf);
+    char name[32];
+    std::snprintf(name, sizeof(name), "orders_%04d%02d", tm_buf.tm_year + 1900, tm_buf.tm_mon + 1);
+    return name;
+}
+
+} // namespace storage
+} // namespace order_engine
@@ -0,0 +1,104 @@
+#include "utils/hash_utils.h"
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+namespace order_engine {
+namespace utils {
+
+namespace {
+
+const uint32_t kCrc32cPoly = 0x82F63B78;
+
+struct Crc32cTable {
+    uint32_t table[8][256];
+
+    Crc32cTable() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int j = 0; j < 8; ++j) {
+                crc = (crc >> 1) ^ ((crc & 1) ? kCrc32cPoly : 0);
+            }
+            table[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (int k = 1; k < 8; ++k) {
+                table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF];
+            }
+        }
+    }
+};
+
+// slice-by-8查表实现
+uint32_t crc32cSoftware(const uint8_t* p, size_t len, uint32_t crc) {
+    static const Crc32cTable tables;
+    const auto& t = tables.table;
+
+    while (len >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        word ^= crc;
+        crc = t[7][word & 0xFF] ^ t[6][(word >> 8) & 0xFF] ^
+              t[5][(word >> 16) & 0xFF] ^ t[4][(word >> 24) & 0xFF] ^
+              t[3][(word >> 32) & 0xFF] ^ t[2][(word >> 40) & 0xFF] ^
+              t[1][(word >> 48) & 0xFF] ^ t[0][word >> 56];
+        p += 8;
+        len -= 8;
+    }
+    while (len--) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    }
+    return crc;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2")))
+uint32_t crc32cHardware(const uint8_t* p, size_t len, uint32_t crc) {
+    uint64_t crc64 = crc;
+    while (len >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        p += 8;
+        len -= 8;
+    }
+    uint32_t crc32 = static_cast<uint32_t>(crc64);
+    while (len--) {
+        crc32 = _mm_crc32_u8(crc32, *p++);
+    }
+    return crc32;
+}
+
+bool hasSse42() {
+    static const bool supported = __builtin_cpu_supports("sse4.2");
+    return supported;
+}
+#endif
+
+} // namespace
+
+uint32_t crc32c(const void* data, size_t len, uint32_t crc) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    crc = ~crc;
+#if defined(__x86_64__)
+    if (hasSse42()) {
+        return ~crc32cHardware(p, len, crc);
+    }
+#endif
+    return ~crc32cSoftware(p, len, crc);
+}
+
+uint64_t hash64(const void* data, size_t len, uint64_t seed) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = 0xcbf29ce484222325ULL ^ mix64(seed);
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return mix64(hash);
+}
+
+} // namespace utils
+} // namespace order_engine
@@ -0,0 +1,71 @@
+#include "utils/histogram.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace order_engine {
+namespace utils {
+
+namespace {
+
+void appendNumber(std::string& out, double value) {
+    char buffer[32];
+    int len = std::snprintf(buffer, sizeof(buffer), "%g", value);
+    out.append(buffer, static_cast<size_t>(len));
+}
+
+} // namespace
+
+Histogram::Histogram(std::vector<double> bounds)
+    : bounds_(std::move(bounds))
+    , buckets_(new std::atomic<uint64_t>[bounds_.size() + 1])
+    , count_(0)
+    , sum_(0.0) {
+    std::sort(bounds_.begin(), bounds_.end());
+    for (size_t i = 0; i <= bounds_.size(); ++i) {
+        buckets_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void Histogram::observe(double value) {
+    // 第一个不小于value的边界（Prometheus的le语义）
+    size_t index = static_cast<size_t>(std::lower_bound(bounds_.begin(), bounds_.end(), value) - bounds_.begin());
+    buckets_[index].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+}
+
+void Histogram::appendPrometheus(std::string& out, std::string_view name, std::string_view labels) const {
+    std::string prefix(name);
+    out += "# TYPE " + prefix + " histogram\n";
+    std::string separator = labels.empty() ? std::string() : std::string(labels) + ",";
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i <= bounds_.size(); ++i) {
+        cumulative += bucketCount(i);
+        out += prefix + "_bucket{" + separator + "le=\"";
+        if (i < bounds_.size()) {
+            appendNumber(out, bounds_[i]);
+        } else {
+            out += "+Inf";
+        }
+        out += "\"} " + std::to_string(cumulative) + "\n";
+    }
+
+    std::string suffix = labels.empty() ? std::string() : "{" + std::string(labels) + "}";
+    out += prefix + "_sum" + suffix + " ";
+    appendNumber(out, sum());
+    out += "\n" + prefix + "_count" + suffix + " " + std::to_string(cumulative) + "\n";
+}
+
+std::vector<double> Histogram::exponentialBounds(double start, double factor, size_t count) {
+    std::vector<double> bounds;
+    bounds.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        bounds.push_back(start);
+        start *= factor;
+    }
+    return bounds;
+}
+
+} // namespace utils
+} // namespace order_engine
@@ -0,0 +1,104 @@
+#include "utils/id_generator.h"
+#include <cassert>
+#include <chrono>
+#include <ctime>
+
+namespace order_engine {
+namespace utils {
+
+namespace {
+
+constexpr uint64_t kMillisPerDay = 86400000ULL;
+
+uint64_t nowMillis() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+// 定宽十进制，高位补0
+void writeDigits(char* out, uint64_t value, int width) {
+    for (int i = width - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+
+} // namespace
+
+IdGenerator::IdGenerator(uint16_t node_id)
+    : node_id_(node_id & kMaxNodeId)
+    , utc_offset_ms_(0)
+    , state_(0)
+    , borrow_count_(0) {
+    time_t now = time(nullptr);
+    struct tm tm_now;
+    localtime_r(&now, &tm_now);
+    utc_offset_ms_ = static_cast<int64_t>(tm_now.tm_gmtoff) * 1000;
+}
+
+void IdGenerator::setNodeId(uint16_t node_id) {
+    node_id_ = node_id & kMaxNodeId;
+}
+
+uint64_t IdGenerator::nextBlock(size_t count) {
+    return nextBlock(count, nowMillis());
+}
+
+uint64_t IdGenerator::nextBlock(size_t count, uint64_t now_ms) {
+    assert(count >= 1 && count <= kMaxBlockSize);
+    uint64_t now = now_ms > kEpochMs ? now_ms - kEpochMs : 0;
+
+    uint64_t current = state_.load(std::memory_order_relaxed);
+    uint64_t first;
+    bool borrowed;
+    do {
+        borrowed = false;
+        if (now > (current >> kSequenceBits)) {
+            first = now << kSequenceBits;
+        } else {
+            // 同一毫秒、或时钟回拨：接着上次的位置，放不下整段时进入下一毫秒
+            first = current + 1;
+            if ((first & kMaxSequence) + count > kMaxSequence + 1) {
+                first = ((first >> kSequenceBits) + 1) << kSequenceBits;
+            }
+            borrowed = (first >> kSequenceBits) > now;
+        }
+    } while (!state_.compare_exchange_weak(current, first + count - 1, std::memory_order_relaxed));
+
+    if (borrowed) {
+        borrow_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return ((first >> kSequenceBits) << kTimestampShift) |
+           (static_cast<uint64_t>(node_id_) << kSequenceBits) |
+           (first & kMaxSequence);
+}
+
+void IdGenerator::advancePast(uint64_t id) {
+    // 与state_相同的(时间戳, 序列号)位置，下次分配从其后开始
+    uint64_t position = ((id >> kTimestampShift) << kSequenceBits) | (id & kMaxSequence);
+    uint64_t current = state_.load(std::memory_order_relaxed);
+    while (current < position &&
+           !state_.compare_exchange_weak(current, position, std::memory_order_relaxed)) {
+    }
+}
+
+size_t IdGenerator::formatOrderNumber(uint64_t id, char* buffer) const {
+    int64_t local_ms = static_cast<int64_t>(timestampMs(id)) + utc_offset_ms_;
+    uint64_t days = static_cast<uint64_t>(local_ms) / kMillisPerDay;
+    uint64_t ms_of_day = static_cast<uint64_t>(local_ms) % kMillisPerDay;
+    std::chrono::year_month_day date{std::chrono::sys_days{std::chrono::days{days}}};
+
+    buffer[0] = 'O';
+    buffer[1] = 'R';
+    buffer[2] = 'D';
+    writeDigits(buffer + 3, static_cast<uint64_t>(static_cast<int>(date.year())), 4);
+    writeDigits(buffer + 7, static_cast<unsigned>(date.month()), 2);
+    writeDigits(buffer + 9, static_cast<unsigned>(date.day()), 2);
+    writeDigits(buffer + 11, ms_of_day, 8);
+    writeDigits(buffer + 19, nodeOf(id), 4);
+    writeDigits(buffer + 23, sequenceOf(id), 4);
+    return kOrderNumberLength;
+}
+
+} // namespace utils
+} // namespace order_engine
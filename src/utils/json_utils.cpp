@@ -0,0 +1,829 @@
+#include "utils/json_utils.h"
+#include "services/order_state_machine.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace order_engine {
+namespace utils {
+
+namespace {
+
+const size_t kBlockSize = 64;
+
+// 一个64字节块的字符分类位掩码，第i位对应块内第i个字节
+struct BlockMasks {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t op;        // { } [ ] : ,
+    uint64_t ws;        // 空格 \t \n \r
+};
+
+// 跨块携带的扫描状态
+struct ScanState {
+    uint64_t prev_escaped = 0;
+    uint64_t prev_in_string = 0;
+    uint64_t prev_scalar = 0;
+};
+
+enum CharClass : uint8_t {
+    kOther = 0,
+    kQuote = 1,
+    kBackslash = 2,
+    kOp = 3,
+    kWhitespace = 4
+};
+
+struct CharClassTable {
+    uint8_t table[256];
+    bool needs_escape[256];
+
+    CharClassTable() {
+        std::memset(table, kOther, sizeof(table));
+        table[static_cast<uint8_t>('"')] = kQuote;
+        table[static_cast<uint8_t>('\\')] = kBackslash;
+        for (char c : {'{', '}', '[', ']', ':', ','}) {
+            table[static_cast<uint8_t>(c)] = kOp;
+        }
+        for (char c : {' ', '\t', '\n', '\r'}) {
+            table[static_cast<uint8_t>(c)] = kWhitespace;
+        }
+        for (int c = 0; c < 256; ++c) {
+            needs_escape[c] = c < 0x20 || c == '"' || c == '\\';
+        }
+    }
+};
+
+const CharClassTable& charClasses() {
+    static const CharClassTable classes;
+    return classes;
+}
+
+void classifyScalar(const uint8_t* p, BlockMasks& masks) {
+    const uint8_t* table = charClasses().table;
+    masks = BlockMasks{0, 0, 0, 0};
+    for (size_t i = 0; i < kBlockSize; ++i) {
+        uint64_t bit = 1ULL << i;
+        switch (table[p[i]]) {
+            case kQuote:      masks.quote |= bit; break;
+            case kBackslash:  masks.backslash |= bit; break;
+            case kOp:         masks.op |= bit; break;
+            case kWhitespace: masks.ws |= bit; break;
+            default: break;
+        }
+    }
+}
+
+inline uint64_t prefixXor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// 被转义的字符：前面紧跟奇数个连续反斜杠
+inline uint64_t escapedMask(uint64_t backslash, uint64_t& prev_escaped) {
+    const uint64_t even_bits = 0x5555555555555555ULL;
+    backslash &= ~prev_escaped;
+    uint64_t follows_escape = (backslash << 1) | prev_escaped;
+    uint64_t odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+    uint64_t sequences_starting_on_even_bits;
+    prev_escaped = __builtin_add_overflow(odd_sequence_starts, backslash, &sequences_starting_on_even_bits);
+    uint64_t invert_mask = sequences_starting_on_even_bits << 1;
+    return (even_bits ^ invert_mask) & follows_escape;
+}
+
+// 由字符分类得到结构字符：字符串外的{}[]:,以及每个值（字符串、数字、字面量）的首字符
+inline uint64_t structuralMask(const BlockMasks& masks, ScanState& state) {
+    uint64_t escaped = escapedMask(masks.backslash, state.prev_escaped);
+    uint64_t quote = masks.quote & ~escaped;
+    uint64_t in_string = prefixXor(quote) ^ state.prev_in_string;
+    state.prev_in_string = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+    // 开引号之后直到闭引号（含）
+    uint64_t string_tail = in_string ^ quote;
+
+    uint64_t scalar = ~(masks.op | masks.ws);
+    uint64_t follows_scalar = (scalar << 1) | state.prev_scalar;
+    state.prev_scalar = scalar >> 63;
+    uint64_t scalar_start = scalar & ~follows_scalar;
+
+    return (masks.op | scalar_start) & ~string_tail;
+}
+
+inline size_t flushBits(uint64_t bits, uint32_t base, std::vector<uint32_t>& out, size_t count) {
+    if (count + kBlockSize > out.size()) {
+        out.resize(std::max(out.size() * 2, count + kBlockSize));
+    }
+    uint32_t* dst = out.data() + count;
+    while (bits) {
+        *dst++ = base + static_cast<uint32_t>(__builtin_ctzll(bits));
+        bits &= bits - 1;
+    }
+    return dst - out.data();
+}
+
+// 尾部不足一块时用空格补齐（空白不产生结构字符）
+inline const uint8_t* tailBlock(const char* data, size_t offset, size_t len, uint8_t* tail) {
+    std::memset(tail, ' ', kBlockSize);
+    std::memcpy(tail, data + offset, len - offset);
+    return tail;
+}
+
+size_t scanScalar(const char* data, size_t len, std::vector<uint32_t>& out, ScanState& state) {
+    size_t count = 0;
+    BlockMasks masks;
+    size_t offset = 0;
+    for (; offset + kBlockSize <= len; offset += kBlockSize) {
+        classifyScalar(reinterpret_cast<const uint8_t*>(data + offset), masks);
+        count = flushBits(structuralMask(masks, state), static_cast<uint32_t>(offset), out, count);
+    }
+    if (offset < len) {
+        uint8_t tail[kBlockSize];
+        classifyScalar(tailBlock(data, offset, len, tail), masks);
+        count = flushBits(structuralMask(masks, state), static_cast<uint32_t>(offset), out, count);
+    }
+    return count;
+}
+
+size_t findEscapeScalar(const char* p, size_t from, size_t n) {
+    const bool* needs_escape = charClasses().needs_escape;
+    while (from < n && !needs_escape[static_cast<uint8_t>(p[from])]) {
+        ++from;
+    }
+    return from;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("avx2")))
+inline uint32_t eqMask32(__m256i chunk, char c) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(c))));
+}
+
+__attribute__((target("avx2")))
+inline uint64_t eqMask64(__m256i lo, __m256i hi, char c) {
+    return eqMask32(lo, c) | (static_cast<uint64_t>(eqMask32(hi, c)) << 32);
+}
+
+__attribute__((target("avx2")))
+inline void classifyAvx2(const uint8_t* p, BlockMasks& masks) {
+    __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+    masks.quote = eqMask64(lo, hi, '"');
+    masks.backslash = eqMask64(lo, hi, '\\');
+    masks.op = eqMask64(lo, hi, '{') | eqMask64(lo, hi, '}') | eqMask64(lo, hi, '[') |
+               eqMask64(lo, hi, ']') | eqMask64(lo, hi, ':') | eqMask64(lo, hi, ',');
+    masks.ws = eqMask64(lo, hi, ' ') | eqMask64(lo, hi, '\t') |
+               eqMask64(lo, hi, '\n') | eqMask64(lo, hi, '\r');
+}
+
+// 与scanScalar相同的循环，单独成函数以便分类逻辑内联进AVX2代码
+__attribute__((target("avx2")))
+size_t scanAvx2(const char* data, size_t len, std::vector<uint32_t>& out, ScanState& state) {
+    size_t count = 0;
+    BlockMasks masks;
+    size_t offset = 0;
+    for (; offset + kBlockSize <= len; offset += kBlockSize) {
+        classifyAvx2(reinterpret_cast<const uint8_t*>(data + offset), masks);
+        count = flushBits(structuralMask(masks, state), static_cast<uint32_t>(offset), out, count);
+    }
+    if (offset < len) {
+        alignas(32) uint8_t tail[kBlockSize];
+        classifyAvx2(tailBlock(data, offset, len, tail), masks);
+        count = flushBits(structuralMask(masks, state), static_cast<uint32_t>(offset), out, count);
+    }
+    return count;
+}
+
+// 找下一个需要转义的字节：c < 0x20、'"'、'\\'
+__attribute__((target("avx2")))
+size_t findEscapeAvx2(const char* p, size_t from, size_t n) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control_max = _mm256_set1_epi8(0x1F);
+    for (; from + 32 <= n; from += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + from));
+        __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote), _mm256_cmpeq_epi8(chunk, backslash));
+        // 无符号 c <= 0x1F 等价于 max(c, 0x1F) == 0x1F
+        hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control_max), control_max));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hit));
+        if (mask) {
+            return from + __builtin_ctz(mask);
+        }
+    }
+    return findEscapeScalar(p, from, n);
+}
+#endif
+
+bool hasAvx2() {
+#if defined(__x86_64__)
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+size_t findEscape(const char* p, size_t from, size_t n) {
+#if defined(__x86_64__)
+    if (hasAvx2()) {
+        return findEscapeAvx2(p, from, n);
+    }
+#endif
+    return findEscapeScalar(p, from, n);
+}
+
+void appendEscapeSequence(std::string& out, char c) {
+    switch (c) {
+        case '"':  out.append("\\\""); return;
+        case '\\': out.append("\\\\"); return;
+        case '\n': out.append("\\n"); return;
+        case '\r': out.append("\\r"); return;
+        case '\t': out.append("\\t"); return;
+        case '\b': out.append("\\b"); return;
+        case '\f': out.append("\\f"); return;
+        default: {
+            static const char kHex[] = "0123456789abcdef";
+            char buf[6] = {'\\', 'u', '0', '0', kHex[(c >> 4) & 0xF], kHex[c & 0xF]};
+            out.append(buf, sizeof(buf));
+            return;
+        }
+    }
+}
+
+bool parseHex4(const char* p, const char* end, uint32_t& value) {
+    if (end - p < 4) {
+        return false;
+    }
+    auto result = std::from_chars(p, p + 4, value, 16);
+    return result.ec == std::errc() && result.ptr == p + 4;
+}
+
+void appendUtf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+bool unescape(std::string_view raw, std::string& out) {
+    out.clear();
+    out.reserve(raw.size());
+    const char* p = raw.data();
+    const char* end = p + raw.size();
+    while (p < end) {
+        const char* slash = static_cast<const char*>(std::memchr(p, '\\', end - p));
+        if (!slash) {
+            out.append(p, end - p);
+            break;
+        }
+        out.append(p, slash - p);
+        if (slash + 1 >= end) {
+            return false;
+        }
+        p = slash + 2;
+        switch (slash[1]) {
+            case '"':  out.push_back('"'); break;
+            case '\\': out.push_back('\\'); break;
+            case '/':  out.push_back('/'); break;
+            case 'b':  out.push_back('\b'); break;
+            case 'f':  out.push_back('\f'); break;
+            case 'n':  out.push_back('\n'); break;
+            case 'r':  out.push_back('\r'); break;
+            case 't':  out.push_back('\t'); break;
+            case 'u': {
+                uint32_t cp;
+                if (!parseHex4(p, end, cp)) {
+                    return false;
+                }
+                p += 4;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    uint32_t low;
+                    if (end - p < 6 || p[0] != '\\' || p[1] != 'u' || !parseHex4(p + 2, end, low) ||
+                        low < 0xDC00 || low > 0xDFFF) {
+                        return false;
+                    }
+                    p += 6;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    return false;
+                }
+                appendUtf8(out, cp);
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+// JsonParser
+JsonParser::JsonParser(bool allow_simd)
+    : allow_simd_(allow_simd)
+    , used_simd_(false)
+    , error_(nullptr) {
+}
+
+bool JsonParser::simdSupported() {
+    return hasAvx2();
+}
+
+bool JsonParser::parse(std::string_view json) {
+    json_ = json;
+    error_ = nullptr;
+    if (json.size() > kMaxSize) {
+        error_ = "document too large";
+        return false;
+    }
+    if (!buildIndex() || !matchBrackets()) {
+        return false;
+    }
+    if (structurals_.empty()) {
+        error_ = "empty document";
+        return false;
+    }
+    if (root().skip() != structurals_.size()) {
+        error_ = "trailing content after root value";
+        return false;
+    }
+    return true;
+}
+
+bool JsonParser::buildIndex() {
+    ScanState state;
+    size_t count;
+    used_simd_ = false;
+#if defined(__x86_64__)
+    if (allow_simd_ && hasAvx2()) {
+        used_simd_ = true;
+        count = scanAvx2(json_.data(), json_.size(), structurals_, state);
+    } else
+#endif
+    {
+        count = scanScalar(json_.data(), json_.size(), structurals_, state);
+    }
+    structurals_.resize(count);
+
+    if (state.prev_in_string) {
+        error_ = "unterminated string";
+        return false;
+    }
+    return true;
+}
+
+bool JsonParser::matchBrackets() {
+    uint32_t stack[kMaxDepth];
+    size_t depth = 0;
+    matches_.resize(structurals_.size());
+    for (uint32_t i = 0; i < structurals_.size(); ++i) {
+        char c = json_[structurals_[i]];
+        if (c == '{' || c == '[') {
+            if (depth == kMaxDepth) {
+                error_ = "nesting too deep";
+                return false;
+            }
+            stack[depth++] = i;
+        } else if (c == '}' || c == ']') {
+            char open = c == '}' ? '{' : '[';
+            if (depth == 0 || json_[structurals_[stack[depth - 1]]] != open) {
+                error_ = "mismatched bracket";
+                return false;
+            }
+            matches_[stack[--depth]] = i;
+        }
+    }
+    if (depth != 0) {
+        error_ = "unclosed bracket";
+        return false;
+    }
+    return true;
+}
+
+// JsonValue
+char JsonValue::tokenChar() const {
+    return parser_->json_[parser_->structurals_[index_]];
+}
+
+JsonType JsonValue::type() const {
+    if (!parser_) {
+        return JsonType::kInvalid;
+    }
+    switch (tokenChar()) {
+        case '{': return JsonType::kObject;
+        case '[': return JsonType::kArray;
+        case '"': return JsonType::kString;
+        case 't':
+        case 'f': return JsonType::kBool;
+        case 'n': return JsonType::kNull;
+        case '-':
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            return JsonType::kNumber;
+        default:
+            return JsonType::kInvalid;
+    }
+}
+
+uint32_t JsonValue::skip() const {
+    char c = tokenChar();
+    if (c == '{' || c == '[') {
+        return parser_->matches_[index_] + 1;
+    }
+    return index_ + 1;
+}
+
+std::string_view JsonValue::scalarToken() const {
+    const auto& structurals = parser_->structurals_;
+    size_t start = structurals[index_];
+    size_t end = index_ + 1 < structurals.size() ? structurals[index_ + 1] : parser_->json_.size();
+    std::string_view token = parser_->json_.substr(start, end - start);
+    while (!token.empty() && charClasses().table[static_cast<uint8_t>(token.back())] == kWhitespace) {
+        token.remove_suffix(1);
+    }
+    return token;
+}
+
+JsonValue JsonValue::operator[](std::string_view key) const {
+    if (type() != JsonType::kObject) {
+        return JsonValue();
+    }
+    const auto& json = parser_->json_;
+    const auto& structurals = parser_->structurals_;
+    uint32_t count = static_cast<uint32_t>(structurals.size());
+    uint32_t i = index_ + 1;
+    while (i + 2 < count && json[structurals[i]] == '"') {
+        if (json[structurals[i + 1]] != ':') {
+            return JsonValue();
+        }
+        JsonValue value(parser_, i + 2);
+        std::string_view name;
+        if (JsonValue(parser_, i).getRawString(name) && name == key) {
+            return value;
+        }
+        i = value.skip();
+        if (i < count && json[structurals[i]] == ',') {
+            ++i;
+        }
+    }
+    return JsonValue();
+}
+
+JsonValue JsonValue::firstElement() const {
+    if (type() != JsonType::kArray || tokenChar() == ']') {
+        return JsonValue();
+    }
+    uint32_t first = index_ + 1;
+    if (first >= parser_->structurals_.size() || parser_->json_[parser_->structurals_[first]] == ']') {
+        return JsonValue();
+    }
+    return JsonValue(parser_, first);
+}
+
+JsonValue JsonValue::nextElement() const {
+    if (!parser_) {
+        return JsonValue();
+    }
+    uint32_t next = skip();
+    const auto& structurals = parser_->structurals_;
+    if (next + 1 < structurals.size() && parser_->json_[structurals[next]] == ',') {
+        return JsonValue(parser_, next + 1);
+    }
+    return JsonValue();
+}
+
+bool JsonValue::getUint64(uint64_t& value) const {
+    if (type() != JsonType::kNumber) {
+        return false;
+    }
+    std::string_view token = scalarToken();
+    auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+    return result.ec == std::errc() && result.ptr == token.data() + token.size();
+}
+
+bool JsonValue::getInt64(int64_t& value) const {
+    if (type() != JsonType::kNumber) {
+        return false;
+    }
+    std::string_view token = scalarToken();
+    auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+    return result.ec == std::errc() && result.ptr == token.data() + token.size();
+}
+
+bool JsonValue::getDouble(double& value) const {
+    if (type() != JsonType::kNumber) {
+        return false;
+    }
+    std::string_view token = scalarToken();
+    auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+    return result.ec == std::errc() && result.ptr == token.data() + token.size();
+}
+
+bool JsonValue::getBool(bool& value) const {
+    if (type() != JsonType::kBool) {
+        return false;
+    }
+    std::string_view token = scalarToken();
+    if (token == "true") {
+        value = true;
+        return true;
+    }
+    if (token == "false") {
+        value = false;
+        return true;
+    }
+    return false;
+}
+
+bool JsonValue::isNull() const {
+    return type() == JsonType::kNull && scalarToken() == "null";
+}
+
+bool JsonValue::getRawString(std::string_view& value) const {
+    if (type() != JsonType::kString) {
+        return false;
+    }
+    const auto& json = parser_->json_;
+    size_t start = parser_->structurals_[index_] + 1;
+    size_t pos = start;
+    while (true) {
+        pos = json.find('"', pos);
+        if (pos == std::string_view::npos) {
+            return false;
+        }
+        // 前面连续反斜杠为偶数个时才是闭引号
+        size_t backslashes = 0;
+        while (pos - backslashes > start && json[pos - backslashes - 1] == '\\') {
+            ++backslashes;
+        }
+        if (backslashes % 2 == 0) {
+            break;
+        }
+        ++pos;
+    }
+    value = json.substr(start, pos - start);
+    return true;
+}
+
+bool JsonValue::getString(std::string& value) const {
+    std::string_view raw;
+    if (!getRawString(raw)) {
+        return false;
+    }
+    if (raw.find('\\') == std::string_view::npos) {
+        value.assign(raw);
+        return true;
+    }
+    return unescape(raw, value);
+}
+
+// JsonWriter
+void JsonWriter::separator() {
+    if (need_comma_) {
+        out_.push_back(',');
+    }
+}
+
+void JsonWriter::startObject() {
+    separator();
+    out_.push_back('{');
+    need_comma_ = false;
+}
+
+void JsonWriter::endObject() {
+    out_.push_back('}');
+    need_comma_ = true;
+}
+
+void JsonWriter::startArray() {
+    separator();
+    out_.push_back('[');
+    need_comma_ = false;
+}
+
+void JsonWriter::endArray() {
+    out_.push_back(']');
+    need_comma_ = true;
+}
+
+void JsonWriter::key(std::string_view name) {
+    separator();
+    out_.push_back('"');
+    appendJsonEscaped(out_, name);
+    out_.append("\":");
+    need_comma_ = false;
+}
+
+void JsonWriter::writeString(std::string_view value) {
+    separator();
+    out_.push_back('"');
+    appendJsonEscaped(out_, value);
+    out_.push_back('"');
+    need_comma_ = true;
+}
+
+void JsonWriter::writeUint(uint64_t value) {
+    separator();
+    char buf[24];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out_.append(buf, result.ptr - buf);
+    need_comma_ = true;
+}
+
+void JsonWriter::writeInt(int64_t value) {
+    separator();
+    char buf[24];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out_.append(buf, result.ptr - buf);
+    need_comma_ = true;
+}
+
+void JsonWriter::writeDouble(double value) {
+    if (!std::isfinite(value)) {
+        writeNull();
+        return;
+    }
+    separator();
+    char buf[32];
+    auto result = std::to_chars(buf, buf + sizeof(buf), value);
+    out_.append(buf, result.ptr - buf);
+    need_comma_ = true;
+}
+
+void JsonWriter::writeBool(bool value) {
+    separator();
+    out_.append(value ? "true" : "false");
+    need_comma_ = true;
+}
+
+void JsonWriter::writeNull() {
+    separator();
+    out_.append("null");
+    need_comma_ = true;
+}
+
+void appendJsonEscaped(std::string& out, std::string_view value) {
+    const char* p = value.data();
+    size_t n = value.size();
+    size_t i = 0;
+    while (i < n) {
+        size_t j = findEscape(p, i, n);
+        out.append(p + i, j - i);
+        if (j == n) {
+            break;
+        }
+        appendEscapeSequence(out, p[j]);
+        i = j + 1;
+    }
+}
+
+// OrderInfo映射
+bool parseOrderInfo(JsonParser& parser, std::string_view json, services::OrderInfo& order,
+                    std::string& error) {
+    if (!parser.parse(json)) {
+        error = parser.error();
+        return false;
+    }
+    JsonValue root = parser.root();
+    if (root.type() != JsonType::kObject) {
+        error = "order must be a JSON object";
+        return false;
+    }
+
+    order = services::OrderInfo{};
+    order.status = services::OrderStatus::PENDING;
+    if (!root["user_id"].getUint64(order.user_id)) {
+        error = "missing or invalid user_id";
+        return false;
+    }
+    if (!root["total_amount"].getDouble(order.total_amount)) {
+        error = "missing or invalid total_amount";
+        return false;
+    }
+
+    uint64_t number;
+    JsonValue items = root["items"];
+    if (items.valid()) {
+        for (JsonValue item = items.firstElement(); item.valid(); item = item.nextElement()) {
+            uint64_t quantity;
+            if (!item["product_id"].getUint64(number) || !item["quantity"].getUint64(quantity) ||
+                quantity > UINT32_MAX) {
+                error = "invalid order item";
+                return false;
+            }
+            order.product_ids.push_back(number);
+            order.quantities.push_back(static_cast<uint32_t>(quantity));
+        }
+    } else {
+        // 旧格式：平行数组
+        for (JsonValue e = root["product_ids"].firstElement(); e.valid(); e = e.nextElement()) {
+            if (!e.getUint64(number)) {
+                error = "invalid product_ids";
+                return false;
+            }
+            order.product_ids.push_back(number);
+        }
+        for (JsonValue e = root["quantities"].firstElement(); e.valid(); e = e.nextElement()) {
+            if (!e.getUint64(number) || number > UINT32_MAX) {
+                error = "invalid quantities";
+                return false;
+            }
+            order.quantities.push_back(static_cast<uint32_t>(number));
+        }
+    }
+
+    JsonValue address = root["shipping_address"];
+    if (address.valid() && !address.getString(order.shipping_address)) {
+        error = "invalid shipping_address";
+        return false;
+    }
+    JsonValue payment = root["payment_method"];
+    if (payment.valid() && !payment.getString(order.payment_method)) {
+        error = "invalid payment_method";
+        return false;
+    }
+    return true;
+}
+
+void writeOrderInfo(JsonWriter& writer, const services::OrderInfo& order) {
+    writer.startObject();
+    writer.key("order_id");
+    writer.writeUint(order.order_id);
+    writer.key("user_id");
+    writer.writeUint(order.user_id);
+    writer.key("status");
+    writer.writeString(orderStatusToString(order.status));
+    writer.key("total_amount");
+    writer.writeDouble(order.total_amount);
+    writer.key("items");
+    writer.startArray();
+    size_t items = std::min(order.product_ids.size(), order.quantities.size());
+    for (size_t i = 0; i < items; ++i) {
+        writer.startObject();
+        writer.key("product_id");
+        writer.writeUint(order.product_ids[i]);
+        writer.key("quantity");
+        writer.writeUint(order.quantities[i]);
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.key("shipping_address");
+    writer.writeString(order.shipping_address);
+    writer.key("payment_method");
+    writer.writeString(order.payment_method);
+    writer.key("created_at");
+    writer.writeInt(static_cast<int64_t>(order.created_at));
+    writer.key("updated_at");
+    writer.writeInt(static_cast<int64_t>(order.updated_at));
+    writer.endObject();
+}
+
+const char* orderStatusToString(services::OrderStatus status) {
+    switch (status) {
+        case services::OrderStatus::PENDING:   return "PENDING";
+        case services::OrderStatus::PAID:      return "PAID";
+        case services::OrderStatus::SHIPPED:   return "SHIPPED";
+        case services::OrderStatus::DELIVERED: return "DELIVERED";
+        case services::OrderStatus::CANCELLED: return "CANCELLED";
+        case services::OrderStatus::REFUNDED:  return "REFUNDED";
+        default:                               return "UNKNOWN";
+    }
+}
+
+bool orderStatusFromString(std::string_view name, services::OrderStatus& status) {
+    for (size_t i = 0; i < services::kOrderStatusCount; ++i) {
+        std::string_view candidate = orderStatusToString(static_cast<services::OrderStatus>(i));
+        if (name.size() == candidate.size() &&
+            std::equal(name.begin(), name.end(), candidate.begin(), [](char a, char b) {
+                return std::toupper(static_cast<unsigned char>(a)) == b;
+            })) {
+            status = static_cast<services::OrderStatus>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace utils
+} // namespace order_engine
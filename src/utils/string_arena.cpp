@@ -0,0 +1,46 @@
+#include "utils/string_arena.h"
+#include <cstring>
+#include <utility>
+
+namespace order_engine {
+namespace utils {
+
+std::string_view StringArena::store(std::string_view value) {
+    if (value.empty()) {
+        return std::string_view();
+    }
+    stored_bytes_ += value.size();
+
+    if (blocks_.empty() || capacity_ - used_ < value.size()) {
+        // 超过块大小的字符串单独成块，不浪费当前块剩余空间
+        if (value.size() > block_size_ / 4) {
+            auto block = std::make_unique<char[]>(value.size());
+            std::memcpy(block.get(), value.data(), value.size());
+            std::string_view stored(block.get(), value.size());
+            blocks_.insert(blocks_.end() - (blocks_.empty() ? 0 : 1), std::move(block));
+            allocated_bytes_ += value.size();
+            return stored;
+        }
+        blocks_.push_back(std::make_unique<char[]>(block_size_));
+        used_ = 0;
+        capacity_ = block_size_;
+        allocated_bytes_ += block_size_;
+    }
+
+    char* dest = blocks_.back().get() + used_;
+    std::memcpy(dest, value.data(), value.size());
+    used_ += value.size();
+    return std::string_view(dest, value.size());
+}
+
+void StringArena::swap(StringArena& other) noexcept {
+    std::swap(block_size_, other.block_size_);
+    blocks_.swap(other.blocks_);
+    std::swap(used_, other.used_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(allocated_bytes_, other.allocated_bytes_);
+    std::swap(stored_bytes_, other.stored_bytes_);
+}
+
+} // namespace utils
+} // namespace order_engine
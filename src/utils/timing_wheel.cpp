@@ -0,0 +1,81 @@
+#include "utils/timing_wheel.h"
+#include <algorithm>
+
+namespace order_engine {
+namespace utils {
+
+TimingWheel::TimingWheel(time_t now)
+    : current_(static_cast<int64_t>(now))
+    , size_(0) {
+}
+
+void TimingWheel::schedule(uint64_t id, time_t deadline) {
+    place(Entry{id, static_cast<int64_t>(deadline)});
+    ++size_;
+}
+
+void TimingWheel::place(const Entry& entry) {
+    // 已到期的条目放到下一秒的槽
+    int64_t slot_time = std::max(entry.deadline, current_ + 1);
+    int64_t delta = slot_time - current_;
+    size_t level = 0;
+    while (level + 1 < kLevels && delta >= (int64_t(1) << (kSlotBits * (level + 1)))) {
+        ++level;
+    }
+    int64_t span_bits = static_cast<int64_t>(kSlotBits * level);
+    if (level == kLevels - 1 && delta >= (int64_t(1) << (kSlotBits * kLevels))) {
+        // 超出范围：先放在最高层最远的槽，触发时重新放入
+        slot_time = current_ + (int64_t(1) << (kSlotBits * kLevels)) - 1;
+    }
+    slots_[level][static_cast<size_t>((slot_time >> span_bits) & (kSlots - 1))].push_back(entry);
+}
+
+void TimingWheel::cascade(size_t level) {
+    std::vector<Entry>& slot = slots_[level][static_cast<size_t>((current_ >> (kSlotBits * level)) & (kSlots - 1))];
+    std::vector<Entry> entries;
+    entries.swap(slot);
+    for (const Entry& entry : entries) {
+        if (entry.deadline <= current_) {
+            // 正好在本秒到期，放入本秒随后要触发的第0层槽
+            slots_[0][static_cast<size_t>(current_ & (kSlots - 1))].push_back(entry);
+        } else {
+            place(entry);
+        }
+    }
+}
+
+void TimingWheel::advance(time_t now, const std::function<void(uint64_t id)>& fn) {
+    int64_t target = static_cast<int64_t>(now);
+    if (size_ == 0) {
+        // 空轮直接跳到now：长时间空闲或大步推进时不逐秒走空槽
+        current_ = std::max(current_, target);
+        return;
+    }
+    while (current_ < target) {
+        ++current_;
+        // 高层先下沉：落入的低层槽若同时轮到，会在本秒继续下沉或触发
+        for (size_t level = kLevels - 1; level > 0; --level) {
+            if ((current_ & ((int64_t(1) << (kSlotBits * level)) - 1)) == 0) {
+                cascade(level);
+            }
+        }
+
+        std::vector<Entry>& slot = slots_[0][static_cast<size_t>(current_ & (kSlots - 1))];
+        if (slot.empty()) {
+            continue;
+        }
+        firing_.clear();
+        firing_.swap(slot);
+        for (const Entry& entry : firing_) {
+            if (entry.deadline > current_) {
+                place(entry);  // 超出范围的条目尚未到期
+                continue;
+            }
+            --size_;
+            fn(entry.id);
+        }
+    }
+}
+
+} // namespace utils
+} // namespace order_engine
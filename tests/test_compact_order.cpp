@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "services/compact_order.h"
+
+using namespace order_engine;
+using namespace order_engine::services;
+
+TEST(InlineVectorTest, SpillsToHeapBeyondInlineCapacity) {
+    utils::InlineVector<LineItem, 4> items;
+    for (uint64_t i = 0; i < 4; ++i) {
+        items.push_back(LineItem{i, 1, 0});
+    }
+    EXPECT_TRUE(items.isInline());
+    EXPECT_EQ(items.heapBytes(), 0u);
+
+    items.push_back(LineItem{4, 1, 0});
+    EXPECT_FALSE(items.isInline());
+    EXPECT_EQ(items.size(), 5u);
+
+    // 拷贝和移动保持内容
+    utils::InlineVector<LineItem, 4> copy = items;
+    utils::InlineVector<LineItem, 4> moved = std::move(items);
+    EXPECT_TRUE(items.empty());
+    ASSERT_EQ(moved.size(), 5u);
+    for (uint64_t i = 0; i < 5; ++i) {
+        EXPECT_EQ(copy[i].product_id, i);
+        EXPECT_EQ(moved[i].product_id, i);
+    }
+
+    utils::InlineVector<LineItem, 4> small;
+    small.push_back(LineItem{9, 2, 0});
+    moved = std::move(small);
+    EXPECT_TRUE(moved.isInline());
+    EXPECT_EQ(moved[0].product_id, 9u);
+}
+
+TEST(StringArenaTest, StoresStringsInBlocks) {
+    utils::StringArena arena(64);
+    std::string_view a = arena.store("hello");
+    std::string_view b = arena.store("world");
+    EXPECT_EQ(a, "hello");
+    EXPECT_EQ(b, "world");
+    EXPECT_EQ(a.data() + a.size(), b.data());  // 同一块内连续
+    EXPECT_EQ(arena.allocatedBytes(), 64u);
+
+    std::string big(100, 'x');
+    EXPECT_EQ(arena.store(big), big);           // 大字符串单独成块
+    EXPECT_EQ(arena.allocatedBytes(), 164u);
+    std::string_view c = arena.store("!");
+    EXPECT_EQ(b.data() + b.size(), c.data());   // 当前块继续使用
+    EXPECT_TRUE(arena.store("").empty());
+    EXPECT_EQ(arena.storedBytes(), 111u);
+}
+
+TEST(CompactOrderTest, RoundTripsOrderInfo) {
+    OrderInfo order{};
+    order.order_id = 123456789;
+    order.user_id = 42;
+    order.product_ids = {1001, 1002, 1003};
+    order.quantities = {1, 2, 3};
+    order.total_amount = 199.99;
+    order.status = OrderStatus::PAID;
+    order.created_at = 1792324800;
+    order.updated_at = 1792324860;
+    order.shipping_address = "No. 1 Software Avenue, Nanshan District, Shenzhen";
+    order.payment_method = "wechat";
+
+    utils::StringArena arena;
+    CompactOrder compact = CompactOrder::fromOrderInfo(order, arena);
+    EXPECT_TRUE(compact.items.isInline());
+    EXPECT_EQ(compact.payment_method, static_cast<uint8_t>(PaymentMethod::WECHAT));
+
+    OrderInfo restored{};
+    compact.toOrderInfo(restored);
+    EXPECT_EQ(restored.order_id, order.order_id);
+    EXPECT_EQ(restored.user_id, order.user_id);
+    EXPECT_EQ(restored.product_ids, order.product_ids);
+    EXPECT_EQ(restored.quantities, order.quantities);
+    EXPECT_EQ(restored.total_amount, order.total_amount);
+    EXPECT_EQ(restored.status, order.status);
+    EXPECT_EQ(restored.created_at, order.created_at);
+    EXPECT_EQ(restored.updated_at, order.updated_at);
+    EXPECT_EQ(restored.shipping_address, order.shipping_address);
+    EXPECT_EQ(restored.payment_method, order.payment_method);
+}
+
+TEST(CompactOrderTest, InternsUnknownPaymentMethods) {
+    uint8_t code = internPaymentMethod("union_pay");
+    EXPECT_GE(code, static_cast<uint8_t>(PaymentMethod::kFirstInterned));
+    EXPECT_EQ(internPaymentMethod("union_pay"), code);
+    EXPECT_EQ(paymentMethodName(code), "union_pay");
+    EXPECT_EQ(internPaymentMethod("alipay"), static_cast<uint8_t>(PaymentMethod::ALIPAY));
+    EXPECT_EQ(internPaymentMethod(""), static_cast<uint8_t>(PaymentMethod::UNKNOWN));
+    EXPECT_TRUE(paymentMethodName(0).empty());
+}
@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+#include "network/coroutine.h"
+#include "network/reactor.h"
+#include "network/tcp_connection.h"
+#include "common/logger.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <thread>
+#include <chrono>
+#include <atomic>
+
+using namespace order_engine::network;
+
+namespace {
+
+Task<int> addAsync(int a, int b) {
+    co_return a + b;
+}
+
+Task<int> chainAsync(int n) {
+    int sum = 0;
+    for (int i = 0; i < n; ++i) {
+        sum += co_await addAsync(i, 1);
+    }
+    co_return sum;
+}
+
+Task<void> throwAsync() {
+    throw std::runtime_error("boom");
+    co_return;
+}
+
+// 回调式异步操作：inline为true时在start中直接完成，否则由外部线程完成
+class ValueAwaiter : public CallbackAwaiter<int> {
+public:
+    ValueAwaiter(Reactor* reactor, bool inline_complete, std::atomic<ValueAwaiter*>* pending)
+        : CallbackAwaiter<int>(reactor), inline_complete_(inline_complete), pending_(pending) {}
+
+    void complete(int value) { resolve(value); }
+
+protected:
+    void start() override {
+        if (inline_complete_) {
+            resolve(7);
+        } else {
+            pending_->store(this);
+        }
+    }
+
+private:
+    bool inline_complete_;
+    std::atomic<ValueAwaiter*>* pending_;
+};
+
+} // namespace
+
+class CoroutineTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        if (Reactor* reactor = reactor_.load()) {
+            reactor->quit();
+        }
+        if (reactor_thread_.joinable()) {
+            reactor_thread_.join();
+        }
+    }
+
+    // Reactor在其循环线程中创建
+    void startReactor() {
+        reactor_thread_ = std::thread([this]() {
+            Reactor reactor;
+            reactor_.store(&reactor);
+            reactor.loop();
+            reactor_.store(nullptr);
+        });
+        while (!reactor_.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    std::atomic<Reactor*> reactor_{nullptr};
+    std::thread reactor_thread_;
+};
+
+TEST_F(CoroutineTest, TaskReturnsValue) {
+    int result = 0;
+    spawn([&result]() -> Task<void> {
+        result = co_await chainAsync(10);
+    }());
+
+    EXPECT_EQ(result, 55);
+}
+
+TEST_F(CoroutineTest, ExceptionPropagates) {
+    bool caught = false;
+    spawn([&caught]() -> Task<void> {
+        try {
+            co_await throwAsync();
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+    }());
+
+    EXPECT_TRUE(caught);
+}
+
+TEST_F(CoroutineTest, FramePoolReusesFrames) {
+    FramePool pool;
+    FramePool::setCurrent(&pool);
+
+    for (int i = 0; i < 100; ++i) {
+        spawn([]() -> Task<void> {
+            co_await addAsync(1, 2);
+        }());
+    }
+
+    FramePool::setCurrent(nullptr);
+
+    // 每轮三个帧（外层lambda、分离外壳和addAsync），首轮之后全部来自空闲链表
+    EXPECT_EQ(pool.getAllocCount(), 300u);
+    EXPECT_GE(pool.getReuseCount(), 297u);
+    EXPECT_GT(pool.getCachedBlocks(), 0u);
+}
+
+TEST_F(CoroutineTest, ReactorSleep) {
+    std::atomic<bool> resumed{false};
+    auto start_time = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point resumed_at;
+
+    startReactor();
+    Reactor* reactor = reactor_.load();
+
+    reactor->runInLoop([reactor, &resumed, &resumed_at]() {
+        spawn([](Reactor* r, std::atomic<bool>* flag,
+                 std::chrono::steady_clock::time_point* at) -> Task<void> {
+            co_await r->sleep(0.05);
+            *at = std::chrono::steady_clock::now();
+            flag->store(true);
+        }(reactor, &resumed, &resumed_at));
+    });
+
+    // 等待协程恢复
+    for (int i = 0; i < 100 && !resumed.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    reactor->quit();
+    reactor_thread_.join();
+
+    ASSERT_TRUE(resumed.load());
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(resumed_at - start_time);
+    EXPECT_GE(elapsed.count(), 50);
+}
+
+TEST_F(CoroutineTest, ConnectionReadWrite) {
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+    struct sockaddr_in peer_addr {};
+    auto conn = std::make_shared<TcpConnection>(fds[0], peer_addr);
+    conn->establishConnection();
+
+    ssize_t read_bytes = -1;
+    ssize_t written_bytes = -1;
+    char buf[64] = {};
+    spawn([](TcpConnectionPtr c, char* out, ssize_t* r, ssize_t* w) -> Task<void> {
+        *r = co_await c->read(out, 64);
+        *w = co_await c->write("pong", 4);
+    }(conn, buf, &read_bytes, &written_bytes));
+
+    // 无数据时协程挂起
+    EXPECT_EQ(read_bytes, -1);
+
+    ASSERT_EQ(::write(fds[1], "ping", 4), 4);
+    conn->handleRead();
+
+    EXPECT_EQ(read_bytes, 4);
+    EXPECT_EQ(std::string(buf, 4), "ping");
+    EXPECT_EQ(written_bytes, 4);
+
+    char reply[8] = {};
+    ASSERT_EQ(::read(fds[1], reply, sizeof(reply)), 4);
+    EXPECT_EQ(std::string(reply, 4), "pong");
+
+    ::close(fds[1]);
+}
+
+TEST_F(CoroutineTest, CallbackAwaiterCompletesInline) {
+    int result = 0;
+    spawn([](int* out) -> Task<void> {
+        *out = co_await ValueAwaiter(nullptr, true, nullptr);
+    }(&result));
+
+    // 同步完成时不挂起，也不需要Reactor
+    EXPECT_EQ(result, 7);
+}
+
+TEST_F(CoroutineTest, CallbackAwaiterResumesOnReactor) {
+    std::atomic<ValueAwaiter*> pending{nullptr};
+    std::atomic<int> result{0};
+    std::atomic<bool> resumed_in_loop{false};
+
+    startReactor();
+    Reactor* reactor = reactor_.load();
+
+    reactor->runInLoop([reactor, &pending, &result, &resumed_in_loop]() {
+        spawn([](Reactor* r, std::atomic<ValueAwaiter*>* p, std::atomic<int>* out,
+                 std::atomic<bool>* in_loop) -> Task<void> {
+            int value = co_await ValueAwaiter(r, false, p);
+            in_loop->store(r->isInLoopThread());
+            out->store(value);
+        }(reactor, &pending, &result, &resumed_in_loop));
+    });
+
+    for (int i = 0; i < 100 && !pending.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_NE(pending.load(), nullptr);
+
+    // 在测试线程中完成，协程应回到Reactor线程继续执行
+    pending.load()->complete(42);
+
+    for (int i = 0; i < 100 && result.load() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    EXPECT_EQ(result.load(), 42);
+    EXPECT_TRUE(resumed_in_loop.load());
+}
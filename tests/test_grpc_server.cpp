@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "rpc/grpc_server.h"
+#include "order.grpc.pb.h"
+#include <grpcpp/create_channel.h>
+#include <grpcpp/security/credentials.h>
+#include <thread>
+#include <vector>
+#include <atomic>
+
+using namespace order_engine;
+
+class GrpcServerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // 端口0由系统分配；业务服务为空，验证RPC框架本身
+        server_ = std::make_unique<rpc::GrpcServer>("127.0.0.1", 0, 2, nullptr, nullptr);
+        ASSERT_TRUE(server_->start());
+        ASSERT_GT(server_->getPort(), 0);
+
+        auto channel = grpc::CreateChannel("127.0.0.1:" + std::to_string(server_->getPort()),
+                                           grpc::InsecureChannelCredentials());
+        stub_ = proto::OrderService::NewStub(channel);
+    }
+
+    void TearDown() override {
+        server_->stop();
+    }
+
+    std::unique_ptr<rpc::GrpcServer> server_;
+    std::unique_ptr<proto::OrderService::Stub> stub_;
+};
+
+TEST_F(GrpcServerTest, UnavailableWithoutServices) {
+    proto::CreateOrderRequest request;
+    request.set_user_id(1);
+    proto::LineItem* item = request.add_items();
+    item->set_product_id(100);
+    item->set_quantity(2);
+
+    grpc::ClientContext ctx;
+    proto::Result result;
+    grpc::Status status = stub_->CreateOrder(&ctx, request, &result);
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::UNAVAILABLE);
+
+    grpc::ClientContext reserve_ctx;
+    proto::ReserveStockRequest reserve;
+    reserve.set_order_id(1);
+    status = stub_->ReserveStock(&reserve_ctx, reserve, &result);
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::UNAVAILABLE);
+}
+
+TEST_F(GrpcServerTest, ConcurrentCallsAcrossQueues) {
+    const int num_threads = 4;
+    const int calls_per_thread = 50;
+    std::atomic<int> completed{0};
+
+    std::vector<std::thread> clients;
+    for (int t = 0; t < num_threads; ++t) {
+        clients.emplace_back([this, &completed]() {
+            for (int i = 0; i < calls_per_thread; ++i) {
+                grpc::ClientContext ctx;
+                proto::QueryOrderRequest request;
+                request.set_order_id(i);
+                proto::OrderRecord record;
+                grpc::Status status = stub_->QueryOrder(&ctx, request, &record);
+                if (status.error_code() == grpc::StatusCode::UNAVAILABLE) {
+                    ++completed;
+                }
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+
+    EXPECT_EQ(completed.load(), num_threads * calls_per_thread);
+    EXPECT_EQ(server_->getHandledCount(), static_cast<uint64_t>(num_threads * calls_per_thread));
+}
+
+TEST_F(GrpcServerTest, StopIsIdempotent) {
+    server_->stop();
+    server_->stop();
+    EXPECT_EQ(server_->getQueueCount(), 0u);
+}
@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+#include "http/http_server.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <thread>
+#include <chrono>
+
+using namespace order_engine::http;
+
+TEST(HttpParserTest, ParsesCompleteRequest) {
+    std::string raw = "POST /api/v1/orders?user=42&page=2 HTTP/1.1\r\n"
+                      "Host: localhost\r\n"
+                      "content-length: 5\r\n"
+                      "\r\n"
+                      "hello";
+    HttpParser parser;
+    HttpRequest request;
+    size_t consumed = 0;
+    ASSERT_EQ(parser.parse(raw.data(), raw.size(), request, consumed), ParseStatus::kComplete);
+    EXPECT_EQ(consumed, raw.size());
+    EXPECT_EQ(request.method, Method::kPost);
+    EXPECT_EQ(request.path, "/api/v1/orders");
+    EXPECT_EQ(request.queryParam("user"), "42");
+    EXPECT_EQ(request.queryParam("page"), "2");
+    EXPECT_EQ(request.header("Content-Length"), "5");
+    EXPECT_EQ(request.header("HOST"), "localhost");
+    EXPECT_EQ(request.body, "hello");
+    EXPECT_TRUE(request.keep_alive);
+}
+
+TEST(HttpParserTest, IncrementalAndPipelined) {
+    std::string raw = "GET /health HTTP/1.1\r\nHost: a\r\n\r\n"
+                      "POST /x HTTP/1.0\r\nContent-Length: 3\r\n\r\nabc";
+    HttpParser parser;
+    HttpRequest request;
+    size_t consumed = 0;
+
+    // 逐字节送入，直到第一个请求完整
+    size_t fed = 1;
+    ParseStatus status = ParseStatus::kNeedMore;
+    for (; fed <= raw.size(); ++fed) {
+        status = parser.parse(raw.data(), fed, request, consumed);
+        if (status != ParseStatus::kNeedMore) {
+            break;
+        }
+    }
+    ASSERT_EQ(status, ParseStatus::kComplete);
+    EXPECT_EQ(request.path, "/health");
+    EXPECT_EQ(consumed, fed);
+
+    // 第二个请求：头部完整但消息体不完整
+    std::string rest = raw.substr(consumed);
+    ASSERT_EQ(parser.parse(rest.data(), rest.size() - 1, request, consumed), ParseStatus::kNeedMore);
+    // 模拟缓冲区搬移后再次解析
+    std::string moved = rest;
+    ASSERT_EQ(parser.parse(moved.data(), moved.size(), request, consumed), ParseStatus::kComplete);
+    EXPECT_EQ(request.path, "/x");
+    EXPECT_EQ(request.body, "abc");
+    EXPECT_EQ(request.body.data(), moved.data() + moved.size() - 3);
+    EXPECT_FALSE(request.keep_alive);  // HTTP/1.0默认短连接
+}
+
+TEST(HttpParserTest, RejectsInvalidRequests) {
+    HttpParser parser;
+    HttpRequest request;
+    size_t consumed = 0;
+
+    std::string bad = "GARBAGE\r\n\r\n";
+    EXPECT_EQ(parser.parse(bad.data(), bad.size(), request, consumed), ParseStatus::kBadRequest);
+
+    parser.reset();
+    std::string chunked = "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n";
+    EXPECT_EQ(parser.parse(chunked.data(), chunked.size(), request, consumed), ParseStatus::kNotImplemented);
+
+    parser.reset();
+    std::string huge = "POST / HTTP/1.1\r\nContent-Length: 99999999\r\n\r\n";
+    EXPECT_EQ(parser.parse(huge.data(), huge.size(), request, consumed), ParseStatus::kBodyTooLarge);
+
+    parser.reset();
+    std::string endless = "GET / HTTP/1.1\r\nX: " + std::string(HttpParser::kMaxHeaderSize, 'a');
+    EXPECT_EQ(parser.parse(endless.data(), endless.size(), request, consumed), ParseStatus::kHeadersTooLarge);
+}
+
+TEST(HttpRouterTest, PrefixTreeMatching) {
+    HttpRouter router;
+    std::string hit;
+    auto record = [&hit](const std::string& name) {
+        return [&hit, name](const HttpRequest&, const RouteParams&, HttpResponse&) { hit = name; };
+    };
+    ASSERT_TRUE(router.addRoute(Method::kGet, "/api/v1/orders/:id", record("get")));
+    ASSERT_TRUE(router.addRoute(Method::kPost, "/api/v1/orders/:id/cancel", record("cancel")));
+    ASSERT_TRUE(router.addRoute(Method::kGet, "/api/v1/orders/stats", record("stats")));
+    ASSERT_TRUE(router.addRoute(Method::kGet, "/static/*file", record("static")));
+    EXPECT_FALSE(router.addRoute(Method::kGet, "/api/v1/orders/:order_id", record("dup")));
+    EXPECT_FALSE(router.addRoute(Method::kGet, "/api/v1/orders/stats", record("dup")));
+
+    const HttpRouter::Handler* handler = nullptr;
+    RouteParams params;
+    HttpRequest request;
+    std::string out;
+    HttpResponse response(out, nullptr, true, false);
+
+    ASSERT_EQ(router.match(Method::kGet, "/api/v1/orders/123", handler, params), HttpRouter::MatchResult::kMatched);
+    EXPECT_EQ(params.get("id"), "123");
+    (*handler)(request, params, response);
+    EXPECT_EQ(hit, "get");
+
+    // 静态段优先于参数段
+    ASSERT_EQ(router.match(Method::kGet, "/api/v1/orders/stats", handler, params), HttpRouter::MatchResult::kMatched);
+    (*handler)(request, params, response);
+    EXPECT_EQ(hit, "stats");
+    EXPECT_EQ(params.size(), 0u);
+
+    ASSERT_EQ(router.match(Method::kPost, "/api/v1/orders/7/cancel", handler, params), HttpRouter::MatchResult::kMatched);
+    EXPECT_EQ(params.get("id"), "7");
+
+    ASSERT_EQ(router.match(Method::kHead, "/static/css/site.css", handler, params), HttpRouter::MatchResult::kMatched);
+    EXPECT_EQ(params.get("file"), "css/site.css");
+
+    EXPECT_EQ(router.match(Method::kDelete, "/api/v1/orders/1", handler, params),
+              HttpRouter::MatchResult::kMethodNotAllowed);
+    EXPECT_EQ(router.match(Method::kGet, "/api/v2/orders/1", handler, params),
+              HttpRouter::MatchResult::kNotFound);
+}
+
+TEST(HttpResponseTest, ChunkedEncoding) {
+    std::string out;
+    HttpResponse response(out, nullptr, false, false);
+    response.beginChunked("text/plain");
+    response.writeChunk("hello ");
+    response.writeChunk("");
+    response.writeChunk("world");
+    response.endChunked();
+    EXPECT_TRUE(response.isFinished());
+    EXPECT_EQ(out, "HTTP/1.1 200 OK\r\n"
+                   "Content-Type: text/plain\r\n"
+                   "Connection: close\r\n"
+                   "Transfer-Encoding: chunked\r\n\r\n"
+                   "6\r\nhello \r\n5\r\nworld\r\n0\r\n\r\n");
+}
+
+class HttpServerTest : public ::testing::Test {
+protected:
+    static constexpr uint16_t kPort = 18089;
+
+    void SetUp() override {
+        server_ = std::make_unique<HttpServer>("127.0.0.1", kPort, 2);
+        server_->router().addRoute(Method::kGet, "/health",
+            [](const HttpRequest&, const RouteParams&, HttpResponse& response) {
+                response.send("ok");
+            });
+        server_->router().addRoute(Method::kGet, "/orders/:id",
+            [](const HttpRequest&, const RouteParams& params, HttpResponse& response) {
+                response.beginChunked("application/json");
+                response.writeChunk("{\"id\":");
+                response.writeChunk(params.get("id"));
+                response.writeChunk("}");
+                response.endChunked();
+            });
+        ASSERT_TRUE(server_->start());
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    void TearDown() override {
+        server_->stop();
+    }
+
+    int connect() {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(kPort);
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        if (::connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    // 读到对端关闭为止
+    std::string readAll(int fd) {
+        std::string result;
+        char buf[4096];
+        ssize_t n;
+        while ((n = ::read(fd, buf, sizeof(buf))) > 0) {
+            result.append(buf, n);
+        }
+        return result;
+    }
+
+    std::unique_ptr<HttpServer> server_;
+};
+
+TEST_F(HttpServerTest, PipelinedKeepAliveRequests) {
+    int fd = connect();
+    ASSERT_GE(fd, 0);
+
+    // 三个请求一次发出，最后一个要求关闭连接
+    std::string requests = "GET /health HTTP/1.1\r\nHost: t\r\n\r\n"
+                           "GET /orders/42 HTTP/1.1\r\nHost: t\r\n\r\n"
+                           "GET /missing HTTP/1.1\r\nConnection: close\r\n\r\n";
+    ASSERT_EQ(::write(fd, requests.data(), requests.size()), static_cast<ssize_t>(requests.size()));
+
+    std::string responses = readAll(fd);
+    ::close(fd);
+
+    size_t first = responses.find("HTTP/1.1 200 OK");
+    size_t second = responses.find("Transfer-Encoding: chunked");
+    size_t third = responses.find("HTTP/1.1 404 Not Found");
+    ASSERT_NE(first, std::string::npos);
+    ASSERT_NE(second, std::string::npos);
+    ASSERT_NE(third, std::string::npos);
+    EXPECT_LT(first, second);
+    EXPECT_LT(second, third);
+    EXPECT_NE(responses.find("{\"id\":\r\n2\r\n42\r\n1\r\n}"), std::string::npos);
+    EXPECT_EQ(server_->getRequestCount(), 3u);
+}
+
+TEST_F(HttpServerTest, MalformedRequestClosesConnection) {
+    int fd = connect();
+    ASSERT_GE(fd, 0);
+    std::string request = "NOT-HTTP\r\n\r\n";
+    ASSERT_EQ(::write(fd, request.data(), request.size()), static_cast<ssize_t>(request.size()));
+    std::string response = readAll(fd);
+    ::close(fd);
+    EXPECT_EQ(response.rfind("HTTP/1.1 400 Bad Request", 0), 0u);
+}
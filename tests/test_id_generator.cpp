@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "utils/id_generator.h"
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <thread>
+#include <vector>
+
+using order_engine::utils::IdGenerator;
+
+namespace {
+// 2026-10-18 12:00:00.123 UTC
+constexpr uint64_t kNoonMs = 1792324800123ULL;
+}
+
+TEST(IdGeneratorTest, LayoutAndBlocks) {
+    IdGenerator generator(17);
+    uint64_t first = generator.nextBlock(3, kNoonMs);
+    EXPECT_EQ(IdGenerator::timestampMs(first), kNoonMs);
+    EXPECT_EQ(IdGenerator::nodeOf(first), 17);
+    EXPECT_EQ(IdGenerator::sequenceOf(first), 0u);
+
+    // 同一毫秒内接着分配
+    uint64_t next = generator.nextBlock(1, kNoonMs);
+    EXPECT_EQ(next, first + 3);
+
+    // 放不下整段时进入下一毫秒，段内仍然连续
+    uint64_t block = generator.nextBlock(IdGenerator::kMaxBlockSize, kNoonMs);
+    EXPECT_EQ(IdGenerator::timestampMs(block), kNoonMs + 1);
+    EXPECT_EQ(IdGenerator::sequenceOf(block), 0u);
+    EXPECT_EQ(IdGenerator::sequenceOf(block + IdGenerator::kMaxBlockSize - 1), IdGenerator::kMaxSequence);
+    EXPECT_EQ(generator.borrowCount(), 1u);
+}
+
+TEST(IdGeneratorTest, ClockRegressionKeepsIdsIncreasing) {
+    IdGenerator generator(1);
+    uint64_t before = generator.nextId();
+    before = std::max(before, generator.nextBlock(1, kNoonMs));
+
+    // 时钟回拨10秒：继续沿用之前的时间戳
+    uint64_t after = generator.nextBlock(1, kNoonMs - 10000);
+    EXPECT_GT(after, before);
+    EXPECT_GE(IdGenerator::timestampMs(after), IdGenerator::timestampMs(before));
+    EXPECT_GE(generator.borrowCount(), 1u);
+
+    // 时钟追上之后回到真实时间
+    uint64_t later = generator.nextBlock(1, IdGenerator::timestampMs(after) + 5);
+    EXPECT_EQ(IdGenerator::timestampMs(later), IdGenerator::timestampMs(after) + 5);
+    EXPECT_EQ(IdGenerator::sequenceOf(later), 0u);
+}
+
+TEST(IdGeneratorTest, AdvancePastRecoveredId) {
+    // 上次运行借用到了10秒之后的时间戳
+    IdGenerator previous(3);
+    uint64_t recovered = previous.nextBlock(5, kNoonMs + 10000);
+
+    IdGenerator generator(3);
+    generator.advancePast(recovered);
+    uint64_t next = generator.nextBlock(1, kNoonMs);
+    EXPECT_GT(next, recovered);
+    EXPECT_EQ(IdGenerator::timestampMs(next), kNoonMs + 10000);
+    EXPECT_EQ(IdGenerator::sequenceOf(next), IdGenerator::sequenceOf(recovered) + 1);
+
+    // 较小的ID不会让生成器后退
+    generator.advancePast(recovered - 100);
+    EXPECT_GT(generator.nextBlock(1, kNoonMs), next);
+}
+
+TEST(IdGeneratorTest, ConcurrentIdsAreUniqueAndMonotonicPerThread) {
+    IdGenerator generator(3);
+    const int kThreads = 8;
+    const int kPerThread = 20000;
+    std::vector<std::vector<uint64_t>> ids(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&generator, &ids, t]() {
+            ids[t].reserve(kPerThread);
+            for (int i = 0; i < kPerThread; ++i) {
+                ids[t].push_back(generator.nextId());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<uint64_t> all;
+    for (const auto& thread_ids : ids) {
+        EXPECT_TRUE(std::is_sorted(thread_ids.begin(), thread_ids.end()));
+        all.insert(all.end(), thread_ids.begin(), thread_ids.end());
+    }
+    std::sort(all.begin(), all.end());
+    EXPECT_EQ(std::adjacent_find(all.begin(), all.end()), all.end());
+}
+
+TEST(IdGeneratorTest, FormatsOrderNumber) {
+    IdGenerator generator(42);
+    uint64_t id = generator.nextBlock(1, kNoonMs);
+    id = generator.nextBlock(1, kNoonMs);
+
+    char buffer[IdGenerator::kOrderNumberLength];
+    ASSERT_EQ(generator.formatOrderNumber(id, buffer), IdGenerator::kOrderNumberLength);
+    std::string number(buffer, IdGenerator::kOrderNumberLength);
+
+    // 日期和当日毫秒按本地时区
+    time_t seconds = static_cast<time_t>(kNoonMs / 1000);
+    struct tm local;
+    localtime_r(&seconds, &local);
+    // 按各字段最大宽度留足空间：3 + 4×11 + 8 + 1
+    char expected[64];
+    std::snprintf(expected, sizeof(expected), "ORD%04d%02d%02d%08d00420001",
+                  local.tm_year + 1900, local.tm_mon + 1, local.tm_mday,
+                  (local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec) * 1000 + 123);
+    EXPECT_EQ(number, expected);
+}
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include "services/idempotency_cache.h"
+#include <iostream>
+#include <vector>
+
+using order_engine::services::IdempotencyCache;
+using order_engine::services::IdempotencyOptions;
+
+namespace {
+
+using Begin = IdempotencyCache::BeginResult;
+
+} // namespace
+
+TEST(IdempotencyCacheTest, ReturnsOriginalResultForRepeatKey) {
+    IdempotencyCache cache;
+    uint64_t key = IdempotencyCache::makeKey(1, "req-1");
+    EXPECT_NE(key, IdempotencyCache::makeKey(2, "req-1"));
+    EXPECT_NE(key, IdempotencyCache::makeKey(1, "req-2"));
+
+    uint64_t order_id = 0;
+    EXPECT_EQ(cache.begin(key, 1000, order_id), Begin::kNew);
+    cache.complete(key, true, 42, 1000);
+    EXPECT_EQ(cache.begin(key, 1001, order_id), Begin::kDone);
+    EXPECT_EQ(order_id, 42u);
+    EXPECT_EQ(cache.stats().hits, 1u);
+}
+
+TEST(IdempotencyCacheTest, AttachesRetriesToInFlightRequest) {
+    IdempotencyCache cache;
+    uint64_t key = IdempotencyCache::makeKey(1, "req-1");
+    uint64_t order_id = 0;
+    ASSERT_EQ(cache.begin(key, 1000, order_id), Begin::kNew);
+
+    // 执行期间的重试不等待，挂到首个请求上
+    std::vector<uint64_t> answered;
+    auto waiter = [&answered](bool success, uint64_t id) {
+        EXPECT_TRUE(success);
+        answered.push_back(id);
+    };
+    EXPECT_EQ(cache.begin(key, 1000, order_id, waiter), Begin::kInProgress);
+    EXPECT_EQ(cache.begin(key, 1001, order_id, waiter), Begin::kInProgress);
+    EXPECT_EQ(cache.stats().in_progress, 2u);
+    EXPECT_TRUE(answered.empty());
+
+    cache.complete(key, true, 7, 1002);
+    EXPECT_EQ(answered, (std::vector<uint64_t>{7, 7}));
+    EXPECT_EQ(cache.begin(key, 1003, order_id), Begin::kDone);
+    EXPECT_EQ(order_id, 7u);
+
+    // 首个请求失败：挂起的重试一并失败，之后的重试重新执行
+    uint64_t key2 = IdempotencyCache::makeKey(1, "req-2");
+    ASSERT_EQ(cache.begin(key2, 1000, order_id), Begin::kNew);
+    int failed = 0;
+    EXPECT_EQ(cache.begin(key2, 1000, order_id, [&failed](bool success, uint64_t) { failed += !success; }),
+              Begin::kInProgress);
+    cache.complete(key2, false, 0, 1000);
+    EXPECT_EQ(failed, 1);
+    EXPECT_EQ(cache.begin(key2, 1001, order_id), Begin::kNew);
+}
+
+TEST(IdempotencyCacheTest, FailsWaitersWhenInFlightKeyExpires) {
+    IdempotencyOptions options;
+    options.ttl_seconds = 60;
+    options.shards = 1;
+    IdempotencyCache cache(options);
+    uint64_t key = IdempotencyCache::makeKey(1, "stuck");
+    uint64_t order_id = 0;
+    ASSERT_EQ(cache.begin(key, 1000, order_id), Begin::kNew);
+    int failed = 0;
+    EXPECT_EQ(cache.begin(key, 1000, order_id, [&failed](bool success, uint64_t) { failed += !success; }),
+              Begin::kInProgress);
+    // 首个请求一直未完成：键过期时挂起的重试以失败结束，不会永远挂着
+    EXPECT_EQ(cache.begin(IdempotencyCache::makeKey(2, "req"), 1060, order_id), Begin::kNew);
+    EXPECT_EQ(failed, 1);
+}
+
+TEST(IdempotencyCacheTest, ForgetsFailedRequests) {
+    IdempotencyCache cache;
+    uint64_t key = IdempotencyCache::makeKey(1, "req-1");
+    uint64_t order_id = 0;
+    ASSERT_EQ(cache.begin(key, 1000, order_id), Begin::kNew);
+    cache.complete(key, false, 0, 1000);
+    EXPECT_EQ(cache.stats().keys, 0u);
+    EXPECT_EQ(cache.begin(key, 1001, order_id), Begin::kNew);
+}
+
+TEST(IdempotencyCacheTest, ExpiresAfterTtl) {
+    IdempotencyOptions options;
+    options.ttl_seconds = 60;
+    IdempotencyCache cache(options);
+    uint64_t key = IdempotencyCache::makeKey(1, "req-1");
+    uint64_t order_id = 0;
+    ASSERT_EQ(cache.begin(key, 1000, order_id), Begin::kNew);
+    cache.complete(key, true, 42, 1000);
+
+    EXPECT_EQ(cache.begin(key, 1059, order_id), Begin::kDone);
+    EXPECT_EQ(cache.begin(key, 1060, order_id), Begin::kNew);
+    EXPECT_EQ(cache.stats().keys, 1u);
+}
+
+TEST(IdempotencyCacheTest, EvictsOldestKeysAtCapacity) {
+    IdempotencyOptions options;
+    options.capacity = 100;
+    options.shards = 1;
+    IdempotencyCache cache(options);
+    uint64_t order_id = 0;
+    for (uint64_t user = 1; user <= 150; ++user) {
+        uint64_t key = IdempotencyCache::makeKey(user, "req");
+        ASSERT_EQ(cache.begin(key, 1000, order_id), Begin::kNew);
+        cache.complete(key, true, user, 1000);
+    }
+    // 淘汰在下次登记时进行
+    cache.begin(IdempotencyCache::makeKey(1000, "req"), 1000, order_id);
+    EXPECT_LE(cache.stats().keys, 101u);
+    EXPECT_GE(cache.stats().evicted, 49u);
+    EXPECT_EQ(cache.begin(IdempotencyCache::makeKey(150, "req"), 1000, order_id), Begin::kDone);
+    EXPECT_EQ(cache.begin(IdempotencyCache::makeKey(1, "req"), 1000, order_id), Begin::kNew);
+}
+
+TEST(IdempotencyCacheTest, EvictsPastInFlightKeysAtCapacity) {
+    IdempotencyOptions options;
+    options.capacity = 10;
+    options.shards = 1;
+    IdempotencyCache cache(options);
+    uint64_t order_id = 0;
+    // 最早的两个键一直未完成，不能挡住后面已完成键的淘汰
+    uint64_t stuck1 = IdempotencyCache::makeKey(1, "stuck");
+    uint64_t stuck2 = IdempotencyCache::makeKey(2, "stuck");
+    ASSERT_EQ(cache.begin(stuck1, 1000, order_id), Begin::kNew);
+    ASSERT_EQ(cache.begin(stuck2, 1000, order_id), Begin::kNew);
+    for (uint64_t user = 1; user <= 100; ++user) {
+        uint64_t key = IdempotencyCache::makeKey(user, "req");
+        ASSERT_EQ(cache.begin(key, 1000, order_id), Begin::kNew);
+        cache.complete(key, true, user, 1000);
+    }
+    EXPECT_LE(cache.stats().keys, 11u);
+    EXPECT_GE(cache.stats().evicted, 90u);
+    EXPECT_EQ(cache.begin(stuck1, 1000, order_id), Begin::kInProgress);
+    EXPECT_EQ(cache.begin(stuck2, 1000, order_id), Begin::kInProgress);
+    EXPECT_EQ(cache.begin(IdempotencyCache::makeKey(100, "req"), 1000, order_id), Begin::kDone);
+}
+
+TEST(IdempotencyCacheTest, MeasuresBytesPerKey) {
+    IdempotencyCache cache;
+    constexpr uint64_t kKeys = 100000;
+    uint64_t order_id = 0;
+    for (uint64_t i = 1; i <= kKeys; ++i) {
+        uint64_t key = IdempotencyCache::makeKey(i, "9b1deb4d-3b7d-4bad-9bdd-2b0d7b3dcb6d");
+        cache.begin(key, 1000, order_id);
+        cache.complete(key, true, i, 1000);
+    }
+    auto stats = cache.stats();
+    EXPECT_EQ(stats.keys, kKeys);
+    double per_key = static_cast<double>(stats.memory_bytes) / kKeys;
+    std::cout << "idempotency key: " << per_key << " bytes" << std::endl;
+    EXPECT_LT(per_key, 96.0);
+}
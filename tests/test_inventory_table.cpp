@@ -0,0 +1,321 @@
+#include <gtest/gtest.h>
+#include "services/inventory_table.h"
+#include "services/inventory_service.h"
+#include <thread>
+
+using namespace order_engine::services;
+
+TEST(InventoryTableTest, ReserveReleaseCommitKeepTotalsConsistent) {
+    InventoryTable table(16);
+    EXPECT_FALSE(table.hasAvailable(1001, 0));
+    EXPECT_FALSE(table.reserve(1001, 1));
+
+    ASSERT_TRUE(table.add(1001, 10));
+    EXPECT_TRUE(table.hasAvailable(1001, 10));
+    EXPECT_FALSE(table.hasAvailable(1001, 11));
+    EXPECT_TRUE(table.reserve(1001, 4));
+    EXPECT_FALSE(table.reserve(1001, 7));
+    table.commit(1001, 3);
+    table.release(1001, 1);
+
+    InventoryInfo info{};
+    ASSERT_TRUE(table.get(1001, info));
+    EXPECT_EQ(info.total_stock, 10u);
+    EXPECT_EQ(info.available_stock, 7u);
+    EXPECT_EQ(info.reserved_stock, 0u);
+    EXPECT_EQ(info.sold_stock, 3u);
+    EXPECT_EQ(info.version, 4u);
+    EXPECT_GT(info.updated_at, 0);
+
+    // 乐观锁：可用库存和版本号都匹配才更新
+    EXPECT_FALSE(table.compareAndSwap(1001, 7, 20, info.version + 1));
+    EXPECT_FALSE(table.compareAndSwap(1001, 6, 20, info.version));
+    EXPECT_TRUE(table.compareAndSwap(1001, 7, 20, info.version));
+    ASSERT_TRUE(table.get(1001, info));
+    EXPECT_EQ(info.available_stock, 20u);
+}
+
+TEST(InventoryTableTest, RejectsOverflowAndFullTable) {
+    InventoryTable table(3);
+    EXPECT_EQ(table.capacity(), 3u);
+    EXPECT_FALSE(table.add(0, 1));
+    ASSERT_TRUE(table.add(1, InventoryTable::kMaxStock - 5));
+    ASSERT_TRUE(table.reserve(1, 5));
+    // 可用与预留之和不能超过上限
+    EXPECT_FALSE(table.add(1, 6));
+    EXPECT_TRUE(table.add(1, 5));
+
+    EXPECT_TRUE(table.add(2, 1));
+    EXPECT_TRUE(table.add(3, 1));
+    EXPECT_FALSE(table.add(4, 1));
+    EXPECT_EQ(table.size(), 3u);
+    EXPECT_TRUE(table.add(3, 1));
+}
+
+TEST(InventoryTableTest, ConcurrentReservationsNeverOversell) {
+    InventoryTable table(1024);
+    constexpr uint32_t kStock = 20000;
+    for (uint64_t product_id = 1; product_id <= 4; ++product_id) {
+        ASSERT_TRUE(table.add(product_id, kStock));
+    }
+
+    constexpr int kThreads = 8;
+    std::vector<std::thread> threads;
+    std::vector<uint64_t> reserved(kThreads, 0);
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&table, &reserved, t] {
+            for (int i = 0; i < 10000; ++i) {
+                uint64_t product_id = static_cast<uint64_t>(i % 4) + 1;
+                if (table.reserve(product_id, 1)) {
+                    ++reserved[t];
+                    // 每10个退回一个
+                    if (i % 10 == 0) {
+                        table.release(product_id, 1);
+                        --reserved[t];
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    uint64_t total = 0;
+    for (uint64_t count : reserved) {
+        total += count;
+    }
+    uint64_t held = 0;
+    for (uint64_t product_id = 1; product_id <= 4; ++product_id) {
+        InventoryInfo info{};
+        ASSERT_TRUE(table.get(product_id, info));
+        EXPECT_EQ(info.available_stock + info.reserved_stock, kStock);
+        held += info.reserved_stock;
+    }
+    EXPECT_EQ(held, total);
+    EXPECT_LE(total, 4u * kStock);
+}
+
+TEST(InventoryTableTest, ServiceRollsBackPartialReservations) {
+    InventoryService inventory;
+    inventory.addStock(1, 5, [](bool success, const std::string&) { EXPECT_TRUE(success); });
+    inventory.addStock(2, 1, [](bool success, const std::string&) { EXPECT_TRUE(success); });
+
+    bool reserved = true;
+    inventory.reserveStock({1, 2, 2}, {3, 1, 1}, "order-1", 60,
+                           [&reserved](bool success, const std::string&) { reserved = success; });
+    EXPECT_FALSE(reserved);
+    EXPECT_TRUE(inventory.checkStock(1, 5));
+    EXPECT_TRUE(inventory.checkStock(2, 1));
+    EXPECT_FALSE(inventory.checkStock(3, 0));
+
+    std::string reservation_id;
+    inventory.reserveStock({1, 2}, {3, 1}, "order-2", 60,
+                           [&reservation_id](bool success, const std::string& message) {
+                               ASSERT_TRUE(success);
+                               reservation_id = message;
+                           });
+    EXPECT_FALSE(inventory.checkStock(2, 1));
+    inventory.confirmReservation(reservation_id, [](bool success, const std::string&) { EXPECT_TRUE(success); });
+    inventory.getInventory(1, [](bool success, const InventoryInfo& info) {
+        ASSERT_TRUE(success);
+        EXPECT_EQ(info.available_stock, 2u);
+        EXPECT_EQ(info.reserved_stock, 0u);
+        EXPECT_EQ(info.sold_stock, 3u);
+    });
+}
+
+TEST(InventoryTableTest, ServiceExpiresReservationsFromWheel) {
+    InventoryService inventory;
+    inventory.addStock(1, 10, [](bool success, const std::string&) { EXPECT_TRUE(success); });
+    time_t now = time(nullptr);
+
+    // 预留分布在多个分片上：10秒、100秒和不过期
+    std::vector<std::string> ids;
+    auto reserve = [&inventory, &ids](int timeout) {
+        inventory.reserveStock({1}, {1}, "order", timeout, [&ids](bool success, const std::string& message) {
+            ASSERT_TRUE(success);
+            ids.push_back(message);
+        });
+    };
+    for (int i = 0; i < 4; ++i) {
+        reserve(10);
+    }
+    reserve(100);
+    reserve(-1);
+    EXPECT_TRUE(inventory.checkStock(1, 4));
+    EXPECT_FALSE(inventory.checkStock(1, 5));
+
+    // 已确认的预留到期时在时间轮中惰性跳过
+    inventory.confirmReservation(ids[0], [](bool success, const std::string&) { EXPECT_TRUE(success); });
+    EXPECT_EQ(inventory.expireReservations(now + 9), 0u);
+    EXPECT_EQ(inventory.expireReservations(now + 11), 3u);
+    EXPECT_TRUE(inventory.checkStock(1, 7));
+    EXPECT_EQ(inventory.expireReservations(now + 86400 * 365), 1u);
+    EXPECT_TRUE(inventory.checkStock(1, 8));
+    inventory.releaseReservation(ids[1], [](bool success, const std::string&) { EXPECT_FALSE(success); });
+
+    // 序号相同但时间不同的ID（重启前分配的）不会取到现有预留
+    std::string stale = "RSV1-" + ids[5].substr(ids[5].rfind('-') + 1);
+    inventory.releaseReservation(stale, [](bool success, const std::string&) { EXPECT_FALSE(success); });
+    inventory.releaseReservation("RSV1-x", [](bool success, const std::string&) { EXPECT_FALSE(success); });
+    inventory.releaseReservation(ids[5], [](bool success, const std::string&) { EXPECT_TRUE(success); });
+    EXPECT_TRUE(inventory.checkStock(1, 9));
+}
+
+TEST(InventoryTableTest, HotStockGathersFragmentedBucketsBeforeSellingOut) {
+    InventoryTable table(16, 4);
+    ASSERT_TRUE(table.add(7, 8));
+    ASSERT_TRUE(table.reserve(7, 1));
+    EXPECT_FALSE(table.enableHot(8));
+    ASSERT_TRUE(table.enableHot(7));
+    EXPECT_TRUE(table.isHot(7));
+    EXPECT_EQ(table.hotCount(), 1u);
+
+    // 7个分到4个桶，本地桶不够时收回其他桶
+    EXPECT_TRUE(table.reserve(7, 5));
+    EXPECT_GE(table.hotRebalances(), 1u);
+    EXPECT_TRUE(table.hasAvailable(7, 2));
+    EXPECT_FALSE(table.reserve(7, 3));
+    EXPECT_TRUE(table.reserve(7, 2));
+    EXPECT_FALSE(table.hasAvailable(7, 1));
+    EXPECT_FALSE(table.reserve(7, 1));
+
+    // 启用前的预留在热点模式下确认、退回，合计仍然准确
+    table.commit(7, 1);
+    table.release(7, 2);
+    EXPECT_FALSE(table.compareAndSwap(7, 2, 100, 0));
+    EXPECT_TRUE(table.add(7, 3));
+    InventoryInfo info{};
+    ASSERT_TRUE(table.get(7, info));
+    EXPECT_EQ(info.total_stock, 11u);
+    EXPECT_EQ(info.available_stock, 5u);
+    EXPECT_EQ(info.reserved_stock, 5u);
+    EXPECT_EQ(info.sold_stock, 1u);
+}
+
+TEST(InventoryTableTest, HotStockFailsFastAfterSellingOut) {
+    InventoryTable table(16, 4);
+    ASSERT_TRUE(table.add(7, 8));
+    ASSERT_TRUE(table.enableHot(7));
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(table.reserve(7, 1));
+    }
+
+    // 售罄后的预留不加锁收回各桶
+    uint64_t rebalances = table.hotRebalances();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&table] {
+            for (int i = 0; i < 1000; ++i) {
+                EXPECT_FALSE(table.reserve(7, 1));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(table.hotRebalances(), rebalances);
+
+    // 退回的库存落在其他桶时，合计足够仍走加锁收回
+    std::thread([&table] { table.release(7, 2); }).join();
+    EXPECT_TRUE(table.reserve(7, 2));
+    EXPECT_FALSE(table.reserve(7, 1));
+}
+
+TEST(InventoryTableTest, HotStockSellsExactlyAllUnitsUnderContention) {
+    InventoryTable table(16, 8);
+    constexpr uint32_t kStock = 5000;
+    ASSERT_TRUE(table.add(42, kStock));
+    ASSERT_TRUE(table.enableHot(42));
+
+    constexpr int kThreads = 8;
+    std::vector<std::thread> threads;
+    std::vector<uint64_t> reserved(kThreads, 0);
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&table, &reserved, t] {
+            // 售罄后仍继续请求，验证不超卖
+            for (int i = 0; i < 2000; ++i) {
+                if (table.reserve(42, 1)) {
+                    ++reserved[t];
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    uint64_t total = 0;
+    for (uint64_t count : reserved) {
+        total += count;
+    }
+    EXPECT_EQ(total, kStock);
+    InventoryInfo info{};
+    ASSERT_TRUE(table.get(42, info));
+    EXPECT_EQ(info.available_stock, 0u);
+    EXPECT_EQ(info.reserved_stock, kStock);
+}
+
+TEST(InventoryTableTest, EnablesHotStockAtContentionThreshold) {
+    InventoryTable table(16, 4);
+    table.setHotThreshold(10);
+    ASSERT_TRUE(table.add(9, 1000));
+    ASSERT_TRUE(table.add(10, 100));
+    ASSERT_TRUE(table.reserve(9, 30));
+
+    // 按秒计数，换秒后重新累计
+    table.noteContention(9, 6, 1000);
+    table.noteContention(9, 6, 1001);
+    table.noteContention(10, 9, 1001);
+    EXPECT_FALSE(table.isHot(9));
+    EXPECT_FALSE(table.isHot(10));
+    table.noteContention(9, 4, 1001);
+    EXPECT_TRUE(table.isHot(9));
+    EXPECT_EQ(table.hotCount(), 1u);
+
+    // 阈值为0时不再自动启用
+    table.setHotThreshold(0);
+    ASSERT_TRUE(table.add(11, 1));
+    table.noteContention(11, 100, 1001);
+    EXPECT_FALSE(table.isHot(11));
+    table.setHotThreshold(10);
+
+    // 启用前后的预留、退回、确认合计准确，超出预留的退回和确认被截断
+    ASSERT_TRUE(table.reserve(9, 20));
+    table.commit(9, 15);
+    table.release(9, 30);
+    table.commit(9, 10);
+    table.release(9, 5);
+    InventoryInfo info{};
+    ASSERT_TRUE(table.get(9, info));
+    EXPECT_EQ(info.total_stock, 1000u);
+    EXPECT_EQ(info.reserved_stock, 0u);
+    EXPECT_EQ(info.sold_stock, 20u);
+    EXPECT_EQ(info.available_stock, 980u);
+    EXPECT_TRUE(table.reserve(9, 980));
+    EXPECT_FALSE(table.reserve(9, 1));
+}
+
+TEST(InventoryTableTest, EnablesHotStockOnContention) {
+    if (std::thread::hardware_concurrency() < 2) {
+        GTEST_SKIP() << "needs at least two cores to produce CAS contention";
+    }
+    InventoryTable table(16);
+    table.setHotThreshold(1);
+    ASSERT_TRUE(table.add(9, InventoryTable::kMaxStock));
+    ASSERT_TRUE(table.add(10, 100));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&table] {
+            for (int i = 0; i < 200000 && !table.isHot(9); ++i) {
+                table.reserve(9, 1);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_TRUE(table.isHot(9));
+    EXPECT_FALSE(table.isHot(10));
+}
@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+#include "utils/json_utils.h"
+#include "http/http_response.h"
+#include <random>
+
+using namespace order_engine;
+using namespace order_engine::utils;
+
+namespace {
+
+// 逐字节状态机给出的结构字符位置，作为SIMD扫描的参照
+std::vector<uint32_t> referenceStructurals(std::string_view json) {
+    std::vector<uint32_t> result;
+    bool in_string = false;
+    bool escaped = false;
+    bool prev_scalar = false;
+    for (uint32_t i = 0; i < json.size(); ++i) {
+        char c = json[i];
+        if (in_string) {
+            if (escaped) {
+                escaped = false;
+            } else if (c == '\\') {
+                escaped = true;
+            } else if (c == '"') {
+                in_string = false;
+            }
+            prev_scalar = true;
+            continue;
+        }
+        bool op = c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',';
+        bool ws = c == ' ' || c == '\t' || c == '\n' || c == '\r';
+        bool scalar = !op && !ws;
+        if (op || (scalar && !prev_scalar)) {
+            result.push_back(i);
+        }
+        if (c == '"') {
+            in_string = true;
+        }
+        prev_scalar = scalar;
+    }
+    return result;
+}
+
+std::string randomDocument(std::mt19937& rng) {
+    static const char* kFragments[] = {
+        "\"a\\\\\"", "\"\\\"{[\"", "\"\\\\\\\\\\\"x\"", "123", "-4.5e3", "true", "null",
+        "\"plain text\"", "\"\\u4e2d\\u6587\"", " ", "\n", "\"\\\\\"",
+    };
+    std::uniform_int_distribution<size_t> pick(0, sizeof(kFragments) / sizeof(kFragments[0]) - 1);
+    std::uniform_int_distribution<int> count(20, 120);
+    std::string doc = "[";
+    int n = count(rng);
+    for (int i = 0; i < n; ++i) {
+        if (i > 0) {
+            doc += ",";
+        }
+        doc += "{\"k\":";
+        doc += kFragments[pick(rng)];
+        doc += "}";
+    }
+    doc += "]";
+    return doc;
+}
+
+} // namespace
+
+TEST(JsonParserTest, StructuralIndexMatchesReference) {
+    std::mt19937 rng(42);
+    JsonParser scalar(false);
+    JsonParser simd(true);
+    for (int round = 0; round < 200; ++round) {
+        std::string doc = randomDocument(rng);
+        std::vector<uint32_t> expected = referenceStructurals(doc);
+
+        ASSERT_TRUE(scalar.parse(doc)) << scalar.error() << "\n" << doc;
+        EXPECT_FALSE(scalar.usedSimd());
+        EXPECT_EQ(scalar.structurals(), expected) << doc;
+
+        ASSERT_TRUE(simd.parse(doc)) << simd.error();
+        EXPECT_EQ(simd.usedSimd(), JsonParser::simdSupported());
+        EXPECT_EQ(simd.structurals(), expected) << doc;
+    }
+}
+
+TEST(JsonParserTest, OnDemandAccess) {
+    std::string doc = R"({"skip":{"deep":[1,[2,{"x":3}]]},"name":"a\"b\\cé","n":-12,)"
+                      R"("f":2.5,"ok":true,"none":null,"list":[10,20,30]})";
+    JsonParser parser;
+    ASSERT_TRUE(parser.parse(doc)) << parser.error();
+    JsonValue root = parser.root();
+    ASSERT_EQ(root.type(), JsonType::kObject);
+
+    std::string name;
+    ASSERT_TRUE(root["name"].getString(name));
+    EXPECT_EQ(name, "a\"b\\c\xC3\xA9");
+
+    int64_t n = 0;
+    EXPECT_TRUE(root["n"].getInt64(n));
+    EXPECT_EQ(n, -12);
+    uint64_t u = 0;
+    EXPECT_FALSE(root["n"].getUint64(u));
+    double f = 0;
+    EXPECT_TRUE(root["f"].getDouble(f));
+    EXPECT_DOUBLE_EQ(f, 2.5);
+    bool ok = false;
+    EXPECT_TRUE(root["ok"].getBool(ok));
+    EXPECT_TRUE(ok);
+    EXPECT_TRUE(root["none"].isNull());
+    EXPECT_FALSE(root["missing"].valid());
+
+    uint64_t sum = 0;
+    for (JsonValue e = root["list"].firstElement(); e.valid(); e = e.nextElement()) {
+        ASSERT_TRUE(e.getUint64(u));
+        sum += u;
+    }
+    EXPECT_EQ(sum, 60u);
+
+    uint64_t x = 0;
+    JsonValue inner = root["skip"]["deep"].firstElement().nextElement().firstElement().nextElement();
+    EXPECT_TRUE(inner["x"].getUint64(x));
+    EXPECT_EQ(x, 3u);
+}
+
+TEST(JsonParserTest, RejectsMalformedDocuments) {
+    JsonParser parser;
+    EXPECT_FALSE(parser.parse(R"({"a":"unterminated})"));
+    EXPECT_FALSE(parser.parse(R"({"a":[1,2})"));
+    EXPECT_FALSE(parser.parse(R"({"a":1}})"));
+    EXPECT_FALSE(parser.parse(R"({"a":1} 2)"));
+    EXPECT_FALSE(parser.parse("   "));
+    EXPECT_FALSE(parser.parse(std::string(JsonParser::kMaxDepth + 1, '[') +
+                              std::string(JsonParser::kMaxDepth + 1, ']')));
+}
+
+TEST(JsonUtilsTest, ParseOrderInfo) {
+    JsonParser parser;
+    services::OrderInfo order;
+    std::string error;
+
+    std::string body = R"({"user_id": 42, "items": [{"product_id": 1001, "quantity": 2},)"
+                       R"( {"product_id": 1002, "quantity": 1}], "total_amount": 199.99,)"
+                       R"( "shipping_address": "北京 \"Chaoyang\"", "payment_method": "wechat"})";
+    ASSERT_TRUE(parseOrderInfo(parser, body, order, error)) << error;
+    EXPECT_EQ(order.user_id, 42u);
+    EXPECT_EQ(order.product_ids, (std::vector<uint64_t>{1001, 1002}));
+    EXPECT_EQ(order.quantities, (std::vector<uint32_t>{2, 1}));
+    EXPECT_DOUBLE_EQ(order.total_amount, 199.99);
+    EXPECT_EQ(order.shipping_address, "\xE5\x8C\x97\xE4\xBA\xAC \"Chaoyang\"");
+    EXPECT_EQ(order.payment_method, "wechat");
+
+    std::string legacy = R"({"user_id":7,"product_ids":[5,6],"quantities":[1,3],"total_amount":10})";
+    ASSERT_TRUE(parseOrderInfo(parser, legacy, order, error)) << error;
+    EXPECT_EQ(order.quantities, (std::vector<uint32_t>{1, 3}));
+
+    EXPECT_FALSE(parseOrderInfo(parser, R"({"user_id":"42","total_amount":1})", order, error));
+    EXPECT_EQ(error, "missing or invalid user_id");
+    EXPECT_FALSE(parseOrderInfo(parser, R"({"user_id":1,"total_amount":1,"items":[{"product_id":1}]})",
+                                order, error));
+}
+
+TEST(JsonUtilsTest, WriterRoundTrip) {
+    services::OrderInfo order{};
+    order.order_id = 9007199254740993ULL;
+    order.user_id = 42;
+    order.product_ids = {1001};
+    order.quantities = {3};
+    order.total_amount = 0.1 + 0.2;
+    order.status = services::OrderStatus::PAID;
+    // 超过32字节，覆盖AVX2转义扫描和标量尾部
+    order.shipping_address = std::string(40, 'x') + "\"quoted\"\n\t\x01" + std::string(40, 'y');
+    order.payment_method = "alipay";
+
+    std::string out;
+    JsonWriter writer(out);
+    writeOrderInfo(writer, order);
+    EXPECT_NE(out.find("\\\"quoted\\\"\\n\\t\\u0001"), std::string::npos);
+    EXPECT_NE(out.find("\"status\":\"PAID\""), std::string::npos);
+
+    JsonParser parser;
+    ASSERT_TRUE(parser.parse(out)) << parser.error() << out;
+    uint64_t order_id = 0;
+    double amount = 0;
+    std::string address;
+    ASSERT_TRUE(parser.root()["order_id"].getUint64(order_id));
+    ASSERT_TRUE(parser.root()["total_amount"].getDouble(amount));
+    ASSERT_TRUE(parser.root()["shipping_address"].getString(address));
+    EXPECT_EQ(order_id, order.order_id);
+    EXPECT_EQ(amount, order.total_amount);  // 最短往返表示，精确相等
+    EXPECT_EQ(address, order.shipping_address);
+}
+
+TEST(JsonUtilsTest, SerializesIntoHttpResponseBody) {
+    std::string out;
+    http::HttpResponse response(out, nullptr, true, false);
+    JsonWriter writer(response.beginBody());
+    writer.startObject();
+    writer.key("ok");
+    writer.writeBool(true);
+    writer.endObject();
+    response.endBody();
+
+    EXPECT_TRUE(response.isFinished());
+    EXPECT_EQ(out, "HTTP/1.1 200 OK\r\n"
+                   "Content-Type: application/json\r\n"
+                   "Content-Length: 0000000011\r\n\r\n"
+                   "{\"ok\":true}");
+}
@@ -0,0 +1,277 @@
+#include <gtest/gtest.h>
+#include "storage/order_archive.h"
+#include "storage/order_journal.h"
+#include "services/order_service.h"
+#include "services/order_store.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+using namespace order_engine::services;
+using namespace order_engine::storage;
+
+namespace {
+
+class OrderArchiveTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        base_ = (std::filesystem::temp_directory_path() /
+                 ("order_archive_test_" + std::to_string(::getpid()))).string();
+        std::filesystem::remove_all(base_);
+        options_.dir = base_ + "/archive";
+        options_.block_rows = 16;
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(base_);
+    }
+
+    static OrderInfo makeOrder(uint64_t order_id, uint64_t user_id, time_t created_at, OrderStatus status) {
+        OrderInfo order{};
+        order.order_id = order_id;
+        order.user_id = user_id;
+        order.created_at = created_at;
+        order.updated_at = created_at + 3600;
+        order.status = status;
+        for (uint64_t i = 0; i < order_id % 3 + 1; ++i) {
+            order.product_ids.push_back(1000 + i);
+            order.quantities.push_back(static_cast<uint32_t>(i + 1));
+        }
+        order.total_amount = static_cast<double>(order_id % 1000) + 0.99;
+        order.shipping_address = "Room " + std::to_string(user_id) + ", Pudong, Shanghai";
+        order.payment_method = order_id % 2 ? "alipay" : "wechat";
+        return order;
+    }
+
+    static void expectSameOrder(const OrderInfo& actual, const OrderInfo& expected) {
+        EXPECT_EQ(actual.order_id, expected.order_id);
+        EXPECT_EQ(actual.user_id, expected.user_id);
+        EXPECT_EQ(actual.created_at, expected.created_at);
+        EXPECT_EQ(actual.updated_at, expected.updated_at);
+        EXPECT_EQ(actual.status, expected.status);
+        EXPECT_DOUBLE_EQ(actual.total_amount, expected.total_amount);
+        EXPECT_EQ(actual.product_ids, expected.product_ids);
+        EXPECT_EQ(actual.quantities, expected.quantities);
+        EXPECT_EQ(actual.shipping_address, expected.shipping_address);
+        EXPECT_EQ(actual.payment_method, expected.payment_method);
+    }
+
+    std::string base_;
+    ArchiveOptions options_;
+};
+
+} // namespace
+
+TEST_F(OrderArchiveTest, UserHistoryRoundTripsAndPagesAcrossBlocks) {
+    // 20个用户，500个订单，每块16行
+    std::vector<OrderInfo> orders;
+    for (uint64_t i = 1; i <= 500; ++i) {
+        orders.push_back(makeOrder(i * 4096 + 7, i % 20 + 1, 1700000000 + static_cast<time_t>(i * 60),
+                                   i % 3 ? OrderStatus::DELIVERED : OrderStatus::CANCELLED));
+    }
+    {
+        OrderArchive archive(options_);
+        ASSERT_TRUE(archive.open());
+        std::string path;
+        ASSERT_TRUE(archive.write(orders, &path));
+        EXPECT_EQ(std::filesystem::path(path).filename().string(), OrderArchive::segmentName(1));
+    }
+
+    // 重新打开后从映射的段读取
+    OrderArchive archive(options_);
+    ASSERT_TRUE(archive.open());
+    ArchiveStats stats = archive.stats();
+    EXPECT_EQ(stats.segments, 1u);
+    EXPECT_EQ(stats.orders, 500u);
+
+    std::vector<OrderInfo> expected;
+    for (const auto& order : orders) {
+        if (order.user_id == 8) {
+            expected.push_back(order);
+        }
+    }
+    std::reverse(expected.begin(), expected.end());
+    std::vector<OrderInfo> all = archive.userHistory(8, nullptr, 100);
+    ASSERT_EQ(all.size(), expected.size());
+    for (size_t i = 0; i < all.size(); ++i) {
+        expectSameOrder(all[i], expected[i]);
+    }
+
+    // 按游标翻页，不重不漏
+    std::vector<uint64_t> paged;
+    UserOrderKey cursor{};
+    const UserOrderKey* after = nullptr;
+    for (;;) {
+        std::vector<OrderInfo> page = archive.userHistory(8, after, 7);
+        for (const auto& order : page) {
+            paged.push_back(order.order_id);
+        }
+        if (page.size() < 7) {
+            break;
+        }
+        cursor = UserOrderKey{static_cast<uint32_t>(page.back().created_at), page.back().order_id};
+        after = &cursor;
+    }
+    ASSERT_EQ(paged.size(), expected.size());
+    for (size_t i = 0; i < paged.size(); ++i) {
+        EXPECT_EQ(paged[i], expected[i].order_id);
+    }
+
+    EXPECT_TRUE(archive.userHistory(999, nullptr, 10).empty());
+}
+
+TEST_F(OrderArchiveTest, AggregatesTimeRangeUsingZoneMaps) {
+    OrderArchive archive(options_);
+    ASSERT_TRUE(archive.open());
+    // 两次归档覆盖不相交的时间段
+    std::vector<OrderInfo> first;
+    std::vector<OrderInfo> second;
+    for (uint64_t i = 1; i <= 320; ++i) {
+        OrderInfo order = makeOrder(i, i % 40 + 1, 1000000 + static_cast<time_t>(i),
+                                    static_cast<OrderStatus>(3 + i % 3));
+        (i <= 160 ? first : second).push_back(order);
+    }
+    ASSERT_TRUE(archive.write(first));
+    ASSERT_TRUE(archive.write(second));
+
+    time_t from = 1000000 + 200;
+    time_t to = 1000000 + 260;
+    ArchiveAggregate summary = archive.aggregate(from, to);
+    uint64_t expected_orders = 0;
+    double expected_revenue = 0;
+    std::array<uint64_t, 6> expected_status{};
+    for (const auto& order : second) {
+        if (order.created_at >= from && order.created_at < to) {
+            ++expected_orders;
+            expected_revenue += order.total_amount;
+            ++expected_status[static_cast<size_t>(order.status)];
+        }
+    }
+    EXPECT_EQ(summary.orders, expected_orders);
+    EXPECT_NEAR(summary.revenue, expected_revenue, 1e-6);
+    for (size_t i = 0; i < expected_status.size(); ++i) {
+        EXPECT_EQ(summary.status_orders[i], expected_status[i]) << i;
+    }
+    // 第一段整段跳过；第二段中按用户排序的块各自的时间区间仍覆盖较宽，至少跳过第一段的10个块
+    EXPECT_GE(summary.skipped_blocks, 10u);
+    EXPECT_EQ(summary.scanned_blocks + summary.skipped_blocks, 20u);
+
+    ArchiveAggregate everything = archive.aggregate(0, INT32_MAX);
+    EXPECT_EQ(everything.orders, 320u);
+    EXPECT_EQ(everything.skipped_blocks, 0u);
+    EXPECT_EQ(archive.aggregate(0, 1000).orders, 0u);
+}
+
+TEST_F(OrderArchiveTest, NewestSegmentWinsForDuplicateOrders) {
+    OrderArchive archive(options_);
+    ASSERT_TRUE(archive.open());
+    OrderInfo delivered = makeOrder(77, 5, 1700000000, OrderStatus::DELIVERED);
+    OrderInfo refunded = delivered;
+    refunded.status = OrderStatus::REFUNDED;
+    refunded.updated_at += 86400;
+    ASSERT_TRUE(archive.write({delivered}));
+    ASSERT_TRUE(archive.write({refunded, makeOrder(78, 5, 1700000001, OrderStatus::CANCELLED)}));
+
+    std::vector<OrderInfo> history = archive.userHistory(5, nullptr, 10);
+    ASSERT_EQ(history.size(), 2u);
+    EXPECT_EQ(history[0].order_id, 78u);
+    expectSameOrder(history[1], refunded);
+}
+
+TEST_F(OrderArchiveTest, SkipsCorruptedSegmentsAndLeftoverTempFiles) {
+    {
+        OrderArchive archive(options_);
+        ASSERT_TRUE(archive.open());
+        ASSERT_TRUE(archive.write({makeOrder(1, 1, 1700000000, OrderStatus::CANCELLED)}));
+        ASSERT_TRUE(archive.write({makeOrder(2, 1, 1700000001, OrderStatus::CANCELLED)}));
+    }
+    // 损坏第一段的区间映射，并留下一个未完成的临时文件
+    std::string first = options_.dir + "/" + OrderArchive::segmentName(1);
+    {
+        std::fstream file(first, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<std::streamoff>(OrderArchive::kHeaderSize + 11 * OrderArchive::kColumnEntrySize));
+        file.put('\x7f');
+    }
+    std::string tmp = options_.dir + "/" + OrderArchive::segmentName(3) + ".tmp";
+    std::ofstream(tmp) << "partial";
+
+    OrderArchive archive(options_);
+    ASSERT_TRUE(archive.open());
+    EXPECT_EQ(archive.stats().segments, 1u);
+    EXPECT_FALSE(std::filesystem::exists(tmp));
+    std::vector<OrderInfo> history = archive.userHistory(1, nullptr, 10);
+    ASSERT_EQ(history.size(), 1u);
+    EXPECT_EQ(history[0].order_id, 2u);
+
+    // 新段的序号接在损坏的段之后，不覆盖任何已有文件
+    std::string path;
+    ASSERT_TRUE(archive.write({makeOrder(3, 1, 1700000002, OrderStatus::CANCELLED)}, &path));
+    EXPECT_EQ(std::filesystem::path(path).filename().string(), OrderArchive::segmentName(3));
+}
+
+TEST_F(OrderArchiveTest, ServiceMovesClosedOrdersOutOfOrderStore) {
+    JournalOptions journal_options;
+    journal_options.dir = base_ + "/journal";
+    std::vector<uint64_t> ids;
+    {
+        auto journal = std::make_shared<OrderJournal>(journal_options);
+        ASSERT_TRUE(journal->open());
+        auto archive = std::make_shared<OrderArchive>(options_);
+        ASSERT_TRUE(archive->open());
+        auto service = std::make_shared<OrderService>();
+        ASSERT_TRUE(service->initialize(3));
+        service->setJournal(journal);
+        service->setArchive(archive);
+
+        for (uint64_t user = 1; user <= 30; ++user) {
+            OrderInfo order = makeOrder(0, user, 0, OrderStatus::PENDING);
+            service->createOrder(order, [&ids](bool success, const std::string&, const OrderInfo& created) {
+                ASSERT_TRUE(success);
+                ids.push_back(created.order_id);
+            });
+        }
+        // 前10个取消（已结束），其余仍待支付
+        for (size_t i = 0; i < 10; ++i) {
+            service->cancelOrder(ids[i], "test", [](bool success, const std::string&, const OrderInfo&) {
+                EXPECT_TRUE(success);
+            });
+        }
+        EXPECT_EQ(service->archiveClosedOrders(time(nullptr) - 3600), 0u);
+        EXPECT_EQ(service->archiveClosedOrders(time(nullptr) + 1), 10u);
+
+        size_t entries = 0;
+        for (const auto& shard : service->orderStore().stats()) {
+            entries += shard.entries;
+        }
+        EXPECT_EQ(entries, 20u);
+        EXPECT_EQ(archive->stats().orders, 10u);
+        std::vector<OrderInfo> history = archive->userHistory(1, nullptr, 10);
+        ASSERT_EQ(history.size(), 1u);
+        EXPECT_EQ(history[0].order_id, ids[0]);
+        EXPECT_EQ(history[0].status, OrderStatus::CANCELLED);
+        service->getOrder(ids[0], [](bool success, const std::string&, const OrderInfo&) {
+            EXPECT_FALSE(success);
+        });
+        service->shutdown();
+        journal->close();
+    }
+
+    // 日志回放不会让已归档的订单回到订单簿
+    auto journal = std::make_shared<OrderJournal>(journal_options);
+    ASSERT_TRUE(journal->open());
+    auto service = std::make_shared<OrderService>();
+    ASSERT_TRUE(service->initialize(2));
+    service->setJournal(journal);
+    ASSERT_TRUE(service->recover(base_ + "/snapshot"));
+    EXPECT_EQ(service->getTotalOrderCount(), 20u);
+    service->getOrder(ids[0], [](bool success, const std::string&, const OrderInfo&) {
+        EXPECT_FALSE(success);
+    });
+    service->getOrder(ids[10], [](bool success, const std::string&, const OrderInfo& order) {
+        EXPECT_TRUE(success);
+        EXPECT_EQ(order.status, OrderStatus::PENDING);
+    });
+    service->shutdown();
+    journal->close();
+}
@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+#include "message/order_event_pipeline.h"
+#include "utils/file_utils.h"
+#include "utils/mpsc_ring.h"
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
+using namespace order_engine::message;
+using order_engine::services::OrderStatus;
+using order_engine::utils::MpscRing;
+
+namespace {
+
+OrderEvent makeEvent(uint64_t order_id, OrderEventType type = OrderEventType::kCreated) {
+    return OrderEvent{order_id, order_id % 100 + 1, 99.5, 1700000000, type, OrderStatus::PENDING};
+}
+
+// 记录收到的批次，可模拟输出端阻塞
+class CollectingSink : public EventSink {
+public:
+    bool write(const EventBatch& batch) override {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (block) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        batches.push_back(batch);
+        return true;
+    }
+
+    std::mutex mutex;
+    std::vector<EventBatch> batches;
+    std::atomic<bool> block{false};
+};
+
+std::string tempDir() {
+    std::string dir = "/tmp/order_event_test_" + std::to_string(getpid());
+    std::filesystem::remove_all(dir);
+    return dir;
+}
+
+} // namespace
+
+TEST(MpscRingTest, KeepsPerProducerOrderUnderContention) {
+    MpscRing<uint64_t> ring(1024);
+    constexpr int kProducers = 4;
+    constexpr uint64_t kPerProducer = 20000;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&ring, p] {
+            for (uint64_t i = 0; i < kPerProducer; ++i) {
+                uint64_t value = (static_cast<uint64_t>(p) << 32) | i;
+                while (!ring.tryPush(value)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<uint64_t> next(kProducers, 0);
+    uint64_t received = 0;
+    uint64_t value = 0;
+    while (received < kProducers * kPerProducer) {
+        if (!ring.tryPop(value)) {
+            continue;
+        }
+        size_t producer = static_cast<size_t>(value >> 32);
+        ASSERT_EQ(value & 0xffffffff, next[producer]);
+        ++next[producer];
+        ++received;
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_FALSE(ring.tryPop(value));
+}
+
+TEST(MpscRingTest, RejectsWhenFull) {
+    MpscRing<uint64_t> ring(4);
+    for (uint64_t i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.tryPush(i));
+    }
+    EXPECT_FALSE(ring.tryPush(4));
+    EXPECT_EQ(ring.size(), 4u);
+    uint64_t value = 0;
+    ASSERT_TRUE(ring.tryPop(value));
+    EXPECT_EQ(value, 0u);
+    EXPECT_TRUE(ring.tryPush(4));
+}
+
+TEST(OrderEventPipelineTest, BatchesByPartitionAndKeepsOrderPerOrder) {
+    auto sink = std::make_shared<CollectingSink>();
+    EventPipelineOptions options;
+    options.partitions = 4;
+    options.batch_bytes = 1024;
+    options.linger_ms = 2;
+    OrderEventPipeline pipeline(sink, options);
+    pipeline.start();
+    for (uint64_t id = 1; id <= 200; ++id) {
+        ASSERT_TRUE(pipeline.publish(makeEvent(id)));
+    }
+    for (uint64_t id = 1; id <= 200; ++id) {
+        ASSERT_TRUE(pipeline.publish(makeEvent(id, OrderEventType::kCancelled)));
+    }
+    pipeline.stop();
+
+    EXPECT_EQ(pipeline.getSentCount(), 400u);
+    EXPECT_EQ(pipeline.getDroppedCount(), 0u);
+    std::map<uint64_t, std::vector<std::string>> per_order;
+    for (const EventBatch& batch : sink->batches) {
+        EXPECT_LT(batch.payload.size(), options.batch_bytes + 200);
+        for (size_t i = 0; i < batch.count(); ++i) {
+            EXPECT_EQ(OrderEventPipeline::partitionFor(batch.keys[i], 4), batch.partition);
+            per_order[batch.keys[i]].emplace_back(batch.record(i));
+        }
+    }
+    ASSERT_EQ(per_order.size(), 200u);
+    for (const auto& [id, records] : per_order) {
+        ASSERT_EQ(records.size(), 2u);
+        EXPECT_NE(records[0].find("\"event\":\"order_created\""), std::string::npos);
+        EXPECT_NE(records[1].find("\"event\":\"order_cancelled\""), std::string::npos);
+        EXPECT_NE(records[0].find("\"order_id\":" + std::to_string(id) + ","), std::string::npos);
+        EXPECT_EQ(records[0].back(), '\n');
+    }
+}
+
+TEST(OrderEventPipelineTest, DropsAndCountsWhenQueueIsFull) {
+    auto sink = std::make_shared<CollectingSink>();
+    sink->block = true;
+    EventPipelineOptions options;
+    options.ring_capacity = 64;
+    options.batch_bytes = 1;  // 每条记录一个批次，序列化线程被输出端拖慢
+    OrderEventPipeline pipeline(sink, options);
+    pipeline.start();
+
+    uint64_t accepted = 0;
+    for (uint64_t id = 1; id <= 1000; ++id) {
+        accepted += pipeline.publish(makeEvent(id)) ? 1 : 0;
+    }
+    EXPECT_GT(pipeline.getDroppedCount(), 0u);
+    EXPECT_EQ(pipeline.getDroppedCount() + accepted, 1000u);
+    EXPECT_EQ(pipeline.getPublishedCount(), accepted);
+
+    sink->block = false;
+    pipeline.stop();
+    EXPECT_EQ(pipeline.getSentCount(), accepted);
+}
+
+TEST(FileEventSinkTest, WritesSegmentsAndResumesOffsets) {
+    std::string dir = tempDir();
+    EventPipelineOptions options;
+    options.partitions = 2;
+    {
+        auto sink = std::make_shared<FileEventSink>(dir, 4096);
+        OrderEventPipeline pipeline(sink, options);
+        pipeline.start();
+        for (uint64_t id = 1; id <= 100; ++id) {
+            pipeline.publish(makeEvent(id));
+        }
+        pipeline.stop();
+        EXPECT_EQ(sink->nextOffset(options.topic, 0) + sink->nextOffset(options.topic, 1), 100u);
+    }
+
+    // 重新打开后接着最新的段追加，偏移连续
+    auto sink = std::make_shared<FileEventSink>(dir, 4096);
+    OrderEventPipeline pipeline(sink, options);
+    pipeline.start();
+    for (uint64_t id = 101; id <= 200; ++id) {
+        pipeline.publish(makeEvent(id));
+    }
+    pipeline.stop();
+
+    size_t lines = 0;
+    size_t segments = 0;
+    for (uint32_t partition = 0; partition < 2; ++partition) {
+        std::string partition_dir = dir + "/" + options.topic + "-" + std::to_string(partition);
+        uint64_t expected_base = 0;
+        std::vector<std::string> names;
+        for (const auto& entry : std::filesystem::directory_iterator(partition_dir)) {
+            names.push_back(entry.path().filename().string());
+        }
+        std::sort(names.begin(), names.end());
+        for (const std::string& name : names) {
+            EXPECT_EQ(name, FileEventSink::segmentName(expected_base));
+            std::string content;
+            ASSERT_TRUE(order_engine::utils::readFile(partition_dir + "/" + name, content));
+            size_t count = static_cast<size_t>(std::count(content.begin(), content.end(), '\n'));
+            expected_base += count;
+            lines += count;
+            ++segments;
+        }
+        EXPECT_EQ(sink->nextOffset(options.topic, partition), expected_base);
+    }
+    EXPECT_EQ(lines, 200u);
+    EXPECT_GT(segments, 2u);
+    std::filesystem::remove_all(dir);
+}
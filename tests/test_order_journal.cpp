@@ -0,0 +1,346 @@
+#include <gtest/gtest.h>
+#include "storage/order_journal.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+using namespace order_engine::services;
+using namespace order_engine::storage;
+
+namespace {
+
+class OrderJournalTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = (std::filesystem::temp_directory_path() /
+                ("order_journal_test_" + std::to_string(::getpid()))).string();
+        std::filesystem::remove_all(dir_);
+        options_.dir = dir_;
+        options_.segment_size = 64 * 1024;
+        options_.commit_interval_us = 0;
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(dir_);
+    }
+
+    std::vector<JournalRecord> replayAll(uint64_t from_lsn, std::vector<std::string>& payloads) {
+        std::vector<JournalRecord> records;
+        EXPECT_TRUE(OrderJournal::replay(dir_, from_lsn, [&](const JournalRecord& record) {
+            records.push_back(record);
+            payloads.emplace_back(record.payload);
+        }));
+        return records;
+    }
+
+    std::string dir_;
+    JournalOptions options_;
+};
+
+OrderInfo makeOrder(uint64_t order_id) {
+    OrderInfo order{};
+    order.order_id = order_id;
+    order.user_id = 42;
+    order.product_ids = {1001, 1002};
+    order.quantities = {1, 3};
+    order.total_amount = 199.5;
+    order.status = OrderStatus::PENDING;
+    order.created_at = 1700000000;
+    order.updated_at = 1700000000;
+    order.shipping_address = "No. 1 Software Avenue, Nanshan District, Shenzhen";
+    order.payment_method = "wechat";
+    return order;
+}
+
+} // namespace
+
+TEST_F(OrderJournalTest, AppendCommitAndReplay) {
+    {
+        OrderJournal journal(options_);
+        ASSERT_TRUE(journal.open());
+        uint64_t first = journal.appendOrderCreated(makeOrder(7), "RSV-7");
+        uint64_t second = journal.appendStatusChanged(7, OrderStatus::PAID, 1700000100);
+        EXPECT_EQ(first, 1u);
+        EXPECT_EQ(second, 2u);
+        ASSERT_TRUE(journal.waitForCommit(second));
+        EXPECT_GE(journal.committedLsn(), second);
+        EXPECT_EQ(journal.getCommittedRecords(), 2u);
+        journal.close();
+    }
+
+    std::vector<std::string> payloads;
+    auto records = replayAll(1, payloads);
+    ASSERT_EQ(records.size(), 2u);
+    ASSERT_EQ(records[0].type, JournalRecordType::kOrderCreated);
+    OrderInfo order{};
+    std::string reservation_id;
+    ASSERT_TRUE(OrderJournal::decodeOrderCreated(payloads[0], order, reservation_id));
+    EXPECT_EQ(order.order_id, 7u);
+    EXPECT_EQ(order.user_id, 42u);
+    EXPECT_EQ(order.product_ids, (std::vector<uint64_t>{1001, 1002}));
+    EXPECT_EQ(order.quantities, (std::vector<uint32_t>{1, 3}));
+    EXPECT_DOUBLE_EQ(order.total_amount, 199.5);
+    EXPECT_EQ(order.shipping_address, makeOrder(7).shipping_address);
+    EXPECT_EQ(order.payment_method, "wechat");
+    EXPECT_EQ(reservation_id, "RSV-7");
+
+    ASSERT_EQ(records[1].type, JournalRecordType::kStatusChanged);
+    uint64_t order_id = 0;
+    OrderStatus status = OrderStatus::PENDING;
+    time_t updated_at = 0;
+    ASSERT_TRUE(OrderJournal::decodeStatusChanged(payloads[1], order_id, status, updated_at));
+    EXPECT_EQ(order_id, 7u);
+    EXPECT_EQ(status, OrderStatus::PAID);
+    EXPECT_EQ(updated_at, 1700000100);
+
+    // from_lsn之前的记录不回放
+    payloads.clear();
+    EXPECT_EQ(replayAll(2, payloads).size(), 1u);
+}
+
+TEST_F(OrderJournalTest, ReopenContinuesAfterTail) {
+    {
+        OrderJournal journal(options_);
+        ASSERT_TRUE(journal.open());
+        for (int i = 0; i < 10; ++i) {
+            journal.append(JournalRecordType::kStatusChanged, "payload");
+        }
+        journal.close();
+    }
+
+    OrderJournal journal(options_);
+    ASSERT_TRUE(journal.open());
+    EXPECT_EQ(journal.lastLsn(), 10u);
+    EXPECT_EQ(journal.committedLsn(), 10u);
+    uint64_t lsn = journal.append(JournalRecordType::kStatusChanged, "payload");
+    EXPECT_EQ(lsn, 11u);
+    ASSERT_TRUE(journal.waitForCommit(lsn));
+    journal.close();
+
+    std::vector<std::string> payloads;
+    auto records = replayAll(1, payloads);
+    ASSERT_EQ(records.size(), 11u);
+    for (size_t i = 0; i < records.size(); ++i) {
+        EXPECT_EQ(records[i].lsn, i + 1);
+    }
+}
+
+TEST_F(OrderJournalTest, RollsSegments) {
+    const std::string payload(1000, 'x');
+    {
+        OrderJournal journal(options_);
+        ASSERT_TRUE(journal.open());
+        uint64_t lsn = 0;
+        for (int i = 0; i < 200; ++i) {
+            lsn = journal.append(JournalRecordType::kStatusChanged, payload);
+        }
+        ASSERT_TRUE(journal.waitForCommit(lsn));
+        journal.close();
+    }
+
+    auto segments = OrderJournal::listSegments(dir_);
+    ASSERT_GT(segments.size(), 2u);
+    for (const auto& [first_lsn, path] : segments) {
+        EXPECT_EQ(std::filesystem::file_size(path), options_.segment_size);
+    }
+
+    std::vector<std::string> payloads;
+    auto records = replayAll(1, payloads);
+    ASSERT_EQ(records.size(), 200u);
+    EXPECT_EQ(records.back().lsn, 200u);
+    EXPECT_EQ(payloads.back(), payload);
+
+    // 从中间段开始回放
+    payloads.clear();
+    records = replayAll(segments[1].first + 1, payloads);
+    ASSERT_FALSE(records.empty());
+    EXPECT_EQ(records.front().lsn, segments[1].first + 1);
+    EXPECT_EQ(records.back().lsn, 200u);
+}
+
+TEST_F(OrderJournalTest, RollsOntoPreallocatedSpareSegment) {
+    const std::string payload(1000, 'x');
+    const std::string spare = dir_ + "/journal-spare.tmp";
+    OrderJournal journal(options_);
+    ASSERT_TRUE(journal.open());
+    auto waitSpare = [&]() {
+        for (int i = 0; i < 200 && !std::filesystem::exists(spare); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return std::filesystem::exists(spare) && std::filesystem::file_size(spare) == options_.segment_size;
+    };
+
+    // 每次切换段都取用后台写零的备用段，之后再准备下一个
+    for (size_t expected_segments = 1; expected_segments <= 3; ++expected_segments) {
+        ASSERT_TRUE(waitSpare());
+        uint64_t lsn = 0;
+        while (OrderJournal::listSegments(dir_).size() < expected_segments) {
+            lsn = journal.append(JournalRecordType::kStatusChanged, payload);
+            ASSERT_TRUE(journal.waitForCommit(lsn));
+        }
+    }
+    journal.close();
+
+    // 段文件都不是残留的临时文件，且都完整预分配
+    for (const auto& [first_lsn, path] : OrderJournal::listSegments(dir_)) {
+        EXPECT_EQ(std::filesystem::file_size(path), options_.segment_size);
+    }
+    std::vector<std::string> payloads;
+    EXPECT_EQ(replayAll(1, payloads).size(), journal.lastLsn());
+}
+
+TEST_F(OrderJournalTest, IgnoresTornTail) {
+    const std::string payload = "status";
+    {
+        OrderJournal journal(options_);
+        ASSERT_TRUE(journal.open());
+        for (int i = 0; i < 5; ++i) {
+            journal.append(JournalRecordType::kStatusChanged, payload);
+        }
+        journal.close();
+    }
+
+    // 模拟最后一条记录只写了一半
+    auto segments = OrderJournal::listSegments(dir_);
+    ASSERT_EQ(segments.size(), 1u);
+    int fd = ::open(segments[0].second.c_str(), O_WRONLY);
+    ASSERT_GE(fd, 0);
+    off_t last = static_cast<off_t>(OrderJournal::kSegmentHeaderSize +
+                                    4 * (OrderJournal::kRecordHeaderSize + payload.size()) +
+                                    OrderJournal::kRecordHeaderSize + 2);
+    ASSERT_EQ(::pwrite(fd, "\0\0\0\0", 4, last), 4);
+    ::close(fd);
+
+    std::vector<std::string> payloads;
+    EXPECT_EQ(replayAll(1, payloads).size(), 4u);
+
+    // 重新打开后覆盖残缺记录
+    OrderJournal journal(options_);
+    ASSERT_TRUE(journal.open());
+    EXPECT_EQ(journal.lastLsn(), 4u);
+    uint64_t lsn = journal.append(JournalRecordType::kStatusChanged, "rewritten");
+    ASSERT_TRUE(journal.waitForCommit(lsn));
+    journal.close();
+
+    payloads.clear();
+    auto records = replayAll(1, payloads);
+    ASSERT_EQ(records.size(), 5u);
+    EXPECT_EQ(payloads.back(), "rewritten");
+}
+
+TEST_F(OrderJournalTest, TruncatesRecordsAfterFailedWrite) {
+    {
+        OrderJournal journal(options_);
+        ASSERT_TRUE(journal.open());
+        for (int i = 0; i < 5; ++i) {
+            journal.append(JournalRecordType::kStatusChanged, "status");
+        }
+        journal.close();
+    }
+
+    // 模拟LSN 4、5所在批次写盘失败：记录已写入磁盘但从未应答
+    std::string marker = dir_ + "/journal.failed";
+    {
+        uint64_t committed = 3;
+        int fd = ::open(marker.c_str(), O_CREAT | O_WRONLY, 0644);
+        ASSERT_GE(fd, 0);
+        ASSERT_EQ(::write(fd, &committed, sizeof(committed)), static_cast<ssize_t>(sizeof(committed)));
+        ::close(fd);
+    }
+    std::vector<std::string> payloads;
+    EXPECT_EQ(replayAll(1, payloads).size(), 3u);
+
+    OrderJournal journal(options_);
+    ASSERT_TRUE(journal.open());
+    EXPECT_FALSE(std::filesystem::exists(marker));
+    EXPECT_EQ(journal.lastLsn(), 3u);
+    uint64_t lsn = journal.append(JournalRecordType::kStatusChanged, "rewritten");
+    EXPECT_EQ(lsn, 4u);
+    ASSERT_TRUE(journal.waitForCommit(lsn));
+    journal.close();
+
+    payloads.clear();
+    auto records = replayAll(1, payloads);
+    ASSERT_EQ(records.size(), 4u);
+    EXPECT_EQ(payloads.back(), "rewritten");
+}
+
+TEST_F(OrderJournalTest, IgnoresSegmentLeftOverFromCrashedCreate) {
+    {
+        OrderJournal journal(options_);
+        ASSERT_TRUE(journal.open());
+        for (int i = 0; i < 3; ++i) {
+            journal.append(JournalRecordType::kStatusChanged, "status");
+        }
+        journal.close();
+    }
+
+    // 模拟创建下一段时在段头写入前崩溃：只留下全零的临时文件
+    std::string temp = dir_ + "/journal-00000000000000000004.tmp";
+    {
+        std::string zeros(options_.segment_size, '\0');
+        int fd = ::open(temp.c_str(), O_CREAT | O_WRONLY, 0644);
+        ASSERT_GE(fd, 0);
+        ASSERT_EQ(::write(fd, zeros.data(), zeros.size()), static_cast<ssize_t>(zeros.size()));
+        ::close(fd);
+    }
+    EXPECT_EQ(OrderJournal::listSegments(dir_).size(), 1u);
+    std::vector<std::string> payloads;
+    EXPECT_EQ(replayAll(1, payloads).size(), 3u);
+
+    OrderJournal journal(options_);
+    ASSERT_TRUE(journal.open());
+    EXPECT_FALSE(std::filesystem::exists(temp));
+    EXPECT_EQ(journal.lastLsn(), 3u);
+    journal.close();
+}
+
+TEST_F(OrderJournalTest, GroupsConcurrentCommits) {
+    options_.commit_interval_us = 500;
+    OrderJournal journal(options_);
+    ASSERT_TRUE(journal.open());
+
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 200;
+    std::atomic<int> callbacks{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&journal, &callbacks, t]() {
+            for (int i = 0; i < kPerThread; ++i) {
+                uint64_t lsn = journal.appendOrderCreated(makeOrder(static_cast<uint64_t>(t * kPerThread + i)),
+                                                          "RSV");
+                ASSERT_NE(lsn, 0u);
+                ASSERT_TRUE(journal.waitForCommit(lsn));
+            }
+            uint64_t lsn = journal.append(JournalRecordType::kStatusChanged, "done",
+                                          [&callbacks](bool success) {
+                                              if (success) {
+                                                  callbacks.fetch_add(1);
+                                              }
+                                          });
+            journal.waitForCommit(lsn);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    journal.close();
+
+    uint64_t total = kThreads * (kPerThread + 1);
+    EXPECT_EQ(journal.getCommittedRecords(), total);
+    EXPECT_LT(journal.getCommitCount(), total);
+    EXPECT_EQ(callbacks.load(), kThreads);
+
+    std::vector<std::string> payloads;
+    EXPECT_EQ(replayAll(1, payloads).size(), total);
+}
+
+TEST_F(OrderJournalTest, RejectsAppendWhenClosed) {
+    OrderJournal journal(options_);
+    EXPECT_EQ(journal.append(JournalRecordType::kStatusChanged, "x"), 0u);
+    ASSERT_TRUE(journal.open());
+    journal.close();
+    EXPECT_EQ(journal.append(JournalRecordType::kStatusChanged, "x"), 0u);
+}
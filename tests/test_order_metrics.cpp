@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include "services/order_metrics.h"
+#include <thread>
+#include <vector>
+
+using namespace order_engine::services;
+
+namespace {
+
+// 取本地日期中午，避免跨天
+time_t localNoon() {
+    time_t now = time(nullptr);
+    struct tm tm_buf;
+    localtime_r(&now, &tm_buf);
+    tm_buf.tm_hour = 12;
+    tm_buf.tm_min = 0;
+    tm_buf.tm_sec = 0;
+    return mktime(&tm_buf);
+}
+
+} // namespace
+
+TEST(OrderMetricsTest, AggregatesAcrossThreads) {
+    OrderMetrics metrics(4);
+    time_t now = localNoon();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&metrics, now]() {
+            for (int i = 0; i < 1000; ++i) {
+                metrics.recordCreated(1, 0.1, now);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(metrics.totalOrders(), 8000u);
+    OrderWindowStats today = metrics.today(now);
+    EXPECT_EQ(today.orders, 8000u);
+    EXPECT_DOUBLE_EQ(today.revenue, 800.0);
+    EXPECT_EQ(today.transitions[static_cast<size_t>(OrderStatus::PENDING)], 8000u);
+    EXPECT_EQ(metrics.lastMinute(now).orders, 8000u);
+    EXPECT_EQ(metrics.lastHour(now).orders, 8000u);
+}
+
+TEST(OrderMetricsTest, RollingWindowsExpire) {
+    OrderMetrics metrics(1);
+    time_t start = localNoon();
+    metrics.recordCreated(2, 20.0, start);
+    metrics.recordCreated(3, 30.0, start + 30);
+    metrics.recordTransition(OrderStatus::PAID, 4, start + 30);
+
+    OrderWindowStats minute = metrics.lastMinute(start + 30);
+    EXPECT_EQ(minute.orders, 5u);
+    EXPECT_DOUBLE_EQ(minute.revenue, 50.0);
+    EXPECT_EQ(minute.transitions[static_cast<size_t>(OrderStatus::PAID)], 4u);
+
+    // 一分钟后只剩30秒时的记录
+    minute = metrics.lastMinute(start + 60);
+    EXPECT_EQ(minute.orders, 3u);
+    EXPECT_EQ(metrics.lastMinute(start + 200).orders, 0u);
+
+    // 桶复用：61秒后写入同一个秒桶，旧值先清零
+    metrics.recordCreated(1, 1.0, start + 60 * 2);
+    EXPECT_EQ(metrics.lastMinute(start + 60 * 2).orders, 1u);
+
+    EXPECT_EQ(metrics.lastHour(start + 59 * 60).orders, 6u);
+    EXPECT_EQ(metrics.lastHour(start + 61 * 60).orders, 1u);
+    EXPECT_EQ(metrics.lastHour(start + 63 * 60).orders, 0u);
+}
+
+TEST(OrderMetricsTest, TodayRollsOverAtMidnight) {
+    OrderMetrics metrics(2);
+    time_t noon = localNoon();
+    metrics.recordCreated(10, 100.0, noon);
+    EXPECT_EQ(metrics.today(noon).orders, 10u);
+
+    time_t tomorrow = noon + 86400;
+    EXPECT_EQ(metrics.today(tomorrow).orders, 0u);
+    metrics.recordCreated(1, 5.0, tomorrow);
+    OrderWindowStats today = metrics.today(tomorrow);
+    EXPECT_EQ(today.orders, 1u);
+    EXPECT_DOUBLE_EQ(today.revenue, 5.0);
+    EXPECT_EQ(metrics.totalOrders(), 11u);
+
+    metrics.setTotalOrders(100);
+    EXPECT_EQ(metrics.totalOrders(), 100u);
+    metrics.recordCreated(1, 1.0, tomorrow);
+    EXPECT_EQ(metrics.totalOrders(), 101u);
+}
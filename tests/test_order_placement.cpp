@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include "services/order_placement.h"
+#include "services/inventory_service.h"
+#include <future>
+#include <latch>
+#include <thread>
+
+using namespace order_engine::services;
+
+namespace {
+
+PlacementBatch makeBatch(size_t orders, std::atomic<size_t>* completed = nullptr) {
+    PlacementBatch batch;
+    batch.add(std::vector<OrderInfo>(orders, OrderInfo{}), [completed](PlacementBatch&, size_t begin, size_t end) {
+        if (completed) {
+            completed->fetch_add(end - begin);
+        }
+    });
+    return batch;
+}
+
+OrderInfo makeOrder(uint64_t user_id, uint64_t product_id, uint32_t quantity) {
+    OrderInfo order{};
+    order.user_id = user_id;
+    order.product_ids = {product_id};
+    order.quantities = {quantity};
+    order.total_amount = 10.0;
+    order.shipping_address = "Shanghai";
+    order.payment_method = "alipay";
+    return order;
+}
+
+} // namespace
+
+TEST(PlacementBatchTest, AppendKeepsRequestRanges) {
+    PlacementBatch batch;
+    std::vector<std::pair<size_t, size_t>> ranges;
+    auto record = [&ranges](PlacementBatch&, size_t begin, size_t end) { ranges.emplace_back(begin, end); };
+    batch.add(std::vector<OrderInfo>(2, OrderInfo{}), record);
+    PlacementBatch other;
+    other.add(std::vector<OrderInfo>(3, OrderInfo{}), record);
+    other.results[1].code = OrderResultCode::INVALID_ORDER;
+    batch.append(std::move(other));
+
+    ASSERT_EQ(batch.size(), 5u);
+    EXPECT_EQ(batch.results[3].code, OrderResultCode::INVALID_ORDER);
+    batch.complete();
+    EXPECT_EQ(ranges, (std::vector<std::pair<size_t, size_t>>{{0, 2}, {2, 5}}));
+}
+
+TEST(PlacementStageTest, MergesQueuedBatchesAndPropagatesBackpressure) {
+    PlacementOptions options;
+    options.queue_capacity = 8;
+    options.max_batch = 6;
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::vector<size_t> sizes;
+    std::mutex sizes_mutex;
+    std::atomic<size_t> completed{0};
+
+    // 第二级被阻塞：第一级随后阻塞在交给第二级上，入口队列最终填满
+    PlacementStage second("second", 1, options, [&](PlacementBatch& batch) {
+        released.wait();
+        std::lock_guard<std::mutex> lock(sizes_mutex);
+        sizes.push_back(batch.size());
+    }, nullptr);
+    PlacementStage first("first", 1, options, [](PlacementBatch&) {}, &second);
+    second.start();
+    first.start();
+
+    size_t accepted = 0;
+    for (int i = 0; i < 64; ++i) {
+        if (first.tryPush(makeBatch(1, &completed))) {
+            ++accepted;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    EXPECT_LT(accepted, 64u);
+    EXPECT_GT(first.stats().rejected, 0u);
+    EXPECT_LE(first.stats().queued_orders, options.queue_capacity);
+
+    release.set_value();
+    first.stop();
+    second.stop();
+    EXPECT_EQ(completed.load(), accepted);
+    // 阻塞期间排队的请求被合并处理
+    size_t largest = 0;
+    for (size_t size : sizes) {
+        EXPECT_LE(size, options.max_batch);
+        largest = std::max(largest, size);
+    }
+    EXPECT_GT(largest, 1u);
+}
+
+TEST(PlacementStageTest, RejectsAfterStop) {
+    PlacementStage stage("only", 1, PlacementOptions(), [](PlacementBatch&) {}, nullptr);
+    EXPECT_FALSE(stage.tryPush(makeBatch(1)));
+    stage.start();
+    std::atomic<size_t> completed{0};
+    EXPECT_TRUE(stage.tryPush(makeBatch(3, &completed)));
+    stage.stop();
+    EXPECT_EQ(completed.load(), 3u);
+    EXPECT_FALSE(stage.tryPush(makeBatch(1)));
+}
+
+TEST(StagedPlacementTest, ConcurrentOrdersAreBatchedThroughStages) {
+    auto inventory = std::make_shared<InventoryService>();
+    inventory->addStock(1001, 150, [](bool, const std::string&) {});
+    auto service = std::make_shared<OrderService>();
+    service->setInventoryService(inventory);
+    PlacementOptions options;
+    service->enableStagedPlacement(options);
+    ASSERT_TRUE(service->initialize(4));
+    ASSERT_NE(service->placementPipeline(), nullptr);
+
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 25;
+    std::atomic<int> created{0};
+    std::atomic<int> out_of_stock{0};
+    std::latch answered(kThreads * kPerThread);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            std::thread::id caller = std::this_thread::get_id();
+            for (int i = 0; i < kPerThread; ++i) {
+                // 提交后立即返回，完成级线程回调
+                service->createOrder(makeOrder(static_cast<uint64_t>(t + 1), 1001, 1),
+                    [&, caller](bool success, const std::string& message, const OrderInfo& order) {
+                        EXPECT_NE(std::this_thread::get_id(), caller);
+                        if (success) {
+                            EXPECT_NE(order.order_id, 0u);
+                            EXPECT_EQ(order.status, OrderStatus::PENDING);
+                            ++created;
+                        } else {
+                            EXPECT_EQ(message, "insufficient stock");
+                            ++out_of_stock;
+                        }
+                        answered.count_down();
+                    });
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    answered.wait();
+    EXPECT_EQ(created.load(), 150);
+    EXPECT_EQ(out_of_stock.load(), kThreads * kPerThread - 150);
+
+    // 批量接口同样经过流水线，结果与订单一一对应
+    std::vector<OrderResult> results;
+    std::latch batch_answered(1);
+    service->createOrders({makeOrder(0, 1001, 1), makeOrder(1, 1001, 1)},
+        [&results, &batch_answered](const std::vector<OrderResult>& r) {
+            results = r;
+            batch_answered.count_down();
+        });
+    batch_answered.wait();
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].code, OrderResultCode::INVALID_ORDER);
+    EXPECT_EQ(results[1].code, OrderResultCode::INSUFFICIENT_STOCK);
+
+    uint64_t reserve_orders = 0;
+    uint64_t reserve_batches = 0;
+    for (const PlacementStage* stage : service->placementPipeline()->stages()) {
+        PlacementStage::Stats stats = stage->stats();
+        EXPECT_EQ(stats.orders, static_cast<uint64_t>(kThreads * kPerThread + 2)) << stage->name();
+        EXPECT_EQ(stats.queued_orders, 0u);
+        if (stage->name() == "reserve") {
+            reserve_orders = stats.orders;
+            reserve_batches = stats.batches;
+        }
+    }
+    EXPECT_LE(reserve_batches, reserve_orders);
+    service->shutdown();
+}
@@ -0,0 +1,245 @@
+#include <gtest/gtest.h>
+#include "protocol/order_protocol.h"
+
+using namespace order_engine;
+using namespace order_engine::protocol;
+
+class OrderProtocolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        order_ = services::OrderInfo{};
+        order_.user_id = 42;
+        order_.product_ids = {1001, 1002, 1003};
+        order_.quantities = {1, 2, 3};
+        order_.total_amount = 199.99;
+        order_.shipping_address = "Beijing Chaoyang";
+        order_.payment_method = "wechat";
+    }
+
+    services::OrderInfo order_;
+};
+
+TEST_F(OrderProtocolTest, CreateOrderRoundTrip) {
+    std::string buffer;
+    encodeCreateOrderRequest(buffer, 7, order_);
+
+    FrameView frame;
+    ASSERT_EQ(decodeFrame(buffer.data(), buffer.size(), frame), DecodeStatus::kOk);
+    EXPECT_EQ(frame.frameSize(), buffer.size());
+    EXPECT_EQ(frame.type(), MessageType::kCreateOrderRequest);
+    EXPECT_EQ(frame.requestId(), 7u);
+
+    CreateOrderView view;
+    ASSERT_EQ(CreateOrderView::parse(frame, view), DecodeStatus::kOk);
+    EXPECT_EQ(view.userId(), 42u);
+    EXPECT_EQ(view.totalAmountCents(), 19999);
+    ASSERT_EQ(view.itemCount(), 3);
+    EXPECT_EQ(view.item(1).productId(), 1002u);
+    EXPECT_EQ(view.item(2).quantity(), 3u);
+    EXPECT_EQ(view.shippingAddress(), "Beijing Chaoyang");
+    EXPECT_EQ(view.paymentMethod(), "wechat");
+
+    // 视图直接指向缓冲区，没有拷贝
+    EXPECT_GE(view.shippingAddress().data(), buffer.data());
+    EXPECT_LT(view.shippingAddress().data(), buffer.data() + buffer.size());
+
+    services::OrderInfo decoded;
+    view.toOrderInfo(decoded);
+    EXPECT_EQ(decoded.product_ids, order_.product_ids);
+    EXPECT_EQ(decoded.quantities, order_.quantities);
+    EXPECT_DOUBLE_EQ(decoded.total_amount, 199.99);
+}
+
+TEST_F(OrderProtocolTest, PipelinedFramesAndPartialData) {
+    std::string buffer;
+    encodeQueryOrderRequest(buffer, 1, 555);
+    encodeCancelOrderRequest(buffer, 2, 666, "user request");
+    size_t first_size = kFrameHeaderSize + QueryOrderView::kFixedSize;
+
+    FrameView frame;
+    // 帧头不完整、消息体不完整都需要等待
+    EXPECT_EQ(decodeFrame(buffer.data(), 10, frame), DecodeStatus::kNeedMore);
+    EXPECT_EQ(decodeFrame(buffer.data(), first_size - 1, frame), DecodeStatus::kNeedMore);
+
+    ASSERT_EQ(decodeFrame(buffer.data(), buffer.size(), frame), DecodeStatus::kOk);
+    ASSERT_EQ(frame.frameSize(), first_size);
+    QueryOrderView query;
+    ASSERT_EQ(QueryOrderView::parse(frame, query), DecodeStatus::kOk);
+    EXPECT_EQ(query.orderId(), 555u);
+
+    const char* next = buffer.data() + frame.frameSize();
+    ASSERT_EQ(decodeFrame(next, buffer.size() - first_size, frame), DecodeStatus::kOk);
+    CancelOrderView cancel;
+    ASSERT_EQ(CancelOrderView::parse(frame, cancel), DecodeStatus::kOk);
+    EXPECT_EQ(cancel.orderId(), 666u);
+    EXPECT_EQ(cancel.reason(), "user request");
+}
+
+TEST_F(OrderProtocolTest, RejectsCorruptedFrames) {
+    std::string buffer;
+    encodeCreateOrderRequest(buffer, 1, order_);
+    FrameView frame;
+
+    std::string corrupted = buffer;
+    corrupted[kFrameHeaderSize + 3] ^= 0x01;
+    EXPECT_EQ(decodeFrame(corrupted.data(), corrupted.size(), frame), DecodeStatus::kBadChecksum);
+
+    corrupted = buffer;
+    corrupted[0] = 'X';
+    EXPECT_EQ(decodeFrame(corrupted.data(), corrupted.size(), frame), DecodeStatus::kBadMagic);
+
+    corrupted = buffer;
+    corrupted[2] = 9;
+    EXPECT_EQ(decodeFrame(corrupted.data(), corrupted.size(), frame), DecodeStatus::kBadVersion);
+
+    corrupted = buffer;
+    uint32_t huge = kMaxPayloadSize + 1;
+    std::memcpy(&corrupted[4], &huge, sizeof(huge));
+    EXPECT_EQ(decodeFrame(corrupted.data(), corrupted.size(), frame), DecodeStatus::kTooLarge);
+}
+
+TEST_F(OrderProtocolTest, RejectsInconsistentItemCount) {
+    // 条目数与长度不符：CRC正确但消息体不自洽
+    std::string buffer;
+    encodeReserveStockRequest(buffer, 3, 888, {1, 2}, {5, 6}, 30);
+    FrameView frame;
+    ASSERT_EQ(decodeFrame(buffer.data(), buffer.size(), frame), DecodeStatus::kOk);
+    ReserveStockView reserve;
+    ASSERT_EQ(ReserveStockView::parse(frame, reserve), DecodeStatus::kOk);
+    EXPECT_EQ(reserve.timeoutSeconds(), 30u);
+    EXPECT_EQ(reserve.item(1).quantity(), 6u);
+
+    std::string forged;
+    encodeResult(forged, MessageType::kReserveStockRequest, 3, 888, ResultCode::kOk, "");
+    ASSERT_EQ(decodeFrame(forged.data(), forged.size(), frame), DecodeStatus::kOk);
+    EXPECT_EQ(ReserveStockView::parse(frame, reserve), DecodeStatus::kMalformed);
+
+    // 类型不匹配
+    ASSERT_EQ(decodeFrame(buffer.data(), buffer.size(), frame), DecodeStatus::kOk);
+    CreateOrderView create;
+    EXPECT_EQ(CreateOrderView::parse(frame, create), DecodeStatus::kMalformed);
+}
+
+TEST_F(OrderProtocolTest, EncodersRejectOversizeOrders) {
+    std::string buffer = "prefix";
+
+    // 超出解码端上限的订单不截断编码，输出缓冲区保持不变
+    services::OrderInfo oversize = order_;
+    oversize.product_ids.assign(kMaxItemsPerOrder + 1, 1001);
+    oversize.quantities.assign(kMaxItemsPerOrder + 1, 1);
+    EXPECT_FALSE(encodeCreateOrderRequest(buffer, 1, oversize));
+    EXPECT_FALSE(encodeOrderRecord(buffer, 1, ResultCode::kOk, oversize));
+    EXPECT_FALSE(encodeReserveStockRequest(buffer, 1, 888, oversize.product_ids, oversize.quantities, 30));
+    EXPECT_FALSE(encodeBatchCreateOrderRequest(buffer, 1, {order_, oversize}));
+
+    services::OrderInfo mismatched = order_;
+    mismatched.quantities.pop_back();
+    EXPECT_FALSE(encodeCreateOrderRequest(buffer, 1, mismatched));
+    EXPECT_FALSE(encodeReserveStockRequest(buffer, 1, 888, {1, 2}, {5}, 30));
+    EXPECT_FALSE(encodeReserveStockRequest(buffer, 1, 888, {}, {}, 30));
+
+    services::OrderInfo long_payment = order_;
+    long_payment.payment_method.assign(UINT8_MAX + 1, 'p');
+    EXPECT_FALSE(encodeCreateOrderRequest(buffer, 1, long_payment));
+
+    EXPECT_FALSE(encodeBatchCreateOrderRequest(buffer, 1, {}));
+    EXPECT_FALSE(encodeBatchCreateOrderRequest(buffer, 1,
+                                               std::vector<services::OrderInfo>(kMaxOrdersPerBatch + 1, order_)));
+
+    // 每个订单都合法，但合计超过单帧上限
+    services::OrderInfo large = order_;
+    large.product_ids.assign(kMaxItemsPerOrder, 1001);
+    large.quantities.assign(kMaxItemsPerOrder, 1);
+    EXPECT_FALSE(encodeBatchCreateOrderRequest(buffer, 1, std::vector<services::OrderInfo>(100, large)));
+    EXPECT_EQ(buffer, "prefix");
+
+    // 恰好在上限内的订单可以正常往返
+    ASSERT_TRUE(encodeCreateOrderRequest(buffer, 1, large));
+    FrameView frame;
+    ASSERT_EQ(decodeFrame(buffer.data() + 6, buffer.size() - 6, frame), DecodeStatus::kOk);
+    CreateOrderView view;
+    ASSERT_EQ(CreateOrderView::parse(frame, view), DecodeStatus::kOk);
+    EXPECT_EQ(view.itemCount(), kMaxItemsPerOrder);
+}
+
+TEST_F(OrderProtocolTest, OrderRecordAndResult) {
+    order_.order_id = 123456789;
+    order_.status = services::OrderStatus::PAID;
+    order_.created_at = 1700000000;
+    order_.updated_at = 1700000100;
+
+    std::string buffer;
+    encodeOrderRecord(buffer, 9, ResultCode::kOk, order_);
+    encodeResult(buffer, MessageType::kCancelOrderResponse, 10, 123456789,
+                 ResultCode::kNotFound, "order not found");
+
+    FrameView frame;
+    ASSERT_EQ(decodeFrame(buffer.data(), buffer.size(), frame), DecodeStatus::kOk);
+    OrderRecordView record;
+    ASSERT_EQ(OrderRecordView::parse(frame, record), DecodeStatus::kOk);
+    EXPECT_EQ(record.orderId(), 123456789u);
+    EXPECT_EQ(record.status(), services::OrderStatus::PAID);
+    EXPECT_EQ(record.updatedAt(), 1700000100);
+    EXPECT_EQ(record.paymentMethod(), "wechat");
+
+    const char* next = buffer.data() + frame.frameSize();
+    ASSERT_EQ(decodeFrame(next, buffer.size() - frame.frameSize(), frame), DecodeStatus::kOk);
+    ResultView result;
+    ASSERT_EQ(ResultView::parse(frame, result), DecodeStatus::kOk);
+    EXPECT_EQ(result.result(), ResultCode::kNotFound);
+    EXPECT_EQ(result.message(), "order not found");
+}
+
+TEST_F(OrderProtocolTest, BatchCreateOrderRoundTrip) {
+    services::OrderInfo second = order_;
+    second.user_id = 43;
+    second.product_ids = {2001};
+    second.quantities = {9};
+    second.shipping_address = "";
+
+    std::string buffer;
+    encodeBatchCreateOrderRequest(buffer, 11, {order_, second});
+
+    FrameView frame;
+    ASSERT_EQ(decodeFrame(buffer.data(), buffer.size(), frame), DecodeStatus::kOk);
+    BatchCreateOrderView batch;
+    ASSERT_EQ(BatchCreateOrderView::parse(frame, batch), DecodeStatus::kOk);
+    ASSERT_EQ(batch.orderCount(), 2);
+
+    size_t offset = 0;
+    CreateOrderView order;
+    ASSERT_TRUE(batch.next(offset, order));
+    EXPECT_EQ(order.userId(), 42u);
+    EXPECT_EQ(order.paymentMethod(), "wechat");
+    ASSERT_TRUE(batch.next(offset, order));
+    EXPECT_EQ(order.userId(), 43u);
+    EXPECT_EQ(order.item(0).quantity(), 9u);
+    EXPECT_TRUE(order.shippingAddress().empty());
+    EXPECT_FALSE(batch.next(offset, order));
+
+    std::vector<services::OrderInfo> decoded;
+    batch.toOrderInfos(decoded);
+    ASSERT_EQ(decoded.size(), 2u);
+    EXPECT_EQ(decoded[0].product_ids, order_.product_ids);
+
+    // 声明的订单数多于实际订单体
+    std::string forged = buffer;
+    uint16_t count = 3;
+    std::memcpy(&forged[kFrameHeaderSize], &count, sizeof(count));
+    protocol::endFrame(forged, 0);
+    ASSERT_EQ(decodeFrame(forged.data(), forged.size(), frame), DecodeStatus::kOk);
+    EXPECT_EQ(BatchCreateOrderView::parse(frame, batch), DecodeStatus::kMalformed);
+
+    std::vector<services::OrderResult> results = {
+        {1001, services::OrderResultCode::SUCCESS, "order created"},
+        {0, services::OrderResultCode::INSUFFICIENT_STOCK, "insufficient stock"},
+    };
+    std::string response;
+    encodeBatchCreateOrderResponse(response, 11, results);
+    ASSERT_EQ(decodeFrame(response.data(), response.size(), frame), DecodeStatus::kOk);
+    BatchResultView batch_result;
+    ASSERT_EQ(BatchResultView::parse(frame, batch_result), DecodeStatus::kOk);
+    ASSERT_EQ(batch_result.orderCount(), 2);
+    EXPECT_EQ(batch_result.orderId(0), 1001u);
+    EXPECT_EQ(batch_result.result(1), ResultCode::kInsufficientStock);
+}
@@ -0,0 +1,580 @@
+#include <gtest/gtest.h>
+#include "services/order_service.h"
+#include "services/inventory_service.h"
+#include "services/idempotency_cache.h"
+#include "services/order_store.h"
+#include "message/order_event_pipeline.h"
+#include "storage/order_journal.h"
+#include "storage/persistence_batcher.h"
+#include <filesystem>
+#include <thread>
+#include <unistd.h>
+
+using namespace order_engine::services;
+
+class OrderServiceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        inventory_ = std::make_shared<InventoryService>();
+        service_ = std::make_shared<OrderService>();
+        service_->setInventoryService(inventory_);
+        ASSERT_TRUE(service_->initialize(4));
+        addStock(1001, 10);
+        addStock(1002, 3);
+    }
+
+    void TearDown() override {
+        service_->shutdown();
+    }
+
+    void addStock(uint64_t product_id, uint32_t quantity) {
+        inventory_->addStock(product_id, quantity, [](bool success, const std::string&) {
+            ASSERT_TRUE(success);
+        });
+    }
+
+    uint32_t available(uint64_t product_id) {
+        uint32_t stock = 0;
+        inventory_->getInventory(product_id, [&stock](bool success, const InventoryInfo& info) {
+            ASSERT_TRUE(success);
+            stock = info.available_stock;
+        });
+        return stock;
+    }
+
+    static OrderInfo makeOrder(uint64_t user_id, std::vector<uint64_t> product_ids,
+                               std::vector<uint32_t> quantities) {
+        OrderInfo order{};
+        order.user_id = user_id;
+        order.product_ids = std::move(product_ids);
+        order.quantities = std::move(quantities);
+        order.total_amount = 99.0;
+        order.shipping_address = "Shanghai";
+        order.payment_method = "alipay";
+        return order;
+    }
+
+    std::shared_ptr<InventoryService> inventory_;
+    std::shared_ptr<OrderService> service_;
+};
+
+TEST_F(OrderServiceTest, CreateAndCancelOrder) {
+    uint64_t order_id = 0;
+    service_->createOrder(makeOrder(1, {1001}, {4}),
+        [&order_id](bool success, const std::string&, const OrderInfo& order) {
+            ASSERT_TRUE(success);
+            order_id = order.order_id;
+        });
+    ASSERT_NE(order_id, 0u);
+    EXPECT_EQ(available(1001), 6u);
+
+    service_->cancelOrder(order_id, "test", [](bool success, const std::string&, const OrderInfo& order) {
+        EXPECT_TRUE(success);
+        EXPECT_EQ(order.status, OrderStatus::CANCELLED);
+    });
+    EXPECT_EQ(available(1001), 10u);
+}
+
+TEST_F(OrderServiceTest, CancelViaStatusUpdateReleasesReservation) {
+    uint64_t order_id = 0;
+    service_->createOrder(makeOrder(1, {1001, 1002}, {4, 3}),
+        [&order_id](bool success, const std::string&, const OrderInfo& order) {
+            ASSERT_TRUE(success);
+            order_id = order.order_id;
+        });
+    ASSERT_NE(order_id, 0u);
+    EXPECT_EQ(available(1001), 6u);
+    EXPECT_EQ(available(1002), 0u);
+
+    service_->updateOrderStatus(order_id, OrderStatus::CANCELLED,
+        [](bool success, const std::string&, const OrderInfo& order) {
+            EXPECT_TRUE(success);
+            EXPECT_EQ(order.status, OrderStatus::CANCELLED);
+        });
+    EXPECT_EQ(available(1001), 10u);
+    EXPECT_EQ(available(1002), 3u);
+
+    // 预留已退回，再次取消不会重复释放
+    service_->cancelOrder(order_id, "test",
+        [](bool success, const std::string&, const OrderInfo&) { EXPECT_FALSE(success); });
+    EXPECT_EQ(available(1001), 10u);
+}
+
+TEST_F(OrderServiceTest, PaymentConfirmsReservation) {
+    std::vector<uint64_t> ids;
+    for (uint64_t user = 1; user <= 3; ++user) {
+        service_->createOrder(makeOrder(user, {1001}, {2}),
+            [&ids](bool success, const std::string&, const OrderInfo& order) {
+                ASSERT_TRUE(success);
+                ids.push_back(order.order_id);
+            });
+    }
+    ASSERT_EQ(ids.size(), 3u);
+    EXPECT_EQ(available(1001), 4u);
+
+    service_->updateOrderStatus(ids[0], OrderStatus::PAID, [](bool success, const std::string&, const OrderInfo&) {
+        EXPECT_TRUE(success);
+    });
+    service_->updateOrderStatuses({ids[1]}, OrderStatus::PAID, [](const std::vector<OrderResult>& results) {
+        EXPECT_EQ(results[0].code, OrderResultCode::SUCCESS);
+    });
+
+    // 预留超时后只退回未支付订单的库存，已支付的保持售出
+    EXPECT_EQ(inventory_->expireReservations(time(nullptr) + 86400), 1u);
+    EXPECT_EQ(available(1001), 6u);
+}
+
+TEST_F(OrderServiceTest, BatchCreateReturnsPerOrderResults) {
+    std::vector<OrderInfo> orders = {
+        makeOrder(1, {1001, 1002}, {2, 2}),
+        makeOrder(0, {1001}, {1}),           // 非法用户
+        makeOrder(2, {1002}, {2}),           // 前一个订单用掉2件后库存不足
+        makeOrder(3, {1001, 1001}, {3, 3}),  // 同一商品合计6件
+        makeOrder(4, {9999}, {1}),           // 未知商品
+    };
+
+    std::vector<OrderResult> results;
+    service_->createOrders(orders, [&results](const std::vector<OrderResult>& r) { results = r; });
+
+    ASSERT_EQ(results.size(), orders.size());
+    EXPECT_EQ(results[0].code, OrderResultCode::SUCCESS);
+    EXPECT_EQ(results[1].code, OrderResultCode::INVALID_ORDER);
+    EXPECT_EQ(results[2].code, OrderResultCode::INSUFFICIENT_STOCK);
+    EXPECT_EQ(results[3].code, OrderResultCode::SUCCESS);
+    EXPECT_EQ(results[4].code, OrderResultCode::INSUFFICIENT_STOCK);
+
+    // 一个批次的订单ID连续分配
+    EXPECT_NE(results[0].order_id, 0u);
+    EXPECT_EQ(results[1].order_id, 0u);
+    EXPECT_EQ(results[3].order_id, results[0].order_id + 2);
+
+    EXPECT_EQ(available(1001), 2u);
+    EXPECT_EQ(available(1002), 1u);
+    EXPECT_EQ(service_->getTotalOrderCount(), 2u);
+    EXPECT_DOUBLE_EQ(service_->getTodayRevenue(), 198.0);
+
+    service_->getOrder(results[3].order_id, [](bool success, const std::string&, const OrderInfo& order) {
+        ASSERT_TRUE(success);
+        EXPECT_EQ(order.user_id, 3u);
+        EXPECT_EQ(order.status, OrderStatus::PENDING);
+    });
+    service_->getOrder(results[2].order_id, [](bool success, const std::string&, const OrderInfo&) {
+        EXPECT_FALSE(success);
+    });
+}
+
+TEST_F(OrderServiceTest, GetUserOrdersPaginates) {
+    std::vector<OrderInfo> orders;
+    for (int i = 0; i < 5; ++i) {
+        orders.push_back(makeOrder(7, {1001}, {1}));
+    }
+    service_->createOrders(orders, [](const std::vector<OrderResult>&) {});
+
+    std::vector<OrderInfo> page;
+    service_->getUserOrders(7, 2, 2, [&page](bool success, const std::vector<OrderInfo>& result) {
+        EXPECT_TRUE(success);
+        page = result;
+    });
+    ASSERT_EQ(page.size(), 2u);
+    EXPECT_GT(page[0].order_id, page[1].order_id);
+}
+
+TEST_F(OrderServiceTest, GetUserOrdersPageWalksCursor) {
+    addStock(1001, 100);
+    std::vector<OrderInfo> orders;
+    for (int i = 0; i < 25; ++i) {
+        orders.push_back(makeOrder(9, {1001}, {1}));
+        orders.push_back(makeOrder(10, {1001}, {1}));
+    }
+    service_->createOrders(orders, [](const std::vector<OrderResult>&) {});
+
+    std::vector<OrderInfo> all;
+    service_->getUserOrders(9, 1, 100, [&all](bool success, const std::vector<OrderInfo>& result) {
+        EXPECT_TRUE(success);
+        all = result;
+    });
+    ASSERT_EQ(all.size(), 25u);
+
+    // 逐页翻完，与偏移分页的结果一致
+    std::vector<OrderInfo> walked;
+    std::string cursor;
+    size_t pages = 0;
+    do {
+        service_->getUserOrdersPage(9, cursor, 7,
+            [&](bool success, const std::vector<OrderInfo>& page, const std::string& next_cursor) {
+                ASSERT_TRUE(success);
+                EXPECT_LE(page.size(), 7u);
+                walked.insert(walked.end(), page.begin(), page.end());
+                cursor = next_cursor;
+            });
+        ASSERT_LT(++pages, 10u);
+    } while (!cursor.empty());
+    EXPECT_EQ(pages, 4u);
+    ASSERT_EQ(walked.size(), all.size());
+    for (size_t i = 0; i < all.size(); ++i) {
+        EXPECT_EQ(walked[i].order_id, all[i].order_id);
+        EXPECT_EQ(walked[i].user_id, 9u);
+    }
+
+    service_->getUserOrdersPage(9, "not-a-cursor", 7,
+        [](bool success, const std::vector<OrderInfo>&, const std::string&) { EXPECT_FALSE(success); });
+}
+
+TEST_F(OrderServiceTest, JournalsChangesBeforeAck) {
+    order_engine::storage::JournalOptions options;
+    options.dir = (std::filesystem::temp_directory_path() /
+                   ("order_service_journal_" + std::to_string(::getpid()))).string();
+    options.segment_size = 64 * 1024;
+    std::filesystem::remove_all(options.dir);
+    auto journal = std::make_shared<order_engine::storage::OrderJournal>(options);
+    ASSERT_TRUE(journal->open());
+    service_->setJournal(journal);
+
+    uint64_t order_id = 0;
+    service_->createOrder(makeOrder(1, {1001}, {2}),
+        [&](bool success, const std::string&, const OrderInfo& order) {
+            ASSERT_TRUE(success);
+            // 应答时记录已落盘
+            EXPECT_EQ(journal->committedLsn(), 1u);
+            order_id = order.order_id;
+        });
+    std::vector<OrderInfo> batch = {makeOrder(2, {1001}, {1}), makeOrder(3, {1002}, {1})};
+    service_->createOrders(batch, [&](const std::vector<OrderResult>& results) {
+        ASSERT_EQ(results.size(), 2u);
+        EXPECT_EQ(journal->committedLsn(), 3u);
+    });
+    service_->cancelOrder(order_id, "test", [](bool success, const std::string&, const OrderInfo&) {
+        EXPECT_TRUE(success);
+    });
+    journal->close();
+
+    std::vector<order_engine::storage::JournalRecordType> types;
+    ASSERT_TRUE(order_engine::storage::OrderJournal::replay(options.dir, 1,
+        [&](const order_engine::storage::JournalRecord& record) { types.push_back(record.type); }));
+    ASSERT_EQ(types.size(), 4u);
+    EXPECT_EQ(types[3], order_engine::storage::JournalRecordType::kStatusChanged);
+
+    // 日志关闭后拒绝写入，订单不应答成功且库存回滚
+    uint32_t before = available(1001);
+    service_->createOrder(makeOrder(4, {1001}, {1}),
+        [](bool success, const std::string&, const OrderInfo&) { EXPECT_FALSE(success); });
+    EXPECT_EQ(available(1001), before);
+    std::filesystem::remove_all(options.dir);
+}
+
+TEST_F(OrderServiceTest, PersistsToDatabaseBeforeAckWithoutJournal) {
+    std::atomic<bool> fail(false);
+    std::atomic<size_t> transactions(0);
+    auto batcher = std::make_shared<order_engine::storage::PersistenceBatcher>(
+        [&](const std::vector<std::string>& statements) {
+            EXPECT_FALSE(statements.empty());
+            transactions.fetch_add(1);
+            return !fail.load();
+        });
+    batcher->start();
+    service_->setPersistenceBatcher(batcher);
+
+    service_->createOrder(makeOrder(1, {1001}, {2}),
+        [&](bool success, const std::string&, const OrderInfo&) {
+            ASSERT_TRUE(success);
+            EXPECT_EQ(batcher->getRowCount(), 1u);
+        });
+    std::vector<OrderInfo> batch = {makeOrder(2, {1001}, {1}), makeOrder(3, {1002}, {1})};
+    service_->createOrders(batch, [&](const std::vector<OrderResult>& results) {
+        ASSERT_EQ(results.size(), 2u);
+        EXPECT_EQ(results[1].code, OrderResultCode::SUCCESS);
+        EXPECT_EQ(batcher->getRowCount(), 3u);
+    });
+    EXPECT_EQ(transactions.load(), 2u);
+
+    // 事务失败时订单不应答成功，订单簿和库存回滚
+    fail = true;
+    uint32_t before = available(1001);
+    auto storeEntries = [this]() {
+        size_t entries = 0;
+        for (const auto& shard : service_->orderStore().stats()) {
+            entries += shard.entries;
+        }
+        return entries;
+    };
+    size_t entries = storeEntries();
+    service_->createOrder(makeOrder(4, {1001}, {1}),
+        [](bool success, const std::string&, const OrderInfo&) { EXPECT_FALSE(success); });
+    service_->createOrders({makeOrder(5, {1001}, {1})}, [](const std::vector<OrderResult>& results) {
+        EXPECT_NE(results[0].code, OrderResultCode::SUCCESS);
+    });
+    EXPECT_EQ(available(1001), before);
+    EXPECT_EQ(storeEntries(), entries);
+    batcher->stop();
+}
+
+TEST_F(OrderServiceTest, RejectsWritesAfterStopWrites) {
+    uint64_t order_id = 0;
+    service_->createOrder(makeOrder(1, {1001}, {2}),
+        [&order_id](bool success, const std::string&, const OrderInfo& order) {
+            ASSERT_TRUE(success);
+            order_id = order.order_id;
+        });
+
+    // 热重启交出日志之前：写入以失败应答且库存回滚，查询照常
+    service_->stopWrites();
+    service_->createOrder(makeOrder(2, {1001}, {1}),
+        [](bool success, const std::string&, const OrderInfo&) { EXPECT_FALSE(success); });
+    EXPECT_EQ(available(1001), 8u);
+    service_->updateOrderStatus(order_id, OrderStatus::PAID,
+        [](bool success, const std::string&, const OrderInfo&) { EXPECT_FALSE(success); });
+    service_->getOrder(order_id, [](bool success, const std::string&, const OrderInfo& order) {
+        EXPECT_TRUE(success);
+        EXPECT_EQ(order.status, OrderStatus::PENDING);
+    });
+}
+
+TEST_F(OrderServiceTest, RejectsInvalidStatusTransition) {
+    uint64_t order_id = 0;
+    service_->createOrder(makeOrder(1, {1001}, {1}),
+        [&order_id](bool, const std::string&, const OrderInfo& order) { order_id = order.order_id; });
+
+    service_->updateOrderStatus(order_id, OrderStatus::SHIPPED,
+        [](bool success, const std::string& message, const OrderInfo& order) {
+            EXPECT_FALSE(success);
+            EXPECT_EQ(message, "invalid status transition");
+            EXPECT_EQ(order.status, OrderStatus::PENDING);
+        });
+    service_->updateOrderStatus(order_id, OrderStatus::PAID,
+        [](bool success, const std::string&, const OrderInfo&) { EXPECT_TRUE(success); });
+    service_->updateOrderStatus(order_id, OrderStatus::SHIPPED,
+        [](bool success, const std::string&, const OrderInfo&) { EXPECT_TRUE(success); });
+    // 已发货不能取消
+    service_->cancelOrder(order_id, "test",
+        [](bool success, const std::string&, const OrderInfo&) { EXPECT_FALSE(success); });
+}
+
+TEST_F(OrderServiceTest, UpdatesStatusesInBulk) {
+    addStock(1001, 100);
+    std::vector<OrderInfo> orders;
+    for (uint64_t user = 1; user <= 20; ++user) {
+        orders.push_back(makeOrder(user, {1001}, {1}));
+    }
+    std::vector<uint64_t> ids;
+    service_->createOrders(orders, [&ids](const std::vector<OrderResult>& results) {
+        for (const auto& result : results) {
+            ids.push_back(result.order_id);
+        }
+    });
+    ASSERT_EQ(ids.size(), 20u);
+
+    // 前10个先支付，整批发货时只有这10个允许
+    std::vector<uint64_t> paid(ids.begin(), ids.begin() + 10);
+    service_->updateOrderStatuses(paid, OrderStatus::PAID, [](const std::vector<OrderResult>& results) {
+        for (const auto& result : results) {
+            EXPECT_EQ(result.code, OrderResultCode::SUCCESS);
+        }
+    });
+    std::vector<uint64_t> shipping = ids;
+    shipping.push_back(123456789);
+    service_->updateOrderStatuses(shipping, OrderStatus::SHIPPED, [](const std::vector<OrderResult>& results) {
+        ASSERT_EQ(results.size(), 21u);
+        for (size_t i = 0; i < 20; ++i) {
+            EXPECT_EQ(results[i].code, i < 10 ? OrderResultCode::SUCCESS : OrderResultCode::INVALID_ORDER);
+        }
+        EXPECT_EQ(results[20].code, OrderResultCode::NOT_FOUND);
+    });
+    for (size_t i = 0; i < ids.size(); ++i) {
+        service_->getOrder(ids[i], [i](bool, const std::string&, const OrderInfo& order) {
+            EXPECT_EQ(order.status, i < 10 ? OrderStatus::SHIPPED : OrderStatus::PENDING);
+        });
+    }
+
+    // 整批取消释放库存
+    uint32_t before = available(1001);
+    std::vector<uint64_t> pending(ids.begin() + 10, ids.end());
+    service_->updateOrderStatuses(pending, OrderStatus::CANCELLED, [](const std::vector<OrderResult>& results) {
+        for (const auto& result : results) {
+            EXPECT_EQ(result.code, OrderResultCode::SUCCESS);
+        }
+    });
+    EXPECT_EQ(available(1001), before + 10);
+}
+
+TEST_F(OrderServiceTest, CancelsUnpaidOrdersAfterTimeout) {
+    // 超时在initialize()时生效，重新建一个服务
+    service_->shutdown();
+    service_ = std::make_shared<OrderService>();
+    service_->setInventoryService(inventory_);
+    service_->setOrderTimeout(60);
+    ASSERT_TRUE(service_->initialize(4));
+
+    uint32_t before = available(1001);
+    std::vector<uint64_t> ids;
+    std::vector<OrderInfo> orders;
+    for (uint64_t user = 1; user <= 4; ++user) {
+        orders.push_back(makeOrder(user, {1001}, {1}));
+    }
+    service_->createOrders(orders, [&ids](const std::vector<OrderResult>& results) {
+        for (const auto& result : results) {
+            ids.push_back(result.order_id);
+        }
+    });
+    service_->createOrder(makeOrder(5, {1001}, {1}),
+        [&ids](bool, const std::string&, const OrderInfo& order) { ids.push_back(order.order_id); });
+    ASSERT_EQ(ids.size(), 5u);
+    EXPECT_EQ(available(1001), before - 5);
+
+    // 已支付的订单不受超时影响
+    service_->updateOrderStatus(ids[0], OrderStatus::PAID, [](bool, const std::string&, const OrderInfo&) {});
+
+    time_t now = time(nullptr);
+    EXPECT_EQ(service_->cancelExpiredOrders(now + 30), 0u);
+    EXPECT_EQ(service_->cancelExpiredOrders(now + 61), 4u);
+    EXPECT_EQ(service_->cancelExpiredOrders(now + 120), 0u);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        service_->getOrder(ids[i], [i](bool, const std::string&, const OrderInfo& order) {
+            EXPECT_EQ(order.status, i == 0 ? OrderStatus::PAID : OrderStatus::CANCELLED);
+        });
+    }
+    EXPECT_EQ(available(1001), before - 1);
+}
+
+TEST_F(OrderServiceTest, ReservationOutlivesOrderTimeout) {
+    // 配置的预留期限短于订单超时：调大，预留不会先于超时取消过期
+    service_->shutdown();
+    service_ = std::make_shared<OrderService>();
+    service_->setInventoryService(inventory_);
+    service_->setOrderTimeout(60);
+    service_->setInventoryReserveTimeout(30);
+    ASSERT_TRUE(service_->initialize(4));
+    EXPECT_EQ(service_->inventoryReserveTimeout(), 60 + OrderService::kReservationGrace);
+
+    uint64_t order_id = 0;
+    service_->createOrder(makeOrder(1, {1001}, {2}),
+        [&order_id](bool success, const std::string&, const OrderInfo& order) {
+            ASSERT_TRUE(success);
+            order_id = order.order_id;
+        });
+    time_t now = time(nullptr);
+    EXPECT_EQ(inventory_->expireReservations(now + 45), 0u);
+    EXPECT_EQ(available(1001), 8u);
+
+    // 期限之内支付，库存保持售出
+    service_->updateOrderStatus(order_id, OrderStatus::PAID, [](bool success, const std::string&, const OrderInfo&) {
+        EXPECT_TRUE(success);
+    });
+    EXPECT_EQ(inventory_->expireReservations(now + 3600), 0u);
+    EXPECT_EQ(available(1001), 8u);
+
+    // 不自动取消时预留不过期
+    service_->shutdown();
+    service_ = std::make_shared<OrderService>();
+    service_->setInventoryService(inventory_);
+    service_->setOrderTimeout(0);
+    ASSERT_TRUE(service_->initialize(4));
+    service_->createOrder(makeOrder(2, {1001}, {1}),
+        [](bool success, const std::string&, const OrderInfo&) { EXPECT_TRUE(success); });
+    EXPECT_EQ(inventory_->expireReservations(now + 86400 * 365), 0u);
+    EXPECT_EQ(available(1001), 7u);
+}
+
+TEST_F(OrderServiceTest, DeduplicatesRetriesByIdempotencyKey) {
+    service_->setIdempotencyCache(std::make_shared<IdempotencyCache>());
+
+    // 同一幂等键并发重试：只创建一个订单，只预留一次库存；
+    // 首个请求执行期间到达的重试挂到首个请求上，拿到同一个订单
+    constexpr int kRetries = 8;
+    std::vector<uint64_t> ids(kRetries, 0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kRetries; ++i) {
+        threads.emplace_back([this, &ids, i] {
+            service_->createOrder(makeOrder(1, {1001}, {2}), "req-1",
+                [&ids, i](bool success, const std::string&, const OrderInfo& order) {
+                    EXPECT_TRUE(success);
+                    ids[i] = order.order_id;
+                });
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    uint64_t created_id = ids[0];
+    ASSERT_NE(created_id, 0u);
+    for (uint64_t id : ids) {
+        EXPECT_EQ(id, created_id);
+    }
+    EXPECT_EQ(available(1001), 8u);
+    // 完成之后的重试返回原订单
+    service_->createOrder(makeOrder(1, {1001}, {2}), "req-1",
+        [&ids](bool success, const std::string&, const OrderInfo& order) {
+            EXPECT_TRUE(success);
+            ids[0] = order.order_id;
+        });
+    EXPECT_EQ(ids[0], created_id);
+
+    // 其他用户的同名键和不带键的请求各自创建
+    uint64_t other = 0;
+    service_->createOrder(makeOrder(2, {1001}, {1}), "req-1",
+        [&other](bool, const std::string&, const OrderInfo& order) { other = order.order_id; });
+    EXPECT_NE(other, ids[0]);
+    service_->createOrder(makeOrder(1, {1001}, {1}), "",
+        [&other](bool, const std::string&, const OrderInfo& order) { other = order.order_id; });
+    EXPECT_NE(other, ids[0]);
+    EXPECT_EQ(available(1001), 6u);
+
+    // 失败不被记住：补货后用同一键重试会重新执行
+    bool created = true;
+    service_->createOrder(makeOrder(3, {1002}, {5}), "req-2",
+        [&created](bool success, const std::string&, const OrderInfo&) { created = success; });
+    EXPECT_FALSE(created);
+    addStock(1002, 2);
+    service_->createOrder(makeOrder(3, {1002}, {5}), "req-2",
+        [&created](bool success, const std::string&, const OrderInfo&) { created = success; });
+    EXPECT_TRUE(created);
+
+    // 首个请求仍在执行（在去重表中登记但未完成）：重试不预留库存，
+    // createOrder立即返回，首个请求完成时才应答
+    auto cache = std::make_shared<IdempotencyCache>();
+    service_->setIdempotencyCache(cache);
+    uint64_t unused = 0;
+    ASSERT_EQ(cache->begin(IdempotencyCache::makeKey(4, "req-3"), time(nullptr), unused),
+              IdempotencyCache::BeginResult::kNew);
+    uint32_t before = available(1001);
+    bool answered = false;
+    uint64_t attached_id = 0;
+    service_->createOrder(makeOrder(4, {1001}, {1}), "req-3",
+        [&answered, &attached_id](bool success, const std::string&, const OrderInfo& order) {
+            answered = true;
+            EXPECT_TRUE(success);
+            attached_id = order.order_id;
+        });
+    EXPECT_FALSE(answered);
+    EXPECT_EQ(available(1001), before);
+    cache->complete(IdempotencyCache::makeKey(4, "req-3"), true, created_id, time(nullptr));
+    EXPECT_TRUE(answered);
+    EXPECT_EQ(attached_id, created_id);
+}
+
+TEST_F(OrderServiceTest, PublishesOrderEvents) {
+    class CountingSink : public order_engine::message::EventSink {
+    public:
+        bool write(const order_engine::message::EventBatch& batch) override {
+            for (size_t i = 0; i < batch.count(); ++i) {
+                records.emplace_back(batch.record(i));
+            }
+            return true;
+        }
+        std::vector<std::string> records;
+    };
+    auto sink = std::make_shared<CountingSink>();
+    auto pipeline = std::make_shared<order_engine::message::OrderEventPipeline>(sink);
+    pipeline->start();
+    service_->setEventPipeline(pipeline);
+
+    uint64_t order_id = 0;
+    service_->createOrder(makeOrder(1, {1001}, {1}),
+        [&order_id](bool, const std::string&, const OrderInfo& order) { order_id = order.order_id; });
+    service_->cancelOrder(order_id, "test", [](bool, const std::string&, const OrderInfo&) {});
+    pipeline->stop();
+
+    ASSERT_EQ(sink->records.size(), 2u);
+    EXPECT_NE(sink->records[0].find("\"event\":\"order_created\""), std::string::npos);
+    EXPECT_NE(sink->records[1].find("\"event\":\"order_cancelled\""), std::string::npos);
+    EXPECT_NE(sink->records[1].find("\"status\":\"CANCELLED\""), std::string::npos);
+}
@@ -0,0 +1,274 @@
+#include <gtest/gtest.h>
+#include "storage/order_snapshot.h"
+#include "storage/order_recovery.h"
+#include "storage/order_journal.h"
+#include "services/order_service.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <filesystem>
+#include <map>
+
+using namespace order_engine::services;
+using namespace order_engine::storage;
+
+namespace {
+
+class OrderSnapshotTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        base_ = (std::filesystem::temp_directory_path() /
+                 ("order_snapshot_test_" + std::to_string(::getpid()))).string();
+        std::filesystem::remove_all(base_);
+        snapshot_dir_ = base_ + "/snapshot";
+        journal_options_.dir = base_ + "/journal";
+        journal_options_.segment_size = 64 * 1024;
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(base_);
+    }
+
+    // 启动一个带日志的订单服务（不设置库存服务）
+    std::shared_ptr<OrderService> startService(size_t shards, std::shared_ptr<OrderJournal>& journal) {
+        journal = std::make_shared<OrderJournal>(journal_options_);
+        EXPECT_TRUE(journal->open());
+        auto service = std::make_shared<OrderService>();
+        EXPECT_TRUE(service->initialize(shards));
+        service->setJournal(journal);
+        return service;
+    }
+
+    static OrderInfo makeOrder(uint64_t user_id, size_t items) {
+        OrderInfo order{};
+        order.user_id = user_id;
+        for (size_t i = 0; i < items; ++i) {
+            order.product_ids.push_back(1000 + i);
+            order.quantities.push_back(static_cast<uint32_t>(i + 1));
+        }
+        order.total_amount = 10.0 * static_cast<double>(items);
+        order.shipping_address = "Room " + std::to_string(user_id) + ", Pudong, Shanghai";
+        order.payment_method = user_id % 2 ? "alipay" : "paypal";
+        return order;
+    }
+
+    // 订单簿全部内容：order_id -> (status, user_id, 商品数, 地址, 支付方式, 预留ID)
+    using Dump = std::map<uint64_t, std::tuple<OrderStatus, uint64_t, size_t, std::string, std::string, std::string>>;
+
+    static Dump dump(OrderStore& store) {
+        Dump result;
+        std::mutex mutex;
+        store.executeAll([&](size_t, OrderShard& shard) {
+            shard.forEach([&](const StoredOrder& entry) {
+                OrderInfo order{};
+                entry.order.toOrderInfo(order);
+                std::lock_guard<std::mutex> lock(mutex);
+                result[order.order_id] = std::make_tuple(order.status, order.user_id, order.product_ids.size(),
+                                                         order.shipping_address, order.payment_method,
+                                                         std::string(entry.reservation_id));
+            });
+        });
+        return result;
+    }
+
+    std::string base_;
+    std::string snapshot_dir_;
+    JournalOptions journal_options_;
+};
+
+} // namespace
+
+TEST_F(OrderSnapshotTest, EncodeDecodeRoundTrip) {
+    order_engine::utils::StringArena arena;
+    OrderInfo order = makeOrder(8, 6);
+    order.order_id = 42;
+    order.status = OrderStatus::SHIPPED;
+    StoredOrder entry{CompactOrder::fromOrderInfo(order, arena), "RSV-42"};
+
+    std::string buffer;
+    OrderSnapshot::encodeOrder(buffer, entry);
+    OrderSnapshot::encodeOrder(buffer, entry);
+
+    std::string_view in = buffer;
+    CompactOrder decoded;
+    std::string_view reservation_id;
+    ASSERT_TRUE(OrderSnapshot::decodeOrder(in, decoded, reservation_id));
+    OrderInfo restored{};
+    decoded.toOrderInfo(restored);
+    EXPECT_EQ(restored.order_id, 42u);
+    EXPECT_EQ(restored.status, OrderStatus::SHIPPED);
+    EXPECT_EQ(restored.product_ids, order.product_ids);
+    EXPECT_EQ(restored.quantities, order.quantities);
+    EXPECT_EQ(restored.shipping_address, order.shipping_address);
+    EXPECT_EQ(restored.payment_method, "paypal");
+    EXPECT_EQ(reservation_id, "RSV-42");
+    ASSERT_TRUE(OrderSnapshot::decodeOrder(in, decoded, reservation_id));
+    EXPECT_TRUE(in.empty());
+
+    // 截断的记录
+    std::string_view truncated(buffer.data(), buffer.size() / 2 - 1);
+    EXPECT_FALSE(OrderSnapshot::decodeOrder(truncated, decoded, reservation_id));
+}
+
+TEST_F(OrderSnapshotTest, RecoversSnapshotPlusJournalTail) {
+    Dump expected;
+    {
+        std::shared_ptr<OrderJournal> journal;
+        auto service = startService(4, journal);
+        std::vector<uint64_t> ids;
+        for (uint64_t user = 1; user <= 200; ++user) {
+            service->createOrder(makeOrder(user, user % 7 + 1),
+                [&ids](bool success, const std::string&, const OrderInfo& order) {
+                    ASSERT_TRUE(success);
+                    ids.push_back(order.order_id);
+                });
+        }
+        ASSERT_TRUE(service->writeSnapshot(snapshot_dir_));
+
+        // 快照之后的变更只在日志中
+        for (size_t i = 0; i < 50; ++i) {
+            service->cancelOrder(ids[i], "test", [](bool success, const std::string&, const OrderInfo&) {
+                EXPECT_TRUE(success);
+            });
+        }
+        service->updateOrderStatus(ids[100], OrderStatus::PAID, [](bool, const std::string&, const OrderInfo&) {});
+        std::vector<OrderInfo> batch;
+        for (uint64_t user = 300; user < 340; ++user) {
+            batch.push_back(makeOrder(user, 2));
+        }
+        service->createOrders(batch, [](const std::vector<OrderResult>&) {});
+
+        expected = dump(const_cast<OrderStore&>(service->orderStore()));
+        ASSERT_EQ(expected.size(), 240u);
+        service->shutdown();
+        journal->close();
+    }
+
+    // 分片数相同和不同两种情况
+    for (size_t shards : {4u, 3u}) {
+        std::shared_ptr<OrderJournal> journal;
+        auto service = startService(shards, journal);
+        ASSERT_TRUE(service->recover(snapshot_dir_));
+        EXPECT_EQ(dump(const_cast<OrderStore&>(service->orderStore())), expected);
+        EXPECT_EQ(service->getTotalOrderCount(), 240u);
+
+        // 新订单ID接在恢复出的最大ID之后（最后一轮才写入，不影响下一轮恢复）
+        if (shards == 3u) {
+            service->createOrder(makeOrder(999, 1), [&](bool success, const std::string&, const OrderInfo& order) {
+                ASSERT_TRUE(success);
+                EXPECT_GT(order.order_id, expected.rbegin()->first);
+            });
+        }
+        service->shutdown();
+        journal->close();
+    }
+}
+
+TEST_F(OrderSnapshotTest, ReplaysWholeJournalWithoutSnapshot) {
+    Dump expected;
+    {
+        std::shared_ptr<OrderJournal> journal;
+        auto service = startService(2, journal);
+        for (uint64_t user = 1; user <= 30; ++user) {
+            service->createOrder(makeOrder(user, 1), [](bool, const std::string&, const OrderInfo&) {});
+        }
+        expected = dump(const_cast<OrderStore&>(service->orderStore()));
+        service->shutdown();
+        journal->close();
+    }
+
+    OrderStore store(5);
+    store.start();
+    RecoveryResult result;
+    ASSERT_TRUE(OrderRecovery::recover(snapshot_dir_, journal_options_.dir, store, result));
+    EXPECT_TRUE(result.snapshot_path.empty());
+    EXPECT_EQ(result.replayed_records, 30u);
+    EXPECT_EQ(dump(store), expected);
+    store.stop();
+}
+
+TEST_F(OrderSnapshotTest, SkipsAbortedOrdersOnReplay) {
+    uint64_t aborted_id = 0;
+    {
+        std::shared_ptr<OrderJournal> journal;
+        auto service = startService(2, journal);
+        for (uint64_t user = 1; user <= 3; ++user) {
+            service->createOrder(makeOrder(user, 1), [&](bool success, const std::string&, const OrderInfo& order) {
+                ASSERT_TRUE(success);
+                aborted_id = order.order_id;
+            });
+        }
+        // 创建记录已提交后下单失败：撤销记录使回放不再恢复该订单
+        ASSERT_TRUE(journal->waitForCommit(journal->appendOrderAborted(aborted_id)));
+        service->shutdown();
+        journal->close();
+    }
+
+    OrderStore store(2);
+    store.start();
+    RecoveryResult result;
+    ASSERT_TRUE(OrderRecovery::recover(snapshot_dir_, journal_options_.dir, store, result));
+    Dump recovered = dump(store);
+    EXPECT_EQ(recovered.size(), 2u);
+    EXPECT_EQ(recovered.count(aborted_id), 0u);
+    store.stop();
+}
+
+TEST_F(OrderSnapshotTest, RemovesCoveredJournalSegments) {
+    std::shared_ptr<OrderJournal> journal;
+    auto service = startService(2, journal);
+    // 长地址让日志很快切换段
+    auto createOrders = [&service](uint64_t from, uint64_t to) {
+        for (uint64_t user = from; user < to; ++user) {
+            OrderInfo order = makeOrder(user, 1);
+            order.shipping_address.append(1000, 'x');
+            service->createOrder(order, [](bool, const std::string&, const OrderInfo&) {});
+        }
+    };
+    createOrders(1, 301);
+    size_t before = OrderJournal::listSegments(journal_options_.dir).size();
+    ASSERT_GT(before, 3u);
+
+    ASSERT_TRUE(service->writeSnapshot(snapshot_dir_));
+    EXPECT_LT(OrderJournal::listSegments(journal_options_.dir).size(), before);
+    uint64_t first_lsn = journal->lastLsn();
+
+    // 保留两个快照，日志只删到较旧的那个
+    createOrders(301, 601);
+    ASSERT_TRUE(service->writeSnapshot(snapshot_dir_));
+    auto segments = OrderJournal::listSegments(journal_options_.dir);
+    EXPECT_LE(segments.front().first, first_lsn + 1);
+    EXPECT_GT(segments.size(), 1u);
+    createOrders(601, 611);
+    service->shutdown();
+    journal->close();
+
+    OrderStore store(2);
+    RecoveryResult result;
+    ASSERT_TRUE(OrderRecovery::recover(snapshot_dir_, journal_options_.dir, store, result));
+    EXPECT_EQ(result.snapshot_orders, 600u);
+    EXPECT_EQ(result.replayed_records, 10u);
+}
+
+TEST_F(OrderSnapshotTest, RejectsCorruptedSnapshot) {
+    std::shared_ptr<OrderJournal> journal;
+    auto service = startService(2, journal);
+    for (uint64_t user = 1; user <= 20; ++user) {
+        service->createOrder(makeOrder(user, 2), [](bool, const std::string&, const OrderInfo&) {});
+    }
+    SnapshotInfo info;
+    ASSERT_TRUE(OrderSnapshot::write(snapshot_dir_, const_cast<OrderStore&>(service->orderStore()),
+                                     journal.get(), &info));
+    EXPECT_EQ(info.orders, 20u);
+    EXPECT_EQ(OrderSnapshot::latest(snapshot_dir_), info.path);
+    service->shutdown();
+    journal->close();
+
+    // 改动最后一个字节，段校验失败
+    int fd = ::open(info.path.c_str(), O_WRONLY);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(::pwrite(fd, "!", 1, static_cast<off_t>(info.bytes - 1)), 1);
+    ::close(fd);
+
+    OrderStore store(2);
+    EXPECT_FALSE(OrderSnapshot::load(info.path, store));
+}
@@ -0,0 +1,30 @@
+#include <gtest/gtest.h>
+#include "services/order_state_machine.h"
+
+using namespace order_engine::services;
+
+TEST(OrderStateMachineTest, AllowsForwardTransitionsOnly) {
+    EXPECT_TRUE(canTransition(OrderStatus::PENDING, OrderStatus::PAID));
+    EXPECT_TRUE(canTransition(OrderStatus::PENDING, OrderStatus::CANCELLED));
+    EXPECT_TRUE(canTransition(OrderStatus::PAID, OrderStatus::SHIPPED));
+    EXPECT_TRUE(canTransition(OrderStatus::PAID, OrderStatus::REFUNDED));
+    EXPECT_TRUE(canTransition(OrderStatus::SHIPPED, OrderStatus::DELIVERED));
+    EXPECT_TRUE(canTransition(OrderStatus::DELIVERED, OrderStatus::REFUNDED));
+
+    EXPECT_FALSE(canTransition(OrderStatus::PENDING, OrderStatus::SHIPPED));
+    EXPECT_FALSE(canTransition(OrderStatus::PENDING, OrderStatus::REFUNDED));
+    EXPECT_FALSE(canTransition(OrderStatus::SHIPPED, OrderStatus::PAID));
+    EXPECT_FALSE(canTransition(OrderStatus::DELIVERED, OrderStatus::CANCELLED));
+}
+
+TEST(OrderStateMachineTest, TerminalStatesHaveNoTransitions) {
+    for (size_t to = 0; to < kOrderStatusCount; ++to) {
+        EXPECT_FALSE(canTransition(OrderStatus::CANCELLED, static_cast<OrderStatus>(to)));
+        EXPECT_FALSE(canTransition(OrderStatus::REFUNDED, static_cast<OrderStatus>(to)));
+        // 不允许原地转换
+        EXPECT_FALSE(canTransition(static_cast<OrderStatus>(to), static_cast<OrderStatus>(to)));
+    }
+    EXPECT_TRUE(isTerminal(OrderStatus::CANCELLED));
+    EXPECT_FALSE(isTerminal(OrderStatus::DELIVERED));
+    EXPECT_FALSE(canTransition(static_cast<OrderStatus>(9), OrderStatus::PAID));
+}
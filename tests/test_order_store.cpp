@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include "services/order_store.h"
+#include <algorithm>
+#include <numeric>
+#include <set>
+
+using namespace order_engine::services;
+
+namespace {
+
+OrderInfo makeOrder(uint64_t order_id, uint64_t user_id) {
+    OrderInfo order{};
+    order.order_id = order_id;
+    order.user_id = user_id;
+    order.product_ids = {1001, 1002};
+    order.quantities = {1, 2};
+    order.shipping_address = "No. 1 Software Avenue, Nanshan District, Shenzhen";
+    order.payment_method = "alipay";
+    return order;
+}
+
+} // namespace
+
+TEST(OrderStoreTest, ShardAccounting) {
+    OrderShard shard;
+    OrderShardStats empty = shard.stats();
+    EXPECT_EQ(empty.entries, 0u);
+
+    ASSERT_TRUE(shard.insert(makeOrder(1, 7), "RSV-1"));
+    EXPECT_FALSE(shard.insert(makeOrder(1, 8), "RSV-1"));
+    ASSERT_TRUE(shard.insert(makeOrder(2, 7), ""));
+    EXPECT_EQ(shard.find(1)->reservation_id, "RSV-1");
+    EXPECT_EQ(shard.find(1)->order.user_id, 7u);
+    OrderShardStats two = shard.stats();
+    EXPECT_EQ(two.entries, 2u);
+    EXPECT_GT(two.memory_bytes, 2 * sizeof(StoredOrder));
+
+    // 修改后重新计算占用：订单行超出内联容量后搬到堆上
+    ASSERT_TRUE(shard.modify(1, [](StoredOrder& entry) {
+        for (uint64_t id = 0; id < 256; ++id) {
+            entry.order.items.push_back(LineItem{id, 1, 0});
+        }
+    }));
+    EXPECT_GE(shard.stats().memory_bytes, two.memory_bytes + 256 * sizeof(LineItem));
+    EXPECT_FALSE(shard.modify(3, [](StoredOrder&) {}));
+
+    ASSERT_TRUE(shard.erase(1));
+    ASSERT_TRUE(shard.erase(2));
+    EXPECT_FALSE(shard.erase(2));
+    EXPECT_EQ(shard.stats().entries, 0u);
+    EXPECT_EQ(shard.find(1), nullptr);
+}
+
+TEST(OrderStoreTest, CompactsStringsOfRemovedOrders) {
+    OrderShard shard;
+    constexpr uint64_t kOrders = 20000;
+    for (uint64_t id = 1; id <= kOrders; ++id) {
+        ASSERT_TRUE(shard.insert(makeOrder(id, id % 100), "RSV-" + std::to_string(id)));
+    }
+    size_t full = shard.stats().memory_bytes;
+
+    // 删除九成、清空剩余订单的一半预留ID后整理，在册订单的字符串不变
+    for (uint64_t id = 1; id <= kOrders; ++id) {
+        if (id % 10 != 0) {
+            ASSERT_TRUE(shard.erase(id));
+        } else if (id % 20 == 0) {
+            ASSERT_TRUE(shard.modify(id, [](StoredOrder& entry) { entry.reservation_id = std::string_view(); }));
+        }
+    }
+    EXPECT_GE(shard.compactions(), 1u);
+    EXPECT_LT(shard.stats().memory_bytes, full / 4);
+    for (uint64_t id = 10; id <= kOrders; id += 10) {
+        const StoredOrder* entry = shard.find(id);
+        ASSERT_NE(entry, nullptr);
+        EXPECT_EQ(entry->order.shipping_address, makeOrder(id, 0).shipping_address);
+        EXPECT_EQ(entry->reservation_id, id % 20 == 0 ? "" : "RSV-" + std::to_string(id));
+    }
+
+    // 引用的字节多于不再引用的字节时不整理
+    uint64_t compactions = shard.compactions();
+    ASSERT_TRUE(shard.modify(10, [&shard](StoredOrder& entry) { entry.reservation_id = shard.storeString("RSV-X"); }));
+    ASSERT_TRUE(shard.erase(20));
+    EXPECT_EQ(shard.compactions(), compactions);
+    EXPECT_EQ(shard.find(10)->reservation_id, "RSV-X");
+}
+
+TEST(OrderStoreTest, TasksRunOnOwningThread) {
+    OrderStore store(4);
+    store.start();
+    ASSERT_TRUE(store.isRunning());
+
+    std::vector<OrderInfo> orders;
+    for (uint64_t id = 1; id <= 1000; ++id) {
+        orders.push_back(makeOrder(id, id % 10));
+    }
+    std::vector<const OrderInfo*> pointers;
+    for (const auto& order : orders) {
+        pointers.push_back(&order);
+    }
+    std::vector<bool> inserted = store.insertBatch(pointers, std::vector<std::string_view>(1000));
+    ASSERT_EQ(inserted.size(), 1000u);
+    EXPECT_TRUE(std::all_of(inserted.begin(), inserted.end(), [](bool ok) { return ok; }));
+
+    // 同一分片的任务总在同一个线程上执行，且不是调用线程
+    std::set<std::thread::id> threads;
+    for (uint64_t id = 1; id <= 1000; ++id) {
+        std::thread::id owner;
+        bool found = false;
+        store.execute(id, [&](OrderShard& shard) {
+            owner = std::this_thread::get_id();
+            found = shard.find(id) != nullptr;
+        });
+        EXPECT_TRUE(found);
+        EXPECT_NE(owner, std::this_thread::get_id());
+        threads.insert(owner);
+    }
+    EXPECT_EQ(threads.size(), 4u);
+
+    size_t total = 0;
+    for (const auto& stats : store.stats()) {
+        EXPECT_GT(stats.entries, 0u);  // 连续ID经过混洗后分布到各分片
+        total += stats.entries;
+    }
+    EXPECT_EQ(total, 1000u);
+
+    // 重复ID插入失败
+    OrderInfo duplicate = makeOrder(5, 1);
+    OrderInfo fresh = makeOrder(2000, 1);
+    inserted = store.insertBatch({&duplicate, &fresh}, {"RSV-5", "RSV-2000"});
+    EXPECT_FALSE(inserted[0]);
+    EXPECT_TRUE(inserted[1]);
+
+    std::vector<size_t> counts(store.shardCount(), 0);
+    store.executeAll([&counts](size_t index, OrderShard& shard) {
+        shard.forEach([&counts, index](const StoredOrder& entry) {
+            if (entry.order.user_id == 3) {
+                ++counts[index];
+            }
+        });
+    });
+    EXPECT_EQ(std::accumulate(counts.begin(), counts.end(), size_t(0)), 100u);
+
+    store.stop();
+    EXPECT_FALSE(store.isRunning());
+    // 停止后在调用线程直接执行
+    std::thread::id owner;
+    store.execute(1, [&owner](OrderShard&) { owner = std::this_thread::get_id(); });
+    EXPECT_EQ(owner, std::this_thread::get_id());
+}
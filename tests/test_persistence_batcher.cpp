@@ -0,0 +1,378 @@
+#include <gtest/gtest.h>
+#include "storage/persistence_batcher.h"
+#include "utils/histogram.h"
+#include <atomic>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <latch>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
+using namespace order_engine::services;
+using namespace order_engine::storage;
+using order_engine::utils::Histogram;
+
+namespace {
+
+// 记录每个事务的语句，可设置为失败
+class FakeDatabase {
+public:
+    PersistenceBatcher::TransactionExecutor executor() {
+        return [this](const std::vector<std::string>& statements) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            transactions_.push_back(statements);
+            return !fail_.load();
+        };
+    }
+
+    std::vector<std::vector<std::string>> transactions() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return transactions_;
+    }
+
+    std::atomic<bool> fail_{false};
+
+private:
+    std::mutex mutex_;
+    std::vector<std::vector<std::string>> transactions_;
+};
+
+OrderInfo makeOrder(uint64_t order_id, time_t created_at = 1745000000) {
+    OrderInfo order{};
+    order.order_id = order_id;
+    order.user_id = 100 + order_id;
+    order.product_ids = {1001, 1002};
+    order.quantities = {1, 3};
+    order.total_amount = 25.5;
+    order.status = OrderStatus::PENDING;
+    order.created_at = created_at;
+    order.updated_at = created_at;
+    order.shipping_address = "Pudong, Shanghai";
+    order.payment_method = "alipay";
+    return order;
+}
+
+size_t countRows(const std::string& statement) {
+    size_t rows = 0;
+    for (size_t pos = statement.find("VALUES "); pos != std::string::npos; pos = statement.find("),(", pos + 1)) {
+        ++rows;
+    }
+    return rows;
+}
+
+} // namespace
+
+TEST(PersistenceBatcherTest, FlushesWhenMaxRowsReached) {
+    FakeDatabase db;
+    PersistenceOptions options;
+    options.max_delay_ms = 60000;  // 只靠行数触发
+    options.max_rows = 4;
+    PersistenceBatcher batcher(db.executor(), options);
+    batcher.start();
+
+    std::latch done(8);
+    for (uint64_t id = 1; id <= 8; ++id) {
+        ASSERT_TRUE(batcher.submit(makeOrder(id), "N" + std::to_string(id), [&done](bool success) {
+            EXPECT_TRUE(success);
+            done.count_down();
+        }));
+    }
+    done.wait();
+
+    auto transactions = db.transactions();
+    ASSERT_EQ(transactions.size(), 2u);
+    for (const auto& statements : transactions) {
+        ASSERT_EQ(statements.size(), 2u);
+        EXPECT_EQ(countRows(statements[0]), 4u);
+        EXPECT_EQ(countRows(statements[1]), 8u);  // 每个订单两件商品
+    }
+    EXPECT_EQ(batcher.getBatchCount(), 2u);
+    EXPECT_EQ(batcher.getRowCount(), 8u);
+    batcher.stop();
+}
+
+TEST(PersistenceBatcherTest, FlushesAfterMaxDelay) {
+    FakeDatabase db;
+    PersistenceOptions options;
+    options.max_delay_ms = 20;
+    options.max_rows = 1000;
+    PersistenceBatcher batcher(db.executor(), options);
+    batcher.start();
+
+    // 多个线程并发提交，同一窗口内的订单合并为一个事务
+    std::latch done(40);
+    std::vector<std::thread> threads;
+    for (uint64_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            for (uint64_t i = 0; i < 10; ++i) {
+                batcher.submit(makeOrder(t * 10 + i + 1), "N", [&done](bool) { done.count_down(); });
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    done.wait();
+
+    EXPECT_LT(db.transactions().size(), 40u);
+    EXPECT_EQ(batcher.getRowCount(), 40u);
+    EXPECT_EQ(batcher.batchSize().count(), batcher.getBatchCount());
+    EXPECT_EQ(batcher.batchSize().sum(), 40.0);
+    EXPECT_EQ(batcher.batchLatency().count(), batcher.getBatchCount());
+    batcher.stop();
+}
+
+TEST(PersistenceBatcherTest, CallbacksReportTransactionFailure) {
+    FakeDatabase db;
+    db.fail_ = true;
+    PersistenceBatcher batcher(db.executor());
+    batcher.start();
+
+    std::atomic<int> failed(0);
+    std::latch done(3);
+    for (uint64_t id = 1; id <= 3; ++id) {
+        batcher.submit(makeOrder(id), "N", [&](bool success) {
+            if (!success) {
+                failed.fetch_add(1);
+            }
+            done.count_down();
+        });
+    }
+    done.wait();
+    EXPECT_EQ(failed.load(), 3);
+    EXPECT_GE(batcher.getFailedBatchCount(), 1u);
+    EXPECT_EQ(batcher.getRowCount(), 0u);
+    batcher.stop();
+}
+
+TEST(PersistenceBatcherTest, RetriesFailedBatchUntilCommitted) {
+    FakeDatabase db;
+    db.fail_ = true;
+    PersistenceOptions options;
+    options.max_delay_ms = 1;
+    options.retry_delay_ms = 1;
+    options.max_retry_delay_ms = 4;
+    PersistenceBatcher batcher(db.executor(), options);
+    batcher.start();
+
+    // 要求重试的订单在失败时不回调，不重试的立即以失败回调
+    std::atomic<int> committed(0);
+    std::atomic<int> failed(0);
+    std::latch rejected(1);
+    for (uint64_t id = 1; id <= 3; ++id) {
+        batcher.submit(makeOrder(id), "N", [&](bool success) {
+            (success ? committed : failed).fetch_add(1);
+        }, true);
+    }
+    batcher.submit(makeOrder(4), "N", [&](bool success) {
+        EXPECT_FALSE(success);
+        rejected.count_down();
+    });
+    rejected.wait();
+    while (db.transactions().size() < 3) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(committed.load(), 0);
+    EXPECT_EQ(failed.load(), 0);
+    EXPECT_GE(batcher.getRetriedRowCount(), 3u);
+
+    db.fail_ = false;
+    while (committed.load() < 3) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(failed.load(), 0);
+    EXPECT_EQ(batcher.getRowCount(), 3u);
+    batcher.stop();
+}
+
+TEST(PersistenceBatcherTest, BisectsPoisonRowIntoDeadLetter) {
+    std::string dead_letter = (std::filesystem::temp_directory_path() /
+                               ("batcher_dead_letter_" + std::to_string(::getpid()) + ".sql")).string();
+    std::filesystem::remove(dead_letter);
+    // 含订单13的事务总是失败（例如某列越界）
+    std::atomic<size_t> transactions(0);
+    PersistenceOptions options;
+    options.max_delay_ms = 1;
+    options.retry_delay_ms = 1;
+    options.max_retry_delay_ms = 2;
+    options.max_attempts = 2;
+    options.dead_letter_file = dead_letter;
+    PersistenceBatcher batcher([&](const std::vector<std::string>& statements) {
+        transactions.fetch_add(1);
+        return statements[0].find("(13,") == std::string::npos;
+    }, options);
+    batcher.start();
+
+    std::atomic<int> committed(0);
+    std::atomic<int> failed(0);
+    for (uint64_t id = 10; id < 18; ++id) {
+        batcher.submit(makeOrder(id), "N", [&](bool success) {
+            (success ? committed : failed).fetch_add(1);
+        }, true);
+    }
+    for (int i = 0; i < 2000 && committed.load() + failed.load() < 8; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // 好的订单经二分后写入，坏数据单独转入死信，不再阻塞队列
+    EXPECT_EQ(committed.load(), 7);
+    EXPECT_EQ(failed.load(), 1);
+    EXPECT_EQ(batcher.getRowCount(), 7u);
+    EXPECT_EQ(batcher.getDeadLetterCount(), 1u);
+    EXPECT_EQ(batcher.queueDepth(), 0u);
+    batcher.stop();
+
+    std::string content;
+    std::ifstream in(dead_letter);
+    content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    EXPECT_NE(content.find("(13,"), std::string::npos);
+    EXPECT_EQ(content.find("(12,"), std::string::npos);
+    std::filesystem::remove(dead_letter);
+}
+
+TEST(PersistenceBatcherTest, RejectsSubmitsWhenQueueFull) {
+    std::atomic<bool> release(false);
+    std::atomic<bool> entered(false);
+    PersistenceOptions options;
+    options.max_delay_ms = 0;
+    options.max_rows = 1;
+    options.max_pending = 2;
+    PersistenceBatcher batcher([&](const std::vector<std::string>&) {
+        entered = true;
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }, options);
+    batcher.start();
+
+    // 第一个订单在事务中阻塞，之后队列最多容纳两个
+    ASSERT_TRUE(batcher.submit(makeOrder(1), "N"));
+    while (!entered.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(batcher.submit(makeOrder(2), "N"));
+    EXPECT_TRUE(batcher.submit(makeOrder(3), "N"));
+    EXPECT_FALSE(batcher.submit(makeOrder(4), "N"));
+    EXPECT_EQ(batcher.getRejectedCount(), 1u);
+    EXPECT_EQ(batcher.queueDepth(), 2u);
+
+    release = true;
+    batcher.stop();
+    EXPECT_EQ(batcher.getRowCount(), 3u);
+}
+
+TEST(PersistenceBatcherTest, StopReportsOrdersStillFailing) {
+    FakeDatabase db;
+    db.fail_ = true;
+    PersistenceOptions options;
+    options.retry_delay_ms = 60000;
+    PersistenceBatcher batcher(db.executor(), options);
+    batcher.start();
+
+    std::atomic<int> failed(0);
+    for (uint64_t id = 1; id <= 2; ++id) {
+        batcher.submit(makeOrder(id), "N", [&failed](bool success) {
+            if (!success) {
+                failed.fetch_add(1);
+            }
+        }, true);
+    }
+    while (batcher.getRetriedRowCount() == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // 停止时打断退避等待，最后写一次，仍失败才回调
+    batcher.stop();
+    EXPECT_EQ(failed.load(), 2);
+    EXPECT_GE(db.transactions().size(), 2u);
+}
+
+TEST(PersistenceBatcherTest, StopFlushesPendingAndRejectsLateSubmits) {
+    FakeDatabase db;
+    PersistenceOptions options;
+    options.max_delay_ms = 60000;
+    PersistenceBatcher batcher(db.executor(), options);
+    EXPECT_FALSE(batcher.submit(makeOrder(1), "N"));
+
+    batcher.start();
+    std::atomic<int> committed(0);
+    for (uint64_t id = 1; id <= 5; ++id) {
+        batcher.submit(makeOrder(id), "N", [&committed](bool success) {
+            if (success) {
+                committed.fetch_add(1);
+            }
+        });
+    }
+    batcher.stop();
+    EXPECT_EQ(committed.load(), 5);
+    EXPECT_EQ(db.transactions().size(), 1u);
+    EXPECT_FALSE(batcher.submit(makeOrder(6), "N"));
+}
+
+TEST(PersistenceBatcherTest, BuildsMonthlyTablesAndEscapesValues) {
+    // 取月中时间，避免时区影响月份
+    struct tm tm_buf{};
+    tm_buf.tm_year = 2025 - 1900;
+    tm_buf.tm_mon = 3;
+    tm_buf.tm_mday = 15;
+    tm_buf.tm_hour = 12;
+    time_t april = mktime(&tm_buf);
+    tm_buf.tm_mon = 4;
+    time_t may = mktime(&tm_buf);
+    EXPECT_EQ(PersistenceBatcher::ordersTable(april), "orders_202504");
+    EXPECT_EQ(PersistenceBatcher::ordersTable(may), "orders_202505");
+
+    std::vector<PersistenceBatcher::PendingOrder> batch;
+    OrderInfo tricky = makeOrder(1, april);
+    tricky.shipping_address = "O'Neil \"Tower\"\n";
+    tricky.payment_method = "wechat\\pay";
+    batch.push_back({tricky, "ORD-1", nullptr, {}, false});
+    batch.push_back({makeOrder(2, may), "ORD-2", nullptr, {}, false});
+    batch.push_back({makeOrder(3, april), "ORD-3", nullptr, {}, false});
+
+    std::vector<std::string> statements;
+    PersistenceBatcher::buildStatements(batch, statements);
+    ASSERT_EQ(statements.size(), 3u);
+    EXPECT_EQ(statements[0].rfind("INSERT INTO orders_202504 ", 0), 0u);
+    EXPECT_EQ(countRows(statements[0]), 2u);
+    EXPECT_EQ(statements[1].rfind("INSERT INTO orders_202505 ", 0), 0u);
+    EXPECT_EQ(countRows(statements[1]), 1u);
+    EXPECT_EQ(statements[2].rfind("INSERT INTO order_items ", 0), 0u);
+    EXPECT_EQ(countRows(statements[2]), 6u);
+
+    const std::string& april_rows = statements[0];
+    EXPECT_NE(april_rows.find("(1,'ORD-1',101,25.50,25.50,0,'wechat\\\\pay',"), std::string::npos);
+    // 地址先编码为JSON字符串，再做SQL转义
+    EXPECT_NE(april_rows.find("'\\\"O\\'Neil \\\\\\\"Tower\\\\\\\"\\\\n\\\"'"), std::string::npos);
+    EXPECT_NE(april_rows.find("FROM_UNIXTIME(" + std::to_string(april) + ")"), std::string::npos);
+    EXPECT_NE(statements[2].find("(1,1002,3,FROM_UNIXTIME("), std::string::npos);
+    EXPECT_EQ(statements[2].find("product_name"), std::string::npos);
+}
+
+TEST(HistogramTest, ObservesIntoCumulativeBuckets) {
+    Histogram histogram(Histogram::exponentialBounds(1.0, 2.0, 3));  // 1, 2, 4
+    ASSERT_EQ(histogram.bounds(), (std::vector<double>{1.0, 2.0, 4.0}));
+    for (double value : {0.5, 1.0, 1.5, 3.0, 100.0}) {
+        histogram.observe(value);
+    }
+    EXPECT_EQ(histogram.bucketCount(0), 2u);  // le=1包含边界值
+    EXPECT_EQ(histogram.bucketCount(1), 1u);
+    EXPECT_EQ(histogram.bucketCount(2), 1u);
+    EXPECT_EQ(histogram.bucketCount(3), 1u);
+    EXPECT_EQ(histogram.count(), 5u);
+    EXPECT_DOUBLE_EQ(histogram.sum(), 106.0);
+
+    std::string out;
+    histogram.appendPrometheus(out, "latency_ms", "stage=\"db\"");
+    EXPECT_EQ(out,
+              "# TYPE latency_ms histogram\n"
+              "latency_ms_bucket{stage=\"db\",le=\"1\"} 2\n"
+              "latency_ms_bucket{stage=\"db\",le=\"2\"} 3\n"
+              "latency_ms_bucket{stage=\"db\",le=\"4\"} 4\n"
+              "latency_ms_bucket{stage=\"db\",le=\"+Inf\"} 5\n"
+              "latency_ms_sum{stage=\"db\"} 106\n"
+              "latency_ms_count{stage=\"db\"} 5\n");
+}
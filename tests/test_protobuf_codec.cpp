@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include "protocol/protobuf_codec.h"
+#include "order.pb.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace order_engine;
+using namespace order_engine::protocol;
+
+namespace {
+
+// 统计当前线程在计数窗口内的堆分配次数
+thread_local bool g_counting = false;
+thread_local size_t g_allocations = 0;
+
+} // namespace
+
+void* operator new(size_t size) {
+    if (g_counting) {
+        ++g_allocations;
+    }
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+class ProtobufCodecTest : public ::testing::Test {
+protected:
+    std::string makeRequest(uint64_t request_id, size_t items) {
+        proto::CreateOrderRequest request;
+        request.set_user_id(42);
+        request.set_total_amount_cents(19999);
+        for (size_t i = 0; i < items; ++i) {
+            proto::LineItem* item = request.add_items();
+            item->set_product_id(1000 + i);
+            item->set_quantity(static_cast<uint32_t>(i + 1));
+        }
+        // 短字符串走SSO，长字符串内容仍由std::string在堆上分配
+        request.set_shipping_address("Shenzhen");
+        request.set_payment_method("alipay");
+
+        std::string frame;
+        codec_.serialize(frame, MessageType::kCreateOrderRequest, request_id, request);
+        return frame;
+    }
+
+    ProtobufCodec codec_;
+};
+
+TEST_F(ProtobufCodecTest, RoundTripThroughFrame) {
+    std::string buffer = makeRequest(7, 3);
+
+    FrameView frame;
+    ASSERT_EQ(decodeFrame(buffer.data(), buffer.size(), frame), DecodeStatus::kOk);
+    EXPECT_TRUE(frame.flags() & kFlagProtobuf);
+    EXPECT_EQ(frame.requestId(), 7u);
+
+    auto* request = codec_.parse<proto::CreateOrderRequest>(frame);
+    ASSERT_NE(request, nullptr);
+    EXPECT_NE(request->GetArena(), nullptr);
+    EXPECT_EQ(request->user_id(), 42u);
+    ASSERT_EQ(request->items_size(), 3);
+    EXPECT_EQ(request->items(2).product_id(), 1002u);
+    EXPECT_EQ(request->payment_method(), "alipay");
+    codec_.reset();
+
+    // 二进制协议的帧不会被当作protobuf解析
+    std::string binary;
+    encodeQueryOrderRequest(binary, 1, 99);
+    ASSERT_EQ(decodeFrame(binary.data(), binary.size(), frame), DecodeStatus::kOk);
+    EXPECT_EQ(codec_.parse<proto::QueryOrderRequest>(frame), nullptr);
+}
+
+TEST_F(ProtobufCodecTest, ConvertsToAndFromOrderInfo) {
+    std::string buffer = makeRequest(7, 3);
+    FrameView frame;
+    ASSERT_EQ(decodeFrame(buffer.data(), buffer.size(), frame), DecodeStatus::kOk);
+    auto* request = codec_.parse<proto::CreateOrderRequest>(frame);
+    ASSERT_NE(request, nullptr);
+
+    services::OrderInfo order;
+    toOrderInfo(*request, order);
+    EXPECT_EQ(order.user_id, 42u);
+    ASSERT_EQ(order.product_ids.size(), 3u);
+    EXPECT_EQ(order.product_ids[2], 1002u);
+    EXPECT_EQ(order.quantities.size(), 3u);
+    EXPECT_EQ(order.payment_method, "alipay");
+    EXPECT_EQ(order.status, services::OrderStatus::PENDING);
+
+    order.order_id = 99;
+    auto* record = codec_.create<proto::OrderRecord>();
+    fromOrderInfo(order, *record);
+    EXPECT_EQ(record->order_id(), 99u);
+    EXPECT_EQ(record->total_amount_cents(), request->total_amount_cents());
+    ASSERT_EQ(record->items_size(), 3);
+    EXPECT_EQ(record->items(2).product_id(), 1002u);
+    EXPECT_EQ(record->payment_method(), "alipay");
+    codec_.reset();
+}
+
+TEST_F(ProtobufCodecTest, SteadyStateHasNoAllocations) {
+    std::string buffer = makeRequest(1, 64);
+    std::string out;
+    out.reserve(64 * 1024);
+
+    auto handle = [&]() {
+        FrameView frame;
+        ASSERT_EQ(decodeFrame(buffer.data(), buffer.size(), frame), DecodeStatus::kOk);
+        auto* request = codec_.parse<proto::CreateOrderRequest>(frame);
+        ASSERT_NE(request, nullptr);
+
+        auto* result = codec_.create<proto::Result>();
+        result->set_order_id(request->user_id());
+        result->set_code(0);
+        out.clear();
+        codec_.serialize(out, MessageType::kCreateOrderResponse, frame.requestId(), *result);
+        codec_.reset();
+    };
+
+    // 预热：arena按峰值扩容
+    for (int i = 0; i < 4; ++i) {
+        handle();
+    }
+
+    g_allocations = 0;
+    g_counting = true;
+    for (int i = 0; i < 1000; ++i) {
+        handle();
+    }
+    g_counting = false;
+
+    EXPECT_EQ(g_allocations, 0u);
+    EXPECT_EQ(codec_.getResetCount(), 1004u);
+}
+
+TEST_F(ProtobufCodecTest, GrowsForLargeRequests) {
+    ProtobufCodec codec(1024);
+    std::string buffer = makeRequest(1, 512);
+
+    FrameView frame;
+    ASSERT_EQ(decodeFrame(buffer.data(), buffer.size(), frame), DecodeStatus::kOk);
+    ASSERT_NE(codec.parse<proto::CreateOrderRequest>(frame), nullptr);
+    codec.reset();
+    EXPECT_EQ(codec.getGrowCount(), 1u);
+    EXPECT_GT(codec.getBlockSize(), 1024u);
+
+    size_t grown = codec.getBlockSize();
+    ASSERT_NE(codec.parse<proto::CreateOrderRequest>(frame), nullptr);
+    codec.reset();
+    EXPECT_EQ(codec.getGrowCount(), 1u);
+    EXPECT_EQ(codec.getBlockSize(), grown);
+}
+
+TEST_F(ProtobufCodecTest, RejectsGarbagePayload) {
+    std::string buffer;
+    size_t start = beginFrame(buffer, MessageType::kCreateOrderRequest, 1, kFlagProtobuf);
+    buffer.append("\xff\xff\xff\xff\xff", 5);
+    endFrame(buffer, start);
+
+    FrameView frame;
+    ASSERT_EQ(decodeFrame(buffer.data(), buffer.size(), frame), DecodeStatus::kOk);
+    EXPECT_EQ(codec_.parse<proto::CreateOrderRequest>(frame), nullptr);
+    codec_.reset();
+}
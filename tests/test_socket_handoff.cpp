@@ -0,0 +1,255 @@
+#include <gtest/gtest.h>
+#include "network/socket_handoff.h"
+#include "common/logger.h"
+#include "services/order_service.h"
+#include "services/inventory_service.h"
+#include "storage/order_journal.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <filesystem>
+
+using namespace order_engine::network;
+
+class SocketHandoffTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        socket_path_ = "/tmp/order_engine_handoff_test_" + std::to_string(::getpid()) + ".sock";
+    }
+
+    void TearDown() override {
+        ::unlink(socket_path_.c_str());
+    }
+
+    std::string socket_path_;
+};
+
+TEST_F(SocketHandoffTest, TransferListenAndConnectionFds) {
+    // 模拟旧进程持有的监听socket和一条已建立连接
+    int listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(listen_fd, 0);
+    struct sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = 0;
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    ASSERT_EQ(::bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)), 0);
+    ASSERT_EQ(::listen(listen_fd, 16), 0);
+
+    int pair[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+
+    SocketHandoff old_side(socket_path_);
+    ASSERT_TRUE(old_side.startListening());
+
+    HandoffFds received;
+    std::atomic<bool> request_ok{false};
+    std::thread new_process([this, &received, &request_ok]() {
+        SocketHandoff new_side(socket_path_);
+        request_ok = new_side.requestFrom(received, 2000);
+        if (request_ok) {
+            new_side.confirm();
+        }
+    });
+
+    ASSERT_TRUE(old_side.hasPendingRequest(2000));
+    HandoffFds fds;
+    fds.listen_fds.push_back(listen_fd);
+    fds.connection_fds.push_back(pair[0]);
+    EXPECT_TRUE(old_side.serve(fds, 2000));
+    new_process.join();
+
+    ASSERT_TRUE(request_ok.load());
+    ASSERT_EQ(received.listen_fds.size(), 1u);
+    ASSERT_EQ(received.connection_fds.size(), 1u);
+
+    // 接收到的监听fd仍处于监听状态
+    int accepting = 0;
+    socklen_t len = sizeof(accepting);
+    ASSERT_EQ(::getsockopt(received.listen_fds[0], SOL_SOCKET, SO_ACCEPTCONN, &accepting, &len), 0);
+    EXPECT_EQ(accepting, 1);
+
+    // 旧进程关闭副本后连接依然可用
+    ::close(pair[0]);
+    ASSERT_EQ(::write(received.connection_fds[0], "hi", 2), 2);
+    char buf[4] = {};
+    ASSERT_EQ(::read(pair[1], buf, sizeof(buf)), 2);
+    EXPECT_EQ(std::string(buf, 2), "hi");
+
+    ::close(listen_fd);
+    ::close(pair[1]);
+    ::close(received.listen_fds[0]);
+    ::close(received.connection_fds[0]);
+}
+
+TEST_F(SocketHandoffTest, ManyConnectionFds) {
+    SocketHandoff old_side(socket_path_);
+    ASSERT_TRUE(old_side.startListening());
+
+    // 超过单条消息上限，验证分片发送
+    const int num_fds = 150;
+    std::vector<int> peers;
+    HandoffFds fds;
+    for (int i = 0; i < num_fds; ++i) {
+        int pair[2];
+        ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+        fds.connection_fds.push_back(pair[0]);
+        peers.push_back(pair[1]);
+    }
+
+    HandoffFds received;
+    std::thread new_process([this, &received]() {
+        SocketHandoff new_side(socket_path_);
+        if (new_side.requestFrom(received, 2000)) {
+            new_side.confirm();
+        }
+    });
+
+    ASSERT_TRUE(old_side.hasPendingRequest(2000));
+    EXPECT_TRUE(old_side.serve(fds, 2000));
+    new_process.join();
+
+    ASSERT_EQ(received.connection_fds.size(), static_cast<size_t>(num_fds));
+    EXPECT_TRUE(received.listen_fds.empty());
+
+    for (int fd : fds.connection_fds) ::close(fd);
+    for (int fd : peers) ::close(fd);
+    for (int fd : received.connection_fds) ::close(fd);
+}
+
+TEST_F(SocketHandoffTest, NotConfirmedKeepsServing) {
+    SocketHandoff old_side(socket_path_);
+    ASSERT_TRUE(old_side.startListening());
+
+    std::thread new_process([this]() {
+        SocketHandoff new_side(socket_path_);
+        HandoffFds received;
+        new_side.requestFrom(received, 2000);
+        for (int fd : received.listen_fds) ::close(fd);
+        // 不确认，直接关闭
+    });
+
+    int pair[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+    HandoffFds fds;
+    fds.listen_fds.push_back(pair[0]);
+
+    ASSERT_TRUE(old_side.hasPendingRequest(2000));
+    EXPECT_FALSE(old_side.serve(fds, 500));
+    new_process.join();
+
+    ::close(pair[0]);
+    ::close(pair[1]);
+}
+
+TEST_F(SocketHandoffTest, HandsOverJournalAfterDrain) {
+    using namespace order_engine::services;
+    using namespace order_engine::storage;
+
+    std::string dir = "/tmp/order_engine_handoff_journal_" + std::to_string(::getpid());
+    std::filesystem::remove_all(dir);
+    JournalOptions options;
+    options.dir = dir + "/journal";
+    options.segment_size = 1024 * 1024;
+    options.commit_interval_us = 0;
+    std::string snapshot_dir = dir + "/snapshot";
+
+    // 库存尚未持久化，新旧进程各自补货
+    auto startService = [](const std::shared_ptr<OrderJournal>& journal) {
+        auto inventory = std::make_shared<InventoryService>();
+        inventory->addStock(1001, 100, [](bool, const std::string&) {});
+        auto service = std::make_shared<OrderService>();
+        service->setInventoryService(inventory);
+        service->setJournal(journal);
+        EXPECT_TRUE(service->initialize(2));
+        return service;
+    };
+    auto placeOrder = [](OrderService& service) {
+        OrderInfo order{};
+        order.user_id = 7;
+        order.product_ids = {1001};
+        order.quantities = {1};
+        order.total_amount = 10.0;
+        order.shipping_address = "Hangzhou";
+        order.payment_method = "alipay";
+        uint64_t order_id = 0;
+        service.createOrder(order, [&order_id](bool success, const std::string&, const OrderInfo& created) {
+            EXPECT_TRUE(success);
+            order_id = created.order_id;
+        });
+        return order_id;
+    };
+
+    auto old_journal = std::make_shared<OrderJournal>(options);
+    ASSERT_TRUE(old_journal->open());
+    auto old_service = startService(old_journal);
+    std::vector<uint64_t> order_ids = {placeOrder(*old_service)};
+
+    SocketHandoff old_side(socket_path_);
+    ASSERT_TRUE(old_side.startListening());
+
+    std::atomic<bool> released{false};
+    uint64_t released_lsn = 0;
+    std::vector<bool> found;
+    uint64_t new_lsn = 0;
+    std::thread new_process([&]() {
+        SocketHandoff new_side(socket_path_);
+        HandoffFds received;
+        if (!new_side.requestFrom(received, 2000) || !new_side.confirm()) {
+            return;
+        }
+        for (int fd : received.listen_fds) ::close(fd);
+        // 旧进程交出日志之前不能打开
+        if (!new_side.waitJournalRelease(released_lsn, 5000)) {
+            return;
+        }
+        released = true;
+        auto journal = std::make_shared<OrderJournal>(options);
+        ASSERT_TRUE(journal->open());
+        auto service = startService(journal);
+        ASSERT_TRUE(service->recover(snapshot_dir));
+        for (uint64_t order_id : order_ids) {
+            service->getOrder(order_id, [&found](bool success, const std::string&, const OrderInfo&) {
+                found.push_back(success);
+            });
+        }
+        placeOrder(*service);
+        new_lsn = journal->lastLsn();
+        service->shutdown();
+        journal->close();
+    });
+
+    int pair[2];
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+    HandoffFds fds;
+    fds.listen_fds.push_back(pair[0]);
+    ASSERT_TRUE(old_side.hasPendingRequest(2000));
+    ASSERT_TRUE(old_side.serve(fds, 2000));
+    old_side.stopListening();
+
+    // 排空期间旧进程仍在接受订单
+    order_ids.push_back(placeOrder(*old_service));
+    order_ids.push_back(placeOrder(*old_service));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(released.load());
+
+    ASSERT_TRUE(old_service->writeSnapshot(snapshot_dir));
+    order_ids.push_back(placeOrder(*old_service));
+    old_service->shutdown();
+    old_journal->close();
+    uint64_t old_lsn = old_journal->lastLsn();
+    EXPECT_TRUE(old_side.releaseJournal(old_lsn));
+    new_process.join();
+
+    ASSERT_TRUE(released.load());
+    EXPECT_EQ(released_lsn, old_lsn);
+    EXPECT_EQ(found, std::vector<bool>(order_ids.size(), true));
+    EXPECT_EQ(new_lsn, old_lsn + 1);
+
+    ::close(pair[0]);
+    ::close(pair[1]);
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "services/status_order_index.h"
+#include "services/order_service.h"
+#include <set>
+
+using namespace order_engine::services;
+
+TEST(StatusOrderIndexTest, RangesAscendingAcrossBuckets) {
+    StatusOrderIndex index;
+    // 每10秒一个订单，跨越多个60秒的桶
+    for (uint64_t id = 1; id <= 30; ++id) {
+        index.add(OrderStatus::PENDING, UserOrderKey{static_cast<uint32_t>(1000 + id * 10), id});
+    }
+    index.add(OrderStatus::PAID, UserOrderKey{1015, 99});
+    EXPECT_EQ(index.count(OrderStatus::PENDING), 30u);
+    EXPECT_EQ(index.count(OrderStatus::PAID), 1u);
+    EXPECT_EQ(index.count(OrderStatus::SHIPPED), 0u);
+
+    std::vector<UserOrderKey> page;
+    index.range(OrderStatus::PENDING, 1055, 1200, nullptr, 5, page);
+    ASSERT_EQ(page.size(), 5u);
+    EXPECT_EQ(page.front().order_id, 6u);
+    EXPECT_EQ(page.back().order_id, 10u);
+
+    // 从上一页最后一个键之后继续，不越过to
+    UserOrderKey after = page.back();
+    page.clear();
+    index.range(OrderStatus::PENDING, 1055, 1200, &after, 100, page);
+    ASSERT_EQ(page.size(), 9u);
+    EXPECT_EQ(page.front().order_id, 11u);
+    EXPECT_EQ(page.back().order_id, 19u);
+
+    page.clear();
+    index.range(OrderStatus::DELIVERED, 0, UINT32_MAX, nullptr, 10, page);
+    EXPECT_TRUE(page.empty());
+}
+
+TEST(StatusOrderIndexTest, CountsMatchBruteForceForAnyRange) {
+    StatusOrderIndex index;
+    std::vector<UserOrderKey> keys;
+    for (uint64_t id = 1; id <= 500; ++id) {
+        // 乱序插入，同一秒内有多个订单
+        UserOrderKey key{static_cast<uint32_t>(5000 + (id * 37) % 900), id};
+        index.add(OrderStatus::PENDING, key);
+        keys.push_back(key);
+    }
+    for (uint32_t from = 4990; from < 5920; from += 23) {
+        for (uint32_t to = from; to < 5920; to += 41) {
+            size_t expected = 0;
+            for (const auto& key : keys) {
+                expected += key.created_at >= from && key.created_at < to ? 1 : 0;
+            }
+            ASSERT_EQ(index.count(OrderStatus::PENDING, from, to), expected) << from << " " << to;
+        }
+    }
+    EXPECT_EQ(index.count(OrderStatus::PENDING, 0, UINT32_MAX), 500u);
+}
+
+TEST(StatusOrderIndexTest, RemovesKeysAndReleasesEmptyBuckets) {
+    StatusOrderIndex index;
+    size_t empty_bytes = index.memoryBytes();
+    index.add(OrderStatus::PENDING, UserOrderKey{100, 1});
+    index.add(OrderStatus::PENDING, UserOrderKey{100, 1});  // 重复忽略
+    index.add(OrderStatus::PENDING, UserOrderKey{400, 2});
+    EXPECT_EQ(index.count(OrderStatus::PENDING), 2u);
+    EXPECT_GT(index.memoryBytes(), empty_bytes);
+
+    EXPECT_FALSE(index.remove(OrderStatus::PAID, UserOrderKey{100, 1}));
+    EXPECT_FALSE(index.remove(OrderStatus::PENDING, UserOrderKey{100, 3}));
+    EXPECT_TRUE(index.remove(OrderStatus::PENDING, UserOrderKey{100, 1}));
+    EXPECT_TRUE(index.remove(OrderStatus::PENDING, UserOrderKey{400, 2}));
+    EXPECT_EQ(index.count(OrderStatus::PENDING), 0u);
+    EXPECT_EQ(index.memoryBytes(), empty_bytes);
+}
+
+TEST(StatusOrderIndexTest, ServiceQueriesFollowStatusChanges) {
+    auto service = std::make_shared<OrderService>();
+    ASSERT_TRUE(service->initialize(4));
+    std::vector<uint64_t> ids;
+    for (uint64_t user = 1; user <= 40; ++user) {
+        OrderInfo order{};
+        order.user_id = user;
+        order.product_ids = {1001};
+        order.quantities = {1};
+        order.total_amount = 9.9;
+        service->createOrder(order, [&ids](bool success, const std::string&, const OrderInfo& created) {
+            ASSERT_TRUE(success);
+            ids.push_back(created.order_id);
+        });
+    }
+    for (size_t i = 0; i < 15; ++i) {
+        service->updateOrderStatus(ids[i], OrderStatus::PAID, [](bool success, const std::string&, const OrderInfo&) {
+            EXPECT_TRUE(success);
+        });
+    }
+    service->cancelOrder(ids[39], "test", [](bool success, const std::string&, const OrderInfo&) {
+        EXPECT_TRUE(success);
+    });
+
+    time_t now = time(nullptr);
+    EXPECT_EQ(service->countOrdersByStatus(OrderStatus::PENDING, 0, now + 1), 24u);
+    EXPECT_EQ(service->countOrdersByStatus(OrderStatus::PAID, 0, now + 1), 15u);
+    EXPECT_EQ(service->countOrdersByStatus(OrderStatus::CANCELLED, 0, now + 1), 1u);
+    EXPECT_EQ(service->countOrdersByStatus(OrderStatus::PENDING, now + 1, now + 60), 0u);
+
+    // 跨分片按游标翻页，从旧到新，不重不漏
+    std::set<uint64_t> seen;
+    std::string cursor;
+    OrderInfo previous{};
+    for (int pages = 0;; ++pages) {
+        ASSERT_LT(pages, 10);
+        std::string next;
+        service->getOrdersByStatus(OrderStatus::PENDING, 0, now + 1, cursor, 7,
+            [&](bool success, const std::vector<OrderInfo>& orders, const std::string& next_cursor) {
+                ASSERT_TRUE(success);
+                for (const auto& order : orders) {
+                    EXPECT_EQ(order.status, OrderStatus::PENDING);
+                    EXPECT_TRUE(previous.order_id == 0 || previous.created_at < order.created_at ||
+                                (previous.created_at == order.created_at && previous.order_id < order.order_id));
+                    EXPECT_TRUE(seen.insert(order.order_id).second);
+                    previous = order;
+                }
+                next = next_cursor;
+            });
+        if (next.empty()) {
+            break;
+        }
+        cursor = next;
+    }
+    EXPECT_EQ(seen.size(), 24u);
+    EXPECT_EQ(seen.count(ids[0]), 0u);
+    EXPECT_EQ(seen.count(ids[39]), 0u);
+
+    service->getOrdersByStatus(OrderStatus::PENDING, 0, now + 1, "bogus", 7,
+        [](bool success, const std::vector<OrderInfo>&, const std::string&) {
+            EXPECT_FALSE(success);
+        });
+    service->shutdown();
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include "utils/timing_wheel.h"
+#include <map>
+#include <random>
+
+using order_engine::utils::TimingWheel;
+
+TEST(TimingWheelTest, FiresAtDeadline) {
+    TimingWheel wheel(1000);
+    wheel.schedule(1, 1005);
+    wheel.schedule(2, 1005);
+    wheel.schedule(3, 1010);
+    wheel.schedule(4, 900);  // 已过期，下次推进即触发
+    EXPECT_EQ(wheel.size(), 4u);
+
+    std::vector<uint64_t> fired;
+    auto collect = [&fired](uint64_t id) { fired.push_back(id); };
+    wheel.advance(1004, collect);
+    EXPECT_EQ(fired, std::vector<uint64_t>({4}));
+    wheel.advance(1005, collect);
+    ASSERT_EQ(fired.size(), 3u);
+    wheel.advance(1009, collect);
+    EXPECT_EQ(fired.size(), 3u);
+    wheel.advance(1010, collect);
+    EXPECT_EQ(fired.back(), 3u);
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(TimingWheelTest, CascadesAcrossLevelsExactly) {
+    // 随机起点和到期时间，跨越所有层；每个条目必须恰好在到期秒触发
+    std::mt19937_64 rng(42);
+    time_t start = 1700000000 + static_cast<time_t>(rng() % 100000);
+    TimingWheel wheel(start);
+    std::map<uint64_t, time_t> deadlines;
+    const int64_t delays[] = {1, 63, 64, 65, 1800, 4095, 4096, 4097, 262143, 262144, 300000, 20000000};
+    uint64_t id = 0;
+    for (int64_t delay : delays) {
+        for (int j = 0; j < 3; ++j) {
+            time_t deadline = start + delay + static_cast<time_t>(rng() % 3);
+            deadlines[++id] = deadline;
+            wheel.schedule(id, deadline);
+        }
+    }
+
+    size_t fired = 0;
+    time_t end = start + 20000010;
+    // 步长不固定，模拟推进不均匀
+    for (time_t now = start; now < end;) {
+        now = std::min(end, now + 1 + static_cast<time_t>(rng() % 5000));
+        wheel.advance(now, [&](uint64_t fired_id) {
+            ++fired;
+            EXPECT_EQ(wheel.current(), deadlines[fired_id]) << "id " << fired_id;
+        });
+    }
+    EXPECT_EQ(fired, deadlines.size());
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(TimingWheelTest, HandlesDeadlinesBeyondRange) {
+    TimingWheel wheel(0);
+    const time_t far = (time_t(1) << 24) + 123;  // 超出4层覆盖范围
+    wheel.schedule(7, far);
+    bool fired = false;
+    wheel.advance(far - 1, [&fired](uint64_t) { fired = true; });
+    EXPECT_FALSE(fired);
+    wheel.advance(far, [&](uint64_t id) {
+        fired = true;
+        EXPECT_EQ(id, 7u);
+        EXPECT_EQ(wheel.current(), far);
+    });
+    EXPECT_TRUE(fired);
+}
+
+TEST(TimingWheelTest, RescheduleFromCallback) {
+    TimingWheel wheel(0);
+    wheel.schedule(1, 10);
+    int fired = 0;
+    wheel.advance(100, [&](uint64_t id) {
+        if (++fired < 3) {
+            wheel.schedule(id, wheel.current() + 10);
+        }
+    });
+    EXPECT_EQ(fired, 3);
+}
+
+TEST(TimingWheelTest, SkipsAheadWhenEmpty) {
+    TimingWheel wheel(1000);
+    std::vector<uint64_t> fired;
+    auto collect = [&fired](uint64_t id) { fired.push_back(id); };
+    // 空轮一步推进一年，之后按新的当前时间排期
+    wheel.advance(1000 + 86400 * 365, collect);
+    EXPECT_EQ(wheel.current(), 1000 + 86400 * 365);
+    wheel.schedule(1, wheel.current() + 70);
+    wheel.advance(wheel.current() + 69, collect);
+    EXPECT_TRUE(fired.empty());
+    wheel.advance(wheel.current() + 1, collect);
+    EXPECT_EQ(fired, std::vector<uint64_t>({1}));
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include "services/user_order_index.h"
+#include "services/order_store.h"
+
+using namespace order_engine::services;
+
+TEST(UserOrderIndexTest, PagesFromNewestToOldest) {
+    UserOrderIndex index;
+    for (uint64_t id = 1; id <= 10; ++id) {
+        index.add(42, UserOrderKey{static_cast<uint32_t>(1000 + id / 2), id});
+    }
+    index.add(43, UserOrderKey{2000, 99});
+    EXPECT_EQ(index.count(42), 10u);
+    EXPECT_EQ(index.userCount(), 2u);
+
+    std::vector<UserOrderKey> page;
+    index.before(42, nullptr, 4, page);
+    ASSERT_EQ(page.size(), 4u);
+    EXPECT_EQ(page[0].order_id, 10u);
+    EXPECT_EQ(page[3].order_id, 7u);
+
+    // 从上一页最后一个键之后继续
+    UserOrderKey cursor = page.back();
+    page.clear();
+    index.before(42, &cursor, 100, page);
+    ASSERT_EQ(page.size(), 6u);
+    EXPECT_EQ(page.front().order_id, 6u);
+    EXPECT_EQ(page.back().order_id, 1u);
+
+    page.clear();
+    index.before(7, nullptr, 10, page);
+    EXPECT_TRUE(page.empty());
+}
+
+TEST(UserOrderIndexTest, KeepsOrderForOutOfOrderInsertsAndRemoves) {
+    UserOrderIndex index;
+    index.add(1, UserOrderKey{300, 3});
+    index.add(1, UserOrderKey{100, 1});
+    index.add(1, UserOrderKey{200, 2});
+    index.add(1, UserOrderKey{200, 2});  // 重复忽略
+    EXPECT_EQ(index.count(1), 3u);
+
+    EXPECT_TRUE(index.remove(1, UserOrderKey{200, 2}));
+    EXPECT_FALSE(index.remove(1, UserOrderKey{200, 2}));
+    std::vector<UserOrderKey> page;
+    index.before(1, nullptr, 10, page);
+    ASSERT_EQ(page.size(), 2u);
+    EXPECT_EQ(page[0].order_id, 3u);
+    EXPECT_EQ(page[1].order_id, 1u);
+
+    EXPECT_TRUE(index.remove(1, UserOrderKey{300, 3}));
+    EXPECT_TRUE(index.remove(1, UserOrderKey{100, 1}));
+    EXPECT_EQ(index.userCount(), 0u);
+}
+
+TEST(UserOrderIndexTest, CursorRoundTrip) {
+    UserOrderKey key{1745000000, 123456789012345ULL};
+    UserOrderKey parsed{};
+    ASSERT_TRUE(UserOrderKey::fromCursor(key.toCursor(), parsed));
+    EXPECT_EQ(parsed, key);
+
+    EXPECT_FALSE(UserOrderKey::fromCursor("", parsed));
+    EXPECT_FALSE(UserOrderKey::fromCursor("123", parsed));
+    EXPECT_FALSE(UserOrderKey::fromCursor("12x-5", parsed));
+    EXPECT_FALSE(UserOrderKey::fromCursor("12-5-", parsed));
+}
+
+TEST(UserOrderIndexTest, ShardMaintainsIndex) {
+    OrderShard shard;
+    OrderInfo order{};
+    order.user_id = 5;
+    order.product_ids = {1};
+    order.quantities = {1};
+    for (uint64_t id = 1; id <= 3; ++id) {
+        order.order_id = id;
+        order.created_at = 100 + id;
+        ASSERT_TRUE(shard.insert(order, ""));
+    }
+    EXPECT_EQ(shard.userIndex().count(5), 3u);
+
+    // 状态变更不改变索引，改动用户时迁移
+    shard.modify(2, [](StoredOrder& entry) { entry.order.status = OrderStatus::PAID; });
+    EXPECT_EQ(shard.userIndex().count(5), 3u);
+    shard.modify(3, [](StoredOrder& entry) { entry.order.user_id = 6; });
+    EXPECT_EQ(shard.userIndex().count(5), 2u);
+    EXPECT_EQ(shard.userIndex().count(6), 1u);
+
+    shard.erase(1);
+    std::vector<UserOrderKey> page;
+    shard.userIndex().before(5, nullptr, 10, page);
+    ASSERT_EQ(page.size(), 1u);
+    EXPECT_EQ(page[0].order_id, 2u);
+}